@@ -20,9 +20,22 @@ allowed_ips = "127.0.0.1;192.168.1.51"
 
 -- Max memory size, 1GB
 max_size = 1024 * 1024 * 1024
+-- The cache is split into this many shards, each gets max_size / cache_shards
+cache_shards = 16
+-- Threads doing the database work, 0 = depending on the number of CPUs
+io_threads = 0
+-- Database connections, 0 = one for each I/O thread. SQLite always uses one.
+db_pool_size = 0
 -- Flush cache every minute
 flush_interval = 1000 * 60
 -- Clean cache every 10min
 clean_interval = 1000 * 60 * 10
+-- Changed records are written to the DB at latest after 1s
+write_latency = 1000
+-- Max records written in one transaction
+write_batch_size = 100
+-- Changes not yet written to the DB are logged here, so they are not lost on a
+-- crash. Empty to disable.
+journal_dir = EXE_PATH .. "/journal/abdata"
 
 require("config/db")
@@ -10,8 +10,12 @@ file_ip = ""         -- Listen on all
 file_host = ""       -- emtpy use same host as for login
 file_port = 8081
 
--- Used to calculate the load Byte/sec (100Mbit)
+-- Used to calculate the load Byte/sec (100Mbit). Downloads are throttled to not exceed it.
 max_throughput = (100 * 1024 * 1024) / 8
+-- Byte/sec for all downloads of one client, 0 = unlimited
+max_client_throughput = 0
+-- Max. size of small files kept in memory, 0 to disable
+file_cache_size = 64 * 1024 * 1024
 
 server_key = "server.key"
 server_cert = "server.crt"
@@ -9,6 +9,11 @@ server_name = "AT3"
 require("config/data_server")
 
 data_dir = "data"
+-- Compiled scripts are stored here, so they are only compiled again when they
+-- change. Empty to disable.
+script_cache_dir = "cache/scripts"
+-- Reload changed data files, e.g. scripts, while the server is running
+watch_assets = false
 recordings_dir = "recordings"
 record_games = false
 
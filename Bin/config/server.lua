@@ -16,3 +16,10 @@ ai_server_interval = 100
 
 -- DOS prevention
 max_packets_per_second = 60
+
+-- Game messages with at least this many bytes are compressed
+compression_threshold = 128
+-- Time in microseconds per game tick for collecting Lua garbage
+lua_gc_budget = 1000
+-- Time in microseconds per game tick for evaluating the behavior trees of NPCs
+ai_budget = 5000
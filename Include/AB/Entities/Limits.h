@@ -35,6 +35,7 @@ static constexpr int MAX_SERVICE_NAME = 64;
 static constexpr int MAX_SERVICE_HOST = 64;
 static constexpr int MAX_SERVICE_IP = 64;
 static constexpr int MAX_SERVICE_LOCATION = 10;
+static constexpr int MAX_SERVICE_STATS = 4096;
 static constexpr int MAX_SERVICES = 64;         // Max number of services in ServiceList
 
 static constexpr int MAX_MUSIC = 65536;
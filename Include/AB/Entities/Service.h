@@ -79,6 +79,7 @@ struct Service : Entity
         s.value1b(temporary);
         s.value1b(load);
         s.value8b(heartbeat);
+        s.text1b(stats, Limits::MAX_SERVICE_STATS);
     }
 
     std::string name;
@@ -106,6 +107,9 @@ struct Service : Entity
     uint8_t load = 0;
     /// Last heart beat time
     timestamp_t heartbeat{ 0 };
+    /// Statistics of the service, one "name: value" per line. Not written to DB.
+    /// The service is responsible to update this value.
+    std::string stats;
 };
 
 }
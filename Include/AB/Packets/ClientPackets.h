@@ -34,6 +34,8 @@ struct GameLogin
 {
     uint16_t clientOs;
     uint16_t protocolVersion;
+    /// PROTOCOL_CAPABILITY_* flags
+    uint32_t capabilities;
     uint8_t key[DH_KEY_LENGTH];
     std::string accountUuid;
     std::string authToken;
@@ -46,6 +48,7 @@ struct GameLogin
     {
         ar.value(clientOs);
         ar.value(protocolVersion);
+        ar.value(capabilities);
         for (unsigned i = 0; i < DH_KEY_LENGTH; ++i)
             ar.value(key[i]);
         ar.value(accountUuid);
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <AB/Packets/Packet.h>
+#include <AB/Packets/ServerPackets.h>
+#include <AB/ProtocolCodes.h>
+#include <cstring>
+#include <lz4.h>
+#include <string>
+
+// Compression of game messages. The server compresses the plain message before
+// it is encrypted, the client decompresses it after decrypting it. Compressed
+// messages start with MESSAGE_COMPRESSED and the size of the compressed data,
+// others with MESSAGE_UNCOMPRESSED.
+
+namespace AB {
+namespace Packets {
+
+static constexpr uint8_t MESSAGE_UNCOMPRESSED = 0;
+static constexpr uint8_t MESSAGE_COMPRESSED = 1;
+/// Smaller messages are not compressed, LZ4 can't do much with them
+static constexpr int DEFAULT_COMPRESSION_THRESHOLD = 128;
+
+namespace detail {
+
+class DictionaryWriter
+{
+public:
+    std::string data_;
+    template<typename T>
+    void Add(const T& value)
+    {
+        data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template<typename T>
+    void AddByte(T value)
+    {
+        Add<uint8_t>(static_cast<uint8_t>(value));
+    }
+};
+
+template<>
+inline void DictionaryWriter::Add<std::string>(const std::string& value)
+{
+    Add<uint16_t>(static_cast<uint16_t>(value.length()));
+    data_.append(value);
+}
+
+template<typename T>
+inline void AddDictionaryPacket(DictionaryWriter& writer, GameProtocol::ServerPacketType type, T packet)
+{
+    writer.AddByte(type);
+    Add(packet, writer);
+}
+
+}
+
+/// Data LZ4 can refer to, made of the packets most game status messages consist of.
+/// Messages are small, so there is little to find within a single message.
+/// Client and server must use the same dictionary, change PROTOCOL_VERSION when it changes.
+inline const std::string& GetCompressionDictionary()
+{
+    static const std::string dictionary = []()
+    {
+        using namespace GameProtocol;
+        using namespace Server;
+        detail::DictionaryWriter writer;
+        // LZ4 prefers matches closer to the end of the dictionary, so the most frequent packets come last.
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectDamaged, ObjectDamaged{ 0, 0, 0, 0, 0 });
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectEffectAdded, ObjectEffectAdded{ 0, 0, 0 });
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectUseSkill, ObjectUseSkill{ 0, 0, 0, 0, 0, 0, 0 });
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectSelectTarget, ObjectTargetSelected{ 0, 0 });
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectStateChange, ObjectStateChanged{ 0, static_cast<uint8_t>(CreatureState::Idle) });
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectStateChange, ObjectStateChanged{ 0, static_cast<uint8_t>(CreatureState::Moving) });
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectResourceChange, ObjectResourceChanged{ 0, 0, 0 });
+        ObjectTransformations transformations;
+        transformations.count = 2;
+        transformations.objects.push_back({ 0, ObjectTransformationPosition, { 0, 0, 0 }, 0 });
+        transformations.objects.push_back({ 0, ObjectTransformationPosition | ObjectTransformationRotation, { 0, 0, 0 }, 0 });
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameObjectTransformations, transformations);
+        detail::AddDictionaryPacket(writer, ServerPacketType::GameUpdate, GameUpdate{ 0 });
+        return writer.data_;
+    }();
+    return dictionary;
+}
+
+/// Returns the size of the compressed data, or 0 on failure
+inline int CompressMessage(const char* source, int sourceSize, char* dest, int destCapacity)
+{
+    const std::string& dictionary = GetCompressionDictionary();
+    LZ4_stream_t stream;
+    LZ4_resetStream(&stream);
+    LZ4_loadDict(&stream, dictionary.data(), static_cast<int>(dictionary.size()));
+    return LZ4_compress_fast_continue(&stream, source, dest, sourceSize, destCapacity, 1);
+}
+
+/// Returns the size of the decompressed data, or a negative value on failure
+inline int DecompressMessage(const char* source, int sourceSize, char* dest, int destCapacity)
+{
+    const std::string& dictionary = GetCompressionDictionary();
+    return LZ4_decompress_safe_usingDict(source, dest, sourceSize, destCapacity,
+        dictionary.data(), static_cast<int>(dictionary.size()));
+}
+
+}
+}
@@ -24,7 +24,9 @@
 #include "stdint.h"
 #include <string>
 #include <AB/ProtocolCodes.h>
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <vector>
 
 namespace AB {
@@ -511,6 +513,127 @@ struct ObjectRotationUpdate
     }
 };
 
+/// Maps positions within the bounds of a map to 16 bit per axis. The server sends
+/// it once when a player enters a game, before the first ObjectTransformations.
+struct PositionQuantizer
+{
+    /// Center of the bounds
+    std::array<float, 3> origin{ { 0.0f, 0.0f, 0.0f } };
+    /// Steps per unit
+    std::array<float, 3> scale{ { 1.0f, 1.0f, 1.0f } };
+
+    static PositionQuantizer FromBounds(const std::array<float, 3>& min, const std::array<float, 3>& max)
+    {
+        PositionQuantizer result;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            result.origin[i] = (min[i] + max[i]) * 0.5f;
+            const float halfSize = std::max((max[i] - min[i]) * 0.5f, 1.0f);
+            result.scale[i] = 32767.0f / halfSize;
+        }
+        return result;
+    }
+    /// Returns false when the value is outside of the bounds
+    bool Quantize(size_t axis, float value, int16_t& result) const
+    {
+        const float steps = std::round((value - origin[axis]) * scale[axis]);
+        if (!(steps >= -32768.0f && steps <= 32767.0f))
+            return false;
+        result = static_cast<int16_t>(steps);
+        return true;
+    }
+    bool Quantize(const std::array<float, 3>& value, std::array<int16_t, 3>& result) const
+    {
+        return Quantize(0, value[0], result[0]) &&
+            Quantize(1, value[1], result[1]) &&
+            Quantize(2, value[2], result[2]);
+    }
+    float Dequantize(size_t axis, int16_t value) const
+    {
+        return origin[axis] + static_cast<float>(value) / scale[axis];
+    }
+    std::array<float, 3> Dequantize(const std::array<int16_t, 3>& value) const
+    {
+        return { Dequantize(0, value[0]), Dequantize(1, value[1]), Dequantize(2, value[2]) };
+    }
+
+    template<typename _Ar>
+    void Serialize(_Ar& ar)
+    {
+        ar.value(origin[0]);
+        ar.value(origin[1]);
+        ar.value(origin[2]);
+        ar.value(scale[0]);
+        ar.value(scale[1]);
+        ar.value(scale[2]);
+    }
+};
+
+/// Quantize Y rotation in radians to 16 bit
+inline uint16_t QuantizeRotation(float value)
+{
+    constexpr float twoPi = 6.28318530718f;
+    float result = std::fmod(value, twoPi);
+    if (result < 0.0f)
+        result += twoPi;
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::round(result * (65536.0f / twoPi))) & 0xFFFF);
+}
+
+/// Returns the rotation in the range [-Pi, Pi)
+inline float DequantizeRotation(uint16_t value)
+{
+    constexpr float twoPi = 6.28318530718f;
+    const float result = static_cast<float>(value) * (twoPi / 65536.0f);
+    return result >= twoPi * 0.5f ? result - twoPi : result;
+}
+
+enum ObjectTransformationFlags : uint8_t
+{
+    ObjectTransformationPosition = 1,
+    ObjectTransformationSetPosition = 1 << 1,
+    ObjectTransformationRotation = 1 << 2,
+    ObjectTransformationManualRotation = 1 << 3
+};
+
+/// Position and rotation changes of many objects in one packet. Sent instead of
+/// ObjectPosUpdate, ObjectSetPosition and ObjectRotationUpdate when the client
+/// supports PROTOCOL_CAPABILITY_COMPACT_MOVEMENT. Positions are quantized with the
+/// PositionQuantizer of the game. Positions outside of its bounds are sent with
+/// ObjectPosUpdate or ObjectSetPosition.
+struct ObjectTransformations
+{
+    struct Transformation
+    {
+        uint32_t id;
+        uint8_t flags;
+        std::array<int16_t, 3> pos;
+        uint16_t yRot;
+    };
+    uint16_t count;
+    std::vector<Transformation> objects;
+
+    template<typename _Ar>
+    void Serialize(_Ar& ar)
+    {
+        ar.value(count);
+        objects.resize(count);
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            auto& object = objects[i];
+            ar.value(object.id);
+            ar.value(object.flags);
+            if (object.flags & (ObjectTransformationPosition | ObjectTransformationSetPosition))
+            {
+                ar.value(object.pos[0]);
+                ar.value(object.pos[1]);
+                ar.value(object.pos[2]);
+            }
+            if (object.flags & ObjectTransformationRotation)
+                ar.value(object.yRot);
+        }
+    }
+};
+
 struct ObjectSpeedChanged
 {
     uint32_t id;
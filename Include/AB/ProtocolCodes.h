@@ -27,7 +27,11 @@ namespace AB
 {
 
 /// Increase whenever the protocol changes
-static constexpr uint16_t PROTOCOL_VERSION = 1;
+static constexpr uint16_t PROTOCOL_VERSION = 4;
+
+/// Optional features of the game protocol. The client tells the server what it supports.
+static constexpr uint32_t PROTOCOL_CAPABILITY_COMPACT_MOVEMENT = 1;
+static constexpr uint32_t PROTOCOL_CAPABILITIES = PROTOCOL_CAPABILITY_COMPACT_MOVEMENT;
 
 static constexpr uint16_t CLIENT_OS_WIN = 1;
 static constexpr uint16_t CLIENT_OS_LINUX = 2;
@@ -48,8 +52,8 @@ enum ProtocolIds : uint8_t
 };
 
 #define ENABLE_GAME_ENCRYTION true
-// TODO:
-#define ENABLE_GAME_COMPRESSION false
+// Server to client messages only
+#define ENABLE_GAME_COMPRESSION true
 
 const uint32_t ENC_KEY[4] = {
     0xd705d09f,
@@ -176,7 +180,9 @@ const uint32_t ENC_KEY[4] = {
     ENUMERATE_SERVER_PACKET_CODE(ObjectSetAttributeValue)     \
     ENUMERATE_SERVER_PACKET_CODE(ObjectSecProfessionChanged)  \
     ENUMERATE_SERVER_PACKET_CODE(ObjectSetSkill)              \
-    ENUMERATE_SERVER_PACKET_CODE(PlayerSkillTemplLoaded)
+    ENUMERATE_SERVER_PACKET_CODE(PlayerSkillTemplLoaded)      \
+    ENUMERATE_SERVER_PACKET_CODE(GameObjectTransformations)   \
+    ENUMERATE_SERVER_PACKET_CODE(GamePositionQuantizer)
 
 #define ENUMERATE_CREATURE_STATES          \
     ENUMERATE_CREATURE_STATE(Unknown)      \
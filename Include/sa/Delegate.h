@@ -0,0 +1,87 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <utility>
+#include <type_traits>
+
+namespace sa {
+
+template <typename Signature>
+class Delegate;
+
+/// A callable which is just an object pointer and a function pointer, so it can be copied and
+/// stored without allocating memory like a std::function with a std::bind() does.
+/// Lambdas with captures can not be stored, use std::function for them.
+template <typename R, typename... Args>
+class Delegate<R(Args...)>
+{
+public:
+    using Stub = R(*)(void*, Args...);
+private:
+    void* object_{ nullptr };
+    Stub stub_{ nullptr };
+    template <auto Method, typename T>
+    static R MethodStub(void* object, Args... args)
+    {
+        return (static_cast<T*>(object)->*Method)(std::forward<Args>(args)...);
+    }
+    template <auto Function>
+    static R FunctionStub(void*, Args... args)
+    {
+        return Function(std::forward<Args>(args)...);
+    }
+public:
+    constexpr Delegate() noexcept = default;
+    constexpr Delegate(void* object, Stub stub) noexcept :
+        object_(object),
+        stub_(stub)
+    { }
+    /// Make<&Foo::Bar>(foo)
+    template <auto Method, typename T>
+    static Delegate Make(T* object) noexcept
+    {
+        using ObjectType = std::remove_const_t<T>;
+        return { const_cast<ObjectType*>(object), &MethodStub<Method, T> };
+    }
+    /// Make<&FreeFunction>()
+    template <auto Function>
+    static Delegate Make() noexcept
+    {
+        return { nullptr, &FunctionStub<Function> };
+    }
+
+    R operator()(Args... args) const
+    {
+        return stub_(object_, std::forward<Args>(args)...);
+    }
+    explicit operator bool() const noexcept { return stub_ != nullptr; }
+    bool operator ==(const Delegate& rhs) const noexcept
+    {
+        return object_ == rhs.object_ && stub_ == rhs.stub_;
+    }
+    bool operator !=(const Delegate& rhs) const noexcept { return !(*this == rhs); }
+    void* GetObject() const noexcept { return object_; }
+    Stub GetStub() const noexcept { return stub_; }
+};
+
+}
@@ -0,0 +1,164 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <sa/Delegate.h>
+#include <sa/Events.h>
+#include <array>
+#include <vector>
+#include <tuple>
+#include <stdint.h>
+
+namespace sa {
+
+/// An entry of an EventTable
+template <event_t Id, typename Signature>
+struct Event
+{
+    static constexpr event_t ID = Id;
+    using SignatureType = Signature;
+};
+
+/// Events which are known at compile time, e.g.
+/// EventTable<Event<EVENT_FOO, void(int)>, Event<EVENT_BAR, void(void)>>.
+/// The slot of an event and its signature are resolved at compile time, so a call does not look up
+/// anything. Subscribers are Delegates, all of them are stored in one std::vector ordered by event.
+template <typename... Events>
+class EventTable
+{
+private:
+    static constexpr size_t Count = sizeof...(Events);
+    static_assert(Count < 0xFFFF, "Too many events");
+    template <event_t Id>
+    static constexpr size_t IndexOf()
+    {
+        constexpr event_t ids[] = { Events::ID... };
+        for (size_t i = 0; i < Count; ++i)
+        {
+            if (ids[i] == Id)
+                return i;
+        }
+        return Count;
+    }
+    struct Subscriber
+    {
+        size_t index;
+        void* object;
+        /// Type erased Delegate::Stub, it's cast back to the Stub of the event when called
+        void(*stub)();
+    };
+    std::vector<Subscriber> subscribers_;
+    /// Subscribers of event i are subscribers_[offsets_[i]..offsets_[i + 1])
+    std::array<uint16_t, Count + 1> offsets_{};
+    size_t indices_{ 0 };
+public:
+    template <event_t Id>
+    static constexpr bool Contains = IndexOf<Id>() < Count;
+    template <event_t Id>
+    using SignatureOf = std::tuple_element_t<IndexOf<Id>(), std::tuple<typename Events::SignatureType...>>;
+    template <event_t Id>
+    using DelegateOf = Delegate<SignatureOf<Id>>;
+
+    /// Subscribers are called in the order they subscribed. Returns an index for Unsubscribe().
+    template <event_t Id>
+    size_t Subscribe(DelegateOf<Id> delegate)
+    {
+        static_assert(Contains<Id>, "Event not in table");
+        constexpr size_t slot = IndexOf<Id>();
+        if (subscribers_.capacity() == 0)
+            subscribers_.reserve(16);
+        const size_t index = ++indices_;
+        subscribers_.insert(subscribers_.begin() + offsets_[slot + 1],
+            { index, delegate.GetObject(), reinterpret_cast<void(*)()>(delegate.GetStub()) });
+        for (size_t i = slot + 1; i <= Count; ++i)
+            ++offsets_[i];
+        return index;
+    }
+    template <event_t Id>
+    void Unsubscribe(size_t index)
+    {
+        static_assert(Contains<Id>, "Event not in table");
+        constexpr size_t slot = IndexOf<Id>();
+        for (size_t i = offsets_[slot]; i < offsets_[slot + 1]; ++i)
+        {
+            if (subscribers_[i].index != index)
+                continue;
+            subscribers_.erase(subscribers_.begin() + i);
+            for (size_t j = slot + 1; j <= Count; ++j)
+                --offsets_[j];
+            return;
+        }
+    }
+    template <event_t Id>
+    size_t GetSubscriberCount() const
+    {
+        constexpr size_t slot = IndexOf<Id>();
+        return offsets_[slot + 1] - offsets_[slot];
+    }
+
+    /// Calls the first subscriber and returns the result
+    template <event_t Id, typename... ArgTypes>
+    auto CallOne(ArgTypes&& ... Arguments)
+    {
+        static_assert(Contains<Id>, "Event not in table");
+        constexpr size_t slot = IndexOf<Id>();
+        using ResultType = typename std::invoke_result<SignatureOf<Id>, ArgTypes...>::type;
+        using Stub = typename DelegateOf<Id>::Stub;
+        if (offsets_[slot] == offsets_[slot + 1])
+            return ResultType();
+        const Subscriber& sub = subscribers_[offsets_[slot]];
+        return reinterpret_cast<Stub>(sub.stub)(sub.object, std::forward<ArgTypes>(Arguments)...);
+    }
+
+    /// Calls all subscribers and returns a std::vector of results or void.
+    /// Arguments are not forwarded, because they are passed to all subscribers.
+    template <event_t Id, typename... ArgTypes>
+    auto CallAll(ArgTypes&& ... Arguments)
+    {
+        static_assert(Contains<Id>, "Event not in table");
+        constexpr size_t slot = IndexOf<Id>();
+        using ResultType = typename std::invoke_result<SignatureOf<Id>, ArgTypes...>::type;
+        using Stub = typename DelegateOf<Id>::Stub;
+        // A subscriber may (un)subscribe, so don't keep iterators
+        if constexpr (std::is_same_v<ResultType, void>)
+        {
+            for (size_t i = offsets_[slot]; i < offsets_[slot + 1]; ++i)
+            {
+                const Subscriber sub = subscribers_[i];
+                reinterpret_cast<Stub>(sub.stub)(sub.object, Arguments...);
+            }
+        }
+        else
+        {
+            std::vector<ResultType> result;
+            result.reserve(offsets_[slot + 1] - offsets_[slot]);
+            for (size_t i = offsets_[slot]; i < offsets_[slot + 1]; ++i)
+            {
+                const Subscriber sub = subscribers_[i];
+                result.push_back(reinterpret_cast<Stub>(sub.stub)(sub.object, Arguments...));
+            }
+            return result;
+        }
+    }
+};
+
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace sa {
+
+/// Keeps the most recently used capacity items and drops the least recently used.
+/// This class is not thread safe.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache
+{
+private:
+    using Item = std::pair<Key, Value>;
+    using ItemList = std::list<Item>;
+    size_t capacity_;
+    // Most recently used first
+    ItemList items_;
+    std::unordered_map<Key, typename ItemList::iterator, Hash> index_;
+public:
+    explicit LruCache(size_t capacity) :
+        capacity_(capacity)
+    { }
+    /// Returns nullptr if the key is not in the cache. The pointer is valid until the next Put().
+    Value* Get(const Key& key)
+    {
+        const auto it = index_.find(key);
+        if (it == index_.end())
+            return nullptr;
+        items_.splice(items_.begin(), items_, it->second);
+        return &it->second->second;
+    }
+    void Put(const Key& key, Value value)
+    {
+        if (capacity_ == 0)
+            return;
+        const auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            it->second->second = std::move(value);
+            items_.splice(items_.begin(), items_, it->second);
+            return;
+        }
+        if (items_.size() >= capacity_)
+        {
+            index_.erase(items_.back().first);
+            items_.pop_back();
+        }
+        items_.emplace_front(key, std::move(value));
+        index_.emplace(key, items_.begin());
+    }
+    bool Erase(const Key& key)
+    {
+        const auto it = index_.find(key);
+        if (it == index_.end())
+            return false;
+        items_.erase(it->second);
+        index_.erase(it);
+        return true;
+    }
+    void Clear()
+    {
+        index_.clear();
+        items_.clear();
+    }
+    size_t Size() const { return items_.size(); }
+    size_t GetCapacity() const { return capacity_; }
+};
+
+}
@@ -0,0 +1,199 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+#include <sa/Iteration.h>
+
+namespace sa {
+
+/// Dense storage of values ordered by key. The values are stored in a contiguous
+/// array, so iterating does not touch the heap and lookups are a binary search.
+/// Additions and removals made while VisitAll() runs are deferred until it
+/// returns. Removed values are kept alive until then.
+/// An empty Value, i.e. Value() evaluates to false, marks a removed entry.
+template <typename Key, typename Value>
+class Registry
+{
+public:
+    using Entry = std::pair<Key, Value>;
+private:
+    std::vector<Entry> items_;
+    std::vector<Entry> added_;
+    std::vector<Value> removed_;
+    unsigned locks_{ 0 };
+    static bool KeyLess(const Entry& lhs, const Key& rhs) { return lhs.first < rhs; }
+    static bool EntryLess(const Entry& lhs, const Entry& rhs) { return lhs.first < rhs.first; }
+    size_t IndexOf(const Key& key) const
+    {
+        const auto it = std::lower_bound(items_.begin(), items_.end(), key, KeyLess);
+        if (it == items_.end() || (*it).first != key)
+            return items_.size();
+        return static_cast<size_t>(it - items_.begin());
+    }
+    void Insert(Entry&& entry)
+    {
+        // Keys are usually increasing, so this is mostly an append
+        if (items_.empty() || items_.back().first < entry.first)
+        {
+            items_.push_back(std::move(entry));
+            return;
+        }
+        const auto it = std::lower_bound(items_.begin(), items_.end(), entry.first, KeyLess);
+        items_.insert(it, std::move(entry));
+    }
+    void Apply()
+    {
+        if (!removed_.empty())
+        {
+            items_.erase(std::remove_if(items_.begin(), items_.end(), [](const Entry& current)
+            {
+                return !current.second;
+            }), items_.end());
+            // Now it's safe to delete them
+            removed_.clear();
+        }
+        if (!added_.empty())
+        {
+            const size_t middle = items_.size();
+            for (auto& entry : added_)
+                items_.push_back(std::move(entry));
+            added_.clear();
+            const auto first = items_.begin() + static_cast<std::ptrdiff_t>(middle);
+            std::sort(first, items_.end(), EntryLess);
+            if (middle != 0 && (*first).first < (*(first - 1)).first)
+                std::inplace_merge(items_.begin(), first, items_.end(), EntryLess);
+        }
+    }
+public:
+    Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+    ~Registry() = default;
+
+    /// Reserve space for count values, so adding them does not allocate.
+    void Reserve(size_t count)
+    {
+        items_.reserve(count);
+        removed_.reserve(count);
+    }
+    bool Add(const Key& key, Value value)
+    {
+        assert(value);
+        if (Contains(key))
+            return false;
+        if (locks_ != 0)
+        {
+            added_.emplace_back(key, std::move(value));
+            return true;
+        }
+        Insert(Entry(key, std::move(value)));
+        return true;
+    }
+    bool Remove(const Key& key)
+    {
+        const auto ait = std::find_if(added_.begin(), added_.end(), [&key](const Entry& current)
+        {
+            return current.first == key;
+        });
+        if (ait != added_.end())
+        {
+            added_.erase(ait);
+            return true;
+        }
+
+        const size_t index = IndexOf(key);
+        if (index == items_.size() || !items_[index].second)
+            return false;
+        if (locks_ != 0)
+        {
+            // Someone is iterating, keep the value alive and leave a hole
+            removed_.push_back(std::move(items_[index].second));
+            items_[index].second = Value();
+            return true;
+        }
+        items_.erase(items_.begin() + static_cast<std::ptrdiff_t>(index));
+        return true;
+    }
+    void Clear()
+    {
+        assert(locks_ == 0);
+        items_.clear();
+        added_.clear();
+        removed_.clear();
+    }
+    /// Returns nullptr when not found
+    const Value* Get(const Key& key) const
+    {
+        const size_t index = IndexOf(key);
+        if (index != items_.size())
+        {
+            if (!items_[index].second)
+                return nullptr;
+            return &items_[index].second;
+        }
+        for (const auto& entry : added_)
+        {
+            if (entry.first == key)
+                return &entry.second;
+        }
+        return nullptr;
+    }
+    bool Contains(const Key& key) const { return Get(key) != nullptr; }
+    size_t Size() const { return items_.size() - removed_.size() + added_.size(); }
+    bool IsEmpty() const { return Size() == 0; }
+
+    /// Visit all values in the order of their keys. Values added by the callback
+    /// are not visited, removed values are not visited anymore.
+    template<typename Callback>
+    void VisitAll(Callback&& callback)
+    {
+        ++locks_;
+        for (size_t i = 0; i < items_.size(); ++i)
+        {
+            Value& value = items_[i].second;
+            if (!value)
+                continue;
+            if (callback(value) != Iteration::Continue)
+                break;
+        }
+        if (--locks_ == 0)
+            Apply();
+    }
+    template<typename Callback>
+    void VisitAll(Callback&& callback) const
+    {
+        for (size_t i = 0; i < items_.size(); ++i)
+        {
+            const Value& value = items_[i].second;
+            if (!value)
+                continue;
+            if (callback(value) != Iteration::Continue)
+                break;
+        }
+    }
+};
+
+}
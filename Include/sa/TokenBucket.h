@@ -0,0 +1,84 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+#include <stdint.h>
+
+namespace sa {
+
+/// Limits a rate, e.g. Bytes/sec. It does not wait, instead Consume() returns how long the caller should
+/// wait before it consumes more. This class is not thread safe.
+template<typename Clock = std::chrono::steady_clock>
+class TokenBucket
+{
+public:
+    using time_point = typename Clock::time_point;
+    /// rate: Tokens/sec, 0 = unlimited
+    /// burst: Max. tokens that can be consumed at once without waiting, 0 = rate
+    explicit TokenBucket(uint64_t rate = 0, uint64_t burst = 0, time_point now = Clock::now()) :
+        last_(now)
+    {
+        SetRate(rate, burst);
+    }
+    void SetRate(uint64_t rate, uint64_t burst = 0)
+    {
+        rate_ = rate;
+        burst_ = static_cast<double>(burst != 0 ? burst : rate);
+        tokens_ = burst_;
+    }
+    uint64_t GetRate() const { return rate_; }
+    bool IsUnlimited() const { return rate_ == 0; }
+    /// Takes tokens from the bucket. The bucket may become empty, then it returns the time until
+    /// it has enough tokens again.
+    std::chrono::milliseconds Consume(uint64_t tokens, time_point now = Clock::now())
+    {
+        if (rate_ == 0)
+            return std::chrono::milliseconds(0);
+        Refill(now);
+        tokens_ -= static_cast<double>(tokens);
+        if (tokens_ >= 0.0)
+            return std::chrono::milliseconds(0);
+        return std::chrono::milliseconds(static_cast<int64_t>((-tokens_ * 1000.0) / static_cast<double>(rate_)) + 1);
+    }
+    double GetTokens(time_point now = Clock::now())
+    {
+        Refill(now);
+        return tokens_;
+    }
+private:
+    void Refill(time_point now)
+    {
+        if (now <= last_)
+            return;
+        const double elapsed = std::chrono::duration<double>(now - last_).count();
+        last_ = now;
+        tokens_ = std::min(burst_, tokens_ + elapsed * static_cast<double>(rate_));
+    }
+    uint64_t rate_{ 0 };
+    double burst_{ 0.0 };
+    double tokens_{ 0.0 };
+    time_point last_;
+};
+
+}
@@ -0,0 +1,180 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include "AI.Mockup.h"
+#include <abai/LuaLoader.h>
+#include <abai/Registry.h>
+#include <abai/Root.h>
+#include <abai/Zone.h>
+#include <abai/Agent.h>
+#include <abai/BevaviorCache.h>
+#include <abscommon/FileUtils.h>
+#include <abscommon/StringUtils.h>
+#include <set>
+
+namespace {
+
+// Registers stand-ins for the nodes of the game server, so we can load the
+// real behavior trees.
+class BehaviorRegistry final : public AI::TestRegistry
+{
+public:
+    void Initialize() override
+    {
+        TestRegistry::Initialize();
+        for (const char* name : { "AttackSelection", "Die", "Flee", "Follow", "GainEnergy", "GoHome",
+            "HealOther", "HealSelf", "Idle", "Interrupt", "MoveIntoSkillRange", "MoveOutAOE",
+            "MoveTo", "ResurrectSelection", "Say", "UseDamageSkill", "Wander" })
+            RegisterNodeFactory(name, AI::Running2Action::GetFactory());
+        for (const char* name : { "AllyHealthCritical", "HaveHome", "HaveResurrection", "HaveSkill",
+            "HaveWanderRoute", "HaveWeapon", "IsAllyHealthLow", "IsAttacked", "IsCloseToSelection",
+            "IsEnergyLow", "IsFighting", "IsInAOE", "IsInSkillRange", "IsInWeaponRange", "IsMeleeTarget",
+            "IsSelectionAlive", "IsSelfHealthLow", "Random", "SelfHealthCritical" })
+            RegisterConditionFactory(name, AI::TestCondition::GetFactory());
+        for (const char* name : { "SelectAggro", "SelectAttackers", "SelectAttackTarget",
+            "SelectDeadAllies", "SelectGettingDamage", "SelectLowHealth", "SelectMob",
+            "SelectRandom", "SelectTargetAttacking", "SelectTargetUsingSkill", "SelectVisible",
+            "SelectWithEffect", "SortByDistance" })
+            RegisterFilterFactory(name, AI::SelectSelf::GetFactory());
+    }
+};
+
+// Loads the scripts from the data directory next to the executable
+class DataLoader final : public AI::LuaLoader
+{
+protected:
+    std::string GetScriptFile(const std::string file) override
+    {
+        return dataDir_ + file;
+    }
+public:
+    explicit DataLoader(AI::Registry& reg) :
+        LuaLoader(reg),
+        dataDir_(Utils::ExtractFileDir(Utils::GetExeName()) + "/data")
+    { }
+    std::string dataDir_;
+};
+
+}
+
+TEST_CASE("Node indices")
+{
+    AI::TestRegistry reg;
+    reg.Initialize();
+    AI::LuaLoader loader(reg);
+    const std::string script = R"lua(
+function init(root)
+    local prio = node("Priority")
+    local nd = node("Sequence")
+    nd:AddNode(node("TestAction"))
+    nd:AddNode(node("Running2Action"))
+    prio:AddNode(nd)
+    prio:AddNode(node("RunningAction"))
+    root:AddNode(prio)
+end
+)lua";
+    auto root = loader.LoadString(script);
+    REQUIRE(root);
+    REQUIRE(root->GetNodeCount() == 6);
+    REQUIRE(root->GetIndex() == 0);
+
+    std::set<AI::Index> indices;
+    AI::ForEachChildNode(*root, [&](const AI::Node&, const AI::Node& child)
+    {
+        indices.emplace(child.GetIndex());
+        return Iteration::Continue;
+    });
+    REQUIRE(indices.size() == 5);
+    REQUIRE(*indices.begin() == 1);
+    REQUIRE(*indices.rbegin() == 5);
+}
+
+TEST_CASE("Agent context")
+{
+    AI::TestRegistry reg;
+    reg.Initialize();
+    AI::LuaLoader loader(reg);
+    const std::string script = R"lua(
+function init(root)
+    local nd = node("Sequence")
+    nd:AddNode(node("TestAction"))
+    nd:AddNode(node("Running2Action"))
+    root:AddNode(nd)
+end
+)lua";
+    auto root = loader.LoadString(script);
+    REQUIRE(root);
+
+    AI::Agent agent(1);
+    agent.SetBehavior(root);
+    REQUIRE(agent.context_.GetSize() == root->GetNodeCount());
+
+    agent.Update(0);
+    REQUIRE(agent.GetCurrentStatus() == AI::Node::Status::Running);
+    // The Sequence remembers where it stopped
+    REQUIRE(agent.context_.Has<AI::Nodes::iterator>(1));
+    agent.Update(0);
+    REQUIRE(agent.GetCurrentStatus() == AI::Node::Status::Finished);
+    REQUIRE(!agent.context_.Has<AI::Nodes::iterator>(1));
+
+    // Setting a behavior drops the state of the old one
+    REQUIRE(agent.context_.Has<AI::node_status_type>(0));
+    agent.SetBehavior(root);
+    REQUIRE(!agent.context_.Has<AI::node_status_type>(0));
+}
+
+TEST_CASE("Behavior tree benchmark")
+{
+    BehaviorRegistry reg;
+    reg.Initialize();
+    DataLoader loader(reg);
+    AI::BevaviorCache cache;
+    if (!Utils::FileExists(loader.dataDir_ + "/scripts/behaviors/behaviors.lua"))
+    {
+        WARN("Behaviors not found in " + loader.dataDir_);
+        return;
+    }
+    REQUIRE(loader.InitChache("/scripts/behaviors/behaviors.lua", cache));
+
+    std::vector<std::shared_ptr<AI::Root>> trees;
+    cache.VisitBehaviors([&](const std::string& name, const AI::Root&)
+    {
+        trees.push_back(cache.Get(name));
+        return Iteration::Continue;
+    });
+    REQUIRE(!trees.empty());
+
+    AI::Zone zone("test");
+    for (AI::Id id = 1; id <= 1000; ++id)
+    {
+        auto agent = std::make_shared<AI::Agent>(id);
+        agent->SetBehavior(trees[id % trees.size()]);
+        zone.AddAgent(agent);
+    }
+
+    BENCHMARK("Update 1000 agents")
+    {
+        zone.Update(16);
+    }
+}
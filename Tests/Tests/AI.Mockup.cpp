@@ -38,6 +38,7 @@ void TestRegistry::Initialize()
     RegisterNodeFactory("Running2Action", Running2Action::GetFactory());
     RegisterFilterFactory("SelectSelf", SelectSelf::GetFactory());
     RegisterFilterFactory("SelectNothing", SelectNothing::GetFactory());
+    RegisterConditionFactory("TestCondition", TestCondition::GetFactory());
 }
 
 void SelectSelf::Execute(Agent& agent)
@@ -52,6 +53,11 @@ void SelectNothing::Execute(Agent& agent)
     agent.filteredAgents_.clear();
 }
 
+bool TestCondition::Evaluate(Agent& agent, const Node& node)
+{
+    return ((agent.GetId() + node.GetIndex()) % 2) == 0;
+}
+
 Node::Status RunningAction::DoAction(Agent&, uint32_t)
 {
     return Status::Running;
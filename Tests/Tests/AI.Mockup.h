@@ -24,6 +24,7 @@
 #include <abai/Action.h>
 #include <abai/Registry.h>
 #include <abai/Filter.h>
+#include <abai/Condition.h>
 
 namespace AI {
 
@@ -80,6 +81,17 @@ public:
     void Execute(Agent& agent) override;
 };
 
+// True for every other agent, depending on the node
+class TestCondition : public Condition
+{
+    CONDITON_CLASS(TestCondition)
+public:
+    explicit TestCondition(const ArgumentsType& arguments) :
+        Condition(arguments)
+    { }
+    bool Evaluate(Agent& agent, const Node& node) override;
+};
+
 class TestRegistry : public Registry
 {
 public:
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include "AiScheduler.h"
+#include <thread>
+#include <vector>
+
+TEST_CASE("Scheduler stagger")
+{
+    AI::Scheduler scheduler;
+    std::vector<AI::Scheduler::Schedule> schedules(AI::Scheduler::DORMANT_INTERVAL);
+    scheduler.BeginTick();
+    // Everyone is due in the first tick
+    for (uint32_t id = 0; id < schedules.size(); ++id)
+        REQUIRE(scheduler.Run(schedules[id], id, []() { }));
+
+    // After that the agents with the same interval are spread over the ticks
+    std::vector<unsigned> runs(schedules.size(), 0);
+    for (uint32_t tick = 0; tick < AI::Scheduler::DORMANT_INTERVAL * 2; ++tick)
+    {
+        scheduler.BeginTick();
+        unsigned count = 0;
+        for (uint32_t id = 0; id < schedules.size(); ++id)
+        {
+            if (scheduler.Run(schedules[id], id, [&]() { ++runs[id]; }))
+                ++count;
+        }
+        REQUIRE(count == 1);
+    }
+    for (unsigned r : runs)
+        REQUIRE(r == 2);
+}
+
+TEST_CASE("Scheduler rate")
+{
+    AI::Scheduler scheduler;
+    AI::Scheduler::Schedule schedule;
+    constexpr uint32_t TICKS = 100;
+    unsigned count = 0;
+
+    SECTION("Dormant")
+    {
+        for (uint32_t tick = 0; tick < TICKS; ++tick)
+        {
+            scheduler.BeginTick();
+            scheduler.Run(schedule, 0, [&]() { ++count; });
+        }
+        REQUIRE(scheduler.GetLevel(schedule) == AI::Scheduler::Level::Dormant);
+        REQUIRE(count == 1 + TICKS / AI::Scheduler::DORMANT_INTERVAL);
+    }
+    SECTION("Near")
+    {
+        for (uint32_t tick = 0; tick < TICKS; ++tick)
+        {
+            scheduler.BeginTick();
+            scheduler.SetPlayerLevel(schedule, AI::Scheduler::Level::Near);
+            scheduler.Run(schedule, 0, [&]() { ++count; });
+        }
+        REQUIRE(scheduler.GetLevel(schedule) == AI::Scheduler::Level::Near);
+        REQUIRE(count == 1 + TICKS / AI::Scheduler::NEAR_INTERVAL);
+    }
+    SECTION("Active")
+    {
+        for (uint32_t tick = 0; tick < TICKS; ++tick)
+        {
+            scheduler.BeginTick();
+            scheduler.SetPlayerLevel(schedule, AI::Scheduler::Level::Active);
+            scheduler.Run(schedule, 0, [&]() { ++count; });
+        }
+        REQUIRE(count == TICKS);
+    }
+    SECTION("Closest player")
+    {
+        scheduler.BeginTick();
+        scheduler.SetPlayerLevel(schedule, AI::Scheduler::Level::Active);
+        scheduler.SetPlayerLevel(schedule, AI::Scheduler::Level::Near);
+        REQUIRE(scheduler.GetLevel(schedule) == AI::Scheduler::Level::Active);
+        // The player is gone in the next tick
+        scheduler.BeginTick();
+        REQUIRE(scheduler.GetLevel(schedule) == AI::Scheduler::Level::Dormant);
+    }
+    SECTION("Player enters aggro range")
+    {
+        scheduler.BeginTick();
+        REQUIRE(scheduler.Run(schedule, 0, []() { }));
+        scheduler.BeginTick();
+        REQUIRE_FALSE(scheduler.Run(schedule, 0, []() { }));
+        // Doesn't wait for the next evaluation
+        scheduler.SetPlayerLevel(schedule, AI::Scheduler::Level::Active);
+        REQUIRE(scheduler.Run(schedule, 0, []() { }));
+    }
+}
+
+TEST_CASE("Scheduler budget")
+{
+    AI::Scheduler scheduler;
+    AI::Scheduler::Schedule schedule1;
+    AI::Scheduler::Schedule schedule2;
+
+    SECTION("No budget")
+    {
+        scheduler.SetBudget(0);
+        scheduler.BeginTick();
+        REQUIRE_FALSE(scheduler.Run(schedule1, 1, []() { }));
+        REQUIRE_FALSE(scheduler.Run(schedule2, 2, []() { }));
+        scheduler.BeginTick();
+        REQUIRE(scheduler.GetStats().evaluated == 0);
+        REQUIRE(scheduler.GetStats().deferred == 2);
+        // Deferred agents run in the next tick regardless of the budget
+        REQUIRE(scheduler.Run(schedule1, 1, []() { }));
+        REQUIRE(scheduler.Run(schedule2, 2, []() { }));
+        scheduler.BeginTick();
+        REQUIRE(scheduler.GetStats().evaluated == 2);
+        REQUIRE(scheduler.GetStats().deferred == 0);
+    }
+    SECTION("Budget used up")
+    {
+        scheduler.SetBudget(1000);
+        scheduler.BeginTick();
+        REQUIRE(scheduler.Run(schedule1, 1, []() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }));
+        REQUIRE_FALSE(scheduler.Run(schedule2, 2, []() { }));
+        scheduler.BeginTick();
+        REQUIRE(scheduler.GetStats().lastTime >= 2000);
+        REQUIRE(scheduler.GetStats().maxTime >= 2000);
+        REQUIRE(scheduler.GetStats().evaluated == 1);
+        REQUIRE(scheduler.GetStats().deferred == 1);
+        REQUIRE(scheduler.Run(schedule2, 2, []() { }));
+    }
+}
+
+TEST_CASE("Scheduler wake")
+{
+    AI::Scheduler scheduler;
+    AI::Scheduler::Schedule schedule;
+    scheduler.BeginTick();
+    REQUIRE(scheduler.Run(schedule, 0, []() { }));
+    scheduler.BeginTick();
+    REQUIRE_FALSE(scheduler.Run(schedule, 0, []() { }));
+
+    // E.g. the NPC was attacked
+    scheduler.Wake(schedule);
+    REQUIRE(scheduler.GetLevel(schedule) == AI::Scheduler::Level::Active);
+    REQUIRE(scheduler.Run(schedule, 0, []() { }));
+    // Stays active for a while
+    for (uint32_t tick = 1; tick < AI::Scheduler::ACTIVE_TICKS; ++tick)
+    {
+        scheduler.BeginTick();
+        REQUIRE(scheduler.Run(schedule, 0, []() { }));
+    }
+    scheduler.BeginTick();
+    REQUIRE(scheduler.GetLevel(schedule) == AI::Scheduler::Level::Dormant);
+}
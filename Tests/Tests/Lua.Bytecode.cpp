@@ -0,0 +1,318 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+#include "ConfigManager.h"
+#include "IOScript.h"
+#include "Script.h"
+#include <abscommon/Subsystems.h>
+#include <abscommon/UuidUtils.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Trimmed down scripts/actors/npcs/priest.lua
+constexpr const char* NPC_SCRIPT = R"lua(
+name = "Priest"
+level = 20
+itemIndex = 2
+behavior = "priest"
+
+function onInit()
+  local skills = { 281, 280, 288, 305 }
+  local count = 0
+  for _, index in ipairs(skills) do
+    count = count + index
+  end
+  return count > 0
+end
+
+function onUpdate(timeElapsed)
+end
+
+function onClicked(creature)
+end
+
+function onSelected(creature)
+end
+
+function onCollide(creature)
+end
+
+function onAttacked(source, _type, damage, success)
+end
+
+function onDied()
+  if (deaths ~= nil and deaths < 2) then
+    dropped = true
+  end
+end
+)lua";
+
+// Trimmed down scripts/skills/fire_magic/immolate.lua
+constexpr const char* SKILL_SCRIPT = R"lua(
+costEnergy = 5
+costAdrenaline = 0
+activation = 1000
+recharge = 8000
+overcast = 10
+hp = 0
+
+function onStartUse(source, target)
+  if (target == nil) then
+    return 1
+  end
+  if (source == target) then
+    return 1
+  end
+  return 0
+end
+
+function onSuccess(source, target)
+  if (target == nil) then
+    return 1
+  end
+  local fireAttrib = source
+  local damage = math.floor((fireAttrib * 6) + 10)
+  if (damage > 100) then
+    local energy = 5 + math.floor(1 + (fireAttrib / 2))
+    return energy
+  end
+  return 0
+end
+)lua";
+
+constexpr int SKILLBAR_SIZE = 8;
+
+/// Scripts and the script cache in a temporary directory
+class ScriptDir
+{
+private:
+    fs::path path_;
+public:
+    ScriptDir() :
+        path_(fs::temp_directory_path() / ("abtests_" + Utils::Uuid::New()))
+    {
+        fs::create_directories(path_);
+        Subsystems::Instance.CreateSubsystem<ConfigManager>();
+        (*GetSubsystem<ConfigManager>())[ConfigManager::ScriptCacheDir] = (path_ / "cache").string();
+    }
+    ~ScriptDir()
+    {
+        (*GetSubsystem<ConfigManager>())[ConfigManager::ScriptCacheDir] = "";
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+    std::string Write(const std::string& name, const char* source)
+    {
+        const fs::path file = path_ / name;
+        std::ofstream output(file, std::ios::binary | std::ios::trunc);
+        output << source;
+        return file.string();
+    }
+    /// There is one cache file for each script
+    std::vector<fs::path> GetCacheFiles() const
+    {
+        std::vector<fs::path> result;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(path_ / "cache", ec))
+            result.push_back(entry.path());
+        return result;
+    }
+};
+
+std::shared_ptr<Game::Script> Import(const std::string& file)
+{
+    auto script = std::make_shared<Game::Script>();
+    IO::IOScript io;
+    if (!io.Import(*script, file))
+        return std::shared_ptr<Game::Script>();
+    return script;
+}
+
+bool CallInit(kaguya::State& state, Game::Script& script)
+{
+    if (!script.Execute(state))
+        return false;
+    return state["onInit"]();
+}
+
+int CallSuccess(kaguya::State& state, Game::Script& script, int source, int target)
+{
+    if (!script.Execute(state))
+        return -1;
+    return state["onSuccess"](source, target);
+}
+
+/// Touch the cache file, so we can see whether it was written again
+fs::file_time_type Touch(const fs::path& file)
+{
+    const auto time = fs::last_write_time(file) - std::chrono::hours(1);
+    fs::last_write_time(file, time);
+    return time;
+}
+
+/// Change the Lua version in the byte code header
+void ChangeLuaVersion(const fs::path& file)
+{
+    std::string content;
+    {
+        std::ifstream input(file, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+    const size_t pos = content.find(LUA_SIGNATURE);
+    REQUIRE(pos != std::string::npos);
+    content[pos + sizeof(LUA_SIGNATURE) - 1] = 0x52;
+    std::ofstream output(file, std::ios::binary | std::ios::trunc);
+    output << content;
+}
+
+bool ExecuteSource(lua_State* L, const char* source)
+{
+    int status = luaL_loadbufferx(L, source, strlen(source), "script", "t");
+    if (status == LUA_OK)
+        status = lua_pcall(L, 0, LUA_MULTRET, 0);
+    lua_settop(L, 0);
+    return status == LUA_OK;
+}
+
+}
+
+TEST_CASE("IOScript byte code")
+{
+    ScriptDir dir;
+    const std::string npcFile = dir.Write("priest.lua", NPC_SCRIPT);
+    const std::string skillFile = dir.Write("immolate.lua", SKILL_SCRIPT);
+    auto npc = Import(npcFile);
+    auto skill = Import(skillFile);
+    REQUIRE(npc);
+    REQUIRE(skill);
+    REQUIRE(dir.GetCacheFiles().size() == 2);
+
+    kaguya::State state;
+    state.openlibs();
+    REQUIRE(CallInit(state, *npc));
+    REQUIRE(CallSuccess(state, *skill, 20, 1) == 16);
+
+    SECTION("Script::Execute() does not accept source")
+    {
+        Game::Script script;
+        script.GetBuffer().assign(NPC_SCRIPT, NPC_SCRIPT + strlen(NPC_SCRIPT));
+        REQUIRE(!script.Execute(state));
+    }
+    SECTION("Compile error")
+    {
+        const std::string file = dir.Write("error.lua", "function onInit(");
+        REQUIRE(!Import(file));
+    }
+
+    int failed = 0;
+    BENCHMARK("Npc::LoadScript source")
+    {
+        if (!ExecuteSource(state.state(), NPC_SCRIPT))
+            ++failed;
+    }
+    BENCHMARK("Npc::LoadScript byte code")
+    {
+        if (!npc->Execute(state))
+            ++failed;
+    }
+    BENCHMARK("SkillBar source")
+    {
+        for (int i = 0; i < SKILLBAR_SIZE; ++i)
+        {
+            if (!ExecuteSource(state.state(), SKILL_SCRIPT))
+                ++failed;
+        }
+    }
+    BENCHMARK("SkillBar byte code")
+    {
+        for (int i = 0; i < SKILLBAR_SIZE; ++i)
+        {
+            if (!skill->Execute(state))
+                ++failed;
+        }
+    }
+    REQUIRE(failed == 0);
+}
+
+TEST_CASE("IOScript cache")
+{
+    ScriptDir dir;
+    const std::string file = dir.Write("immolate.lua", SKILL_SCRIPT);
+    auto compiled = Import(file);
+    REQUIRE(compiled);
+    const auto cacheFiles = dir.GetCacheFiles();
+    REQUIRE(cacheFiles.size() == 1);
+    const fs::path& cacheFile = cacheFiles.front();
+    const auto time = Touch(cacheFile);
+    kaguya::State state;
+    state.openlibs();
+
+    SECTION("Up to date")
+    {
+        auto cached = Import(file);
+        REQUIRE(cached);
+        REQUIRE(fs::last_write_time(cacheFile) == time);
+        REQUIRE(cached->GetBuffer() == compiled->GetBuffer());
+        REQUIRE(CallSuccess(state, *cached, 20, 1) == 16);
+    }
+    SECTION("Source changed")
+    {
+        // Same size, only the content is different
+        std::string source = SKILL_SCRIPT;
+        const size_t pos = source.find("fireAttrib * 6");
+        REQUIRE(pos != std::string::npos);
+        source[pos + 13] = '7';
+        dir.Write("immolate.lua", source.c_str());
+        auto changed = Import(file);
+        REQUIRE(changed);
+        REQUIRE(fs::last_write_time(cacheFile) != time);
+        REQUIRE(CallSuccess(state, *compiled, 15, 1) == 0);
+        REQUIRE(CallSuccess(state, *changed, 15, 1) == 13);
+    }
+    SECTION("Other Lua version")
+    {
+        ChangeLuaVersion(cacheFile);
+        const auto changedTime = Touch(cacheFile);
+        auto recompiled = Import(file);
+        REQUIRE(recompiled);
+        REQUIRE(fs::last_write_time(cacheFile) != changedTime);
+        REQUIRE(recompiled->GetBuffer() == compiled->GetBuffer());
+        REQUIRE(CallSuccess(state, *recompiled, 20, 1) == 16);
+    }
+    SECTION("Truncated")
+    {
+        const auto size = fs::file_size(cacheFile);
+        fs::resize_file(cacheFile, size - 16);
+        auto recompiled = Import(file);
+        REQUIRE(recompiled);
+        REQUIRE(recompiled->GetBuffer() == compiled->GetBuffer());
+        REQUIRE(fs::file_size(cacheFile) == size);
+        REQUIRE(CallSuccess(state, *recompiled, 20, 1) == 16);
+    }
+}
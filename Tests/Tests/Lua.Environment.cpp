@@ -0,0 +1,214 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+#include "Lua.Mockup.h"
+#include "ScriptManager.h"
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Trimmed down scripts/actors/npcs/priest.lua
+constexpr const char* NPC_SCRIPT = R"lua(
+name = "Priest"
+level = 20
+itemIndex = 2
+behavior = "priest"
+
+function onInit()
+  return Tick() > 0
+end
+
+function onUpdate(timeElapsed)
+end
+
+function onDied()
+  level = level + 1
+end
+)lua";
+
+// Trimmed down scripts/skills/fire_magic/immolate.lua
+constexpr const char* SKILL_SCRIPT = R"lua(
+costEnergy = 5
+activation = 1000
+recharge = 8000
+
+function onStartUse(source, target)
+  if (target == nil) then
+    return 1
+  end
+  return 0
+end
+
+function onSuccess(source, target)
+  local damage = math.floor((source * 6) + 10)
+  return damage
+end
+)lua";
+
+// Included by an NPC script, defines data of the NPC
+constexpr const char* INCLUDE_SCRIPT = R"lua(
+includeCount = (includeCount or 0) + 1
+skills = { 281, 280, 288, 305 }
+)lua";
+
+constexpr const char* INCLUDING_SCRIPT = R"lua(
+include("/scripts/test/environment/skills.lua")
+include("/scripts/test/environment/skills.lua")
+name = "Monk"
+)lua";
+
+constexpr int NPC_COUNT = 100;
+constexpr int SKILLBAR_SIZE = 8;
+
+size_t MemoryUsage(kaguya::State& state)
+{
+    state.garbageCollect();
+    lua_State* L = state.state();
+    return static_cast<size_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 +
+        static_cast<size_t>(lua_gc(L, LUA_GCCOUNTB, 0));
+}
+
+/// One VM with all bindings for each script object
+bool ExecuteSeparate(Game::Script& script, size_t* memory = nullptr)
+{
+    kaguya::State state;
+    Game::Lua::RegisterLuaAll(state);
+    if (!script.Execute(state))
+        return false;
+    if (memory)
+        *memory += MemoryUsage(state);
+    return true;
+}
+
+}
+
+TEST_CASE("Lua environment")
+{
+    Game::Lua::InitSubsystems();
+    Game::Lua::WriteScript("/scripts/test/environment/priest.lua", NPC_SCRIPT);
+    Game::Lua::WriteScript("/scripts/test/environment/skills.lua", INCLUDE_SCRIPT);
+    Game::Lua::WriteScript("/scripts/test/environment/monk.lua", INCLUDING_SCRIPT);
+    auto npcScript = Game::Lua::LoadScript("/scripts/test/environment/priest.lua");
+    REQUIRE(npcScript);
+
+    Game::Lua::SharedState state = Game::Lua::CreateState();
+    Game::Lua::Environment env1;
+    Game::Lua::Environment env2;
+    env1.Create(state);
+    env2.Create(state);
+    REQUIRE(env1.Execute(*npcScript));
+    REQUIRE(env2.Execute(*npcScript));
+
+    // Globals of the VM, e.g. Tick() from RegisterLuaAll(), are visible
+    const bool init = env1["onInit"]();
+    REQUIRE(init);
+    // Variables of the script are not shared
+    env1["onDied"]();
+    REQUIRE(env1["level"].get<int>() == 21);
+    REQUIRE(env2["level"].get<int>() == 20);
+    // And they don't leak into the globals
+    REQUIRE(Game::Lua::IsNil(*state, "level"));
+    REQUIRE(Game::Lua::IsNil(*state, "onInit"));
+
+    SECTION("include() runs in the environment")
+    {
+        auto monkScript = Game::Lua::LoadScript("/scripts/test/environment/monk.lua");
+        REQUIRE(monkScript);
+        Game::Lua::Environment env3;
+        env3.Create(state);
+        REQUIRE(env3.Execute(*monkScript));
+        REQUIRE(env3["name"].get<std::string>() == "Monk");
+        REQUIRE(Game::Lua::IsVariable(env3, "includeCount"));
+        // Included only once
+        REQUIRE(env3["includeCount"].get<int>() == 1);
+        REQUIRE(env3["skills"][2].get<int>() == 280);
+        REQUIRE(Game::Lua::IsNil(env1, "skills"));
+        REQUIRE(Game::Lua::IsNil(*state, "skills"));
+    }
+    SECTION("Reset")
+    {
+        env1.Reset();
+        REQUIRE(!env1.IsValid());
+        REQUIRE(state.use_count() == 2);
+        env2.Reset();
+        REQUIRE(state.use_count() == 1);
+    }
+}
+
+TEST_CASE("Lua environment memory")
+{
+    Game::Lua::InitSubsystems();
+    Game::Lua::WriteScript("/scripts/test/memory/priest.lua", NPC_SCRIPT);
+    Game::Lua::WriteScript("/scripts/test/memory/immolate.lua", SKILL_SCRIPT);
+    auto npcScript = Game::Lua::LoadScript("/scripts/test/memory/priest.lua");
+    auto skillScript = Game::Lua::LoadScript("/scripts/test/memory/immolate.lua");
+    REQUIRE(npcScript);
+    REQUIRE(skillScript);
+    const auto getScript = [&](int i) -> Game::Script&
+    {
+        return (i % (SKILLBAR_SIZE + 1) == 0) ? *npcScript : *skillScript;
+    };
+
+    // 100 NPCs with full skill bars, one VM for each script object like before
+    size_t separate = 0;
+    for (int i = 0; i < NPC_COUNT * (SKILLBAR_SIZE + 1); ++i)
+        REQUIRE(ExecuteSeparate(getScript(i), &separate));
+
+    // The same with one VM and an environment for each script object
+    Game::Lua::SharedState state = Game::Lua::CreateState();
+    std::vector<std::unique_ptr<Game::Lua::Environment>> envs;
+    for (int i = 0; i < NPC_COUNT * (SKILLBAR_SIZE + 1); ++i)
+    {
+        auto env = std::make_unique<Game::Lua::Environment>();
+        env->Create(state);
+        REQUIRE(env->Execute(getScript(i)));
+        envs.push_back(std::move(env));
+    }
+    const size_t shared = MemoryUsage(*state);
+    envs.clear();
+
+    INFO("Separate states: " << separate / 1024 << " KB, shared state: " << shared / 1024 << " KB");
+    REQUIRE(shared * 10 < separate);
+
+    int failed = 0;
+    BENCHMARK("Npc with skill bar separate states")
+    {
+        for (int i = 0; i < SKILLBAR_SIZE + 1; ++i)
+        {
+            if (!ExecuteSeparate(getScript(i)))
+                ++failed;
+        }
+    }
+    BENCHMARK("Npc with skill bar shared state")
+    {
+        for (int i = 0; i < SKILLBAR_SIZE + 1; ++i)
+        {
+            Game::Lua::Environment env;
+            env.Create(state);
+            if (!env.Execute(getScript(i)))
+                ++failed;
+        }
+    }
+    REQUIRE(failed == 0);
+}
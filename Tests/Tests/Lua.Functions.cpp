@@ -0,0 +1,157 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+#include "Lua.Mockup.h"
+#include "ScriptManager.h"
+
+namespace {
+
+// Like the callbacks of an AreaOfEffect
+enum Function : size_t
+{
+    FunctionUpdate,
+    FunctionOnEnded,
+    FunctionOnCollide,
+    FunctionOnInit,
+    FunctionCount
+};
+
+constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+    "onUpdate",
+    "onEnded",
+    "onCollide",
+    "onInit"
+};
+
+constexpr const char* SCRIPT = R"lua(
+ticks = 0
+collisions = 0
+ended = false
+
+function onInit()
+  return true
+end
+
+function onUpdate(timeElapsed)
+  ticks = ticks + timeElapsed
+end
+
+function onEnded()
+  ended = true
+end
+
+function onCollide(other)
+  collisions = collisions + other
+end
+)lua";
+
+// Doesn't have onEnded() and onCollide()
+constexpr const char* PARTIAL_SCRIPT = R"lua(
+ticks = 0
+
+function onInit()
+  return true
+end
+
+function onUpdate(timeElapsed)
+  ticks = ticks + timeElapsed
+end
+)lua";
+
+constexpr int DISPATCH_COUNT = 1000000;
+
+}
+
+TEST_CASE("Lua resolve functions")
+{
+    Game::Lua::InitSubsystems();
+    Game::Lua::WriteScript("/scripts/test/functions/full.lua", SCRIPT);
+    Game::Lua::WriteScript("/scripts/test/functions/partial.lua", PARTIAL_SCRIPT);
+    auto script = Game::Lua::LoadScript("/scripts/test/functions/full.lua");
+    auto partialScript = Game::Lua::LoadScript("/scripts/test/functions/partial.lua");
+    REQUIRE(script);
+    REQUIRE(partialScript);
+
+    Game::Lua::SharedState state = Game::Lua::CreateState();
+    Game::Lua::Environment full;
+    Game::Lua::Environment partial;
+    full.Create(state);
+    partial.Create(state);
+    REQUIRE(full.Execute(*script));
+    REQUIRE(partial.Execute(*partialScript));
+    full.ResolveFunctions(FUNCTION_NAMES);
+    partial.ResolveFunctions(FUNCTION_NAMES);
+
+    for (size_t i = 0; i < FunctionCount; ++i)
+        REQUIRE(full.HaveFunction(i));
+    REQUIRE(partial.HaveFunction(FunctionUpdate));
+    REQUIRE(partial.HaveFunction(FunctionOnInit));
+    REQUIRE(!partial.HaveFunction(FunctionOnEnded));
+    REQUIRE(!partial.HaveFunction(FunctionOnCollide));
+
+    const bool init = full.GetFunction(FunctionOnInit)();
+    REQUIRE(init);
+    full.CallFunction(FunctionUpdate, 16);
+    full.CallFunction(FunctionOnCollide, 2);
+    full.CallFunction(FunctionOnEnded);
+    REQUIRE(full["ticks"].get<int>() == 16);
+    REQUIRE(full["collisions"].get<int>() == 2);
+    REQUIRE(full["ended"].get<bool>());
+
+    // Calling a function the script doesn't have does nothing
+    partial.CallFunction(FunctionUpdate, 8);
+    partial.CallFunction(FunctionOnCollide, 2);
+    partial.CallFunction(FunctionOnEnded);
+    REQUIRE(partial["ticks"].get<int>() == 8);
+    REQUIRE(full["ticks"].get<int>() == 16);
+    REQUIRE(Game::Lua::IsNil(partial, "ended"));
+
+    full.Reset();
+    REQUIRE(!full.HaveFunction(FunctionUpdate));
+}
+
+TEST_CASE("Lua cached function")
+{
+    Game::Lua::InitSubsystems();
+    Game::Lua::WriteScript("/scripts/test/functions/cached.lua", PARTIAL_SCRIPT);
+    auto script = Game::Lua::LoadScript("/scripts/test/functions/cached.lua");
+    REQUIRE(script);
+
+    Game::Lua::Environment env;
+    env.Create(Game::Lua::CreateState());
+    REQUIRE(env.Execute(*script));
+    env.ResolveFunctions(FUNCTION_NAMES);
+    REQUIRE(env.HaveFunction(FunctionUpdate));
+
+    BENCHMARK("1M onUpdate by name")
+    {
+        for (int i = 0; i < DISPATCH_COUNT; ++i)
+            Game::Lua::CallFunction(env, "onUpdate", 1);
+    }
+    BENCHMARK("1M onUpdate cached")
+    {
+        for (int i = 0; i < DISPATCH_COUNT; ++i)
+            env.CallFunction(FunctionUpdate, 1);
+    }
+    REQUIRE(env["ticks"].get<int>() == DISPATCH_COUNT * 2);
+}
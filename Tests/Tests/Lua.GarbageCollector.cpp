@@ -0,0 +1,133 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+#include "GarbageCollector.h"
+
+namespace {
+
+/// Heap size in KB
+size_t GetMemory(kaguya::State& state)
+{
+    return static_cast<size_t>(lua_gc(state.state(), LUA_GCCOUNT, 0));
+}
+
+bool IsRunning(kaguya::State& state)
+{
+    return lua_gc(state.state(), LUA_GCISRUNNING, 0) != 0;
+}
+
+/// A VM with live objects of about size KB
+Game::Lua::SharedState CreateState(size_t size)
+{
+    auto state = std::make_shared<kaguya::State>();
+    state->dostring("live = {}");
+    while (GetMemory(*state) < size)
+        state->dostring("for i = 1, 1000 do live[#live + 1] = { i } end");
+    state->garbageCollect();
+    return state;
+}
+
+void MakeGarbage(kaguya::State& state, size_t size)
+{
+    const size_t target = GetMemory(state) + size;
+    while (GetMemory(state) < target)
+        state.dostring("local t = {} for i = 1, 1000 do t[i] = { i } end");
+}
+
+}
+
+TEST_CASE("Lua garbage collector budget")
+{
+    Game::Lua::GarbageCollector gc;
+    const auto& stats = gc.GetStats();
+    auto state = CreateState(2048);
+    const size_t live = GetMemory(*state);
+    gc.Add(state);
+    // Collecting happens only in Update()
+    REQUIRE(!IsRunning(*state));
+
+    // The heap didn't double yet
+    MakeGarbage(*state, live / 2);
+    gc.Update(1000000);
+    REQUIRE(stats.cycles == 0);
+
+    // A small budget does a part of the cycle in each tick
+    MakeGarbage(*state, live);
+    const size_t garbage = GetMemory(*state);
+    gc.Update(1);
+    REQUIRE(stats.cycles == 0);
+    uint64_t ticks = 2;
+    while (stats.cycles == 0 && ticks < 100000)
+    {
+        gc.Update(100);
+        ++ticks;
+    }
+    REQUIRE(stats.cycles == 1);
+    REQUIRE(stats.ticks == ticks);
+    REQUIRE(stats.overruns == 0);
+    REQUIRE(!IsRunning(*state));
+    REQUIRE(GetMemory(*state) < garbage);
+    REQUIRE(GetMemory(*state) < live * 3 / 2);
+}
+
+TEST_CASE("Lua garbage collector overrun")
+{
+    Game::Lua::GarbageCollector gc;
+    const auto& stats = gc.GetStats();
+    auto state = CreateState(Game::Lua::GarbageCollector::MIN_THRESHOLD);
+    gc.Add(state);
+
+    // No budget and the heap is twice the threshold, let Lua collect it
+    MakeGarbage(*state, GetMemory(*state) * 4);
+    gc.Update(0);
+    REQUIRE(stats.overruns == 1);
+    REQUIRE(IsRunning(*state));
+
+    // Back to normal
+    state->garbageCollect();
+    gc.Update(0);
+    REQUIRE(!IsRunning(*state));
+    REQUIRE(stats.overruns == 1);
+}
+
+TEST_CASE("Lua garbage collector remove")
+{
+    Game::Lua::GarbageCollector gc;
+    auto state = CreateState(0);
+    auto other = CreateState(0);
+    gc.Add(state);
+    gc.Add(other);
+    REQUIRE(!IsRunning(*state));
+
+    // E.g. the player left the game
+    gc.Remove(state);
+    REQUIRE(IsRunning(*state));
+    REQUIRE(!IsRunning(*other));
+    gc.Add(state);
+    REQUIRE(!IsRunning(*state));
+
+    // The owner is gone
+    other.reset();
+    gc.Update(100);
+    REQUIRE(gc.GetStats().ticks == 1);
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include "Lua.Mockup.h"
+#include "ConfigManager.h"
+#include "DataProvider.h"
+#include <abscommon/Subsystems.h>
+#include <abscommon/UuidUtils.h>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace Game {
+namespace Lua {
+
+namespace {
+
+class DataDir
+{
+private:
+    fs::path path_;
+public:
+    DataDir() :
+        path_(fs::temp_directory_path() / ("abtests_" + Utils::Uuid::New()))
+    {
+        fs::create_directories(path_ / "scripts");
+    }
+    ~DataDir()
+    {
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+    }
+    const fs::path& GetPath() const { return path_; }
+};
+
+const DataDir& GetDataDir()
+{
+    // DataProvider remembers the data directory, so all tests use the same
+    static DataDir dataDir;
+    return dataDir;
+}
+
+}
+
+void InitSubsystems()
+{
+    Subsystems::Instance.CreateSubsystem<ConfigManager>();
+    if (!Subsystems::Instance.CreateSubsystem<IO::DataProvider>())
+        return;
+    auto& config = *GetSubsystem<ConfigManager>();
+    config[ConfigManager::DataDir] = GetDataDir().GetPath().string();
+    config[ConfigManager::ScriptCacheDir] = "";
+    WriteScript("/scripts/main.lua", "-- Main script. Executed before all other scripts.\n");
+}
+
+void WriteScript(const std::string& name, const char* source)
+{
+    const fs::path file = GetDataDir().GetPath().string() + name;
+    fs::create_directories(file.parent_path());
+    std::ofstream output(file, std::ios::binary | std::ios::trunc);
+    output << source;
+}
+
+std::shared_ptr<Script> LoadScript(const std::string& name)
+{
+    return GetSubsystem<IO::DataProvider>()->GetAsset<Script>(name);
+}
+
+}
+}
@@ -0,0 +1,176 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include "CrowdManager.h"
+#include "Navigation.Mockup.h"
+#include <vector>
+
+namespace {
+
+constexpr uint32_t TICK = 50;
+constexpr float RADIUS = 0.5f;
+constexpr float SPEED = 5.0f;
+
+// Returns the number of ticks until the agent arrived
+int Walk(Navigation::CrowdManager& crowd, int agent, const Math::Vector3& target, int maxTicks)
+{
+    for (int tick = 1; tick <= maxTicks; ++tick)
+    {
+        crowd.Update(TICK);
+        if (crowd.GetPosition(agent).Distance(target) < 0.2f)
+            return tick;
+    }
+    return -1;
+}
+
+}
+
+TEST_CASE("CrowdManager agents")
+{
+    auto navMesh = Navigation::CreateGridNavMesh(16, 1.0f);
+    REQUIRE(navMesh);
+    Navigation::CrowdManager crowd(navMesh);
+    REQUIRE(crowd.GetAgentCount() == 0);
+
+    const Math::Vector3 pos1 = Navigation::GetCellCenter(1, 1, 1.0f);
+    const Math::Vector3 pos2 = Navigation::GetCellCenter(5, 5, 1.0f);
+    const int agent1 = crowd.AddAgent(1, pos1, RADIUS, SPEED);
+    const int agent2 = crowd.AddAgent(2, pos2, RADIUS, SPEED);
+    REQUIRE(agent1 != -1);
+    REQUIRE(agent2 != -1);
+    REQUIRE(agent1 != agent2);
+    REQUIRE(crowd.GetAgentCount() == 2);
+    REQUIRE(crowd.GetPosition(agent1).Equals(pos1));
+    REQUIRE(crowd.GetPosition(agent2).Equals(pos2));
+    REQUIRE_FALSE(crowd.HasTarget(agent1));
+    // Not on the navigation mesh
+    REQUIRE(crowd.AddAgent(3, { 100.0f, 0.0f, 100.0f }, RADIUS, SPEED) == -1);
+    REQUIRE(crowd.GetAgentCount() == 2);
+
+    std::vector<uint32_t> objects;
+    crowd.VisitAgents([&](int, uint32_t objectId)
+    {
+        objects.push_back(objectId);
+        return Iteration::Continue;
+    });
+    REQUIRE(objects == std::vector<uint32_t>{ 1, 2 });
+
+    crowd.RemoveAgent(agent1);
+    REQUIRE(crowd.GetAgentCount() == 1);
+    // Removing it again or an invalid agent does nothing
+    crowd.RemoveAgent(agent1);
+    crowd.RemoveAgent(-1);
+    crowd.RemoveAgent(100000);
+    REQUIRE(crowd.GetAgentCount() == 1);
+    objects.clear();
+    crowd.VisitAgents([&](int agent, uint32_t objectId)
+    {
+        REQUIRE(agent == agent2);
+        objects.push_back(objectId);
+        return Iteration::Continue;
+    });
+    REQUIRE(objects == std::vector<uint32_t>{ 2 });
+
+    // The slot is used again
+    REQUIRE(crowd.AddAgent(4, pos1, RADIUS, SPEED) == agent1);
+    REQUIRE(crowd.GetAgentCount() == 2);
+
+    // Teleport
+    crowd.SetPosition(agent2, Navigation::GetCellCenter(10, 10, 1.0f));
+    REQUIRE(crowd.GetPosition(agent2).Equals(Navigation::GetCellCenter(10, 10, 1.0f)));
+}
+
+TEST_CASE("CrowdManager target")
+{
+    auto navMesh = Navigation::CreateGridNavMesh(16, 1.0f);
+    REQUIRE(navMesh);
+    Navigation::CrowdManager crowd(navMesh);
+    const Math::Vector3 start = Navigation::GetCellCenter(1, 1, 1.0f);
+    const Math::Vector3 target = Navigation::GetCellCenter(12, 1, 1.0f);
+    const int agent = crowd.AddAgent(1, start, RADIUS, SPEED);
+    REQUIRE(agent != -1);
+
+    REQUIRE_FALSE(crowd.SetTarget(agent, { 100.0f, 0.0f, 100.0f }));
+    REQUIRE(crowd.SetTarget(agent, target));
+    REQUIRE(crowd.HasTarget(agent));
+    REQUIRE_FALSE(crowd.IsTargetFailed(agent));
+
+    crowd.Update(TICK);
+    crowd.Update(TICK);
+    // Walks towards the target
+    REQUIRE(crowd.GetVelocity(agent).Length() > 0.0f);
+    REQUIRE(crowd.GetPosition(agent).x_ > start.x_);
+    REQUIRE(crowd.GetVelocity(agent).Length() <= SPEED + 0.01f);
+
+    // 11 units at 5 units/s are at least 44 ticks
+    const int ticks = Walk(crowd, agent, target, 200);
+    REQUIRE(ticks > 40);
+
+    crowd.ResetTarget(agent);
+    REQUIRE_FALSE(crowd.HasTarget(agent));
+}
+
+TEST_CASE("CrowdManager maze")
+{
+    constexpr int SIZE = 16;
+    auto navMesh = Navigation::CreateMazeNavMesh(SIZE, 1.0f);
+    REQUIRE(navMesh);
+    Navigation::CrowdManager crowd(navMesh);
+    const int agent = crowd.AddAgent(1, Navigation::GetCellCenter(0, 4, 1.0f), RADIUS, SPEED);
+    REQUIRE(agent != -1);
+
+    // On the other side of a wall, the crowd finds the way around it
+    const Math::Vector3 target = Navigation::GetCellCenter(4, 4, 1.0f);
+    REQUIRE(crowd.SetTarget(agent, target));
+    REQUIRE(Walk(crowd, agent, target, 400) != -1);
+}
+
+TEST_CASE("CrowdManager avoidance")
+{
+    auto navMesh = Navigation::CreateGridNavMesh(16, 1.0f);
+    REQUIRE(navMesh);
+    Navigation::CrowdManager crowd(navMesh);
+    // Two agents walk towards each other on the same line
+    const Math::Vector3 pos1 = Navigation::GetCellCenter(2, 8, 1.0f);
+    const Math::Vector3 pos2 = Navigation::GetCellCenter(13, 8, 1.0f);
+    const int agent1 = crowd.AddAgent(1, pos1, RADIUS, SPEED);
+    const int agent2 = crowd.AddAgent(2, pos2, RADIUS, SPEED);
+    REQUIRE(crowd.SetTarget(agent1, pos2));
+    REQUIRE(crowd.SetTarget(agent2, pos1));
+
+    float minDistance = pos1.Distance(pos2);
+    bool arrived = false;
+    for (int tick = 0; tick < 400 && !arrived; ++tick)
+    {
+        crowd.Update(TICK);
+        const Math::Vector3 p1 = crowd.GetPosition(agent1);
+        const Math::Vector3 p2 = crowd.GetPosition(agent2);
+        minDistance = std::min(minDistance, p1.Distance(p2));
+        arrived = p1.Distance(pos2) < 0.2f && p2.Distance(pos1) < 0.2f;
+    }
+    REQUIRE(arrived);
+    // They went around each other instead of through
+    INFO(minDistance);
+    REQUIRE(minDistance > 1.5f * RADIUS);
+}
@@ -0,0 +1,147 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include "Navigation.Mockup.h"
+#include <DetourNavMeshBuilder.h>
+#include <vector>
+
+namespace Navigation {
+
+static constexpr unsigned short NULL_INDEX = 0xffff;
+static constexpr int VERTS_PER_POLY = 4;
+
+std::shared_ptr<NavigationMesh> CreateGridNavMesh(int size, float cellSize, const BlockedCallback& blocked)
+{
+    const auto isWalkable = [&](int x, int z) -> bool
+    {
+        if (x < 0 || z < 0 || x >= size || z >= size)
+            return false;
+        return !blocked || !blocked(x, z);
+    };
+    const auto vertIndex = [&](int x, int z) -> unsigned short
+    {
+        return static_cast<unsigned short>(z * (size + 1) + x);
+    };
+
+    std::vector<unsigned short> verts;
+    for (int z = 0; z <= size; ++z)
+    {
+        for (int x = 0; x <= size; ++x)
+        {
+            verts.push_back(static_cast<unsigned short>(x));
+            verts.push_back(0);
+            verts.push_back(static_cast<unsigned short>(z));
+        }
+    }
+
+    std::vector<int> polyIndex(static_cast<size_t>(size * size), -1);
+    int polyCount = 0;
+    for (int z = 0; z < size; ++z)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            if (isWalkable(x, z))
+                polyIndex[static_cast<size_t>(z * size + x)] = polyCount++;
+        }
+    }
+    const auto neighbor = [&](int x, int z) -> unsigned short
+    {
+        if (!isWalkable(x, z))
+            return NULL_INDEX;
+        return static_cast<unsigned short>(polyIndex[static_cast<size_t>(z * size + x)]);
+    };
+
+    // Vertices followed by the neighbor polygon of the edge from vertex i to vertex i + 1
+    std::vector<unsigned short> polys;
+    for (int z = 0; z < size; ++z)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            if (!isWalkable(x, z))
+                continue;
+            polys.push_back(vertIndex(x, z));
+            polys.push_back(vertIndex(x, z + 1));
+            polys.push_back(vertIndex(x + 1, z + 1));
+            polys.push_back(vertIndex(x + 1, z));
+            polys.push_back(neighbor(x - 1, z));
+            polys.push_back(neighbor(x, z + 1));
+            polys.push_back(neighbor(x + 1, z));
+            polys.push_back(neighbor(x, z - 1));
+        }
+    }
+    std::vector<unsigned short> polyFlags(static_cast<size_t>(polyCount), 1);
+    std::vector<unsigned char> polyAreas(static_cast<size_t>(polyCount), 0);
+
+    dtNavMeshCreateParams params{};
+    params.verts = verts.data();
+    params.vertCount = static_cast<int>(verts.size() / 3);
+    params.polys = polys.data();
+    params.polyFlags = polyFlags.data();
+    params.polyAreas = polyAreas.data();
+    params.polyCount = polyCount;
+    params.nvp = VERTS_PER_POLY;
+    params.bmin[0] = 0.0f;
+    params.bmin[1] = 0.0f;
+    params.bmin[2] = 0.0f;
+    params.bmax[0] = static_cast<float>(size) * cellSize;
+    params.bmax[1] = 2.0f;
+    params.bmax[2] = static_cast<float>(size) * cellSize;
+    params.walkableHeight = 2.0f;
+    params.walkableRadius = 0.5f;
+    params.walkableClimb = 0.5f;
+    params.cs = cellSize;
+    params.ch = 1.0f;
+    params.buildBvTree = true;
+
+    unsigned char* data = nullptr;
+    int dataSize = 0;
+    if (!dtCreateNavMeshData(&params, &data, &dataSize))
+        return std::shared_ptr<NavigationMesh>();
+    dtNavMesh* navMesh = dtAllocNavMesh();
+    if (dtStatusFailed(navMesh->init(data, dataSize, DT_TILE_FREE_DATA)))
+    {
+        dtFree(data);
+        dtFreeNavMesh(navMesh);
+        return std::shared_ptr<NavigationMesh>();
+    }
+    auto result = std::make_shared<NavigationMesh>();
+    result->SetNavMesh(navMesh);
+    return result;
+}
+
+std::shared_ptr<NavigationMesh> CreateMazeNavMesh(int size, float cellSize)
+{
+    return CreateGridNavMesh(size, cellSize, [size](int x, int z)
+    {
+        if (x % 4 != 3)
+            return false;
+        const bool gapAtEnd = (x / 4) % 2 == 0;
+        return gapAtEnd ? z != size - 1 : z != 0;
+    });
+}
+
+Math::Vector3 GetCellCenter(int x, int z, float cellSize)
+{
+    return { (static_cast<float>(x) + 0.5f) * cellSize, 0.0f, (static_cast<float>(z) + 0.5f) * cellSize };
+}
+
+}
@@ -0,0 +1,43 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "NavigationMesh.h"
+#include <absmath/Vector3.h>
+#include <functional>
+#include <memory>
+
+namespace Navigation {
+
+/// Returns true for cells which are not walkable
+using BlockedCallback = std::function<bool(int x, int z)>;
+
+/// A flat navigation mesh in the x/z plane with one square polygon for each walkable
+/// cell of a size x size grid. Cell (x, z) goes from (x, z) * cellSize to (x + 1, z + 1) * cellSize.
+std::shared_ptr<NavigationMesh> CreateGridNavMesh(int size, float cellSize, const BlockedCallback& blocked = {});
+/// Walls at every 4th column with a gap at alternating ends, so paths from the left
+/// to the right side go up and down the whole grid.
+std::shared_ptr<NavigationMesh> CreateMazeNavMesh(int size, float cellSize);
+/// Center of a cell
+Math::Vector3 GetCellCenter(int x, int z, float cellSize);
+
+}
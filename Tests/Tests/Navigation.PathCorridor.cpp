@@ -0,0 +1,105 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include "Navigation.Mockup.h"
+#include "PathCorridor.h"
+#include "PathFinder.h"
+#include <vector>
+
+namespace {
+
+Navigation::Path FindPath(std::shared_ptr<Navigation::NavigationMesh> navMesh, const Math::Vector3& start, const Math::Vector3& end)
+{
+    Navigation::Path result;
+    auto pathFinder = std::make_shared<Navigation::PathFinder>(navMesh);
+    pathFinder->FindPath(start, end, Math::Vector3::One, [&](bool success, Navigation::Path& path)
+    {
+        REQUIRE(success);
+        result = path;
+    });
+    // No ThreadPool, it searches on this thread
+    pathFinder->Dispatch();
+    pathFinder->Deliver();
+    return result;
+}
+
+}
+
+TEST_CASE("PathCorridor follow")
+{
+    constexpr int SIZE = 16;
+    auto navMesh = Navigation::CreateGridNavMesh(SIZE, 1.0f);
+    REQUIRE(navMesh);
+    Navigation::PathCorridor corridor(navMesh);
+    std::vector<Math::Vector3> wayPoints;
+
+    // Needs a path first
+    REQUIRE_FALSE(corridor.IsValid());
+    REQUIRE_FALSE(corridor.Update(Math::Vector3::Zero, Math::Vector3::Zero, false, wayPoints));
+    REQUIRE_FALSE(corridor.SetPath(Navigation::Path()));
+
+    Math::Vector3 start = Navigation::GetCellCenter(1, 1, 1.0f);
+    Math::Vector3 end = Navigation::GetCellCenter(12, 1, 1.0f);
+    REQUIRE(corridor.SetPath(FindPath(navMesh, start, end)));
+    REQUIRE(corridor.IsValid());
+
+    // The follower and the target walk, the corridor follows without searching a new path
+    const Math::Vector3 followerStep = { 0.25f, 0.0f, 0.25f };
+    const Math::Vector3 targetStep = { 0.0f, 0.0f, 0.5f };
+    for (int i = 0; i < 20; ++i)
+    {
+        start += followerStep;
+        end += targetStep;
+        REQUIRE(corridor.Update(start, end, (i % 4) == 0, wayPoints));
+        REQUIRE(corridor.IsValid());
+        REQUIRE_FALSE(wayPoints.empty());
+        REQUIRE(wayPoints.back().Equals(end));
+    }
+}
+
+TEST_CASE("PathCorridor target behind wall")
+{
+    constexpr int SIZE = 16;
+    auto navMesh = Navigation::CreateMazeNavMesh(SIZE, 1.0f);
+    REQUIRE(navMesh);
+    Navigation::PathCorridor corridor(navMesh);
+    std::vector<Math::Vector3> wayPoints;
+
+    const Math::Vector3 start = Navigation::GetCellCenter(0, 4, 1.0f);
+    const Math::Vector3 end = Navigation::GetCellCenter(2, 4, 1.0f);
+    REQUIRE(corridor.SetPath(FindPath(navMesh, start, end)));
+    REQUIRE(corridor.Update(start, end, false, wayPoints));
+
+    // The target went through the wall, the corridor can not follow, a new path is needed
+    REQUIRE_FALSE(corridor.Update(start, Navigation::GetCellCenter(4, 4, 1.0f), false, wayPoints));
+    REQUIRE_FALSE(corridor.IsValid());
+    REQUIRE_FALSE(corridor.Update(start, end, false, wayPoints));
+
+    // The new path goes around the wall
+    const Math::Vector3 newEnd = Navigation::GetCellCenter(4, 4, 1.0f);
+    REQUIRE(corridor.SetPath(FindPath(navMesh, start, newEnd)));
+    REQUIRE(corridor.Update(start, newEnd, true, wayPoints));
+    REQUIRE(wayPoints.size() > 1);
+    REQUIRE(wayPoints.back().Equals(newEnd));
+}
@@ -0,0 +1,226 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include "Navigation.Mockup.h"
+#include "PathFinder.h"
+#include <vector>
+
+// There is no ThreadPool subsystem in the tests, so PathFinder::Dispatch() searches
+// the paths on the calling thread.
+
+TEST_CASE("PathFinder deliver")
+{
+    auto navMesh = Navigation::CreateGridNavMesh(8, 1.0f);
+    REQUIRE(navMesh);
+    auto pathFinder = std::make_shared<Navigation::PathFinder>(navMesh);
+
+    const Math::Vector3 start = Navigation::GetCellCenter(0, 0, 1.0f);
+    const Math::Vector3 end = Navigation::GetCellCenter(7, 7, 1.0f);
+    bool called = false;
+    bool found = false;
+    Navigation::Path result;
+    pathFinder->FindPath(start, end, Math::Vector3::One, [&](bool success, Navigation::Path& path)
+    {
+        called = true;
+        found = success;
+        result = path;
+    });
+    // Requests are sent at the end of the tick
+    pathFinder->Deliver();
+    REQUIRE_FALSE(called);
+    pathFinder->Dispatch();
+    REQUIRE_FALSE(pathFinder->IsBusy());
+    // and delivered at the beginning of the next tick
+    REQUIRE_FALSE(called);
+    pathFinder->Deliver();
+    REQUIRE(called);
+    REQUIRE(found);
+    REQUIRE(result.points.size() >= 2);
+    REQUIRE(result.points.front().Equals(start));
+    REQUIRE(result.points.back().Equals(end));
+    REQUIRE(result.polys.size() >= 8);
+
+    SECTION("Not on the mesh")
+    {
+        called = false;
+        pathFinder->FindPath(start, { 100.0f, 0.0f, 100.0f }, Math::Vector3::One, [&](bool success, Navigation::Path&)
+        {
+            called = true;
+            found = success;
+        });
+        pathFinder->Dispatch();
+        pathFinder->Deliver();
+        REQUIRE(called);
+        REQUIRE_FALSE(found);
+    }
+}
+
+TEST_CASE("PathFinder budget")
+{
+    constexpr int SIZE = 16;
+    auto navMesh = Navigation::CreateMazeNavMesh(SIZE, 1.0f);
+    REQUIRE(navMesh);
+    auto pathFinder = std::make_shared<Navigation::PathFinder>(navMesh);
+    pathFinder->SetIterationBudget(16);
+
+    const Math::Vector3 start = Navigation::GetCellCenter(0, 0, 1.0f);
+    const Math::Vector3 end = Navigation::GetCellCenter(SIZE - 1, 0, 1.0f);
+    std::vector<Math::Vector3> expected;
+    REQUIRE(navMesh->FindPath(expected, start, end));
+
+    std::vector<int> delivered;
+    std::vector<Math::Vector3> result;
+    pathFinder->FindPath(start, end, Math::Vector3::One, [&](bool success, Navigation::Path& path)
+    {
+        REQUIRE(success);
+        delivered.push_back(1);
+        result = path.points;
+    });
+    pathFinder->FindPath(end, start, Math::Vector3::One, [&](bool success, Navigation::Path&)
+    {
+        REQUIRE(success);
+        delivered.push_back(2);
+    });
+
+    int ticks = 0;
+    while (delivered.size() < 2 && ticks < 1000)
+    {
+        ++ticks;
+        pathFinder->Deliver();
+        pathFinder->Dispatch();
+    }
+    // The searches continued over many ticks and were delivered in order
+    REQUIRE(ticks > 2);
+    REQUIRE(ticks < 1000);
+    REQUIRE(delivered == std::vector<int>{ 1, 2 });
+    // Same path as searching it at once
+    REQUIRE(result.size() == expected.size());
+    for (size_t i = 0; i < result.size(); ++i)
+        REQUIRE(result[i].Equals(expected[i]));
+}
+
+TEST_CASE("PathFinder cache")
+{
+    constexpr int SIZE = 16;
+    auto navMesh = Navigation::CreateMazeNavMesh(SIZE, 1.0f);
+    REQUIRE(navMesh);
+    auto pathFinder = std::make_shared<Navigation::PathFinder>(navMesh);
+    pathFinder->SetIterationBudget(16);
+
+    // Returns the number of ticks until the path was delivered
+    const auto findPath = [&](const Math::Vector3& start, const Math::Vector3& end, Navigation::Path& result) -> int
+    {
+        bool called = false;
+        pathFinder->FindPath(start, end, Math::Vector3::One, [&](bool success, Navigation::Path& path)
+        {
+            REQUIRE(success);
+            called = true;
+            result = path;
+        });
+        int ticks = 0;
+        while (!called && ticks < 1000)
+        {
+            ++ticks;
+            pathFinder->Dispatch();
+            pathFinder->Deliver();
+        }
+        return ticks;
+    };
+
+    const Math::Vector3 start = Navigation::GetCellCenter(0, 0, 1.0f);
+    const Math::Vector3 end = Navigation::GetCellCenter(SIZE - 1, 0, 1.0f);
+    Navigation::Path first;
+    REQUIRE(findPath(start, end, first) > 2);
+
+    // Other points in the same start and end polygons only need the straight path
+    const Math::Vector3 offset = { 0.2f, 0.0f, -0.2f };
+    Navigation::Path second;
+    REQUIRE(findPath(start + offset, end + offset, second) == 1);
+    REQUIRE(second.polys == first.polys);
+    REQUIRE(second.points.front().Equals(start + offset));
+    REQUIRE(second.points.back().Equals(end + offset));
+
+    // The end polygon differs, not cached
+    Navigation::Path third;
+    REQUIRE(findPath(start, Navigation::GetCellCenter(SIZE - 1, 1, 1.0f), third) > 2);
+}
+
+TEST_CASE("PathFinder 200 agents re-path")
+{
+    constexpr int SIZE = 32;
+    constexpr int AGENTS = 200;
+    auto navMesh = Navigation::CreateMazeNavMesh(SIZE, 1.0f);
+    REQUIRE(navMesh);
+
+    std::vector<Math::Vector3> starts;
+    std::vector<Math::Vector3> ends;
+    for (int i = 0; i < AGENTS; ++i)
+    {
+        // Left to right through the maze
+        starts.push_back(Navigation::GetCellCenter(i % 3, i % SIZE, 1.0f));
+        ends.push_back(Navigation::GetCellCenter(SIZE - 1 - (i % 3), (i * 7) % SIZE, 1.0f));
+    }
+
+    // Cost of one game tick: searching all paths at once...
+    int found = 0;
+    BENCHMARK("Synchronous one tick")
+    {
+        found = 0;
+        std::vector<Math::Vector3> path;
+        for (int i = 0; i < AGENTS; ++i)
+        {
+            if (navMesh->FindPath(path, starts[i], ends[i]))
+                ++found;
+        }
+    }
+    REQUIRE(found == AGENTS);
+
+    // ...or with the iteration budget
+    auto pathFinder = std::make_shared<Navigation::PathFinder>(navMesh);
+    found = 0;
+    int delivered = 0;
+    for (int i = 0; i < AGENTS; ++i)
+    {
+        pathFinder->FindPath(starts[i], ends[i], Math::Vector3::One, [&](bool success, Navigation::Path&)
+        {
+            ++delivered;
+            if (success)
+                ++found;
+        });
+    }
+    BENCHMARK("PathFinder one tick")
+    {
+        pathFinder->Dispatch();
+    }
+    int ticks = 1;
+    while (delivered < AGENTS && ticks < 10000)
+    {
+        ++ticks;
+        pathFinder->Deliver();
+        pathFinder->Dispatch();
+    }
+    REQUIRE(found == AGENTS);
+    // The budget spreads the searches over several ticks
+    REQUIRE(ticks > 1);
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+#include <AB/Packets/Compression.h>
+#include <vector>
+
+namespace {
+
+class Message
+{
+public:
+    std::vector<char> buffer_;
+    template<typename T>
+    void Add(const T& value)
+    {
+        const size_t size = buffer_.size();
+        buffer_.resize(size + sizeof(T));
+        memcpy(buffer_.data() + size, &value, sizeof(T));
+    }
+    void AddByte(AB::GameProtocol::ServerPacketType value) { Add<uint8_t>(static_cast<uint8_t>(value)); }
+};
+
+// What a game status message of a fight looks like
+Message CreateStatusMessage()
+{
+    using namespace AB::GameProtocol;
+    using namespace AB::Packets::Server;
+    Message msg;
+    msg.AddByte(ServerPacketType::GameUpdate);
+    GameUpdate update{ 1234567 };
+    AB::Packets::Add(update, msg);
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        msg.AddByte(ServerPacketType::GameObjectStateChange);
+        ObjectStateChanged state{ 100 + i, static_cast<uint8_t>(CreatureState::Moving) };
+        AB::Packets::Add(state, msg);
+        msg.AddByte(ServerPacketType::GameObjectResourceChange);
+        ObjectResourceChanged resource{ 100 + i, 1, static_cast<int16_t>(400 - i) };
+        AB::Packets::Add(resource, msg);
+    }
+    return msg;
+}
+
+}
+
+TEST_CASE("Compress status message")
+{
+    Message msg = CreateStatusMessage();
+    const int size = static_cast<int>(msg.buffer_.size());
+    REQUIRE(size >= AB::Packets::DEFAULT_COMPRESSION_THRESHOLD);
+
+    std::vector<char> compressed(static_cast<size_t>(LZ4_compressBound(size)));
+    const int compressedSize = AB::Packets::CompressMessage(msg.buffer_.data(), size,
+        compressed.data(), static_cast<int>(compressed.size()));
+    REQUIRE(compressedSize > 0);
+    REQUIRE(compressedSize < size);
+
+    std::vector<char> decompressed(static_cast<size_t>(size));
+    const int decompressedSize = AB::Packets::DecompressMessage(compressed.data(), compressedSize,
+        decompressed.data(), static_cast<int>(decompressed.size()));
+    REQUIRE(decompressedSize == size);
+    REQUIRE(memcmp(decompressed.data(), msg.buffer_.data(), static_cast<size_t>(size)) == 0);
+}
+
+TEST_CASE("Decompress corrupt message")
+{
+    Message msg = CreateStatusMessage();
+    const int size = static_cast<int>(msg.buffer_.size());
+    std::vector<char> compressed(static_cast<size_t>(LZ4_compressBound(size)));
+    const int compressedSize = AB::Packets::CompressMessage(msg.buffer_.data(), size,
+        compressed.data(), static_cast<int>(compressed.size()));
+    REQUIRE(compressedSize > 0);
+
+    // Too small destination must fail and not write past it
+    std::vector<char> decompressed(static_cast<size_t>(size / 2));
+    const int decompressedSize = AB::Packets::DecompressMessage(compressed.data(), compressedSize,
+        decompressed.data(), static_cast<int>(decompressed.size()));
+    REQUIRE(decompressedSize < 0);
+}
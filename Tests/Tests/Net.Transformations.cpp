@@ -0,0 +1,185 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+#include <AB/Packets/Packet.h>
+#include <AB/Packets/ServerPackets.h>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Minimal message to count the bytes of packets
+class Message
+{
+private:
+    std::vector<uint8_t> buffer_;
+    size_t pos_{ 0 };
+public:
+    template<typename T>
+    void Add(const T& value)
+    {
+        const size_t size = buffer_.size();
+        buffer_.resize(size + sizeof(T));
+        memcpy(buffer_.data() + size, &value, sizeof(T));
+    }
+    void AddByte(AB::GameProtocol::ServerPacketType value) { Add<uint8_t>(static_cast<uint8_t>(value)); }
+    template<typename T>
+    T Get()
+    {
+        T result;
+        memcpy(&result, buffer_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return result;
+    }
+    size_t GetSize() const { return buffer_.size(); }
+};
+
+constexpr uint32_t ACTOR_COUNT = 100;
+
+// All actors moved and turned
+size_t WriteLegacy(Message& msg)
+{
+    for (uint32_t i = 0; i < ACTOR_COUNT; ++i)
+    {
+        msg.AddByte(AB::GameProtocol::ServerPacketType::GameObjectPositionChange);
+        AB::Packets::Server::ObjectPosUpdate pos = { i, { 100.0f + i, 1.5f, -20.0f - i } };
+        AB::Packets::Add(pos, msg);
+        msg.AddByte(AB::GameProtocol::ServerPacketType::GameObjectRotationChange);
+        AB::Packets::Server::ObjectRotationUpdate rot = { i, 0.1f * i, false };
+        AB::Packets::Add(rot, msg);
+    }
+    return msg.GetSize();
+}
+
+size_t WriteCompact(Message& msg)
+{
+    using namespace AB::Packets::Server;
+    const auto quantizer = PositionQuantizer::FromBounds({ -1024.0f, -100.0f, -1024.0f }, { 1024.0f, 100.0f, 1024.0f });
+    ObjectTransformations packet;
+    packet.count = ACTOR_COUNT;
+    for (uint32_t i = 0; i < ACTOR_COUNT; ++i)
+    {
+        std::array<int16_t, 3> pos;
+        REQUIRE(quantizer.Quantize({ 100.0f + i, 1.5f, -20.0f - i }, pos));
+        packet.objects.push_back({ i, ObjectTransformationPosition | ObjectTransformationRotation,
+            pos, QuantizeRotation(0.1f * i) });
+    }
+    msg.AddByte(AB::GameProtocol::ServerPacketType::GameObjectTransformations);
+    AB::Packets::Add(packet, msg);
+    return msg.GetSize();
+}
+
+}
+
+TEST_CASE("Transformations quantize")
+{
+    using namespace AB::Packets::Server;
+    // A map which is not centered at the origin
+    const auto quantizer = PositionQuantizer::FromBounds({ 1000.0f, -50.0f, -3000.0f }, { 3000.0f, 50.0f, -1000.0f });
+    int16_t value = 0;
+    REQUIRE(quantizer.Quantize(0, 2000.0f, value));
+    REQUIRE(value == 0);
+    REQUIRE(quantizer.Quantize(0, 2123.4567f, value));
+    REQUIRE(quantizer.Dequantize(0, value) == Approx(2123.4567f).margin(0.5f / quantizer.scale[0]));
+    REQUIRE(quantizer.Quantize(1, -50.0f, value));
+    REQUIRE(quantizer.Dequantize(1, value) == Approx(-50.0f).margin(0.5f / quantizer.scale[1]));
+
+    std::array<int16_t, 3> pos;
+    REQUIRE(quantizer.Quantize({ 2999.0f, 49.0f, -1001.0f }, pos));
+    const auto result = quantizer.Dequantize(pos);
+    REQUIRE(result[0] == Approx(2999.0f).margin(0.5f / quantizer.scale[0]));
+    REQUIRE(result[1] == Approx(49.0f).margin(0.5f / quantizer.scale[1]));
+    REQUIRE(result[2] == Approx(-1001.0f).margin(0.5f / quantizer.scale[2]));
+
+    // Outside of the bounds, the server must send the float packets
+    REQUIRE_FALSE(quantizer.Quantize(0, 0.0f, value));
+    REQUIRE_FALSE(quantizer.Quantize(1, 200.0f, value));
+    REQUIRE_FALSE(quantizer.Quantize({ 2000.0f, 0.0f, 0.0f }, pos));
+    REQUIRE_FALSE(quantizer.Quantize(0, std::numeric_limits<float>::quiet_NaN(), value));
+
+    REQUIRE(DequantizeRotation(QuantizeRotation(0.0f)) == Approx(0.0f));
+    REQUIRE(DequantizeRotation(QuantizeRotation(1.0f)) == Approx(1.0f).margin(0.001f));
+    REQUIRE(DequantizeRotation(QuantizeRotation(-1.0f)) == Approx(-1.0f).margin(0.001f));
+    // Wraps around
+    REQUIRE(DequantizeRotation(QuantizeRotation(7.0f)) == Approx(7.0f - 6.28318530718f).margin(0.001f));
+}
+
+TEST_CASE("Transformations quantizer serialize")
+{
+    using namespace AB::Packets::Server;
+    Message msg;
+    auto packet = PositionQuantizer::FromBounds({ -10.0f, 0.0f, 20.0f }, { 10.0f, 5.0f, 60.0f });
+    AB::Packets::Add(packet, msg);
+    REQUIRE(msg.GetSize() == 6 * sizeof(float));
+
+    auto result = AB::Packets::Get<PositionQuantizer>(msg);
+    REQUIRE(result.origin == packet.origin);
+    REQUIRE(result.scale == packet.scale);
+}
+
+TEST_CASE("Transformations serialize")
+{
+    using namespace AB::Packets::Server;
+    Message msg;
+    ObjectTransformations packet;
+    packet.count = 3;
+    packet.objects.push_back({ 1, ObjectTransformationPosition, { 10, 20, 30 }, 0 });
+    packet.objects.push_back({ 2, ObjectTransformationRotation | ObjectTransformationManualRotation, { }, 1000 });
+    packet.objects.push_back({ 3, ObjectTransformationSetPosition | ObjectTransformationRotation, { -1, -2, -3 }, 2000 });
+    AB::Packets::Add(packet, msg);
+    // Count + 3 * (id + flags) + 2 * position + 2 * rotation
+    REQUIRE(msg.GetSize() == 2 + 3 * 5 + 2 * 6 + 2 * 2);
+
+    auto result = AB::Packets::Get<ObjectTransformations>(msg);
+    REQUIRE(result.count == 3);
+    REQUIRE(result.objects[0].id == 1);
+    REQUIRE(result.objects[0].pos[2] == 30);
+    REQUIRE(result.objects[1].flags == (ObjectTransformationRotation | ObjectTransformationManualRotation));
+    REQUIRE(result.objects[1].yRot == 1000);
+    REQUIRE(result.objects[2].pos[0] == -1);
+    REQUIRE(result.objects[2].yRot == 2000);
+}
+
+TEST_CASE("Transformations bytes per tick")
+{
+    Message legacy;
+    Message compact;
+    const size_t legacySize = WriteLegacy(legacy);
+    const size_t compactSize = WriteCompact(compact);
+    // 100 actors: 2700 vs. 1303 bytes
+    REQUIRE(legacySize == ACTOR_COUNT * ((1 + 4 + 12) + (1 + 4 + 4 + 1)));
+    REQUIRE(compactSize == 1 + 2 + ACTOR_COUNT * (4 + 1 + 6 + 2));
+    REQUIRE(compactSize * 2 < legacySize);
+
+    BENCHMARK("Legacy 100 actors")
+    {
+        Message msg;
+        WriteLegacy(msg);
+    }
+    BENCHMARK("Compact 100 actors")
+    {
+        Message msg;
+        WriteCompact(msg);
+    }
+}
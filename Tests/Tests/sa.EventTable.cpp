@@ -0,0 +1,146 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include <sa/EventTable.h>
+#include <sa/StringHash.h>
+
+static constexpr sa::event_t EVENT_MUL = sa::StringHash("Mul");
+static constexpr sa::event_t EVENT_CHECK = sa::StringHash("Check");
+static constexpr sa::event_t EVENT_NOTIFY = sa::StringHash("Notify");
+
+using TestEvents = sa::EventTable<
+    sa::Event<EVENT_MUL, int(int, int)>,
+    sa::Event<EVENT_CHECK, void(int, bool&)>,
+    sa::Event<EVENT_NOTIFY, void(void)>
+>;
+
+static int Add(int i, int j)
+{
+    return i + j;
+}
+
+namespace {
+
+class Base
+{
+public:
+    virtual ~Base() = default;
+    virtual int Mul(int i, int j) { return i * j; }
+    void Check(int i, bool& result) { result = result && (i > 0); }
+    void Notify() { ++notified; }
+    int notified{ 0 };
+};
+
+class Derived : public Base
+{
+public:
+    int Mul(int i, int j) override { return (i * j) + 1; }
+};
+
+}
+
+TEST_CASE("Delegate")
+{
+    Base base;
+    auto d = sa::Delegate<int(int, int)>::Make<&Base::Mul>(&base);
+    REQUIRE(d);
+    REQUIRE(d(2, 3) == 6);
+
+    Derived derived;
+    auto d2 = sa::Delegate<int(int, int)>::Make<&Base::Mul>(&derived);
+    // Virtual
+    REQUIRE(d2(2, 3) == 7);
+    REQUIRE(d != d2);
+
+    auto d3 = sa::Delegate<int(int, int)>::Make<&Add>();
+    REQUIRE(d3(2, 3) == 5);
+
+    sa::Delegate<int(int, int)> empty;
+    REQUIRE(!empty);
+}
+
+TEST_CASE("EventTable")
+{
+    static_assert(std::is_same_v<TestEvents::SignatureOf<EVENT_CHECK>, void(int, bool&)>);
+    static_assert(TestEvents::Contains<EVENT_NOTIFY>);
+    static_assert(!TestEvents::Contains<sa::StringHash("Unknown")>);
+
+    SECTION("Results")
+    {
+        TestEvents events;
+        Base base;
+        Derived derived;
+        events.Subscribe<EVENT_MUL>(TestEvents::DelegateOf<EVENT_MUL>::Make<&Base::Mul>(&base));
+        events.Subscribe<EVENT_MUL>(TestEvents::DelegateOf<EVENT_MUL>::Make<&Base::Mul>(&derived));
+        REQUIRE(events.CallOne<EVENT_MUL>(3, 4) == 12);
+        auto results = events.CallAll<EVENT_MUL>(3, 4);
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0] == 12);
+        REQUIRE(results[1] == 13);
+    }
+
+    SECTION("Not subscribed")
+    {
+        TestEvents events;
+        REQUIRE(events.CallOne<EVENT_MUL>(3, 4) == 0);
+        REQUIRE(events.CallAll<EVENT_MUL>(3, 4).empty());
+        events.CallAll<EVENT_NOTIFY>();
+    }
+
+    SECTION("Reference argument")
+    {
+        TestEvents events;
+        Base a;
+        Base b;
+        events.Subscribe<EVENT_CHECK>(TestEvents::DelegateOf<EVENT_CHECK>::Make<&Base::Check>(&a));
+        events.Subscribe<EVENT_CHECK>(TestEvents::DelegateOf<EVENT_CHECK>::Make<&Base::Check>(&b));
+        bool result = true;
+        events.CallAll<EVENT_CHECK>(1, result);
+        REQUIRE(result);
+        events.CallAll<EVENT_CHECK>(0, result);
+        REQUIRE(!result);
+    }
+
+    SECTION("Unsubscribe")
+    {
+        TestEvents events;
+        Base a;
+        Base b;
+        auto i1 = events.Subscribe<EVENT_NOTIFY>(TestEvents::DelegateOf<EVENT_NOTIFY>::Make<&Base::Notify>(&a));
+        events.Subscribe<EVENT_MUL>(TestEvents::DelegateOf<EVENT_MUL>::Make<&Base::Mul>(&a));
+        events.Subscribe<EVENT_NOTIFY>(TestEvents::DelegateOf<EVENT_NOTIFY>::Make<&Base::Notify>(&b));
+        REQUIRE(events.GetSubscriberCount<EVENT_NOTIFY>() == 2);
+        events.CallAll<EVENT_NOTIFY>();
+        REQUIRE(a.notified == 1);
+        REQUIRE(b.notified == 1);
+
+        events.Unsubscribe<EVENT_NOTIFY>(i1);
+        REQUIRE(events.GetSubscriberCount<EVENT_NOTIFY>() == 1);
+        events.CallAll<EVENT_NOTIFY>();
+        REQUIRE(a.notified == 1);
+        REQUIRE(b.notified == 2);
+        // Other events are not affected
+        REQUIRE(events.CallOne<EVENT_MUL>(2, 2) == 4);
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include <sa/LruCache.h>
+#include <string>
+
+TEST_CASE("LruCache Get/Put")
+{
+    sa::LruCache<int, std::string> cache(2);
+    REQUIRE(cache.Get(1) == nullptr);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    REQUIRE(cache.Size() == 2);
+    REQUIRE(*cache.Get(1) == "one");
+    REQUIRE(*cache.Get(2) == "two");
+    cache.Put(2, "zwei");
+    REQUIRE(cache.Size() == 2);
+    REQUIRE(*cache.Get(2) == "zwei");
+}
+
+TEST_CASE("LruCache evict")
+{
+    sa::LruCache<int, int> cache(2);
+    cache.Put(1, 1);
+    cache.Put(2, 2);
+    // 1 is now the most recently used
+    REQUIRE(cache.Get(1) != nullptr);
+    cache.Put(3, 3);
+    REQUIRE(cache.Size() == 2);
+    REQUIRE(cache.Get(2) == nullptr);
+    REQUIRE(*cache.Get(1) == 1);
+    REQUIRE(*cache.Get(3) == 3);
+}
+
+TEST_CASE("LruCache Erase")
+{
+    sa::LruCache<int, int> cache(4);
+    cache.Put(1, 1);
+    cache.Put(2, 2);
+    REQUIRE(cache.Erase(1));
+    REQUIRE(!cache.Erase(1));
+    REQUIRE(cache.Get(1) == nullptr);
+    REQUIRE(cache.Size() == 1);
+    cache.Clear();
+    REQUIRE(cache.Size() == 0);
+    REQUIRE(cache.Get(2) == nullptr);
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+#include <sa/Registry.h>
+#include <map>
+#include <memory>
+
+namespace {
+
+struct Object
+{
+    uint32_t id;
+    uint32_t ticks{ 0 };
+    explicit Object(uint32_t _id) : id(_id) { }
+    void Update() { ++ticks; }
+};
+
+}
+
+TEST_CASE("Registry Add/Get")
+{
+    sa::Registry<uint32_t, std::shared_ptr<Object>> reg;
+    REQUIRE(reg.Add(3, std::make_shared<Object>(3)));
+    REQUIRE(reg.Add(1, std::make_shared<Object>(1)));
+    REQUIRE(reg.Add(2, std::make_shared<Object>(2)));
+    REQUIRE(!reg.Add(2, std::make_shared<Object>(2)));
+    REQUIRE(reg.Size() == 3);
+    REQUIRE(reg.Get(4) == nullptr);
+    REQUIRE((*reg.Get(2))->id == 2);
+
+    // Ordered by key
+    uint32_t last = 0;
+    reg.VisitAll([&](const std::shared_ptr<Object>& o)
+    {
+        REQUIRE(o->id > last);
+        last = o->id;
+        return Iteration::Continue;
+    });
+    REQUIRE(last == 3);
+
+    REQUIRE(reg.Remove(2));
+    REQUIRE(!reg.Remove(2));
+    REQUIRE(reg.Size() == 2);
+    REQUIRE(!reg.Contains(2));
+}
+
+TEST_CASE("Registry deferred changes")
+{
+    sa::Registry<uint32_t, std::shared_ptr<Object>> reg;
+    for (uint32_t i = 1; i <= 10; ++i)
+        reg.Add(i, std::make_shared<Object>(i));
+
+    std::weak_ptr<Object> removed = *reg.Get(5);
+    unsigned visited = 0;
+    reg.VisitAll([&](const std::shared_ptr<Object>& o)
+    {
+        ++visited;
+        if (o->id == 2)
+        {
+            // Not visited because it was removed
+            REQUIRE(reg.Remove(5));
+            // Alive until the iteration ends
+            REQUIRE(!removed.expired());
+            REQUIRE(!reg.Contains(5));
+            // Not visited because it was added while iterating, but it can be found
+            REQUIRE(reg.Add(11, std::make_shared<Object>(11)));
+            REQUIRE(reg.Contains(11));
+            // Added and removed again
+            REQUIRE(reg.Add(0, std::make_shared<Object>(0)));
+            REQUIRE(reg.Remove(0));
+        }
+        return Iteration::Continue;
+    });
+    REQUIRE(visited == 9);
+    REQUIRE(removed.expired());
+    REQUIRE(reg.Size() == 10);
+    REQUIRE(reg.Contains(11));
+    REQUIRE(!reg.Contains(0));
+
+    visited = 0;
+    reg.VisitAll([&](const std::shared_ptr<Object>&)
+    {
+        ++visited;
+        return Iteration::Continue;
+    });
+    REQUIRE(visited == 10);
+}
+
+TEST_CASE("Registry tick benchmark")
+{
+    for (uint32_t count : { 100u, 1000u, 10000u })
+    {
+        std::map<uint32_t, std::shared_ptr<Object>> map;
+        sa::Registry<uint32_t, std::shared_ptr<Object>> reg;
+        for (uint32_t i = 1; i <= count; ++i)
+        {
+            auto o = std::make_shared<Object>(i);
+            map.emplace(i, o);
+            reg.Add(i, o);
+        }
+
+        const std::string suffix = " " + std::to_string(count) + " objects";
+        // What Game::Update() did before: copy the list to survive insertions
+        BENCHMARK("std::map copy" + suffix)
+        {
+            const auto copy = map;
+            for (const auto& o : copy)
+                o.second->Update();
+        }
+        BENCHMARK("Registry" + suffix)
+        {
+            reg.VisitAll([](const std::shared_ptr<Object>& o)
+            {
+                o->Update();
+                return Iteration::Continue;
+            });
+        }
+    }
+}
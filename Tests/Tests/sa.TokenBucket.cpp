@@ -0,0 +1,59 @@
+/**
+ * Copyright 2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include <catch.hpp>
+
+#include <sa/TokenBucket.h>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("TokenBucket unlimited")
+{
+    sa::TokenBucket<> bucket;
+    REQUIRE(bucket.IsUnlimited());
+    REQUIRE(bucket.Consume(1000000000) == 0ms);
+}
+
+TEST_CASE("TokenBucket burst")
+{
+    const auto now = std::chrono::steady_clock::now();
+    sa::TokenBucket<> bucket(1000, 0, now);
+    // Full bucket
+    REQUIRE(bucket.Consume(1000, now) == 0ms);
+    // Empty, 500 tokens at 1000/sec
+    const auto wait = bucket.Consume(500, now);
+    REQUIRE(wait >= 500ms);
+    REQUIRE(wait <= 501ms);
+}
+
+TEST_CASE("TokenBucket refill")
+{
+    const auto now = std::chrono::steady_clock::now();
+    sa::TokenBucket<> bucket(1000, 100, now);
+    REQUIRE(bucket.Consume(100, now) == 0ms);
+    REQUIRE(bucket.GetTokens(now) == Approx(0.0));
+    REQUIRE(bucket.GetTokens(now + 50ms) == Approx(50.0));
+    // Does not exceed burst
+    REQUIRE(bucket.GetTokens(now + 10s) == Approx(100.0));
+    REQUIRE(bucket.Consume(100, now + 10s) == 0ms);
+    REQUIRE(bucket.Consume(1, now + 10s) > 0ms);
+}
@@ -54,6 +54,8 @@ void Agent::Update(uint32_t timeElapsed)
 void Agent::SetBehavior(std::shared_ptr<Root> node)
 {
     root_ = node;
+    // The state of the previous tree is meaningless for the new tree
+    context_.Resize(root_ ? root_->GetNodeCount() : 0);
 }
 
 std::shared_ptr<Root> Agent::GetBehavior() const
@@ -46,6 +46,8 @@ using AgentIds = std::vector<Id>;
 // Once the BT is loaded it must not be modified, so the iterators are not invalidated.
 // This is a bit unflexible when an application needs to store other types, but
 // you could create a second context in the subclass.
+// The context has one slot per Node of the behavior tree, it is sized in
+// Agent::SetBehavior().
 class AgentContext : public Context<id_type, node_status_type, limit_type, timer_type, counter_type, Nodes::iterator>
 {
 public:
@@ -34,6 +34,9 @@ namespace AI {
 
 typedef uint32_t Id;
 static constexpr Id INVALID_ID = std::numeric_limits<Id>::max();
+// Dense index of a Node inside its tree, used to address the Agent's context.
+typedef uint32_t Index;
+static constexpr Index INVALID_INDEX = std::numeric_limits<Index>::max();
 using ArgumentsType = std::vector<std::string>;
 
 template <typename T, std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value, int> = 0>
@@ -22,12 +22,14 @@
 #pragma once
 
 #include "AiDefines.h"
-#include <unordered_map>
+#include <vector>
 #include <tuple>
 #include <sa/Iteration.h>
 
 namespace AI {
 
+// Stores values of different types per Node. Values are addressed by the dense
+// Node index, so each type is just an array with one slot per Node of the tree.
 template <typename... Types>
 class Context
 {
@@ -35,7 +37,9 @@ private:
     template<typename T>
     struct Values
     {
-        std::unordered_map<Id, T> values;
+        std::vector<T> values;
+        // One byte per slot, vector<bool> is slower to access.
+        std::vector<uint8_t> set;
     };
 
     std::tuple<Values<Types>...> values_;
@@ -62,54 +66,78 @@ private:
         constexpr auto index = FindElement<Values<T>>::value;
         return std::get<index>(values_);
     }
-public:
     template <typename T>
-    bool Has(Id id) const
+    static void ResizeValues(Values<T>& vals, size_t size)
     {
-        const auto& vals = GetValuesT<T>().values;
-        const auto it = vals.find(id);
-        return it != vals.end();
+        vals.values.assign(size, T{});
+        vals.set.assign(size, 0);
     }
-    template <typename T>
-    T Get(Id id) const
+    void Grow(size_t size)
     {
-        return GetValuesT<T>().values[id];
+        std::apply([size](auto&... vals)
+        {
+            ((vals.values.resize(size), vals.set.resize(size, 0)), ...);
+        }, values_);
+    }
+public:
+    // Allocate slots for all nodes and drop all values.
+    void Resize(size_t size)
+    {
+        std::apply([size](auto&... vals) { (ResizeValues(vals, size), ...); }, values_);
+    }
+    size_t GetSize() const
+    {
+        return std::get<0>(values_).set.size();
     }
     template <typename T>
-    T& Get(Id id)
+    bool Has(Index index) const
     {
-        return GetValuesT<T>().values[id];
+        const auto& vals = GetValuesT<T>();
+        return index < vals.set.size() && vals.set[index] != 0;
     }
     template <typename T>
-    const T& Get(Id id) const
+    T Get(Index index) const
     {
-        return GetValuesT<T>().values[id];
+        const auto& vals = GetValuesT<T>();
+        if (index >= vals.values.size())
+            return T{};
+        return vals.values[index];
     }
     template <typename T>
-    void Set(Id id, T value)
+    void Set(Index index, T value)
     {
-        GetValuesT<T>().values[id] = value;
+        if (index == INVALID_INDEX)
+            return;
+        // Only happens when the Agent was not sized for the tree, e.g. a tree
+        // that was numbered as a sub tree of another tree.
+        if (index >= GetSize())
+            Grow(index + 1);
+        auto& vals = GetValuesT<T>();
+        vals.values[index] = value;
+        vals.set[index] = 1;
     }
     template <typename T>
-    void Delete(Id id)
+    void Delete(Index index)
     {
-        auto& vals = GetValuesT<T>().values;
-        auto it = vals.find(id);
-        if (it != vals.end())
-            vals.erase(it);
+        auto& vals = GetValuesT<T>();
+        if (index >= vals.set.size())
+            return;
+        vals.values[index] = T{};
+        vals.set[index] = 0;
     }
     template <typename T, typename Callback>
     void VisitTypes(Callback&& callback) const
     {
-        const auto& vals = GetValuesT<T>().values;
-        for (const auto& val : vals)
+        const auto& vals = GetValuesT<T>();
+        for (size_t i = 0; i < vals.set.size(); ++i)
         {
-            // Iteration callback(Id id, T value)
-            if (callback(val.first, val.second) == Iteration::Break)
+            if (vals.set[i] == 0)
+                continue;
+            // Iteration callback(Index index, T value)
+            if (callback(static_cast<Index>(i), vals.values[i]) == Iteration::Break)
                 break;
         }
     }
 };
 
 }
-
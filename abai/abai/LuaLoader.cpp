@@ -150,6 +150,7 @@ std::shared_ptr<Root> LuaLoader::LoadString(const std::string& value)
         return std::shared_ptr<Root>();
 
     luaState["init"](result);
+    result->AssignIndices();
 
     return result;
 }
@@ -175,6 +176,7 @@ std::shared_ptr<Root> LuaLoader::LoadFile(const std::string& fileName)
 
     // Call the init() function which passes in the root node
     luaState["init"](result);
+    result->AssignIndices();
 
     return result;
 }
@@ -53,7 +53,7 @@ Node::Status Node::Execute(Agent& agent, uint32_t)
 
 Node::Status Node::ReturnStatus(Agent& agent, Node::Status value)
 {
-    agent.context_.Set<node_status_type>(id_, value);
+    agent.context_.Set<node_status_type>(index_, value);
     return value;
 }
 
@@ -84,6 +84,8 @@ public:
 protected:
     // Node ID managed by the library.
     Id id_;
+    // Position of this node in the tree, assigned by the loader.
+    Index index_{ INVALID_INDEX };
     std::string name_;
     std::shared_ptr<Condition> condition_;
     // Store the result in the Agent's context and return it.
@@ -92,6 +94,8 @@ protected:
 public:
     virtual ~Node();
     Id GetId() const { return id_; }
+    Index GetIndex() const { return index_; }
+    void SetIndex(Index value) { index_ = value; }
 
     virtual const char* GetClassName() const = 0;
     const std::string& GetName() const { return name_; }
@@ -28,6 +28,20 @@ Root::Root() :
     Decorator(ArgumentsType{})
 { }
 
+void Root::AssignIndices()
+{
+    Index index = 0;
+    SetIndex(index++);
+    ForEachChildNode(*this, [&](const Node&, const Node& child)
+    {
+        // The tree is not yet shared with any Agent, so it's safe to modify it
+        // here. A sub tree (another Root) is numbered as part of this tree.
+        const_cast<Node&>(child).SetIndex(index++);
+        return Iteration::Continue;
+    });
+    nodeCount_ = index;
+}
+
 Node::Status Root::Execute(Agent& agent, uint32_t timeElapsed)
 {
     if (!child_)
@@ -27,10 +27,16 @@ namespace AI {
 
 class Root : public Decorator
 {
+private:
+    size_t nodeCount_{ 0 };
 public:
     Root();
     const char* GetClassName() const override { return "Root"; }
     Node::Status Execute(Agent& agent, uint32_t timeElapsed) override;
+    // Number all nodes of this tree, so an Agent can store the state of the nodes
+    // in flat arrays. Must be called once the tree is complete.
+    void AssignIndices();
+    size_t GetNodeCount() const { return nodeCount_; }
 };
 
 }
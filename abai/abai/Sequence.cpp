@@ -36,7 +36,7 @@ Node::Status Sequence::Execute(Agent& agent, uint32_t timeElapsed)
     if (Node::Execute(agent, timeElapsed) == Status::CanNotExecute)
         return ReturnStatus(agent, Status::CanNotExecute);
 
-    Nodes::iterator nIt = agent.context_.Has<Nodes::iterator>(id_) ? agent.context_.Get<Nodes::iterator>(id_) : children_.begin();
+    Nodes::iterator nIt = agent.context_.Has<Nodes::iterator>(index_) ? agent.context_.Get<Nodes::iterator>(index_) : children_.begin();
 
     while (nIt != children_.end())
     {
@@ -45,9 +45,9 @@ Node::Status Sequence::Execute(Agent& agent, uint32_t timeElapsed)
         if (status != Status::Finished)
             return ReturnStatus(agent, status);
         ++nIt;
-        agent.context_.Set(id_, nIt);
+        agent.context_.Set(index_, nIt);
     }
-    agent.context_.Delete<Nodes::iterator>(id_);
+    agent.context_.Delete<Nodes::iterator>(index_);
     return ReturnStatus(agent, Status::Finished);
 }
 
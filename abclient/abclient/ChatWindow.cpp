@@ -666,17 +666,18 @@ void ChatWindow::HandleServerMessageInstances(VariantMap& eventData)
     using namespace Events::ServerMessage;
     const String& instances = eventData[P_DATA].GetString();
     auto instVec = instances.Split(';');
-    kainjow::mustache::mustache tpl{ "{{instance}}: {{name}} ({{game}})" };
+    kainjow::mustache::mustache tpl{ "{{instance}}: {{name}} ({{game}}) GC {{gc}} us" };
     for (auto& inst : instVec)
     {
         auto instData = inst.Split(',');
-        if (instData.Size() != 3)
+        if (instData.Size() != 4)
             continue;
 
         kainjow::mustache::data data;
         data.set("instance", std::string(instData[0].CString(), instData[0].Length()));
         data.set("game", std::string(instData[1].CString(), instData[1].Length()));
         data.set("name", std::string(instData[2].CString(), instData[2].Length()));
+        data.set("gc", std::string(instData[3].CString(), instData[3].Length()));
         std::string t = tpl.render(data);
         AddLine(String(t.c_str()), "ChatLogServerInfoText");
     }
@@ -25,6 +25,7 @@
 #include "Server.h"
 #include <abscommon/Logo.h>
 #include <abdb/Database.h>
+#include <abdb/DatabasePool.h>
 #include <abscommon/StringUtils.h>
 #include <abscommon/SimpleConfigManager.h>
 #include <abscommon/FileUtils.h>
@@ -42,16 +43,20 @@ Application::Application() :
     ServerApp::ServerApp(),
     listenIp_(0),
     maxSize_(0),
+    cacheShards_(0),
+    ioThreads_(0),
+    dbPoolSize_(0),
     readonly_(false),
     ioService_(),
     server_(nullptr),
     flushInterval_(FLUSH_CACHE_MS),
-    cleanInterval_(CLEAN_CACHE_MS)
+    cleanInterval_(CLEAN_CACHE_MS),
+    writeLatency_(WRITE_LATENCY_MS),
+    writeBatchSize_(WRITE_BATCH_SIZE)
 {
     serverType_ = AB::Entities::ServiceTypeDataServer;
     Subsystems::Instance.CreateSubsystem<Asynch::Dispatcher>();
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
-    Subsystems::Instance.CreateSubsystem<Asynch::ThreadPool>(1);
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
 
     std::stringstream dbDrivers;
@@ -177,6 +182,10 @@ bool Application::LoadConfig()
         serverHost_ = config->GetGlobalString("data_host", "");
     if (maxSize_ == 0)
         maxSize_ = static_cast<size_t>(config->GetGlobalInt("max_size", 0ll));
+    if (cacheShards_ == 0)
+        cacheShards_ = static_cast<size_t>(config->GetGlobalInt("cache_shards", static_cast<int64_t>(DEFAULT_CACHE_SHARDS)));
+    if (ioThreads_ == 0)
+        ioThreads_ = static_cast<size_t>(config->GetGlobalInt("io_threads", 0ll));
     if (!readonly_)
         readonly_ = config->GetGlobalBool("read_only", false);
 
@@ -200,6 +209,10 @@ bool Application::LoadConfig()
 
     flushInterval_ = static_cast<uint32_t>(config->GetGlobalInt("flush_interval", flushInterval_));
     cleanInterval_ = static_cast<uint32_t>(config->GetGlobalInt("clean_interval", cleanInterval_));
+    writeLatency_ = static_cast<uint32_t>(config->GetGlobalInt("write_latency", writeLatency_));
+    writeBatchSize_ = static_cast<size_t>(config->GetGlobalInt("write_batch_size", static_cast<int64_t>(writeBatchSize_)));
+    dbPoolSize_ = static_cast<size_t>(config->GetGlobalInt("db_pool_size", 0ll));
+    journalDir_ = config->GetGlobalString("journal_dir", "");
 
     if (serverPort_ == 0)
     {
@@ -223,6 +236,9 @@ void Application::PrintServerInfo()
     LOG_INFO << "  Listening: " << Utils::ConvertIPToString(listenIp_) << ":" << serverPort_ << std::endl;
     LOG_INFO << "  Background threads: " << GetSubsystem<Asynch::ThreadPool>()->GetNumThreads() << std::endl;
     LOG_INFO << "  Cache size: " << Utils::ConvertSize(maxSize_) << std::endl;
+    LOG_INFO << "  Cache shards: " << cacheShards_ << std::endl;
+    LOG_INFO << "  Write latency: " << writeLatency_ << "ms, batch size " << writeBatchSize_ << std::endl;
+    LOG_INFO << "  Journal dir: " << (journalDir_.empty() ? "(empty)" : journalDir_) << std::endl;
     LOG_INFO << "  Log dir: " << (IO::Logger::logDir_.empty() ? "(empty)" : IO::Logger::logDir_) << std::endl;
     LOG_INFO << "  Readonly mode: " << (readonly_ ? "TRUE" : "false") << std::endl;
     LOG_INFO << "  Allowed IPs: ";
@@ -250,13 +266,14 @@ void Application::PrintServerInfo()
     LOG_INFO << "  Host: " << DB::Database::dbHost_ << std::endl;
     LOG_INFO << "  Name: " << DB::Database::dbName_ << std::endl;
     LOG_INFO << "  Port: " << DB::Database::dbPort_ << std::endl;
+    LOG_INFO << "  Connections: " << GetSubsystem<DB::DatabasePool>()->GetSize() << std::endl;
     LOG_INFO << "  User: " << DB::Database::dbUser_ << std::endl;
     LOG_INFO << "  Password: " << (DB::Database::dbPass_.empty() ? "(empty)" : "***********") << std::endl;
 }
 
 int Application::GetDatabaseVersion()
 {
-    auto* db = GetSubsystem<DB::Database>();
+    auto db = GetSubsystem<DB::DatabasePool>()->Acquire();
     std::ostringstream query;
 #ifdef USE_PGSQL
     if (DB::Database::driver_ == "pgsql")
@@ -343,6 +360,32 @@ bool Application::CheckDatabaseVersion()
     return true;
 }
 
+void Application::HeartBeatTask()
+{
+    auto& provider = server_->GetStorageProvider();
+    AB::Entities::Service serv;
+    serv.uuid = GetServerId();
+    if (provider.EntityRead(serv))
+    {
+        // Load is the share of cache shards waiting for the database
+        const auto stats = provider.GetQueueDepths();
+        size_t busy = std::count_if(stats.begin(), stats.end(), [](uint32_t depth) { return depth != 0; });
+        serv.load = static_cast<uint8_t>(busy * 100 / std::max<size_t>(1, stats.size()));
+        serv.stats = provider.GetStatsString();
+        serv.heartbeat = Utils::Tick();
+        provider.EntityUpdate(serv);
+    }
+    else
+        LOG_ERROR << "Error reading service " << GetServerId() << std::endl;
+
+    if (running_)
+    {
+        GetSubsystem<Asynch::Scheduler>()->Add(
+            Asynch::CreateScheduledTask(AB::Entities::HEARTBEAT_INTERVAL, std::bind(&Application::HeartBeatTask, this))
+        );
+    }
+}
+
 bool Application::Initialize(const std::vector<std::string>& args)
 {
     if (!ServerApp::Initialize(args))
@@ -361,22 +404,29 @@ bool Application::Initialize(const std::vector<std::string>& args)
     }
     LOG_INFO << "[done]" << std::endl;
 
+    // Threads doing the DB work. 0 = choose depending on the number of CPUs.
+    if (ioThreads_ == 0)
+        Subsystems::Instance.CreateSubsystem<Asynch::ThreadPool>();
+    else
+        Subsystems::Instance.CreateSubsystem<Asynch::ThreadPool>(ioThreads_);
+
     if (!IO::Logger::logDir_.empty())
         IO::Logger::Close();
 
     LOG_INFO << "Connecting to database...";
-    DB::Database* db = DB::Database::CreateInstance(DB::Database::driver_,
+    // 0 = as many as there are threads doing DB work
+    if (dbPoolSize_ == 0)
+        dbPoolSize_ = GetSubsystem<Asynch::ThreadPool>()->GetNumThreads();
+    Subsystems::Instance.CreateSubsystem<DB::DatabasePool>(dbPoolSize_);
+    if (!GetSubsystem<DB::DatabasePool>()->Open(DB::Database::driver_,
         DB::Database::dbHost_, DB::Database::dbPort_,
         DB::Database::dbUser_, DB::Database::dbPass_,
-        DB::Database::dbName_
-    );
-    if (!db || !db->IsConnected())
+        DB::Database::dbName_))
     {
         LOG_INFO << "[FAIL]" << std::endl;
         LOG_ERROR << "Database connection failed" << std::endl;
         return false;
     }
-    Subsystems::Instance.RegisterSubsystem<DB::Database>(db);
     LOG_INFO << "[done]" << std::endl;
     if (!CheckDatabaseVersion())
         return false;
@@ -392,10 +442,14 @@ void Application::Run()
     GetSubsystem<Asynch::Scheduler>()->Start();
     GetSubsystem<Asynch::ThreadPool>()->Start();
 
-    server_ = std::make_unique<Server>(ioService_, listenIp_, serverPort_, maxSize_, readonly_, whiteList_);
+    server_ = std::make_unique<Server>(ioService_, listenIp_, serverPort_, maxSize_, cacheShards_, readonly_, whiteList_);
     auto& provider = server_->GetStorageProvider();
     provider.flushInterval_ = flushInterval_;
     provider.cleanInterval_ = cleanInterval_;
+    provider.writeLatency_ = writeLatency_;
+    provider.writeBatchSize_ = writeBatchSize_;
+    if (!journalDir_.empty() && !provider.OpenJournal(journalDir_))
+        LOG_ERROR << "Unable to open journal in " << journalDir_ << ", changes are lost on a crash" << std::endl;
 
     AB::Entities::Service serv;
     serv.uuid = GetServerId();
@@ -419,6 +473,9 @@ void Application::Run()
     provider.EntityInvalidate(sl);
 
     running_ = true;
+    GetSubsystem<Asynch::Scheduler>()->Add(
+        Asynch::CreateScheduledTask(AB::Entities::HEARTBEAT_INTERVAL, std::bind(&Application::HeartBeatTask, this))
+    );
     LOG_INFO << "Server is running" << std::endl;
     ioService_.run();
 }
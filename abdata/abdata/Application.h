@@ -32,17 +32,24 @@ class Application final : public ServerApp
 private:
     uint32_t listenIp_;
     size_t maxSize_;
+    size_t cacheShards_;
+    size_t ioThreads_;
+    size_t dbPoolSize_;
     bool readonly_;
     asio::io_service ioService_;
     std::unique_ptr<Server> server_;
     uint32_t flushInterval_;
     uint32_t cleanInterval_;
+    uint32_t writeLatency_;
+    size_t writeBatchSize_;
+    std::string journalDir_;
     Net::IpList whiteList_;
     bool LoadConfig();
     void PrintServerInfo();
     void ShowLogo();
     bool CheckDatabaseVersion();
     int GetDatabaseVersion();
+    void HeartBeatTask();
 protected:
     bool ParseCommandLine() override;
     void ShowVersion() override;
@@ -40,6 +40,12 @@ void CacheIndex::Refresh(const IO::DataKey& key)
 {
     uint64_t next = GetNextRank();
     auto keyItr = dataItems_.find(key);
+    if (keyItr == dataItems_.end())
+    {
+        // Taken by Next() while it's being evicted
+        dataItems_.insert({ key, next });
+        return;
+    }
     dataItems_.modify(keyItr, [next](DataItem& d)
     {
         d.rank = next;
@@ -58,6 +58,7 @@ public:
     void Refresh(const IO::DataKey&);
     void Delete(const IO::DataKey&);
     void Clear();
+    size_t Size() const { return dataItems_.size(); }
 private:
     uint64_t GetNextRank()
     {
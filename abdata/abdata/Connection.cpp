@@ -32,8 +32,7 @@ Connection::Connection(asio::io_service& io_service, ConnectionManager& manager,
     maxKeySize_(maxKey),
     socket_(io_service),
     connectionManager_(manager),
-    storageProvider_(storage),
-    opcode_(IO::OpCodes::None)
+    storageProvider_(storage)
 { }
 
 asio::ip::tcp::socket& Connection::GetSocket()
@@ -43,407 +42,393 @@ asio::ip::tcp::socket& Connection::GetSocket()
 
 void Connection::Start()
 {
-    data_.reset(new std::vector<uint8_t>(3));
     auto self(shared_from_this());
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(3),
+    asio::async_read(socket_, asio::buffer(requestHeader_), asio::transfer_at_least(requestHeader_.size()),
         [this, self](const asio::error_code& error, size_t /* bytes_transferred */)
     {
-        if (!error)
+        if (error)
         {
-            opcode_ = static_cast<IO::OpCodes>(data_->at(0));
-            const uint16_t keySize = ToInt16(*data_, 1);
-            if (keySize <= maxKeySize_)
-                StartReadKey(keySize);
-            else
-                SendStatusAndRestart(IO::ErrorCodes::KeyTooBig, "Supplied key is too big. Maximum allowed key size is: " + std::to_string(maxKeySize_));
+            HandleNetworkError(error);
+            return;
         }
-        else
+        request_ = std::make_shared<Request>();
+        request_->opCode = static_cast<IO::OpCodes>(requestHeader_[0]);
+        request_->id = ToInt32(&requestHeader_[1]);
+        const uint16_t keySize = ToInt16(&requestHeader_[5]);
+        if (keySize > maxKeySize_)
         {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
+            // We can't skip the rest of the request, so the client must reconnect
+            LOG_ERROR << "Supplied key is too big. Maximum allowed key size is: " << maxKeySize_ << std::endl;
             connectionManager_.Stop(self);
+            return;
         }
+        request_->key.resize(keySize);
+        StartReadKey();
     });
 }
 
-void Connection::StartReadKey(uint16_t keySize)
+void Connection::StartReadKey()
 {
-    key_.resize(keySize);
     auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(key_.data_), asio::transfer_at_least(keySize),
-        [this, self, keySize](const asio::error_code& error, size_t byteTransferred)
+    asio::async_read(socket_, asio::buffer(request_->key.data_), asio::transfer_at_least(request_->key.size()),
+        [this, self](const asio::error_code& error, size_t /* bytes_transferred */)
     {
-        if (!error)
+        if (error)
         {
-            if (static_cast<uint16_t>(byteTransferred) != keySize)
-                SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Data sent is not equal to the expected size");
-            else
-                StartClientRequestedOp();
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
+            HandleNetworkError(error);
+            return;
         }
+        StartReadDataSize();
     });
 }
 
-void Connection::StartCreateOperation()
+void Connection::StartReadDataSize()
 {
-    data_.reset(new std::vector<uint8_t>(4));
     auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
+    asio::async_read(socket_, asio::buffer(dataHeader_), asio::transfer_at_least(dataHeader_.size()),
+        [this, self](const asio::error_code& error, size_t /* bytes_transferred */)
     {
-        if (!error)
+        if (error)
         {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new std::vector<uint8_t>(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleCreateReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                SendStatusAndRestart(IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
+            HandleNetworkError(error);
+            return;
         }
-        else
+        const uint32_t size = ToInt32(dataHeader_.data());
+        if (size > maxDataSize_)
         {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
+            LOG_ERROR << "The data sent is too big. Maximum data allowed is: " << maxDataSize_ << std::endl;
             connectionManager_.Stop(self);
+            return;
         }
+        StartReadData(size);
     });
 }
 
-void Connection::StartUpdateDataOperation()
+void Connection::StartReadData(uint32_t size)
 {
-    data_.reset(new std::vector<uint8_t>(4));
+    request_->data = std::make_shared<std::vector<uint8_t>>(size);
+    if (size == 0)
+    {
+        AddTask(&Connection::Execute, std::move(request_));
+        // Don't wait for the result, read the next request
+        Start();
+        return;
+    }
     auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
+    asio::async_read(socket_, asio::buffer(*request_->data), asio::transfer_at_least(size),
+        [this, self](const asio::error_code& error, size_t /* bytes_transferred */)
     {
-        if (!error)
+        if (error)
         {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new std::vector<uint8_t>(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleUpdateReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                SendStatusAndRestart(IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
+            HandleNetworkError(error);
+            return;
         }
+        AddTask(&Connection::Execute, std::move(request_));
+        Start();
     });
 }
 
-void Connection::StartReadOperation()
+void Connection::HandleNetworkError(const asio::error_code& error)
 {
-    data_.reset(new std::vector<uint8_t>(4));
-    auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
+    if (error != asio::error::operation_aborted)
+        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
+    connectionManager_.Stop(shared_from_this());
+}
+
+void Connection::Stop()
+{
+    asio::error_code error;
+    socket_.close(error);
+}
+
+void Connection::Execute(std::shared_ptr<Request> request)
+{
+    // Dispatcher thread. Requests served from the cache run right away, others
+    // wait for the DB on the ThreadPool.
+    if (request->opCode == IO::OpCodes::ReadMany)
     {
-        if (!error && bytes_transferred >= 4)
-        {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new std::vector<uint8_t>(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleReadReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                SendStatusAndRestart(IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
-        }
-        else
+        auto many = std::make_shared<ManyRequest>();
+        if (!ParseReadMany(*request, *many))
         {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
+            SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Malformed request");
+            return;
         }
-    });
+        // The keys are owned by the request, moving the pointer doesn't move them
+        const std::vector<IO::DataKey>& keys = many->keys;
+        storageProvider_.ScheduleMany(keys,
+            std::bind(&Connection::ExecuteReadMany, shared_from_this(), std::move(many)));
+        return;
+    }
+    const IO::DataKey& key = request->key;
+    const IO::OpCodes opCode = request->opCode;
+    const std::vector<uint8_t>& data = *request->data;
+    storageProvider_.Schedule(key, opCode, data,
+        std::bind(&Connection::ExecuteRequest, shared_from_this(), std::move(request)));
 }
 
-void Connection::StartDeleteOperation()
+void Connection::ExecuteRequest(std::shared_ptr<Request> request)
 {
-    if (storageProvider_.Delete(key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-    else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
+    switch (request->opCode)
+    {
+    case IO::OpCodes::Create:
+        ExecuteCreate(*request);
+        break;
+    case IO::OpCodes::Update:
+        ExecuteUpdate(*request);
+        break;
+    case IO::OpCodes::Read:
+        ExecuteRead(*request);
+        break;
+    case IO::OpCodes::Delete:
+        ExecuteDelete(*request);
+        break;
+    case IO::OpCodes::Invalidate:
+        ExecuteInvalidate(*request);
+        break;
+    case IO::OpCodes::Preload:
+        ExecutePreload(*request);
+        break;
+    case IO::OpCodes::Exists:
+        ExecuteExists(*request);
+        break;
+    case IO::OpCodes::Clear:
+        ExecuteClear(*request);
+        break;
+    case IO::OpCodes::Status:
+    case IO::OpCodes::Data:
+        LOG_ERROR << "Status and Data OP Codes are invalid here" << std::endl;
+        SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
+        break;
+    default:
+    {
+        asio::error_code error;
+        const auto ep = socket_.remote_endpoint(error);
+        LOG_ERROR << "Invalid OP Code " << static_cast<int>(request->opCode) << " from " <<
+            ep.address().to_string() << ":" << ep.port() << std::endl;
+        SendStatus(request->id, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
+        break;
+    }
+    }
 }
 
-void Connection::StartInvalidateOperation()
+void Connection::ExecuteCreate(const Request& request)
 {
-    if (storageProvider_.Invalidate(key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
+    if (request.data->empty())
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "No data");
+    else if (storageProvider_.Create(request.key, request.data))
+        SendStatus(request.id, IO::ErrorCodes::Ok, "OK");
     else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "Error");
 }
 
-void Connection::StartPreloadOperation()
+void Connection::ExecuteUpdate(const Request& request)
 {
-    if (storageProvider_.Preload(key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
+    if (request.data->empty())
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "No data");
+    else if (storageProvider_.Update(request.key, request.data))
+        SendStatus(request.id, IO::ErrorCodes::Ok, "OK");
     else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "Error");
 }
 
-void Connection::StartExistsOperation()
+void Connection::ExecuteRead(const Request& request)
 {
-    data_.reset(new std::vector<uint8_t>(4));
-    auto self = shared_from_this();
-    asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(4),
-        [this, self](const asio::error_code& error, size_t bytes_transferred)
+    if (request.data->empty())
     {
-        if (!error)
-        {
-            uint32_t size = ToInt32(*data_, 0);
-            if (size == 0)
-            {
-                LOG_ERROR << "Size = 0, bytes_transferred = " << bytes_transferred << std::endl;
-                return;
-            }
-            if (size <= maxDataSize_)
-            {
-                data_.reset(new std::vector<uint8_t>(size));
-                asio::async_read(socket_, asio::buffer(*data_), asio::transfer_at_least(size),
-                    std::bind(&Connection::HandleExistsReadRawData, self,
-                        std::placeholders::_1, std::placeholders::_2, size));
-            }
-            else
-                SendStatusAndRestart(IO::ErrorCodes::DataTooBig, "The data sent is too big. Maximum data allowed is: " + std::to_string(maxDataSize_));
-        }
-        else
-        {
-            LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-            connectionManager_.Stop(self);
-        }
-    });
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "No data");
+        return;
+    }
+    // On success data is the cached buffer, no need to copy it
+    SharedBuffer data = request.data;
+    if (!storageProvider_.Read(request.key, data))
+    {
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "Error");
+        return;
+    }
+    SendData(request.id, std::move(data));
 }
 
-void Connection::StartClearOperation()
+void Connection::ExecuteDelete(const Request& request)
 {
-    if (storageProvider_.Clear(key_))
-        SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
+    if (storageProvider_.Delete(request.key))
+        SendStatus(request.id, IO::ErrorCodes::Ok, "OK");
     else
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Other Error");
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
 }
 
-void Connection::Stop()
+void Connection::ExecuteInvalidate(const Request& request)
 {
-    socket_.close();
+    if (storageProvider_.Invalidate(request.key))
+        SendStatus(request.id, IO::ErrorCodes::Ok, "OK");
+    else
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
 }
 
-void Connection::HandleUpdateReadRawData(const asio::error_code& error,
-    size_t bytes_transferred, size_t expected)
+void Connection::ExecutePreload(const Request& request)
 {
-    if (!error)
-    {
-        if (bytes_transferred != expected)
-            SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        else
-        {
-            if (storageProvider_.Update(key_, data_))
-                SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-            else
-                SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Error");
-        }
-    }
+    if (storageProvider_.Preload(request.key))
+        SendStatus(request.id, IO::ErrorCodes::Ok, "OK");
     else
-    {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
-    }
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "Supplied key not found in cache");
 }
 
-void Connection::HandleCreateReadRawData(const asio::error_code& error,
-    size_t bytes_transferred, size_t expected)
+void Connection::ExecuteExists(const Request& request)
 {
-    if (!error)
-    {
-        if (bytes_transferred != expected)
-            SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        else
-        {
-            if (storageProvider_.Create(key_, data_))
-                SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-            else
-                SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Error");
-        }
-    }
+    if (request.data->empty())
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "No data");
+    else if (storageProvider_.Exists(request.key, request.data))
+        SendStatus(request.id, IO::ErrorCodes::Ok, "OK");
     else
-    {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
-    }
+        SendStatus(request.id, IO::ErrorCodes::NotExists, "Record does not exist");
 }
 
-void Connection::HandleReadReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected)
+void Connection::ExecuteClear(const Request& request)
 {
-    if (error)
-    {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
-        return;
-    }
-    if (!data_)
-    {
-        SendStatusAndRestart(IO::ErrorCodes::NoSuchKey, "Requested data not in cache");
-        return;
-    }
-    if (bytes_transferred != expected)
-    {
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        return;
-    }
-
-    if (!storageProvider_.Read(key_, data_))
-    {
-        SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Error");
-        return;
-    }
-
-    uint8_t header[] = {
-        static_cast<uint8_t>(IO::OpCodes::Data),
-        static_cast<uint8_t>(data_->size()),
-        static_cast<uint8_t>(data_->size() >> 8),
-        static_cast<uint8_t>(data_->size() >> 16),
-        static_cast<uint8_t>(data_->size() >> 24)
-    };
-
-    std::vector<asio::mutable_buffer> bufs = {
-        asio::buffer(header),
-        asio::buffer(*data_.get())
-    };
-    SendResponseAndStart(bufs, data_->size() + 4);
+    if (storageProvider_.Clear(request.key))
+        SendStatus(request.id, IO::ErrorCodes::Ok, "OK");
+    else
+        SendStatus(request.id, IO::ErrorCodes::OtherErrors, "Other Error");
 }
 
-void Connection::HandleWriteReqResponse(const asio::error_code& error)
+bool Connection::ParseReadMany(const Request& request, ManyRequest& result)
 {
-    if (!error)
-        Start();
-    else
+    const std::string_view table = request.key.table();
+    const std::vector<uint8_t>& data = *request.data;
+    if (table.empty() || data.size() < 4)
+        return false;
+    const uint32_t count = ToInt32(data.data());
+    // Each record has at least a UUID and a size, don't trust count before reserving
+    if (count > (data.size() - 4) / (uuids::uuid::state_size + 4))
+        return false;
+    size_t pos = 4;
+    result.id = request.id;
+    result.keys.reserve(count);
+    result.data.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
     {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
+        if (pos + uuids::uuid::state_size + 4 > data.size())
+            return false;
+        const uuids::uuid id(data.begin() + static_cast<std::ptrdiff_t>(pos),
+            data.begin() + static_cast<std::ptrdiff_t>(pos + uuids::uuid::state_size));
+        pos += uuids::uuid::state_size;
+        const size_t size = ToInt32(&data[pos]);
+        pos += 4;
+        if (pos + size > data.size())
+            return false;
+        result.keys.emplace_back(std::string(table), id);
+        result.data.push_back(std::make_shared<std::vector<uint8_t>>(data.begin() + static_cast<std::ptrdiff_t>(pos),
+            data.begin() + static_cast<std::ptrdiff_t>(pos + size)));
+        pos += size;
     }
+    return true;
 }
 
-void Connection::HandleExistsReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected)
+void Connection::ExecuteReadMany(std::shared_ptr<ManyRequest> request)
 {
-    if (!error)
+    storageProvider_.ReadMany(request->keys, request->data);
+
+    size_t size = 4;
+    for (const auto& record : request->data)
+        size += 5 + (record ? record->size() : 0);
+    auto response = std::make_shared<std::vector<uint8_t>>();
+    response->reserve(size);
+    const auto appendInt32 = [&response](uint32_t value)
     {
-        if (bytes_transferred != expected)
-            SendStatusAndRestart(IO::ErrorCodes::OtherErrors, "Data size sent is not equal to data expected");
-        else
+        response->push_back(static_cast<uint8_t>(value));
+        response->push_back(static_cast<uint8_t>(value >> 8));
+        response->push_back(static_cast<uint8_t>(value >> 16));
+        response->push_back(static_cast<uint8_t>(value >> 24));
+    };
+    appendInt32(static_cast<uint32_t>(request->data.size()));
+    for (const auto& record : request->data)
+    {
+        if (!record)
         {
-            if (storageProvider_.Exists(key_, data_))
-                SendStatusAndRestart(IO::ErrorCodes::Ok, "OK");
-            else
-                SendStatusAndRestart(IO::ErrorCodes::NotExists, "Record does not exist");
+            response->push_back(static_cast<uint8_t>(IO::ErrorCodes::NoSuchKey));
+            appendInt32(0);
+            continue;
         }
+        response->push_back(static_cast<uint8_t>(IO::ErrorCodes::Ok));
+        appendInt32(static_cast<uint32_t>(record->size()));
+        response->insert(response->end(), record->begin(), record->end());
     }
-    else
-    {
-        LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " << error.default_error_condition().message() << std::endl;
-        connectionManager_.Stop(shared_from_this());
-    }
+    SendData(request->id, std::move(response));
 }
 
-void Connection::StartClientRequestedOp()
+void Connection::SendStatus(uint32_t id, IO::ErrorCodes code, const std::string& message)
 {
-    // All this executed in dispatcher thread
-    switch (opcode_)
-    {
-    case IO::OpCodes::Create:
-        AddTask(&Connection::StartCreateOperation);
-        break;
-    case IO::OpCodes::Update:
-        AddTask(&Connection::StartUpdateDataOperation);
-        break;
-    case IO::OpCodes::Read:
-        AddTask(&Connection::StartReadOperation);
-        break;
-    case IO::OpCodes::Delete:
-        AddTask(&Connection::StartDeleteOperation);
-        break;
-    case IO::OpCodes::Invalidate:
-        AddTask(&Connection::StartInvalidateOperation);
-        break;
-    case IO::OpCodes::Preload:
-        AddTask(&Connection::StartPreloadOperation);
-        break;
-    case IO::OpCodes::Exists:
-        AddTask(&Connection::StartExistsOperation);
-        break;
-    case IO::OpCodes::Clear:
-        AddTask(&Connection::StartClearOperation);
-        break;
-    case IO::OpCodes::Status:
-    case IO::OpCodes::Data:
-        LOG_ERROR << "Status and Data OP Codes are invalid here" << std::endl;
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
-        break;
-    default:
-    {
-        const auto ep = socket_.remote_endpoint();
-        LOG_ERROR << "Invalid OP Code " << static_cast<int>(opcode_) << " from " <<
-            ep.address().to_string() << ":" << ep.port() << std::endl;
-        AddTask(&Connection::SendStatusAndRestart, IO::ErrorCodes::OtherErrors, "Invalid Opcode");
-        break;
-    }
-    }
+    const size_t length = std::min<size_t>(255, message.length());
+    auto data = std::make_shared<std::vector<uint8_t>>(message.begin(), message.begin() + static_cast<std::ptrdiff_t>(length));
+    Response response;
+    response.header[0] = static_cast<uint8_t>(IO::OpCodes::Status);
+    response.header[5] = static_cast<uint8_t>(code);
+    response.data = std::move(data);
+    SendResponse(id, std::move(response));
+}
+
+void Connection::SendData(uint32_t id, SharedBuffer data)
+{
+    Response response;
+    response.header[0] = static_cast<uint8_t>(IO::OpCodes::Data);
+    response.header[5] = static_cast<uint8_t>(IO::ErrorCodes::Ok);
+    response.data = std::move(data);
+    SendResponse(id, std::move(response));
 }
 
-void Connection::SendStatusAndRestart(IO::ErrorCodes code, const std::string& message)
+void Connection::SendResponse(uint32_t id, Response&& response)
 {
-    data_.reset(new std::vector<uint8_t>);
-    data_->push_back(static_cast<uint8_t>(IO::OpCodes::Status));
-    data_->push_back(static_cast<uint8_t>(code));
-    data_->push_back(0);
-    data_->push_back(0);
-    data_->push_back(0);
+    response.header[1] = static_cast<uint8_t>(id);
+    response.header[2] = static_cast<uint8_t>(id >> 8);
+    response.header[3] = static_cast<uint8_t>(id >> 16);
+    response.header[4] = static_cast<uint8_t>(id >> 24);
+    const uint32_t size = static_cast<uint32_t>(response.data->size());
+    response.header[6] = static_cast<uint8_t>(size);
+    response.header[7] = static_cast<uint8_t>(size >> 8);
+    response.header[8] = static_cast<uint8_t>(size >> 16);
+    response.header[9] = static_cast<uint8_t>(size >> 24);
 
-    //push message length
-    data_->push_back(std::min(static_cast<uint8_t>(255), static_cast<uint8_t>(message.length())));
-    size_t len = 0;
-    for (const auto& letter : message)
+    bool writing;
     {
-        data_->push_back(static_cast<uint8_t>(letter));
-        ++len;
-        if (len >= 255)
-            break;
+        std::scoped_lock lock(lock_);
+        writing = !responses_.empty();
+        responses_.push_back(std::move(response));
     }
-    std::vector<asio::mutable_buffer> bufs = { asio::buffer(*data_) };
-    SendResponseAndStart(bufs, data_->size());
+    if (!writing)
+        asio::post(socket_.get_executor(), std::bind(&Connection::StartWrite, shared_from_this()));
 }
 
-void Connection::SendResponseAndStart(std::vector<asio::mutable_buffer>& resp, size_t size)
+void Connection::StartWrite()
 {
-    asio::async_write(socket_, resp, asio::transfer_at_least(size),
-        std::bind(&Connection::HandleWriteReqResponse,
-            shared_from_this(), std::placeholders::_1));
+    // Write the headers and the (shared) data of all queued responses with one call.
+    // Elements of a deque don't move when adding at the end.
+    writeBuffers_.clear();
+    {
+        std::scoped_lock lock(lock_);
+        writing_ = std::min(responses_.size(), MAX_WRITE_RESPONSES);
+        for (size_t i = 0; i < writing_; ++i)
+        {
+            const Response& response = responses_[i];
+            writeBuffers_.push_back(asio::buffer(response.header));
+            if (!response.data->empty())
+                writeBuffers_.push_back(asio::buffer(*response.data));
+        }
+    }
+    auto self = shared_from_this();
+    asio::async_write(socket_, writeBuffers_,
+        [this, self](const asio::error_code& error, size_t /* bytes_transferred */)
+    {
+        if (error)
+        {
+            HandleNetworkError(error);
+            return;
+        }
+        bool more;
+        {
+            std::scoped_lock lock(lock_);
+            responses_.erase(responses_.begin(), responses_.begin() + static_cast<std::ptrdiff_t>(writing_));
+            more = !responses_.empty();
+        }
+        if (more)
+            StartWrite();
+    });
 }
-
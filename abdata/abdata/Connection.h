@@ -22,6 +22,9 @@
 #pragma once
 
 #include <stdint.h>
+#include <array>
+#include <deque>
+#include <mutex>
 #include <vector>
 #include "StorageProvider.h"
 #include <abscommon/Dispatcher.h>
@@ -32,6 +35,10 @@
 
 class ConnectionManager;
 
+/// Connection to a DataClient. Requests are read one after another without waiting
+/// for the previous to finish. Cache hits are executed on the Dispatcher thread,
+/// requests that need the DB on the ThreadPool. Responses are tagged with the ID
+/// of the request.
 class Connection : public std::enable_shared_from_this<Connection>
 {
 public:
@@ -41,6 +48,28 @@ public:
     void Start();
     void Stop();
 private:
+    struct Request
+    {
+        IO::OpCodes opCode;
+        uint32_t id;
+        IO::DataKey key;
+        std::shared_ptr<std::vector<uint8_t>> data;
+    };
+    /// The records of a ReadMany request
+    struct ManyRequest
+    {
+        uint32_t id;
+        std::vector<IO::DataKey> keys;
+        std::vector<SharedBuffer> data;
+    };
+    struct Response
+    {
+        std::array<uint8_t, IO::RESPONSE_HEADER_SIZE> header;
+        /// May be shared with the cache
+        SharedBuffer data;
+    };
+    /// Max number of responses written with one call
+    static constexpr size_t MAX_WRITE_RESPONSES = 64;
     template <typename Callable, typename... Args>
     void AddTask(Callable&& function, Args&&... args)
     {
@@ -49,32 +78,41 @@ private:
         );
     }
 
-    void StartCreateOperation();
-    void StartUpdateDataOperation();
-    void StartReadOperation();
-    void StartDeleteOperation();
-    void StartInvalidateOperation();
-    void StartPreloadOperation();
-    void StartExistsOperation();
-    void StartClearOperation();
+    void StartReadKey();
+    void StartReadDataSize();
+    void StartReadData(uint32_t size);
+    void HandleNetworkError(const asio::error_code& error);
 
-    void HandleUpdateReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void HandleCreateReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void HandleReadReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void HandleWriteReqResponse(const asio::error_code& error);
-    void HandleExistsReadRawData(const asio::error_code& error, size_t bytes_transferred, size_t expected);
-    void StartClientRequestedOp();
-    void StartReadKey(uint16_t keySize);
-    void SendResponseAndStart(std::vector<asio::mutable_buffer>& resp, size_t size);
-    void SendStatusAndRestart(IO::ErrorCodes code, const std::string& message);
+    // Executed in the dispatcher thread
+    void Execute(std::shared_ptr<Request> request);
+    // Executed in the dispatcher thread or a ThreadPool thread
+    void ExecuteRequest(std::shared_ptr<Request> request);
+    void ExecuteCreate(const Request& request);
+    void ExecuteUpdate(const Request& request);
+    void ExecuteRead(const Request& request);
+    void ExecuteDelete(const Request& request);
+    void ExecuteInvalidate(const Request& request);
+    void ExecutePreload(const Request& request);
+    void ExecuteExists(const Request& request);
+    void ExecuteClear(const Request& request);
+    void ExecuteReadMany(std::shared_ptr<ManyRequest> request);
+    /// Split a ReadMany request into the records
+    bool ParseReadMany(const Request& request, ManyRequest& result);
 
-    static inline uint32_t ToInt32(const std::vector<uint8_t>& intBytes, size_t start)
+    // Thread safe
+    void SendStatus(uint32_t id, IO::ErrorCodes code, const std::string& message);
+    void SendData(uint32_t id, SharedBuffer data);
+    void SendResponse(uint32_t id, Response&& response);
+    // Executed in the network thread
+    void StartWrite();
+
+    static inline uint32_t ToInt32(const uint8_t* intBytes)
     {
-        return (intBytes[start + 3] << 24) | (intBytes[start + 2] << 16) | (intBytes[start + 1] << 8) | intBytes[start];
+        return (intBytes[3] << 24) | (intBytes[2] << 16) | (intBytes[1] << 8) | intBytes[0];
     }
-    static inline uint16_t ToInt16(const std::vector<uint8_t>& intBytes, size_t start)
+    static inline uint16_t ToInt16(const uint8_t* intBytes)
     {
-        return  (intBytes[start + 1] << 8) | intBytes[start];
+        return (intBytes[1] << 8) | intBytes[0];
     }
 
     size_t maxDataSize_;
@@ -82,8 +120,15 @@ private:
     asio::ip::tcp::socket socket_;
     ConnectionManager& connectionManager_;
     StorageProvider& storageProvider_;
-    IO::OpCodes opcode_;
 
-    IO::DataKey key_;
-    std::shared_ptr<std::vector<uint8_t>> data_;
+    /// The request currently being read
+    std::shared_ptr<Request> request_;
+    std::array<uint8_t, IO::REQUEST_HEADER_SIZE> requestHeader_;
+    std::array<uint8_t, 4> dataHeader_;
+
+    std::mutex lock_;
+    std::deque<Response> responses_;
+    /// Number of responses at the front of responses_ being written
+    size_t writing_{ 0 };
+    std::vector<asio::const_buffer> writeBuffers_;
 };
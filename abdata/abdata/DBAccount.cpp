@@ -25,6 +25,26 @@
 
 namespace DB {
 
+static const DBStatement CREATE_ACCOUNT = { "accounts_create",
+    "INSERT INTO `accounts` (`uuid`, `name`, `password`, `email`, `type`, `status`, `creation`, `char_slots`, "
+    "`current_server_uuid`, `online_status`, `guild_uuid`, `chest_size`) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)" };
+static const DBStatement LOAD_ACCOUNT_UUID = { "accounts_load_uuid",
+    "SELECT * FROM `accounts` WHERE `uuid` = ?" };
+static const DBStatement LOAD_ACCOUNT_NAME = { "accounts_load_name",
+    "SELECT * FROM `accounts` WHERE `name` = ?" };
+static const DBStatement LOAD_ACCOUNT_CHARACTERS = { "accounts_load_characters",
+    "SELECT `uuid`, `name` FROM `players` WHERE `account_uuid` = ? ORDER BY `name`" };
+static const DBStatement SAVE_ACCOUNT = { "accounts_save",
+    "UPDATE `accounts` SET `password` = ?, `email` = ?, `auth_token` = ?, `auth_token_expiry` = ?, `type` = ?, "
+    "`status` = ?, `char_slots` = ?, `current_character_uuid` = ?, `current_server_uuid` = ?, `online_status` = ?, "
+    "`guild_uuid` = ?, `chest_size` = ? WHERE `uuid` = ?" };
+static const DBStatement DELETE_ACCOUNT = { "accounts_delete",
+    "DELETE FROM `accounts` WHERE `uuid` = ?" };
+static const DBStatement EXISTS_ACCOUNT_UUID = { "accounts_exists_uuid",
+    "SELECT COUNT(*) AS `count` FROM `accounts` WHERE `uuid` = ?" };
+static const DBStatement EXISTS_ACCOUNT_NAME = { "accounts_exists_name",
+    "SELECT COUNT(*) AS `count` FROM `accounts` WHERE `name` = ?" };
+
 bool DBAccount::Create(AB::Entities::Account& account)
 {
     if (Utils::Uuid::IsEmpty(account.uuid))
@@ -33,30 +53,26 @@ bool DBAccount::Create(AB::Entities::Account& account)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "INSERT INTO `accounts` (`uuid`, `name`, `password`, `email`, `type`, " <<
-        "`status`, `creation`, `char_slots`, `current_server_uuid`, `online_status`, `guild_uuid`, `chest_size`) VALUES ( ";
-
-    query << db->EscapeString(account.uuid) << ", ";
-    query << db->EscapeString(account.name) << ", ";
-    query << db->EscapeString(account.password) << ", ";
-    query << db->EscapeString(account.email) << ", ";
-    query << static_cast<int>(account.type) << ", ";
-    query << static_cast<int>(account.status) << ", ";
-    query << account.creation << ", ";
-    query << account.charSlots << ", ";
-    query << db->EscapeString(account.currentServerUuid) << ", ";
-    query << static_cast<int>(account.onlineStatus) << ", ";
-    query << db->EscapeString(account.guildUuid) << ", ";
-    query << static_cast<int>(account.chest_size);
-
-    query << ")";
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+    DBParams params(12);
+    params.Add(account.uuid)
+        .Add(account.name)
+        .Add(account.password)
+        .Add(account.email)
+        .Add(static_cast<int>(account.type))
+        .Add(static_cast<int>(account.status))
+        .Add(account.creation)
+        .Add(account.charSlots)
+        .Add(account.currentServerUuid)
+        .Add(static_cast<int>(account.onlineStatus))
+        .Add(account.guildUuid)
+        .Add(static_cast<int>(account.chest_size));
+
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(CREATE_ACCOUNT, params))
         return false;
 
     // End transaction
@@ -68,24 +84,22 @@ bool DBAccount::Create(AB::Entities::Account& account)
 
 bool DBAccount::Load(AB::Entities::Account& account)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::ostringstream query;
-    query << "SELECT * FROM `accounts` WHERE ";
+    std::shared_ptr<DB::DBResult> result;
     if (!Utils::Uuid::IsEmpty(account.uuid))
-        query << "`uuid` = " << db->EscapeString(account.uuid);
+        result = db->StoreQuery(LOAD_ACCOUNT_UUID, DBParams(1).Add(account.uuid));
     else if (!account.name.empty())
-        query << "`name` = " << db->EscapeString(account.name);
+        result = db->StoreQuery(LOAD_ACCOUNT_NAME, DBParams(1).Add(account.name));
     else
     {
         LOG_ERROR << "UUID and name are empty" << std::endl;
         return false;
     }
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
     if (!result)
     {
-        LOG_ERROR << "No record found for " << query.str() << std::endl;
+        LOG_ERROR << "No record found for account " << account.uuid << " (" << account.name << ")" << std::endl;
         return false;
     }
 
@@ -107,12 +121,13 @@ bool DBAccount::Load(AB::Entities::Account& account)
 
     // load characters
     account.characterUuids.clear();
-    query.str("");
-    query << "SELECT `uuid`, `name` FROM `players` WHERE `account_uuid` = " << db->EscapeString(account.uuid) <<
-        " ORDER BY `name`";
-    for (result = db->StoreQuery(query.str()); result; result = result->Next())
+    result = db->StoreQuery(LOAD_ACCOUNT_CHARACTERS, DBParams(1).Add(account.uuid));
+    if (!result)
+        return true;
+    const int colUuid = result->GetColumnIndex("uuid");
+    for (; result; result = result->Next())
     {
-        account.characterUuids.push_back(result->GetString("uuid"));
+        account.characterUuids.push_back(result->GetString(colUuid));
     }
 
     return true;
@@ -126,31 +141,27 @@ bool DBAccount::Save(const AB::Entities::Account& account)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-
-    query << "UPDATE `accounts` SET ";
-
-    query << " `password` = " << db->EscapeString(account.password) << ",";
-    query << " `email` = " << db->EscapeString(account.email) << ",";
-    query << " `auth_token` = " << db->EscapeString(account.authToken) << ",";
-    query << " `auth_token_expiry` = " << account.authTokenExpiry << ",";
-    query << " `type` = " << static_cast<int>(account.type) << ",";
-    query << " `status` = " << static_cast<int>(account.status) << ",";
-    query << " `char_slots` = " << account.charSlots << ",";
-    query << " `current_character_uuid` = " << db->EscapeString(account.currentCharacterUuid) << ",";
-    query << " `current_server_uuid` = " << db->EscapeString(account.currentServerUuid) << ",";
-    query << " `online_status` = " << static_cast<int>(account.onlineStatus) << ",";
-    query << " `guild_uuid` = " << db->EscapeString(account.guildUuid) << ",";
-    query << " `chest_size` = " << static_cast<int>(account.chest_size);
-
-    query << " WHERE `uuid` = " << db->EscapeString(account.uuid);
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+    DBParams params(13);
+    params.Add(account.password)
+        .Add(account.email)
+        .Add(account.authToken)
+        .Add(account.authTokenExpiry)
+        .Add(static_cast<int>(account.type))
+        .Add(static_cast<int>(account.status))
+        .Add(account.charSlots)
+        .Add(account.currentCharacterUuid)
+        .Add(account.currentServerUuid)
+        .Add(static_cast<int>(account.onlineStatus))
+        .Add(account.guildUuid)
+        .Add(static_cast<int>(account.chest_size))
+        .Add(account.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(SAVE_ACCOUNT, params))
         return false;
 
     // End transaction
@@ -165,15 +176,12 @@ bool DBAccount::Delete(const AB::Entities::Account& account)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "DELETE FROM `accounts` WHERE `uuid` = " << db->EscapeString(account.uuid);
-
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(DELETE_ACCOUNT, DBParams(1).Add(account.uuid)))
         return false;
 
     // End transaction
@@ -182,21 +190,19 @@ bool DBAccount::Delete(const AB::Entities::Account& account)
 
 bool DBAccount::Exists(const AB::Entities::Account& account)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::ostringstream query;
-    query << "SELECT COUNT(*) AS `count` FROM `accounts` WHERE ";
+    std::shared_ptr<DB::DBResult> result;
     if (!Utils::Uuid::IsEmpty(account.uuid))
-        query << "`uuid` = " << db->EscapeString(account.uuid);
+        result = db->StoreQuery(EXISTS_ACCOUNT_UUID, DBParams(1).Add(account.uuid));
     else if (!account.name.empty())
-        query << "`name` = " << db->EscapeString(account.name);
+        result = db->StoreQuery(EXISTS_ACCOUNT_NAME, DBParams(1).Add(account.name));
     else
     {
         LOG_ERROR << "UUID and name are empty" << std::endl;
         return false;
     }
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -204,7 +210,7 @@ bool DBAccount::Exists(const AB::Entities::Account& account)
 
 bool DBAccount::LogoutAll()
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "UPDATE `accounts` SET `online_status` = 0";
     DBTransaction transaction(db);
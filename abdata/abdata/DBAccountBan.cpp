@@ -32,7 +32,7 @@ bool DBAccountBan::Create(AB::Entities::AccountBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "INSERT INTO `account_bans` (`uuid`, `ban_uuid`, `account_uuid`) VALUES (";
     query << db->EscapeString(ban.uuid) << ", ";
@@ -57,7 +57,7 @@ bool DBAccountBan::Create(AB::Entities::AccountBan& ban)
 
 bool DBAccountBan::Load(AB::Entities::AccountBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "SELECT * FROM `account_bans` WHERE ";
     if (!Utils::Uuid::IsEmpty(ban.uuid))
@@ -89,7 +89,7 @@ bool DBAccountBan::Save(const AB::Entities::AccountBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `account_bans` SET ";
@@ -117,7 +117,7 @@ bool DBAccountBan::Delete(const AB::Entities::AccountBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `account_bans` WHERE `uuid` = " << db->EscapeString(ban.uuid);
     DBTransaction transaction(db);
@@ -133,7 +133,7 @@ bool DBAccountBan::Delete(const AB::Entities::AccountBan& ban)
 
 bool DBAccountBan::Exists(const AB::Entities::AccountBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `account_bans` WHERE ";
     if (!Utils::Uuid::IsEmpty(ban.uuid))
@@ -43,7 +43,7 @@ bool DBAccountItemList::Load(AB::Entities::AccountItemList& il)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `concrete_items` WHERE `account_uuid` = " << db->EscapeString(il.uuid);
@@ -32,7 +32,7 @@ bool DBAccountKey::Create(AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "INSERT INTO `account_keys` (`uuid`, `used`, `total`, `description`, `status`, " <<
         "`key_type`, `email`) VALUES ( ";
@@ -68,7 +68,7 @@ bool DBAccountKey::Load(AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `account_keys` WHERE `uuid` = " << db->EscapeString(ak.uuid);
@@ -99,7 +99,7 @@ bool DBAccountKey::Save(const AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `account_keys` SET ";
@@ -138,7 +138,7 @@ bool DBAccountKey::Exists(const AB::Entities::AccountKey& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `account_keys` WHERE `uuid` = " << db->EscapeString(ak.uuid);
@@ -32,7 +32,7 @@ bool DBAccountKeyAccounts::Create(AB::Entities::AccountKeyAccounts& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "INSERT INTO `account_account_keys` (`account_uuid`, `account_key_uuid`) VALUES ( ";
     query << db->EscapeString(ak.accountUuid) << ",";
@@ -61,7 +61,7 @@ bool DBAccountKeyAccounts::Load(AB::Entities::AccountKeyAccounts& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `account_account_keys` WHERE ";
@@ -97,7 +97,7 @@ bool DBAccountKeyAccounts::Exists(const AB::Entities::AccountKeyAccounts& ak)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `account_account_keys` WHERE ";
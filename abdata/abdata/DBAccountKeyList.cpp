@@ -31,7 +31,7 @@ bool DBAccountKeyList::Create(AB::Entities::AccountKeyList&)
 
 bool DBAccountKeyList::Load(AB::Entities::AccountKeyList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `account_keys`";
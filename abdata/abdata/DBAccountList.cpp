@@ -31,7 +31,7 @@ bool DBAccountList::Create(AB::Entities::AccountList&)
 
 bool DBAccountList::Load(AB::Entities::AccountList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `accounts`";
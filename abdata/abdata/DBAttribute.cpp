@@ -30,9 +30,18 @@ bool DBAttribute::Create(AB::Entities::Attribute&)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::Attribute& attr)
+{
+    attr.uuid = result.GetString("uuid");
+    attr.index = result.GetUInt("idx");
+    attr.professionUuid = result.GetString("profession_uuid");
+    attr.name = result.GetString("name");
+    attr.isPrimary = result.GetUInt("is_primary") != 0;
+}
+
 bool DBAttribute::Load(AB::Entities::Attribute& attr)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_attributes` WHERE ";
@@ -50,12 +59,23 @@ bool DBAttribute::Load(AB::Entities::Attribute& attr)
     if (!result)
         return false;
 
-    attr.uuid = result->GetString("uuid");
-    attr.index = result->GetUInt("idx");
-    attr.professionUuid = result->GetString("profession_uuid");
-    attr.name = result->GetString("name");
-    attr.isPrimary = result->GetUInt("is_primary") != 0;
+    LoadFromResult(*result, attr);
+
+    return true;
+}
+
+bool DBAttribute::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Attribute>& attributes)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `game_attributes` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        attributes.emplace_back();
+        LoadFromResult(*result, attributes.back());
+    }
     return true;
 }
 
@@ -73,7 +93,7 @@ bool DBAttribute::Delete(const AB::Entities::Attribute&)
 
 bool DBAttribute::Exists(const AB::Entities::Attribute& attr)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) FROM `game_attributes` WHERE ";
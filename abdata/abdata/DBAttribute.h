@@ -33,6 +33,8 @@ public:
 
     static bool Create(AB::Entities::Attribute&);
     static bool Load(AB::Entities::Attribute& attr);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Attribute>& attributes);
     static bool Save(const AB::Entities::Attribute&);
     static bool Delete(const AB::Entities::Attribute&);
     static bool Exists(const AB::Entities::Attribute& attr);
@@ -31,7 +31,7 @@ bool DBAttributeList::Create(AB::Entities::AttributeList&)
 
 bool DBAttributeList::Load(AB::Entities::AttributeList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_attributes`";
@@ -32,7 +32,7 @@ bool DBBan::Create(AB::Entities::Ban& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "INSERT INTO `bans` (`uuid`, `expires`, `added`, `reason`, `active`, `admin_uuid`, `comment`) VALUES (";
     query << db->EscapeString(ban.uuid) << ", ";
@@ -67,7 +67,7 @@ bool DBBan::Load(AB::Entities::Ban& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `bans` WHERE `uuid` = " << db->EscapeString(ban.uuid);
@@ -95,7 +95,7 @@ bool DBBan::Save(const AB::Entities::Ban& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `bans` SET ";
@@ -127,7 +127,7 @@ bool DBBan::Delete(const AB::Entities::Ban& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `bans` WHERE `uuid` = " << db->EscapeString(ban.uuid);
     DBTransaction transaction(db);
@@ -149,7 +149,7 @@ bool DBBan::Exists(const AB::Entities::Ban& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `bans` WHERE `uuid` = " << db->EscapeString(ban.uuid);
@@ -27,6 +27,25 @@ namespace DB {
 // Player names are case insensitive. The DB needs a proper index for that:
 // CREATE INDEX players_name_ci_index ON players USING btree (lower(name))
 
+static const DBStatement CREATE_CHARACTER = { "players_create",
+    "INSERT INTO `players` (`uuid`, `profession`, `profession2`, `profession_uuid`, `profession2_uuid`, `name`, `pvp`, "
+    "`account_uuid`, `level`, `experience`, `skillpoints`, `sex`, `model_index`, `creation`, `inventory_size`) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)" };
+static const DBStatement LOAD_CHARACTER_UUID = { "players_load_uuid",
+    "SELECT * FROM `players` WHERE `uuid` = ?" };
+static const DBStatement LOAD_CHARACTER_NAME = { "players_load_name",
+    "SELECT * FROM `players` WHERE LOWER(`name`) = LOWER(?)" };
+static const DBStatement SAVE_CHARACTER = { "players_save",
+    "UPDATE `players` SET `profession2` = ?, `profession2_uuid` = ?, `skills` = ?, `level` = ?, `experience` = ?, "
+    "`skillpoints` = ?, `lastlogin` = ?, `lastlogout` = ?, `onlinetime` = ?, `deleted` = ?, `current_map_uuid` = ?, "
+    "`last_outpost_uuid` = ?, `inventory_size` = ? WHERE `uuid` = ?" };
+static const DBStatement DELETE_CHARACTER = { "players_delete",
+    "DELETE FROM `players` WHERE `uuid` = ?" };
+static const DBStatement EXISTS_CHARACTER_UUID = { "players_exists_uuid",
+    "SELECT COUNT(*) AS `count` FROM `players` WHERE `uuid` = ?" };
+static const DBStatement EXISTS_CHARACTER_NAME = { "players_exists_name",
+    "SELECT COUNT(*) AS `count` FROM `players` WHERE LOWER(`name`) = LOWER(?)" };
+
 bool DBCharacter::Create(AB::Entities::Character& character)
 {
     if (Utils::Uuid::IsEmpty(character.uuid))
@@ -35,36 +54,29 @@ bool DBCharacter::Create(AB::Entities::Character& character)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "INSERT INTO `players` (`uuid`, `profession`, `profession2`, `profession_uuid`, `profession2_uuid`, `name`, `pvp`, " <<
-        "`account_uuid`, `level`, `experience`, `skillpoints`, `sex`, " <<
-        "`model_index`, `creation`, `inventory_size`";
-    query << ") VALUES (";
-
-    query << db->EscapeString(character.uuid) << ", ";
-    query << db->EscapeString(character.profession) << ", ";
-    query << db->EscapeString(character.profession2) << ", ";
-    query << db->EscapeString(character.professionUuid) << ", ";
-    query << db->EscapeString(character.profession2Uuid) << ", ";
-    query << db->EscapeString(character.name) << ", ";
-    query << (character.pvp ? 1 : 0) << ", ";
-    query << db->EscapeString(character.accountUuid) << ", ";
-    query << static_cast<int>(character.level) << ", ";
-    query << character.xp << ", ";
-    query << character.skillPoints << ", ";
-    query << static_cast<uint32_t>(character.sex) << ", ";
-    query << character.modelIndex << ", ";
-    query << character.creation << ", ";
-    query << static_cast<int>(character.inventory_size);
-
-    query << ")";
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+    DBParams params(15);
+    params.Add(character.uuid)
+        .Add(character.profession)
+        .Add(character.profession2)
+        .Add(character.professionUuid)
+        .Add(character.profession2Uuid)
+        .Add(character.name)
+        .Add(character.pvp ? 1 : 0)
+        .Add(character.accountUuid)
+        .Add(static_cast<int>(character.level))
+        .Add(character.xp)
+        .Add(character.skillPoints)
+        .Add(static_cast<uint32_t>(character.sex))
+        .Add(character.modelIndex)
+        .Add(character.creation)
+        .Add(static_cast<int>(character.inventory_size));
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(CREATE_CHARACTER, params))
         return false;
 
     // End transaction
@@ -76,21 +88,19 @@ bool DBCharacter::Create(AB::Entities::Character& character)
 
 bool DBCharacter::Load(AB::Entities::Character& character)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::ostringstream query;
-    query << "SELECT * FROM `players` WHERE ";
+    std::shared_ptr<DB::DBResult> result;
     if (!Utils::Uuid::IsEmpty(character.uuid))
-        query << "`uuid` = " << db->EscapeString(character.uuid);
+        result = db->StoreQuery(LOAD_CHARACTER_UUID, DBParams(1).Add(character.uuid));
     else if (!character.name.empty())
-        query << "LOWER(`name`) = LOWER(" << db->EscapeString(character.name) << ")";
+        result = db->StoreQuery(LOAD_CHARACTER_NAME, DBParams(1).Add(character.name));
     else
     {
         LOG_ERROR << "UUID (" << character.uuid << ") and name (" << character.name << ") are empty" << std::endl;
         return false;
     }
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
     if (!result)
         return false;
 
@@ -128,33 +138,29 @@ bool DBCharacter::Save(const AB::Entities::Character& character)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-
-    query << "UPDATE `players` SET ";
-
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     // Only these may be changed
-    query << " `profession2` = " << db->EscapeString(character.profession2) << ", ";
-    query << " `profession2_uuid` = " << db->EscapeString(character.profession2Uuid) << ", ";
-    query << " `skills` = " << db->EscapeString(character.skillTemplate) << ", ";
-    query << " `level` = " << static_cast<int>(character.level) << ", ";
-    query << " `experience` = " << character.xp << ", ";
-    query << " `skillpoints` = " << character.skillPoints << ", ";
-    query << " `lastlogin` = " << character.lastLogin << ", ";
-    query << " `lastlogout` = " << character.lastLogout << ", ";
-    query << " `onlinetime` = " << character.onlineTime << ", ";
-    query << " `deleted` = " << character.deletedTime << ", ";
-    query << " `current_map_uuid` = " << db->EscapeString(character.currentMapUuid) << ", ";
-    query << " `last_outpost_uuid` = " << db->EscapeString(character.lastOutpostUuid) << ", ";
-    query << " `inventory_size` = " << static_cast<int>(character.inventory_size);
-
-    query << " WHERE `uuid` = " << db->EscapeString(character.uuid);
+    DBParams params(14);
+    params.Add(character.profession2)
+        .Add(character.profession2Uuid)
+        .Add(character.skillTemplate)
+        .Add(static_cast<int>(character.level))
+        .Add(character.xp)
+        .Add(character.skillPoints)
+        .Add(character.lastLogin)
+        .Add(character.lastLogout)
+        .Add(character.onlineTime)
+        .Add(character.deletedTime)
+        .Add(character.currentMapUuid)
+        .Add(character.lastOutpostUuid)
+        .Add(static_cast<int>(character.inventory_size))
+        .Add(character.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(SAVE_CHARACTER, params))
         return false;
 
     // End transaction
@@ -169,14 +175,12 @@ bool DBCharacter::Delete(const AB::Entities::Character& character)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "DELETE FROM `players` WHERE `uuid` = " << db->EscapeString(character.uuid);
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(DELETE_CHARACTER, DBParams(1).Add(character.uuid)))
         return false;
 
     // End transaction
@@ -185,21 +189,19 @@ bool DBCharacter::Delete(const AB::Entities::Character& character)
 
 bool DBCharacter::Exists(const AB::Entities::Character& character)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::ostringstream query;
-    query << "SELECT COUNT(*) AS `count` FROM `players` WHERE ";
+    std::shared_ptr<DB::DBResult> result;
     if (!Utils::Uuid::IsEmpty(character.uuid))
-        query << "`uuid` = " << db->EscapeString(character.uuid);
+        result = db->StoreQuery(EXISTS_CHARACTER_UUID, DBParams(1).Add(character.uuid));
     else if (!character.name.empty())
-        query << "LOWER(`name`) = LOWER(" << db->EscapeString(character.name) << ")";
+        result = db->StoreQuery(EXISTS_CHARACTER_NAME, DBParams(1).Add(character.name));
     else
     {
         LOG_ERROR << "UUID and name are empty" << std::endl;
         return false;
     }
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -31,7 +31,7 @@ bool DBCharacterList::Create(AB::Entities::CharacterList&)
 
 bool DBCharacterList::Load(AB::Entities::CharacterList& al)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `players`";
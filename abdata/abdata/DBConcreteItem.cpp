@@ -27,6 +27,21 @@
 
 namespace DB {
 
+static const DBStatement CREATE_ITEM = { "concrete_items_create",
+    "INSERT INTO `concrete_items` (`uuid`, `player_uuid`, `storage_place`, `storage_pos`, `upgrade_1`, `upgrade_2`, `upgrade_3`, "
+    "`account_uuid`, `item_uuid`, `stats`, `count`, `creation`, `deleted`, `value`, `instance_uuid`, `map_uuid`) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)" };
+static const DBStatement LOAD_ITEM = { "concrete_items_load",
+    "SELECT * FROM `concrete_items` WHERE `uuid` = ?" };
+static const DBStatement SAVE_ITEM = { "concrete_items_save",
+    "UPDATE `concrete_items` SET `player_uuid` = ?, `storage_place` = ?, `storage_pos` = ?, `upgrade_1` = ?, "
+    "`upgrade_2` = ?, `upgrade_3` = ?, `account_uuid` = ?, `item_uuid` = ?, `stats` = ?, `count` = ?, `creation` = ?, "
+    "`deleted` = ?, `value` = ?, `instance_uuid` = ?, `map_uuid` = ? WHERE `uuid` = ?" };
+static const DBStatement DELETE_ITEM = { "concrete_items_delete",
+    "DELETE FROM `concrete_items` WHERE `uuid` = ?" };
+static const DBStatement EXISTS_ITEM = { "concrete_items_exists",
+    "SELECT COUNT(*) AS `count` FROM `concrete_items` WHERE `uuid` = ? AND `deleted` = 0" };
+
 bool DBConcreteItem::Create(AB::Entities::ConcreteItem& item)
 {
     if (Utils::Uuid::IsEmpty(item.uuid))
@@ -35,36 +50,30 @@ bool DBConcreteItem::Create(AB::Entities::ConcreteItem& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "INSERT INTO `concrete_items` (`uuid`, `player_uuid`, `storage_place`, `storage_pos`, `upgrade_1`, `upgrade_2`, `upgrade_3`, " <<
-        "`account_uuid`, `item_uuid`, `stats`, `count`, `creation`, `deleted`, `value`, `instance_uuid`, `map_uuid`";
-    query << ") VALUES (";
-
-    query << db->EscapeString(item.uuid) << ", ";
-    query << db->EscapeString(item.playerUuid) << ", ";
-    query << static_cast<int>(item.storagePlace) << ", ";
-    query << static_cast<int>(item.storagePos) << ", ";
-    query << db->EscapeString(item.upgrade1Uuid) << ", ";
-    query << db->EscapeString(item.upgrade2Uuid) << ", ";
-    query << db->EscapeString(item.upgrade3Uuid) << ", ";
-    query << db->EscapeString(item.accountUuid) << ", ";
-    query << db->EscapeString(item.itemUuid) << ", ";
-    query << db->EscapeBlob(item.itemStats.data(), item.itemStats.length()) << ", ";
-    query << static_cast<int>(item.count) << ", ";
-    query << item.creation << ", ";
-    query << item.deleted << ", ";
-    query << static_cast<int>(item.value) << ", ";
-    query << db->EscapeString(item.instanceUuid) << ", ";
-    query << db->EscapeString(item.mapUuid);
-
-    query << ")";
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+    DBParams params(16);
+    params.Add(item.uuid)
+        .Add(item.playerUuid)
+        .Add(static_cast<int>(item.storagePlace))
+        .Add(static_cast<int>(item.storagePos))
+        .Add(item.upgrade1Uuid)
+        .Add(item.upgrade2Uuid)
+        .Add(item.upgrade3Uuid)
+        .Add(item.accountUuid)
+        .Add(item.itemUuid)
+        .AddBlob(item.itemStats)
+        .Add(static_cast<int>(item.count))
+        .Add(item.creation)
+        .Add(item.deleted)
+        .Add(static_cast<int>(item.value))
+        .Add(item.instanceUuid)
+        .Add(item.mapUuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(CREATE_ITEM, params))
         return false;
 
     // End transaction
@@ -74,6 +83,26 @@ bool DBConcreteItem::Create(AB::Entities::ConcreteItem& item)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::ConcreteItem& item)
+{
+    item.uuid = result.GetString("uuid");
+    item.playerUuid = result.GetString("player_uuid");
+    item.storagePlace = static_cast<AB::Entities::StoragePlace>(result.GetUInt("storage_place"));
+    item.storagePos = static_cast<uint16_t>(result.GetUInt("storage_pos"));
+    item.upgrade1Uuid = result.GetString("upgrade_1");
+    item.upgrade2Uuid = result.GetString("upgrade_2");
+    item.upgrade3Uuid = result.GetString("upgrade_3");
+    item.accountUuid = result.GetString("account_uuid");
+    item.itemUuid = result.GetString("item_uuid");
+    item.itemStats = result.GetStream("stats");
+    item.count = static_cast<uint16_t>(result.GetUInt("count"));
+    item.creation = result.GetLong("creation");
+    item.deleted = result.GetLong("deleted");
+    item.value = static_cast<uint16_t>(result.GetUInt("value"));
+    item.instanceUuid = result.GetString("instance_uuid");
+    item.mapUuid = result.GetString("map_uuid");
+}
+
 bool DBConcreteItem::Load(AB::Entities::ConcreteItem& item)
 {
     if (Utils::Uuid::IsEmpty(item.uuid))
@@ -82,33 +111,29 @@ bool DBConcreteItem::Load(AB::Entities::ConcreteItem& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-
-    std::ostringstream query;
-    query << "SELECT * FROM `concrete_items` WHERE ";
-    query << "`uuid` = " << db->EscapeString(item.uuid);
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
+    std::shared_ptr<DB::DBResult> result = db->StoreQuery(LOAD_ITEM, DBParams(1).Add(item.uuid));
     if (!result)
         return false;
 
-    item.uuid = result->GetString("uuid");
-    item.playerUuid = result->GetString("player_uuid");
-    item.storagePlace = static_cast<AB::Entities::StoragePlace>(result->GetUInt("storage_place"));
-    item.storagePos = static_cast<uint16_t>(result->GetUInt("storage_pos"));
-    item.upgrade1Uuid = result->GetString("upgrade_1");
-    item.upgrade2Uuid = result->GetString("upgrade_2");
-    item.upgrade3Uuid = result->GetString("upgrade_3");
-    item.accountUuid = result->GetString("account_uuid");
-    item.itemUuid = result->GetString("item_uuid");
-    item.itemStats = result->GetStream("stats");
-    item.count = static_cast<uint16_t>(result->GetUInt("count"));
-    item.creation = result->GetLong("creation");
-    item.deleted = result->GetLong("deleted");
-    item.value = static_cast<uint16_t>(result->GetUInt("value"));
-    item.instanceUuid = result->GetString("instance_uuid");
-    item.mapUuid = result->GetString("map_uuid");
+    LoadFromResult(*result, item);
+
+    return true;
+}
+
+bool DBConcreteItem::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::ConcreteItem>& items)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `concrete_items` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        items.emplace_back();
+        LoadFromResult(*result, items.back());
+    }
     return true;
 }
 
@@ -120,35 +145,31 @@ bool DBConcreteItem::Save(const AB::Entities::ConcreteItem& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-
-    query << "UPDATE `concrete_items` SET ";
-
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     // Only these may be changed
-    query << " `player_uuid` = " << db->EscapeString(item.playerUuid) << ", ";
-    query << " `storage_place` = " << static_cast<int>(item.storagePlace) << ", ";
-    query << " `storage_pos` = " << static_cast<int>(item.storagePos) << ", ";
-    query << " `upgrade_1` = " << db->EscapeString(item.upgrade1Uuid) << ", ";
-    query << " `upgrade_2` = " << db->EscapeString(item.upgrade2Uuid) << ", ";
-    query << " `upgrade_3` = " << db->EscapeString(item.upgrade3Uuid) << ", ";
-    query << " `account_uuid` = " << db->EscapeString(item.accountUuid) << ", ";
-    query << " `item_uuid` = " << db->EscapeString(item.itemUuid) << ", ";
-    query << " `stats` = " << db->EscapeBlob(item.itemStats.data(), item.itemStats.length()) << ", ";
-    query << " `count` = " << static_cast<int>(item.count) << ", ";
-    query << " `creation` = " << item.creation << ", ";
-    query << " `deleted` = " << item.deleted << ", ";
-    query << " `value` = " << static_cast<int>(item.value) << ", ";
-    query << " `instance_uuid` = " << db->EscapeString(item.instanceUuid) << ", ";
-    query << " `map_uuid` = " << db->EscapeString(item.mapUuid);
-
-    query << " WHERE `uuid` = " << db->EscapeString(item.uuid);
+    DBParams params(16);
+    params.Add(item.playerUuid)
+        .Add(static_cast<int>(item.storagePlace))
+        .Add(static_cast<int>(item.storagePos))
+        .Add(item.upgrade1Uuid)
+        .Add(item.upgrade2Uuid)
+        .Add(item.upgrade3Uuid)
+        .Add(item.accountUuid)
+        .Add(item.itemUuid)
+        .AddBlob(item.itemStats)
+        .Add(static_cast<int>(item.count))
+        .Add(item.creation)
+        .Add(item.deleted)
+        .Add(static_cast<int>(item.value))
+        .Add(item.instanceUuid)
+        .Add(item.mapUuid)
+        .Add(item.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(SAVE_ITEM, params))
         return false;
 
     // End transaction
@@ -163,14 +184,12 @@ bool DBConcreteItem::Delete(const AB::Entities::ConcreteItem& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "DELETE FROM `concrete_items` WHERE `uuid` = " << db->EscapeString(item.uuid);
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(DELETE_ITEM, DBParams(1).Add(item.uuid)))
         return false;
 
     // End transaction
@@ -185,13 +204,9 @@ bool DBConcreteItem::Exists(const AB::Entities::ConcreteItem& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::ostringstream query;
-    query << "SELECT COUNT(*) AS `count` FROM `concrete_items` WHERE ";
-    query << "`uuid` = " << db->EscapeString(item.uuid) << " AND `deleted` = 0";
-
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
+    std::shared_ptr<DB::DBResult> result = db->StoreQuery(EXISTS_ITEM, DBParams(1).Add(item.uuid));
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -199,7 +214,7 @@ bool DBConcreteItem::Exists(const AB::Entities::ConcreteItem& item)
 
 void DBConcreteItem::Clean(StorageProvider* sp)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid`, `instance_uuid` FROM `concrete_items` WHERE storage_place = " <<
@@ -209,17 +224,19 @@ void DBConcreteItem::Clean(StorageProvider* sp)
     if (!result)
         return;
 
+    const int colUuid = result->GetColumnIndex("uuid");
+    const int colInstanceUuid = result->GetColumnIndex("instance_uuid");
     std::vector<std::string> uuids;
-    for (result = db->StoreQuery(query.str()); result; result = result->Next())
+    for (; result; result = result->Next())
     {
         AB::Entities::GameInstance instance;
-        instance.uuid = result->GetString("instance_uuid");
+        instance.uuid = result->GetString(colInstanceUuid);
         if (sp->EntityRead(instance) && instance.running)
             // Still running
             continue;
 
         // Not running or not existent, either way, delete it
-        uuids.push_back(result->GetString("uuid"));
+        uuids.push_back(result->GetString(colUuid));
     }
 
     for (const std::string& i : uuids)
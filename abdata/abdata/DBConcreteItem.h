@@ -35,6 +35,8 @@ public:
 
     static bool Create(AB::Entities::ConcreteItem& item);
     static bool Load(AB::Entities::ConcreteItem& item);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::ConcreteItem>& items);
     static bool Save(const AB::Entities::ConcreteItem& item);
     static bool Delete(const AB::Entities::ConcreteItem& item);
     static bool Exists(const AB::Entities::ConcreteItem& item);
@@ -35,9 +35,21 @@ bool DBEffect::Create(AB::Entities::Effect& effect)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::Effect& effect)
+{
+    effect.uuid = result.GetString("uuid");
+    effect.index = result.GetUInt("idx");
+    effect.name = result.GetString("name");
+    effect.category = static_cast<AB::Entities::EffectCategory>(result.GetUInt("category"));
+    effect.script = result.GetString("script");
+    effect.icon = result.GetString("icon");
+    effect.soundEffect = result.GetString("sound_effect");
+    effect.particleEffect = result.GetString("particle_effect");
+}
+
 bool DBEffect::Load(AB::Entities::Effect& effect)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_effects` WHERE ";
@@ -55,15 +67,23 @@ bool DBEffect::Load(AB::Entities::Effect& effect)
     if (!result)
         return false;
 
-    effect.uuid = result->GetString("uuid");
-    effect.index = result->GetUInt("idx");
-    effect.name = result->GetString("name");
-    effect.category = static_cast<AB::Entities::EffectCategory>(result->GetUInt("category"));
-    effect.script = result->GetString("script");
-    effect.icon = result->GetString("icon");
-    effect.soundEffect = result->GetString("sound_effect");
-    effect.particleEffect = result->GetString("particle_effect");
+    LoadFromResult(*result, effect);
+
+    return true;
+}
+
+bool DBEffect::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Effect>& effects)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `game_effects` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        effects.emplace_back();
+        LoadFromResult(*result, effects.back());
+    }
     return true;
 }
 
@@ -91,7 +111,7 @@ bool DBEffect::Delete(const AB::Entities::Effect& effect)
 
 bool DBEffect::Exists(const AB::Entities::Effect& effect)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `game_effects` WHERE ";
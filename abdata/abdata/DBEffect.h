@@ -33,6 +33,8 @@ public:
 
     static bool Create(AB::Entities::Effect& effect);
     static bool Load(AB::Entities::Effect& effect);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Effect>& effects);
     static bool Save(const AB::Entities::Effect& effect);
     static bool Delete(const AB::Entities::Effect& effect);
     static bool Exists(const AB::Entities::Effect& effect);
@@ -31,7 +31,7 @@ bool DBEffectList::Create(AB::Entities::EffectList&)
 
 bool DBEffectList::Load(AB::Entities::EffectList& el)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_effects`";
@@ -43,7 +43,7 @@ bool DBFriendList::Load(AB::Entities::FriendList& fl)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     fl.friends.clear();
     std::ostringstream query;
@@ -74,7 +74,7 @@ bool DBFriendList::Save(const AB::Entities::FriendList& fl)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     DBTransaction transaction(db);
     if (!transaction.Begin())
@@ -116,7 +116,7 @@ bool DBFriendList::Delete(const AB::Entities::FriendList& fl)
     }
 
     // Delete all friends of this account
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `friend_list` WHERE `account_uuid` = " << db->EscapeString(fl.uuid);
     DBTransaction transaction(db);
@@ -43,7 +43,7 @@ bool DBFriendedMe::Load(AB::Entities::FriendedMe& fl)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     fl.friends.clear();
     std::ostringstream query;
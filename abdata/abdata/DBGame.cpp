@@ -30,9 +30,27 @@ bool DBGame::Create(AB::Entities::Game&)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::Game& game)
+{
+    game.uuid = result.GetString("uuid");
+    game.name = result.GetString("name");
+    game.type = static_cast<AB::Entities::GameType>(result.GetUInt("type"));
+    game.mode = static_cast<AB::Entities::GameMode>(result.GetUInt("game_mode"));
+    game.directory = result.GetString("directory");
+    game.script = result.GetString("script_file");
+    game.queueMapUuid = result.GetString("queue_map_uuid");
+    game.landing = result.GetUInt("landing") != 0;
+    game.partySize = static_cast<uint8_t>(result.GetUInt("party_size"));
+    game.partyCount = static_cast<uint8_t>(result.GetUInt("party_count"));
+    game.randomParty = result.GetUInt("random_party") != 0;
+    game.mapCoordX = result.GetInt("map_coord_x");
+    game.mapCoordY = result.GetInt("map_coord_y");
+    game.defaultLevel = static_cast<int8_t>(result.GetInt("default_level"));
+}
+
 bool DBGame::Load(AB::Entities::Game& game)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_maps` WHERE ";
@@ -50,21 +68,23 @@ bool DBGame::Load(AB::Entities::Game& game)
     if (!result)
         return false;
 
-    game.uuid = result->GetString("uuid");
-    game.name = result->GetString("name");
-    game.type = static_cast<AB::Entities::GameType>(result->GetUInt("type"));
-    game.mode = static_cast<AB::Entities::GameMode>(result->GetUInt("game_mode"));
-    game.directory = result->GetString("directory");
-    game.script = result->GetString("script_file");
-    game.queueMapUuid = result->GetString("queue_map_uuid");
-    game.landing = result->GetUInt("landing") != 0;
-    game.partySize = static_cast<uint8_t>(result->GetUInt("party_size"));
-    game.partyCount = static_cast<uint8_t>(result->GetUInt("party_count"));
-    game.randomParty = result->GetUInt("random_party") != 0;
-    game.mapCoordX = result->GetInt("map_coord_x");
-    game.mapCoordY = result->GetInt("map_coord_y");
-    game.defaultLevel = static_cast<int8_t>(result->GetInt("default_level"));
+    LoadFromResult(*result, game);
+
+    return true;
+}
+
+bool DBGame::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Game>& games)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `game_maps` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        games.emplace_back();
+        LoadFromResult(*result, games.back());
+    }
     return true;
 }
 
@@ -82,7 +102,7 @@ bool DBGame::Delete(const AB::Entities::Game&)
 
 bool DBGame::Exists(const AB::Entities::Game& game)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `game_maps` WHERE ";
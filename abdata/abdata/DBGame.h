@@ -33,6 +33,8 @@ public:
 
     static bool Create(AB::Entities::Game&);
     static bool Load(AB::Entities::Game& game);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Game>& games);
     static bool Save(const AB::Entities::Game&);
     static bool Delete(const AB::Entities::Game&);
     static bool Exists(const AB::Entities::Game& game);
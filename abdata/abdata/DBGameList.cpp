@@ -31,7 +31,7 @@ bool DBGameList::Create(AB::Entities::GameList&)
 
 bool DBGameList::Load(AB::Entities::GameList& game)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_maps`";
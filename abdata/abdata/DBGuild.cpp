@@ -32,7 +32,7 @@ bool DBGuild::Create(AB::Entities::Guild& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "INSERT INTO `guilds` (`uuid`, `name`, `tag`, `creator_account_uuid`, `creation`, `guild_hall_uuid`, `creator_name`, `creator_player_uuid`, ";
     query << "`guild_hall_instance_uuid`, `guild_hall_server_uuid`";
@@ -67,7 +67,7 @@ bool DBGuild::Create(AB::Entities::Guild& g)
 
 bool DBGuild::Load(AB::Entities::Guild& g)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `guilds` WHERE ";
@@ -107,7 +107,7 @@ bool DBGuild::Save(const AB::Entities::Guild& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `guilds` SET ";
@@ -144,7 +144,7 @@ bool DBGuild::Delete(const AB::Entities::Guild& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `guilds` WHERE `uuid` = " << db->EscapeString(g.uuid);
     DBTransaction transaction(db);
@@ -160,7 +160,7 @@ bool DBGuild::Delete(const AB::Entities::Guild& g)
 
 bool DBGuild::Exists(const AB::Entities::Guild& g)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `guilds` WHERE ";
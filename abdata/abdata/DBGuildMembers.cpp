@@ -44,7 +44,7 @@ bool DBGuildMembers::Load(AB::Entities::GuildMembers& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     g.members.clear();
 
@@ -108,7 +108,7 @@ bool DBGuildMembers::Exists(const AB::Entities::GuildMembers& g)
 
 void DBGuildMembers::DeleteExpired(StorageProvider* sp)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `guild_uuid` FROM `guild_members` WHERE ";
@@ -32,7 +32,7 @@ bool DBInstance::Create(AB::Entities::GameInstance& inst)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "INSERT INTO `instances` (`uuid`, `game_uuid`, `server_uuid`, `name`, `recording`, " <<
@@ -67,7 +67,7 @@ bool DBInstance::Create(AB::Entities::GameInstance& inst)
 
 bool DBInstance::Load(AB::Entities::GameInstance& inst)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `instances` WHERE ";
@@ -106,7 +106,7 @@ bool DBInstance::Save(const AB::Entities::GameInstance& inst)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `instances` SET ";
@@ -140,7 +140,7 @@ bool DBInstance::Delete(const AB::Entities::GameInstance& inst)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `instances` WHERE `uuid` = " << db->EscapeString(inst.uuid);
     DBTransaction transaction(db);
@@ -156,7 +156,7 @@ bool DBInstance::Delete(const AB::Entities::GameInstance& inst)
 
 bool DBInstance::Exists(const AB::Entities::GameInstance& inst)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `instances` WHERE ";
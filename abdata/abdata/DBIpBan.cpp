@@ -32,7 +32,7 @@ bool DBIpBan::Create(AB::Entities::IpBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream dbQuery;
     dbQuery << "SELECT COUNT(*) as `count` FROM `ip_bans` WHERE ";
     dbQuery << "((" << ban.ip << " & " << ban.mask << " & `mask`) = (`ip` & `mask` & " << ban.mask << "))";
@@ -68,7 +68,7 @@ bool DBIpBan::Create(AB::Entities::IpBan& ban)
 
 bool DBIpBan::Load(AB::Entities::IpBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `ip_bans` WHERE ";
@@ -109,7 +109,7 @@ bool DBIpBan::Save(const AB::Entities::IpBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `ip_bans` SET ";
@@ -138,7 +138,7 @@ bool DBIpBan::Delete(const AB::Entities::IpBan& ban)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `ip_bans` WHERE `uuid` = " << db->EscapeString(ban.uuid);
     DBTransaction transaction(db);
@@ -154,7 +154,7 @@ bool DBIpBan::Delete(const AB::Entities::IpBan& ban)
 
 bool DBIpBan::Exists(const AB::Entities::IpBan& ban)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `ip_bans` WHERE ";
@@ -35,9 +35,26 @@ bool DBItem::Create(AB::Entities::Item& item)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::Item& item)
+{
+    item.uuid = result.GetString("uuid");
+    item.index = result.GetUInt("idx");
+    item.model_class = static_cast<AB::Entities::ModelClass>(result.GetUInt("model_class"));
+    item.name = result.GetString("name");
+    item.script = result.GetString("schript_file");
+    item.objectFile = result.GetString("object_file");
+    item.iconFile = result.GetString("icon_file");
+    item.type = static_cast<AB::Entities::ItemType>(result.GetUInt("type"));
+    item.belongsTo = static_cast<AB::Entities::ItemType>(result.GetUInt("belongs_to"));
+    item.stackAble = result.GetUInt("stack_able") != 0;
+    item.value = static_cast<uint16_t>(result.GetUInt("value"));
+    item.spawnItemUuid = result.GetString("spawn_item_uuid");
+    item.actorScript = result.GetString("actor_script");
+}
+
 bool DBItem::Load(AB::Entities::Item& item)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_items` WHERE ";
@@ -55,20 +72,23 @@ bool DBItem::Load(AB::Entities::Item& item)
     if (!result)
         return false;
 
-    item.uuid = result->GetString("uuid");
-    item.index = result->GetUInt("idx");
-    item.model_class = static_cast<AB::Entities::ModelClass>(result->GetUInt("model_class"));
-    item.name = result->GetString("name");
-    item.script = result->GetString("schript_file");
-    item.objectFile = result->GetString("object_file");
-    item.iconFile = result->GetString("icon_file");
-    item.type = static_cast<AB::Entities::ItemType>(result->GetUInt("type"));
-    item.belongsTo = static_cast<AB::Entities::ItemType>(result->GetUInt("belongs_to"));
-    item.stackAble = result->GetUInt("stack_able") != 0;
-    item.value = static_cast<uint16_t>(result->GetUInt("value"));
-    item.spawnItemUuid = result->GetString("spawn_item_uuid");
-    item.actorScript = result->GetString("actor_script");
+    LoadFromResult(*result, item);
+
+    return true;
+}
+
+bool DBItem::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Item>& items)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `game_items` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        items.emplace_back();
+        LoadFromResult(*result, items.back());
+    }
     return true;
 }
 
@@ -96,7 +116,7 @@ bool DBItem::Delete(const AB::Entities::Item& item)
 
 bool DBItem::Exists(const AB::Entities::Item& item)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `game_items` WHERE ";
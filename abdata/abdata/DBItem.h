@@ -33,6 +33,8 @@ public:
 
     static bool Create(AB::Entities::Item& item);
     static bool Load(AB::Entities::Item& item);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Item>& items);
     static bool Save(const AB::Entities::Item& item);
     static bool Delete(const AB::Entities::Item& item);
     static bool Exists(const AB::Entities::Item& item);
@@ -43,7 +43,7 @@ bool DBItemChanceList::Load(AB::Entities::ItemChanceList& il)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `item_uuid`, `chance` FROM `game_item_chances` WHERE `map_uuid` = " << db->EscapeString(il.uuid);
@@ -31,7 +31,7 @@ bool DBItemList::Create(AB::Entities::ItemList&)
 
 bool DBItemList::Load(AB::Entities::ItemList& il)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_items`";
@@ -32,7 +32,7 @@ bool DBMail::Create(AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     // Check if exceeding mail limit, if yes fail
@@ -82,7 +82,7 @@ bool DBMail::Load(AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `mails` WHERE `uuid` = " << db->EscapeString(mail.uuid);
@@ -110,7 +110,7 @@ bool DBMail::Save(const AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `mails` SET ";
@@ -144,7 +144,7 @@ bool DBMail::Delete(const AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `mails` WHERE `uuid` = " << db->EscapeString(mail.uuid);
     DBTransaction transaction(db);
@@ -166,7 +166,7 @@ bool DBMail::Exists(const AB::Entities::Mail& mail)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `mails` WHERE `uuid` = " << db->EscapeString(mail.uuid);
@@ -42,7 +42,7 @@ bool DBMailList::Load(AB::Entities::MailList& ml)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     ml.mails.clear();
     std::ostringstream query;
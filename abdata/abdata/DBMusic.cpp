@@ -32,7 +32,7 @@ bool DBMusic::Create(AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "INSERT INTO `game_music` (`uuid`, `map_uuid`, `local_file`, `remote_file`, `sorting`, " <<
@@ -62,6 +62,16 @@ bool DBMusic::Create(AB::Entities::Music& item)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::Music& item)
+{
+    item.uuid = result.GetString("uuid");
+    item.mapUuid = result.GetString("map_uuid");
+    item.localFile = result.GetString("local_file");
+    item.remoteFile = result.GetString("remote_file");
+    item.sorting = static_cast<uint8_t>(result.GetUInt("sorting"));
+    item.style = static_cast<AB::Entities::MusicStyle>(result.GetUInt("style"));
+}
+
 bool DBMusic::Load(AB::Entities::Music& item)
 {
     if (Utils::Uuid::IsEmpty(item.uuid))
@@ -70,7 +80,7 @@ bool DBMusic::Load(AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_music` WHERE ";
@@ -80,13 +90,23 @@ bool DBMusic::Load(AB::Entities::Music& item)
     if (!result)
         return false;
 
-    item.uuid = result->GetString("uuid");
-    item.mapUuid = result->GetString("map_uuid");
-    item.localFile = result->GetString("local_file");
-    item.remoteFile = result->GetString("remote_file");
-    item.sorting = static_cast<uint8_t>(result->GetUInt("sorting"));
-    item.style = static_cast<AB::Entities::MusicStyle>(result->GetUInt("style"));
+    LoadFromResult(*result, item);
+
+    return true;
+}
+
+bool DBMusic::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Music>& musics)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `game_music` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        musics.emplace_back();
+        LoadFromResult(*result, musics.back());
+    }
     return true;
 }
 
@@ -98,7 +118,7 @@ bool DBMusic::Save(const AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `game_music` SET ";
@@ -129,7 +149,7 @@ bool DBMusic::Delete(const AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `game_music` WHERE `uuid` = " << db->EscapeString(item.uuid);
     DBTransaction transaction(db);
@@ -151,7 +171,7 @@ bool DBMusic::Exists(const AB::Entities::Music& item)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `game_effects` WHERE ";
@@ -31,7 +31,7 @@ bool DBMusicList::Create(AB::Entities::MusicList&)
 
 bool DBMusicList::Load(AB::Entities::MusicList& il)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_music` ORDER BY `sorting`";
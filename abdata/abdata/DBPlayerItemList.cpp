@@ -24,6 +24,11 @@
 
 namespace DB {
 
+static const DBStatement LOAD_PLAYER_ITEMS = { "concrete_items_player",
+    "SELECT `uuid` FROM `concrete_items` WHERE `player_uuid` = ? AND `deleted` = 0" };
+static const DBStatement LOAD_PLAYER_ITEMS_PLACE = { "concrete_items_player_place",
+    "SELECT `uuid` FROM `concrete_items` WHERE `player_uuid` = ? AND `deleted` = 0 AND `storage_place` = ?" };
+
 bool DBPlayerItemList::Create(AB::Entities::PlayerItemList& il)
 {
     if (Utils::Uuid::IsEmpty(il.uuid))
@@ -43,17 +48,23 @@ bool DBPlayerItemList::Load(AB::Entities::PlayerItemList& il)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::ostringstream query;
-    query << "SELECT `uuid` FROM `concrete_items` WHERE `player_uuid` = " << db->EscapeString(il.uuid) << " AND `deleted` = 0";
+    std::shared_ptr<DB::DBResult> result;
     if (il.storagePlace != AB::Entities::StoragePlaceNone)
     {
-        query << " AND `storage_place` = " << static_cast<int>(il.storagePlace);
+        result = db->StoreQuery(LOAD_PLAYER_ITEMS_PLACE,
+            DBParams(2).Add(il.uuid).Add(static_cast<int>(il.storagePlace)));
     }
-    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    else
+        result = db->StoreQuery(LOAD_PLAYER_ITEMS, DBParams(1).Add(il.uuid));
+    if (!result)
+        return true;
+
+    const int colUuid = result->GetColumnIndex("uuid");
+    for (; result; result = result->Next())
     {
-        il.itemUuids.push_back(result->GetString("uuid"));
+        il.itemUuids.push_back(result->GetString(colUuid));
     }
     return true;
 }
@@ -24,6 +24,19 @@
 
 namespace DB {
 
+static const DBStatement CREATE_PLAYER_QUEST = { "player_quests_create",
+    "INSERT INTO `player_quests` (`uuid`, `quests_uuid`, `player_uuid`, `completed`, `rewarded`, `progress`, "
+    "`picked_up_times`, `completed_time`, `rewarded_time`, `deleted`) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)" };
+static const DBStatement LOAD_PLAYER_QUEST = { "player_quests_load",
+    "SELECT * FROM `player_quests` WHERE `uuid` = ? AND `deleted` = 0" };
+static const DBStatement SAVE_PLAYER_QUEST = { "player_quests_save",
+    "UPDATE `player_quests` SET `completed` = ?, `rewarded` = ?, `progress` = ?, `picked_up_times` = ?, "
+    "`completed_time` = ?, `rewarded_time` = ?, `deleted` = ? WHERE `uuid` = ?" };
+static const DBStatement DELETE_PLAYER_QUEST = { "player_quests_delete",
+    "DELETE FROM `player_quests` WHERE `uuid` = ?" };
+static const DBStatement EXISTS_PLAYER_QUEST = { "player_quests_exists",
+    "SELECT COUNT(*) AS `count` FROM `player_quests` WHERE `uuid` = ? AND `deleted` = 0" };
+
 bool DBPlayerQuest::Create(AB::Entities::PlayerQuest& g)
 {
     if (Utils::Uuid::IsEmpty(g.uuid))
@@ -32,31 +45,24 @@ bool DBPlayerQuest::Create(AB::Entities::PlayerQuest& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "INSERT INTO `player_quests` (`uuid`, `quests_uuid`, `player_uuid`, " <<
-        "`completed`, `rewarded, `progress`, `picked_up_times`, `completed_time`, `rewarded_time`, " <<
-        "`deleted`";
-    query << ") VALUES (";
-
-    query << db->EscapeString(g.uuid) << ", ";
-    query << db->EscapeString(g.questUuid) << ", ";
-    query << db->EscapeString(g.playerUuid) << ", ";
-    query << (g.completed ? 1 : 0) << ", ";
-    query << (g.rewarded ? 1 : 0) << ", ";
-    query << db->EscapeBlob(g.progress.data(), g.progress.length()) << ", ";
-    query << g.pickupTime << ", ";
-    query << g.completeTime << ", ";
-    query << g.rewardTime << ", ";
-    query << (g.deleted ? 1 : 0);
-
-    query << ")";
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+    DBParams params(10);
+    params.Add(g.uuid)
+        .Add(g.questUuid)
+        .Add(g.playerUuid)
+        .Add(g.completed ? 1 : 0)
+        .Add(g.rewarded ? 1 : 0)
+        .AddBlob(g.progress)
+        .Add(g.pickupTime)
+        .Add(g.completeTime)
+        .Add(g.rewardTime)
+        .Add(g.deleted ? 1 : 0);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(CREATE_PLAYER_QUEST, params))
         return false;
 
     // End transaction
@@ -66,6 +72,20 @@ bool DBPlayerQuest::Create(AB::Entities::PlayerQuest& g)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::PlayerQuest& g)
+{
+    g.uuid = result.GetString("uuid");
+    g.playerUuid = result.GetString("player_uuid");
+    g.questUuid = result.GetString("quests_uuid");
+    g.completed = result.GetUInt("completed") != 0;
+    g.rewarded = result.GetUInt("rewarded") != 0;
+    g.progress = result.GetStream("progress");
+    g.pickupTime = result.GetLong("picked_up_times");
+    g.completeTime = result.GetLong("completed_time");
+    g.rewardTime = result.GetLong("rewarded_time");
+    g.deleted = result.GetUInt("deleted");
+}
+
 bool DBPlayerQuest::Load(AB::Entities::PlayerQuest& g)
 {
     if (Utils::Uuid::IsEmpty(g.uuid))
@@ -74,29 +94,31 @@ bool DBPlayerQuest::Load(AB::Entities::PlayerQuest& g)
         return false;
     }
 
-    std::ostringstream query;
-    Database* db = GetSubsystem<Database>();
-    query << "SELECT * FROM `player_quests` WHERE ";
-    query << "`uuid` = " << db->EscapeString(g.uuid) << " AND `deleted` = 0";
-
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+    std::shared_ptr<DB::DBResult> result = db->StoreQuery(LOAD_PLAYER_QUEST, DBParams(1).Add(g.uuid));
     if (!result)
         return false;
 
-    g.uuid = result->GetString("uuid");
-    g.playerUuid = result->GetString("player_uuid");
-    g.questUuid = result->GetString("quests_uuid");
-    g.completed = result->GetUInt("completed") != 0;
-    g.rewarded = result->GetUInt("rewarded") != 0;
-    g.progress = result->GetStream("progress");
-    g.pickupTime = result->GetLong("picked_up_times");
-    g.completeTime = result->GetLong("completed_time");
-    g.rewardTime = result->GetLong("rewarded_time");
-    g.deleted = result->GetUInt("deleted");
+    LoadFromResult(*result, g);
 
     return true;
 }
 
+bool DBPlayerQuest::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::PlayerQuest>& quests)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `player_quests` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ") AND `deleted` = 0";
+
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        quests.emplace_back();
+        LoadFromResult(*result, quests.back());
+    }
+    return true;
+}
+
 bool DBPlayerQuest::Save(const AB::Entities::PlayerQuest& g)
 {
     if (Utils::Uuid::IsEmpty(g.uuid))
@@ -105,27 +127,23 @@ bool DBPlayerQuest::Save(const AB::Entities::PlayerQuest& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-
-    query << "UPDATE `player_quests` SET ";
-
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     // Only these may be changed
-    query << " `completed` = " << (g.completed ? 1 : 0) << ", ";
-    query << " `rewarded` = " << (g.rewarded ? 1 : 0) << ", ";
-    query << " `progress` = " << db->EscapeBlob(g.progress.data(), g.progress.length()) << ", ";
-    query << " `picked_up_times` = " << g.pickupTime << ", ";
-    query << " `completed_time` = " << g.completeTime << ", ";
-    query << " `rewarded_time` = " << g.rewardTime << ", ";
-    query << " `deleted` = " << (g.deleted ? 1 : 0);
-
-    query << " WHERE `uuid` = " << db->EscapeString(g.uuid);
+    DBParams params(8);
+    params.Add(g.completed ? 1 : 0)
+        .Add(g.rewarded ? 1 : 0)
+        .AddBlob(g.progress)
+        .Add(g.pickupTime)
+        .Add(g.completeTime)
+        .Add(g.rewardTime)
+        .Add(g.deleted ? 1 : 0)
+        .Add(g.uuid);
 
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(SAVE_PLAYER_QUEST, params))
         return false;
 
     // End transaction
@@ -140,14 +158,12 @@ bool DBPlayerQuest::Delete(const AB::Entities::PlayerQuest& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
-    std::ostringstream query;
-    query << "DELETE FROM `player_quests` WHERE `uuid` = " << db->EscapeString(g.uuid);
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     DBTransaction transaction(db);
     if (!transaction.Begin())
         return false;
 
-    if (!db->ExecuteQuery(query.str()))
+    if (!db->ExecuteQuery(DELETE_PLAYER_QUEST, DBParams(1).Add(g.uuid)))
         return false;
 
     // End transaction
@@ -161,13 +177,9 @@ bool DBPlayerQuest::Exists(const AB::Entities::PlayerQuest& g)
         LOG_ERROR << "UUID required" << std::endl;
         return false;
     }
-    Database* db = GetSubsystem<Database>();
-
-    std::ostringstream query;
-    query << "SELECT COUNT(*) AS `count` FROM `player_quests` WHERE ";
-    query << "`uuid` = " << db->EscapeString(g.uuid) << " AND `deleted` = 0";
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
-    std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str());
+    std::shared_ptr<DB::DBResult> result = db->StoreQuery(EXISTS_PLAYER_QUEST, DBParams(1).Add(g.uuid));
     if (!result)
         return false;
     return result->GetUInt("count") != 0;
@@ -33,6 +33,8 @@ public:
 
     static bool Create(AB::Entities::PlayerQuest&);
     static bool Load(AB::Entities::PlayerQuest&);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::PlayerQuest>& quests);
     static bool Save(const AB::Entities::PlayerQuest&);
     static bool Delete(const AB::Entities::PlayerQuest&);
     static bool Exists(const AB::Entities::PlayerQuest&);
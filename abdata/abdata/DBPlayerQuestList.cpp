@@ -42,7 +42,7 @@ bool DBPlayerQuestList::Load(AB::Entities::PlayerQuestList& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `quests_uuid` FROM `player_quests` WHERE ";
@@ -86,7 +86,7 @@ bool DBPlayerQuestList::Exists(const AB::Entities::PlayerQuestList& g)
         LOG_ERROR << "UUID is empty" << std::endl;
         return false;
     }
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `player_quests` WHERE ";
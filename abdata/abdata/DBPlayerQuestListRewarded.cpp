@@ -42,7 +42,7 @@ bool DBPlayerQuestListRewarded::Load(AB::Entities::PlayerQuestListRewarded& g)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `quest_uuid` FROM `player_quests` WHERE ";
@@ -86,7 +86,7 @@ bool DBPlayerQuestListRewarded::Exists(const AB::Entities::PlayerQuestListReward
         LOG_ERROR << "UUID is empty" << std::endl;
         return false;
     }
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `player_quests` WHERE ";
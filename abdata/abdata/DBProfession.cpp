@@ -37,7 +37,7 @@ bool DBProfession::Create(AB::Entities::Profession& prof)
 
 bool DBProfession::Load(AB::Entities::Profession& prof)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_professions` WHERE ";
@@ -113,7 +113,7 @@ bool DBProfession::Delete(const AB::Entities::Profession& prof)
 
 bool DBProfession::Exists(const AB::Entities::Profession& prof)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `game_professions` WHERE ";
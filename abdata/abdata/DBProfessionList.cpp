@@ -31,7 +31,7 @@ bool DBProfessionList::Create(AB::Entities::ProfessionList&)
 
 bool DBProfessionList::Load(AB::Entities::ProfessionList& pl)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_professions`";
@@ -33,7 +33,7 @@ bool DBQuest::Create(AB::Entities::Quest& v)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "INSERT INTO `game_quests` (`uuid`, `idx`, `name`, `script`, `repeatable`, `description` " <<
         "`depends_on_uuid`, `reward_xp`, `reward_money`, `reward_items`";
@@ -66,9 +66,23 @@ bool DBQuest::Create(AB::Entities::Quest& v)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::Quest& v)
+{
+    v.uuid = result.GetString("uuid");
+    v.index = result.GetUInt("idx");
+    v.name = result.GetString("name");
+    v.script = result.GetString("script");
+    v.repeatable = result.GetUInt("repeatable") != 0;
+    v.description = result.GetString("description");
+    v.dependsOn = result.GetString("depends_on_uuid");
+    v.rewardXp = result.GetInt("reward_xp");
+    v.rewardMoney = result.GetInt("reward_money");
+    v.rewardItems = Utils::Split(result.GetString("reward_items"), ";");
+}
+
 bool DBQuest::Load(AB::Entities::Quest& v)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_quests` WHERE ";
@@ -86,17 +100,23 @@ bool DBQuest::Load(AB::Entities::Quest& v)
     if (!result)
         return false;
 
-    v.uuid = result->GetString("uuid");
-    v.index = result->GetUInt("idx");
-    v.name = result->GetString("name");
-    v.script = result->GetString("script");
-    v.repeatable = result->GetUInt("repeatable") != 0;
-    v.description = result->GetString("description");
-    v.dependsOn = result->GetString("depends_on_uuid");
-    v.rewardXp = result->GetInt("reward_xp");
-    v.rewardMoney = result->GetInt("reward_money");
-    v.rewardItems = Utils::Split(result->GetString("reward_items"), ";");
+    LoadFromResult(*result, v);
+
+    return true;
+}
+
+bool DBQuest::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Quest>& quests)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `game_quests` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        quests.emplace_back();
+        LoadFromResult(*result, quests.back());
+    }
     return true;
 }
 
@@ -108,7 +128,7 @@ bool DBQuest::Save(const AB::Entities::Quest& v)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `game_quests` SET ";
@@ -144,7 +164,7 @@ bool DBQuest::Delete(const AB::Entities::Quest&)
 
 bool DBQuest::Exists(const AB::Entities::Quest& v)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `game_quests` WHERE ";
@@ -33,6 +33,8 @@ public:
 
     static bool Create(AB::Entities::Quest&);
     static bool Load(AB::Entities::Quest&);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Quest>& quests);
     static bool Save(const AB::Entities::Quest&);
     static bool Delete(const AB::Entities::Quest&);
     static bool Exists(const AB::Entities::Quest&);
@@ -31,7 +31,7 @@ bool DBQuestList::Create(AB::Entities::QuestList&)
 
 bool DBQuestList::Load(AB::Entities::QuestList& q)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_quests`";
@@ -36,7 +36,7 @@ bool DBReservedName::Create(AB::Entities::ReservedName& rn)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "INSERT INTO `reserved_names` (`uuid`, `name`, `is_reserved`, `reserved_for_account_uuid`, `expires`";
     query << ") VALUES (";
@@ -65,7 +65,7 @@ bool DBReservedName::Create(AB::Entities::ReservedName& rn)
 
 bool DBReservedName::Load(AB::Entities::ReservedName& n)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `reserved_names` WHERE ";
@@ -100,7 +100,7 @@ bool DBReservedName::Save(const AB::Entities::ReservedName& rn)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `reserved_names` SET ";
@@ -130,7 +130,7 @@ bool DBReservedName::Delete(const AB::Entities::ReservedName& rn)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `reserved_names` WHERE `uuid` = " << db->EscapeString(rn.uuid);
     DBTransaction transaction(db);
@@ -146,7 +146,7 @@ bool DBReservedName::Delete(const AB::Entities::ReservedName& rn)
 
 bool DBReservedName::Exists(const AB::Entities::ReservedName& n)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `reserved_names` WHERE ";
@@ -171,7 +171,7 @@ bool DBReservedName::Exists(const AB::Entities::ReservedName& n)
 void DBReservedName::DeleteExpired(StorageProvider* sp)
 {
     // When expires == 0 it does not expire, otherwise it's the time stamp
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "SELECT `uuid` FROM `reserved_names` WHERE ";
     query << "(`expires` <> 0 AND `expires` < " << Utils::Tick() << ")";
@@ -32,7 +32,7 @@ bool DBService::Create(AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "INSERT INTO `services` (`uuid`, `name`, `type`, `location`, `host`, `port`, " <<
@@ -79,7 +79,7 @@ bool DBService::Load(AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `services` WHERE ";
@@ -116,7 +116,7 @@ bool DBService::Save(const AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
 
     query << "UPDATE `services` SET ";
@@ -156,7 +156,7 @@ bool DBService::Delete(const AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
     std::ostringstream query;
     query << "DELETE FROM `services` WHERE `uuid` = " << db->EscapeString(s.uuid);
     DBTransaction transaction(db);
@@ -178,7 +178,7 @@ bool DBService::Exists(const AB::Entities::Service& s)
         return false;
     }
 
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `services` WHERE ";
@@ -31,7 +31,7 @@ bool DBServicelList::Create(AB::Entities::ServiceList&)
 
 bool DBServicelList::Load(AB::Entities::ServiceList& sl)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `services` ORDER BY `type`";
@@ -35,9 +35,34 @@ bool DBSkill::Create(AB::Entities::Skill& skill)
     return true;
 }
 
+static void LoadFromResult(DBResult& result, AB::Entities::Skill& skill)
+{
+    skill.uuid = result.GetString("uuid");
+    skill.index = result.GetUInt("idx");
+    skill.name = result.GetString("name");
+    skill.attributeUuid = result.GetString("attribute_uuid");
+    skill.professionUuid = result.GetString("profession_uuid");
+    skill.type = static_cast<AB::Entities::SkillType>(result.GetULong("type"));
+    skill.isElite = result.GetUInt("is_elite") != 0;
+    skill.description = result.GetString("description");
+    skill.shortDescription = result.GetString("short_description");
+    skill.icon = result.GetString("icon");
+    skill.script = result.GetString("script");
+    skill.access = result.GetUInt("access");
+    skill.soundEffect = result.GetString("sound_effect");
+    skill.particleEffect = result.GetString("particle_effect");
+    skill.activation = result.GetInt("activation");
+    skill.recharge = result.GetInt("recharge");
+    skill.costEnergy = result.GetInt("const_energy");
+    skill.costEnergyRegen = result.GetInt("const_energy_regen");
+    skill.costAdrenaline = result.GetInt("const_adrenaline");
+    skill.costOvercast = result.GetInt("const_overcast");
+    skill.costHp = result.GetInt("const_hp");
+}
+
 bool DBSkill::Load(AB::Entities::Skill& skill)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `game_skills` WHERE ";
@@ -51,28 +76,23 @@ bool DBSkill::Load(AB::Entities::Skill& skill)
     if (!result)
         return false;
 
-    skill.uuid = result->GetString("uuid");
-    skill.index = result->GetUInt("idx");
-    skill.name = result->GetString("name");
-    skill.attributeUuid = result->GetString("attribute_uuid");
-    skill.professionUuid = result->GetString("profession_uuid");
-    skill.type = static_cast<AB::Entities::SkillType>(result->GetULong("type"));
-    skill.isElite = result->GetUInt("is_elite") != 0;
-    skill.description = result->GetString("description");
-    skill.shortDescription = result->GetString("short_description");
-    skill.icon = result->GetString("icon");
-    skill.script = result->GetString("script");
-    skill.access = result->GetUInt("access");
-    skill.soundEffect = result->GetString("sound_effect");
-    skill.particleEffect = result->GetString("particle_effect");
-    skill.activation = result->GetInt("activation");
-    skill.recharge = result->GetInt("recharge");
-    skill.costEnergy = result->GetInt("const_energy");
-    skill.costEnergyRegen = result->GetInt("const_energy_regen");
-    skill.costAdrenaline = result->GetInt("const_adrenaline");
-    skill.costOvercast = result->GetInt("const_overcast");
-    skill.costHp = result->GetInt("const_hp");
+    LoadFromResult(*result, skill);
+
+    return true;
+}
+
+bool DBSkill::LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Skill>& skills)
+{
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
+
+    std::ostringstream query;
+    query << "SELECT * FROM `game_skills` WHERE `uuid` IN (" << db->EscapeStringList(uuids) << ")";
 
+    for (std::shared_ptr<DB::DBResult> result = db->StoreQuery(query.str()); result; result = result->Next())
+    {
+        skills.emplace_back();
+        LoadFromResult(*result, skills.back());
+    }
     return true;
 }
 
@@ -100,7 +120,7 @@ bool DBSkill::Delete(const AB::Entities::Skill& skill)
 
 bool DBSkill::Exists(const AB::Entities::Skill& skill)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `game_skills` WHERE ";
@@ -33,6 +33,8 @@ public:
 
     static bool Create(AB::Entities::Skill& skill);
     static bool Load(AB::Entities::Skill& skill);
+    /// Load the records with these UUIDs with one query. Not existing records are missing in the result.
+    static bool LoadMany(const std::vector<std::string>& uuids, std::vector<AB::Entities::Skill>& skills);
     static bool Save(const AB::Entities::Skill& skill);
     static bool Delete(const AB::Entities::Skill& skill);
     static bool Exists(const AB::Entities::Skill& skill);
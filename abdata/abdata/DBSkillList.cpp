@@ -31,7 +31,7 @@ bool DBSkillList::Create(AB::Entities::SkillList&)
 
 bool DBSkillList::Load(AB::Entities::SkillList& sl)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT `uuid` FROM `game_skills`";
@@ -31,7 +31,7 @@ bool DBTypedItemList::Create(AB::Entities::TypedItemList&)
 
 bool DBTypedItemList::Load(AB::Entities::TypedItemList& il)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     /// il.uuid may also be an empty GUID
     std::ostringstream query;
@@ -32,7 +32,7 @@ bool DBVersion::Create(AB::Entities::Version&)
 
 bool DBVersion::Load(AB::Entities::Version& v)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `versions` WHERE ";
@@ -72,7 +72,7 @@ bool DBVersion::Delete(const AB::Entities::Version&)
 
 bool DBVersion::Exists(const AB::Entities::Version& v)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT COUNT(*) AS `count` FROM `versions` WHERE ";
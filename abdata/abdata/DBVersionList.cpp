@@ -31,7 +31,7 @@ bool DBVersionList::Create(AB::Entities::VersionList&)
 
 bool DBVersionList::Load(AB::Entities::VersionList& vl)
 {
-    Database* db = GetSubsystem<Database>();
+    auto db = GetSubsystem<DatabasePool>()->Acquire();
 
     std::ostringstream query;
     query << "SELECT * FROM `versions` WHERE `internal` = 0";
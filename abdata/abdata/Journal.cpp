@@ -0,0 +1,298 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include "Journal.h"
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#if defined(AB_WINDOWS)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Record: type (1 byte), key size (2 bytes), key, data size (4 bytes), data, checksum (4 bytes)
+static constexpr size_t RECORD_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint16_t);
+
+template<typename T>
+static void WriteValue(std::vector<uint8_t>& buffer, T value)
+{
+    const auto* p = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+template<typename T>
+static bool ReadValue(const std::vector<uint8_t>& buffer, size_t& pos, T& value)
+{
+    if (pos + sizeof(T) > buffer.size())
+        return false;
+    memcpy(&value, buffer.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+static uint32_t Checksum(const uint8_t* data, size_t size)
+{
+    return static_cast<uint32_t>(sa::StringHashRt(reinterpret_cast<const char*>(data), size));
+}
+
+Journal::Journal(std::string dir) :
+    dir_(std::move(dir))
+{ }
+
+Journal::~Journal()
+{
+    Close();
+}
+
+std::string Journal::GetFilename(uint64_t segment) const
+{
+    std::stringstream ss;
+    ss << std::setw(16) << std::setfill('0') << segment << ".journal";
+    return (fs::path(dir_) / ss.str()).string();
+}
+
+std::vector<uint64_t> Journal::GetSegments() const
+{
+    std::vector<uint64_t> result;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir_, ec))
+    {
+        const fs::path& path = entry.path();
+        if (path.extension() != ".journal")
+            continue;
+        const std::string name = path.stem().string();
+        if (name.empty() || name.find_first_not_of("0123456789") != std::string::npos)
+            continue;
+        result.push_back(std::stoull(name));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool Journal::OpenSegment(uint64_t segment)
+{
+    const std::string filename = GetFilename(segment);
+    file_ = fopen(filename.c_str(), "ab");
+    if (!file_)
+    {
+        LOG_ERROR << "Unable to open journal " << filename << std::endl;
+        return false;
+    }
+    segment_ = segment;
+    return true;
+}
+
+bool Journal::Open()
+{
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (ec)
+    {
+        LOG_ERROR << "Unable to create directory " << dir_ << ": " << ec.message() << std::endl;
+        return false;
+    }
+    const auto segments = GetSegments();
+    {
+        std::scoped_lock fileLock(fileLock_);
+        if (!OpenSegment(segments.empty() ? 1 : segments.back() + 1))
+            return false;
+    }
+    running_ = true;
+    thread_ = std::thread(&Journal::WriterThread, this);
+    return true;
+}
+
+void Journal::Close()
+{
+    {
+        std::scoped_lock lock(lock_);
+        if (!running_)
+            return;
+        running_ = false;
+    }
+    signal_.notify_one();
+    if (thread_.joinable())
+        thread_.join();
+
+    std::scoped_lock fileLock(fileLock_);
+    WritePending();
+    if (file_)
+    {
+        fclose(file_);
+        file_ = nullptr;
+        // Don't leave empty segments behind
+        std::error_code ec;
+        const std::string filename = GetFilename(segment_);
+        if (fs::file_size(filename, ec) == 0 && !ec)
+            fs::remove(filename, ec);
+    }
+}
+
+void Journal::WritePending()
+{
+    std::vector<uint8_t> pending;
+    {
+        std::scoped_lock lock(lock_);
+        pending.swap(buffer_);
+    }
+    if (pending.empty() || !file_)
+        return;
+
+    if (fwrite(pending.data(), 1, pending.size(), file_) != pending.size())
+        LOG_ERROR << "Error writing journal " << GetFilename(segment_) << std::endl;
+    fflush(file_);
+#if defined(AB_WINDOWS)
+    _commit(_fileno(file_));
+#else
+    fsync(fileno(file_));
+#endif
+}
+
+void Journal::WriterThread()
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            signal_.wait(lock, [this] { return !running_ || !buffer_.empty(); });
+            if (!running_)
+                break;
+        }
+        // Everything appended while we were waiting for the disk is written with
+        // the next sync
+        std::scoped_lock fileLock(fileLock_);
+        WritePending();
+    }
+}
+
+void Journal::Append(RecordType type, const IO::DataKey& key, const std::vector<uint8_t>* data)
+{
+    {
+        std::scoped_lock lock(lock_);
+        const size_t start = buffer_.size();
+        WriteValue<uint8_t>(buffer_, static_cast<uint8_t>(type));
+        WriteValue<uint16_t>(buffer_, static_cast<uint16_t>(key.size()));
+        buffer_.insert(buffer_.end(), key.data(), key.data() + key.size());
+        WriteValue<uint32_t>(buffer_, data ? static_cast<uint32_t>(data->size()) : 0);
+        if (data)
+            buffer_.insert(buffer_.end(), data->begin(), data->end());
+        WriteValue<uint32_t>(buffer_, Checksum(buffer_.data() + start, buffer_.size() - start));
+    }
+    signal_.notify_one();
+}
+
+uint64_t Journal::Rotate()
+{
+    std::scoped_lock fileLock(fileLock_);
+    WritePending();
+    const uint64_t result = segment_;
+    if (file_)
+        fclose(file_);
+    OpenSegment(segment_ + 1);
+    return result;
+}
+
+void Journal::Remove(uint64_t segment)
+{
+    for (auto s : GetSegments())
+    {
+        if (s > segment)
+            break;
+        std::error_code ec;
+        fs::remove(GetFilename(s), ec);
+        if (ec)
+            LOG_WARNING << "Unable to delete " << GetFilename(s) << ": " << ec.message() << std::endl;
+    }
+}
+
+bool Journal::ReadSegment(uint64_t segment, const std::function<void(const Record&)>& callback, size_t& count)
+{
+    const std::string filename = GetFilename(segment);
+    std::FILE* f = fopen(filename.c_str(), "rb");
+    if (!f)
+    {
+        LOG_ERROR << "Unable to open journal " << filename << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> buffer;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), f)) != 0)
+        buffer.insert(buffer.end(), chunk, chunk + read);
+    fclose(f);
+
+    // End of the last valid record
+    size_t valid = 0;
+    size_t pos = 0;
+    while (pos + RECORD_HEADER_SIZE <= buffer.size())
+    {
+        const size_t start = pos;
+        uint8_t type = 0;
+        uint16_t keySize = 0;
+        uint32_t dataSize = 0;
+        uint32_t checksum = 0;
+        Record record;
+        ReadValue(buffer, pos, type);
+        ReadValue(buffer, pos, keySize);
+        if (pos + keySize > buffer.size())
+            break;
+        record.key.data_.assign(buffer.begin() + pos, buffer.begin() + pos + keySize);
+        pos += keySize;
+        if (!ReadValue(buffer, pos, dataSize) || pos + dataSize > buffer.size())
+            break;
+        record.data.assign(buffer.begin() + pos, buffer.begin() + pos + dataSize);
+        pos += dataSize;
+        const uint32_t expected = Checksum(buffer.data() + start, pos - start);
+        if (!ReadValue(buffer, pos, checksum) || checksum != expected)
+            break;
+        if (type != static_cast<uint8_t>(RecordType::Update) && type != static_cast<uint8_t>(RecordType::Delete))
+            break;
+        record.type = static_cast<RecordType>(type);
+        callback(record);
+        ++count;
+        valid = pos;
+    }
+    if (valid != buffer.size())
+        // Most likely the last record was not completely written when we crashed
+        LOG_WARNING << "Journal " << filename << " is truncated at offset " << valid << std::endl;
+    return true;
+}
+
+size_t Journal::Replay(const std::function<void(const Record&)>& callback)
+{
+    uint64_t current;
+    {
+        std::scoped_lock fileLock(fileLock_);
+        current = segment_;
+    }
+    size_t count = 0;
+    for (auto s : GetSegments())
+    {
+        if (s >= current)
+            break;
+        ReadSegment(s, callback, count);
+    }
+    return count;
+}
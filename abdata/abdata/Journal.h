@@ -0,0 +1,92 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <abscommon/DataKey.h>
+
+/// Append only log of changes that are not yet written to the database. The
+/// log is split into segments, a new segment is started with each checkpoint
+/// and the old ones are deleted once the cache was flushed. After a crash the
+/// remaining segments are replayed on the next start.
+class Journal
+{
+public:
+    enum class RecordType : uint8_t
+    {
+        Update = 1,
+        Delete = 2
+    };
+    struct Record
+    {
+        RecordType type;
+        IO::DataKey key;
+        std::vector<uint8_t> data;
+    };
+private:
+    std::string dir_;
+    std::FILE* file_{ nullptr };
+    uint64_t segment_{ 0 };
+    bool running_{ false };
+    /// Protects buffer_ and running_
+    std::mutex lock_;
+    /// Protects file_ and segment_
+    std::mutex fileLock_;
+    std::condition_variable signal_;
+    /// Records not yet written to the file
+    std::vector<uint8_t> buffer_;
+    std::thread thread_;
+    std::string GetFilename(uint64_t segment) const;
+    /// Returns the numbers of all existing segments, sorted
+    std::vector<uint64_t> GetSegments() const;
+    bool OpenSegment(uint64_t segment);
+    /// Caller must hold fileLock_
+    void WritePending();
+    void WriterThread();
+    bool ReadSegment(uint64_t segment, const std::function<void(const Record&)>& callback, size_t& count);
+public:
+    explicit Journal(std::string dir);
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /// Start a new segment after the existing ones
+    bool Open();
+    /// Write everything and stop the writer thread
+    void Close();
+    /// Read the records of all segments before the current one, in the order they were written.
+    /// Returns the number of records.
+    size_t Replay(const std::function<void(const Record&)>& callback);
+    /// Does not block, the records are written and synced by a background thread
+    void Append(RecordType type, const IO::DataKey& key, const std::vector<uint8_t>* data = nullptr);
+    /// Write the current segment and start a new one. Returns the number of the old segment.
+    uint64_t Rotate();
+    /// Delete all segments up to and including segment
+    void Remove(uint64_t segment);
+    const std::string& GetDirectory() const { return dir_; }
+};
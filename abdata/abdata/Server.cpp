@@ -28,14 +28,14 @@
 #include <AB/CommonConfig.h>
 
 Server::Server(asio::io_service& io_service, uint32_t ip,
-    uint16_t port, size_t maxCacheSize, bool readonly,
+    uint16_t port, size_t maxCacheSize, size_t cacheShards, bool readonly,
     Net::IpList& whiteList) :
     io_service_(io_service),
     acceptor_(
         io_service,
         asio::ip::tcp::endpoint(asio::ip::address(asio::ip::address_v4(ip)), port)
     ),
-    storageProvider_(maxCacheSize, readonly),
+    storageProvider_(maxCacheSize, readonly, cacheShards),
     whiteList_(whiteList),
     maxDataSize_(MAX_DATA_SIZE),
     maxKeySize_(MAX_KEY_SIZE)
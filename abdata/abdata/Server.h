@@ -29,7 +29,7 @@ class Server {
 
 public:
     Server(asio::io_service& io_service, uint32_t ip,
-        uint16_t port, size_t maxCacheSize, bool readonly,
+        uint16_t port, size_t maxCacheSize, size_t cacheShards, bool readonly,
         Net::IpList& whiteList);
     ~Server();
     void Shutdown();
@@ -23,12 +23,35 @@
 #include "StorageProvider.h"
 #include "DBAll.h"
 #include <AB/Entities/Party.h>
-#include <abscommon/Dispatcher.h>
 #include <abscommon/Profiler.h>
 #include <abscommon/Scheduler.h>
 #include <abscommon/ThreadPool.h>
 #include <sstream>
 
+static void WritePoolStats(std::ostream& os, const DB::DatabasePool::Stats& s)
+{
+    os << "DB pool: " << s.active << "/" << s.size << " connection(s) active, " <<
+        s.waits << " wait(s), avg " << (s.waits != 0 ? (s.waitTime / s.waits) : 0) << "us, max " << s.maxWaitTime << "us";
+}
+
+static void WriteShardStats(std::ostream& os, size_t index, const CacheShardStats& s)
+{
+    const uint64_t reads = s.hits + s.misses;
+    os << "Cache shard " << index << ": " << s.items << " item(s), size " << Utils::ConvertSize(s.size) <<
+        "/" << Utils::ConvertSize(s.maxSize) <<
+        ", hit rate " << (reads != 0 ? (s.hits * 100 / reads) : 0) << "% of " << reads << " read(s)" <<
+        ", queue depth " << s.queueDepth;
+}
+
+// Nothing to write to the DB
+static bool IsClean(const CacheFlags& flags)
+{
+    // A deleted record is clean when it's not in the DB (anymore)
+    if (flags.deleted)
+        return !flags.created;
+    return flags.created && !flags.modified;
+}
+
 static constexpr size_t KEY_ACCOUNTS_HASH = sa::StringHash(AB::Entities::Account::KEY());
 static constexpr size_t KEY_CHARACTERS_HASH = sa::StringHash(AB::Entities::Character::KEY());
 static constexpr size_t KEY_GAMES_HASH = sa::StringHash(AB::Entities::Game::KEY());
@@ -79,15 +102,23 @@ static constexpr size_t KEY_WEAPONPREFIXITEMLIST_HASH = sa::StringHash(AB::Entit
 static constexpr size_t KEY_WEAPONSUFFIXITEMLIST_HASH = sa::StringHash(AB::Entities::TypedItemsWeaponSuffix::KEY());
 static constexpr size_t KEY_WEAPONINSCRIPTIONITEMLIST_HASH = sa::StringHash(AB::Entities::TypedItemsWeaponInscription::KEY());
 
-StorageProvider::StorageProvider(size_t maxSize, bool readonly) :
+StorageProvider::StorageProvider(size_t maxSize, bool readonly, size_t shards) :
     flushInterval_(FLUSH_CACHE_MS),
     cleanInterval_(CLEAN_CACHE_MS),
+    writeLatency_(WRITE_LATENCY_MS),
+    writeBatchSize_(WRITE_BATCH_SIZE),
     readonly_(readonly),
     running_(true),
-    maxSize_(maxSize),
-    currentSize_(0),
-    cache_()
+    maxSize_(maxSize)
 {
+    const size_t count = std::max<size_t>(1, shards);
+    shards_.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto shard = std::make_unique<Shard>();
+        shard->maxSize = maxSize_ / count;
+        shards_.push_back(std::move(shard));
+    }
     InitEnitityClasses();
     auto sched = GetSubsystem<Asynch::Scheduler>();
     sched->Add(
@@ -96,6 +127,49 @@ StorageProvider::StorageProvider(size_t maxSize, bool readonly) :
     sched->Add(
         Asynch::CreateScheduledTask(CLEAN_CACHE_MS, std::bind(&StorageProvider::CleanTask, this))
     );
+    sched->Add(
+        Asynch::CreateScheduledTask(WRITE_LATENCY_MS, std::bind(&StorageProvider::WriteBehindTask, this))
+    );
+}
+
+bool StorageProvider::OpenJournal(const std::string& dir)
+{
+    if (readonly_)
+        return true;
+
+    journal_ = std::make_unique<Journal>(dir);
+    if (!journal_->Open())
+    {
+        journal_.reset();
+        return false;
+    }
+
+    // Apply the changes that were not written to the DB. Replayed changes are
+    // appended to the new segment, so they are not lost when writing them fails.
+    const size_t count = journal_->Replay([this](const Journal::Record& record)
+    {
+        switch (record.type)
+        {
+        case Journal::RecordType::Update:
+            Update(record.key, std::make_shared<std::vector<uint8_t>>(record.data));
+            break;
+        case Journal::RecordType::Delete:
+        {
+            // You can only delete what you've loaded before
+            SharedBuffer data = std::make_shared<std::vector<uint8_t>>();
+            Read(record.key, data);
+            Delete(record.key);
+            break;
+        }
+        }
+    });
+    if (count == 0)
+        return true;
+
+    LOG_INFO << "Replayed " << count << " record(s) from journal" << std::endl;
+    if (!Checkpoint())
+        LOG_WARNING << "Unable to write replayed journal" << std::endl;
+    return true;
 }
 
 void StorageProvider::InitEnitityClasses()
@@ -151,23 +225,111 @@ void StorageProvider::InitEnitityClasses()
     AddEntityClass<DB::DBPlayerQuest, AB::Entities::PlayerQuest>();
     AddEntityClass<DB::DBPlayerQuestList, AB::Entities::PlayerQuestList>();
     AddEntityClass<DB::DBPlayerQuestListRewarded, AB::Entities::PlayerQuestListRewarded>();
+
+    AddBatchLoader<DB::DBGame, AB::Entities::Game>();
+    AddBatchLoader<DB::DBSkill, AB::Entities::Skill>();
+    AddBatchLoader<DB::DBAttribute, AB::Entities::Attribute>();
+    AddBatchLoader<DB::DBEffect, AB::Entities::Effect>();
+    AddBatchLoader<DB::DBItem, AB::Entities::Item>();
+    AddBatchLoader<DB::DBMusic, AB::Entities::Music>();
+    AddBatchLoader<DB::DBQuest, AB::Entities::Quest>();
+    AddBatchLoader<DB::DBConcreteItem, AB::Entities::ConcreteItem>();
+    AddBatchLoader<DB::DBPlayerQuest, AB::Entities::PlayerQuest>();
 }
 
-bool StorageProvider::Create(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data)
+StorageProvider::Shard& StorageProvider::GetShard(const IO::DataKey& key)
 {
-    auto _data = cache_.find(key);
+    return *shards_[std::hash<IO::DataKey>()(key) % shards_.size()];
+}
 
-    if (_data != cache_.end())
+bool StorageProvider::NeedsIO(Shard& shard, const IO::DataKey& key, IO::OpCodes op)
+{
+    switch (op)
     {
-        // If there is a deleted record we must delete it from DB now or we may get
-        // a constraint violation.
-        if ((*_data).second.first.deleted)
-            FlushData(key);
-        else
-            // Already exists
+    case IO::OpCodes::Create:
+    case IO::OpCodes::Clear:
+        return true;
+    case IO::OpCodes::Read:
+    case IO::OpCodes::Exists:
+        // Reads by name have no UUID and are never in cache
+        return shard.cache.find(key) == shard.cache.end();
+    case IO::OpCodes::Invalidate:
+    {
+        auto _data = shard.cache.find(key);
+        if (_data == shard.cache.end())
             return false;
+        const CacheFlags& flags = (*_data).second.first;
+        return flags.modified || flags.deleted || !flags.created;
+    }
+    default:
+        // Update, Delete and Preload never wait for the DB
+        return false;
+    }
+}
+
+IO::DataKey StorageProvider::GetPendingKey(const IO::DataKey& key, const std::vector<uint8_t>& data)
+{
+    std::string table;
+    uuids::uuid id;
+    if (!key.decode(table, id) || !id.nil())
+        return key;
+    // Reads by name have no UUID, the request contains the name. Queue them by
+    // table and name, not all behind one key.
+    IO::DataKey result(key);
+    result.data_.insert(result.data_.end(), data.begin(), data.end());
+    return result;
+}
+
+void StorageProvider::Schedule(const IO::DataKey& key, IO::OpCodes op, const std::vector<uint8_t>& data,
+    std::function<void()>&& request)
+{
+    // Dispatcher thread
+    const IO::DataKey pendingKey = GetPendingKey(key, data);
+    Shard& shard = GetShard(pendingKey);
+    {
+        std::scoped_lock lock(shard.lock);
+        auto it = shard.pending.find(pendingKey);
+        if (it != shard.pending.end())
+        {
+            // There is already a request for this key running, execute it afterwards
+            ++shard.queueDepth;
+            (*it).second.push_back(std::move(request));
+            return;
+        }
+        if (NeedsIO(shard, key, op))
+        {
+            shard.pending.emplace(pendingKey, std::deque<std::function<void()>>());
+            ++shard.queueDepth;
+            GetSubsystem<Asynch::ThreadPool>()->Enqueue(&StorageProvider::RunPending, this,
+                std::ref(shard), pendingKey, std::move(request));
+            return;
+        }
+    }
+    request();
+}
+
+void StorageProvider::RunPending(Shard& shard, const IO::DataKey& key, std::function<void()> request)
+{
+    // ThreadPool thread
+    for (;;)
+    {
+        request();
+        --shard.queueDepth;
+
+        std::scoped_lock lock(shard.lock);
+        auto it = shard.pending.find(key);
+        if ((*it).second.empty())
+        {
+            shard.pending.erase(it);
+            return;
+        }
+        request = std::move((*it).second.front());
+        (*it).second.pop_front();
     }
+}
 
+bool StorageProvider::Create(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data)
+{
     std::string table;
     uuids::uuid _id;
     if (!key.decode(table, _id))
@@ -181,7 +343,28 @@ bool StorageProvider::Create(const IO::DataKey& key, std::shared_ptr<std::vector
         return false;
     }
 
-    CacheData(table, _id, data, false, false);
+    Shard& shard = GetShard(key);
+    bool deleted = false;
+    {
+        std::scoped_lock lock(shard.lock);
+        auto _data = shard.cache.find(key);
+        if (_data != shard.cache.end())
+        {
+            if (!(*_data).second.first.deleted)
+                // Already exists
+                return false;
+            deleted = true;
+        }
+    }
+    // If there is a deleted record we must delete it from DB now or we may get
+    // a constraint violation.
+    if (deleted)
+        FlushData(key);
+
+    {
+        std::scoped_lock lock(shard.lock);
+        CacheData(shard, table, _id, data, false, false);
+    }
 
     // Unfortunately we must flush the data for create operations. Or we find a way
     // to check constraints, unique columns etc.
@@ -208,68 +391,90 @@ bool StorageProvider::Update(const IO::DataKey& key, std::shared_ptr<std::vector
         // Does not exist
         return false;
 
-    auto _data = cache_.find(key);
-    // The only possibility to update a not yet created entity is when its in cache and not flushed.
-    bool isCreated = true;
-    if (_data != cache_.end())
-        isCreated = (*_data).second.first.created;
-
-    // The client sets the data so this is not stored in DB
-    CacheData(table, id, data, true, isCreated);
+    Shard& shard = GetShard(key);
+    {
+        std::scoped_lock lock(shard.lock);
+        auto _data = shard.cache.find(key);
+        // The only possibility to update a not yet created entity is when its in cache and not flushed.
+        bool isCreated = true;
+        if (_data != shard.cache.end())
+            isCreated = (*_data).second.first.created;
+
+        // The client sets the data so this is not stored in DB
+        CacheData(shard, table, id, data, true, isCreated);
+    }
+    if (journal_)
+        journal_->Append(Journal::RecordType::Update, key, data.get());
+    MarkDirty(key);
     return true;
 }
 
-void StorageProvider::CacheData(const std::string& table, const uuids::uuid& id,
-    std::shared_ptr<std::vector<uint8_t>> data, bool modified, bool created)
+void StorageProvider::CacheData(Shard& shard, const std::string& table, const uuids::uuid& id,
+    SharedBuffer data, bool modified, bool created)
 {
     size_t sizeNeeded = data->size();
-    if (!EnoughSpace(sizeNeeded))
+    if (shard.currentSize + sizeNeeded > shard.maxSize && !shard.evicting.exchange(true))
     {
         // Create space later
-        GetSubsystem<Asynch::Dispatcher>()->Add(
-            Asynch::CreateTask(std::bind(&StorageProvider::CreateSpace, this, sizeNeeded))
-        );
+        GetSubsystem<Asynch::ThreadPool>()->Enqueue(&StorageProvider::CreateSpace, this,
+            std::ref(shard), sizeNeeded);
     }
 
     const IO::DataKey key(table, id);
 
     // we check if its already in cache
-    if (cache_.find(key) == cache_.end())
+    auto _data = shard.cache.find(key);
+    if (_data == shard.cache.end())
     {
-        index_.Add(key);
-        currentSize_ += data->size();
+        shard.index.Add(key);
+        shard.currentSize += data->size();
+        shard.cache.emplace(key, CacheItem{ { created, modified, false }, data });
     }
     else
     {
-        index_.Refresh(key);
-        currentSize_ = (currentSize_ - cache_[key].second->size()) + data->size();
+        shard.index.Refresh(key);
+        shard.currentSize = (shard.currentSize - (*_data).second.second->size()) + data->size();
+        (*_data).second = { { created, modified, false }, data };
     }
 
-    cache_[key] = { { created, modified, false }, data };
-
     // Special case for player names
     size_t tableHash = sa::StringHashRt(table.data());
     if (tableHash == KEY_CHARACTERS_HASH)
     {
         AB::Entities::Character ch;
         if (GetEntity(*data, ch))
+        {
+            std::scoped_lock lock(namesLock_);
             namesCache_.Add(key, ch.name);
+        }
     }
 }
 
-bool StorageProvider::Read(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data)
+bool StorageProvider::ReadCached(const IO::DataKey& key, SharedBuffer& data, bool& found)
+{
+    Shard& shard = GetShard(key);
+    std::scoped_lock lock(shard.lock);
+    auto _data = shard.cache.find(key);
+    found = _data != shard.cache.end();
+    if (!found)
+        return false;
+    ++shard.hits;
+    if ((*_data).second.first.deleted)
+        // Don't return deleted items that are in cache
+        return false;
+    data = (*_data).second.second;
+    return true;
+}
+
+bool StorageProvider::Read(const IO::DataKey& key, SharedBuffer& data)
 {
 //    AB_PROFILE;
 
-    auto _data = cache_.find(key);
-    if (_data != cache_.end())
-    {
-        if ((*_data).second.first.deleted)
-            // Don't return deleted items that are in cache
-            return false;
-        data->assign((*_data).second.second->begin(), (*_data).second.second->end());
+    bool found = false;
+    if (ReadCached(key, data, found))
         return true;
-    }
+    if (found)
+        return false;
 
     std::string table;
     uuids::uuid _id;
@@ -287,57 +492,123 @@ bool StorageProvider::Read(const IO::DataKey& key, std::shared_ptr<std::vector<u
         AB::Entities::Character ch;
         if (GetEntity(*data, ch) && !ch.name.empty())
         {
-            auto* nameKey = namesCache_.LookupName(KEY_CHARACTERS_HASH, ch.name);
-            if (nameKey != nullptr)
+            IO::DataKey nameKey;
             {
-                _data = cache_.find(*nameKey);
-                if (_data != cache_.end())
-                {
-                    if ((*_data).second.first.deleted)
-                        // Don't return deleted items that are in cache
-                        return false;
-                    data->assign((*_data).second.second->begin(), (*_data).second.second->end());
+                std::scoped_lock lock(namesLock_);
+                const auto* _nameKey = namesCache_.LookupName(KEY_CHARACTERS_HASH, ch.name);
+                if (_nameKey != nullptr)
+                    nameKey = *_nameKey;
+            }
+            if (nameKey.size() != 0)
+            {
+                if (ReadCached(nameKey, data, found))
                     return true;
-                }
+                if (found)
+                    return false;
             }
         }
     }
 
     // Really not in cache
-    if (!LoadData(key, data))
+    ++GetShard(key).misses;
+    auto loaded = std::make_shared<std::vector<uint8_t>>(*data);
+    if (!LoadData(key, *loaded))
         return false;
+    data = std::move(loaded);
 
     if (_id.nil())
         // If no UUID given in key (e.g. when reading by name) cache with the proper key
         _id = GetUuid(*data);
-    const IO::DataKey newKey(table, _id);
-    auto _newdata = cache_.find(newKey);
-    if (_newdata == cache_.end())
+    return AddLoaded(table, _id, data);
+}
+
+bool StorageProvider::AddLoaded(const std::string& table, const uuids::uuid& id, SharedBuffer& data)
+{
+    const IO::DataKey key(table, id);
+    Shard& shard = GetShard(key);
+    std::scoped_lock lock(shard.lock);
+    auto _data = shard.cache.find(key);
+    if (_data == shard.cache.end())
     {
-        CacheData(table, _id, data, false, true);
+        CacheData(shard, table, id, data, false, true);
+        return true;
     }
-    else
+    // Was already cached
+    if ((*_data).second.first.deleted)
+        // Don't return deleted items that are in cache
+        return false;
+    // Return the cached object, it may have changed
+    data = (*_data).second.second;
+    return true;
+}
+
+void StorageProvider::ScheduleMany(const std::vector<IO::DataKey>& keys, std::function<void()>&& request)
+{
+    // Dispatcher thread
+    for (const auto& key : keys)
     {
-        // Was already cached
-        if ((*_newdata).second.first.deleted)
-            // Don't return deleted items that are in cache
-            return false;
-        // Return the cached object, it may have changed
-        data->assign((*_newdata).second.second->begin(), (*_newdata).second.second->end());
+        Shard& shard = GetShard(key);
+        std::scoped_lock lock(shard.lock);
+        if (NeedsIO(shard, key, IO::OpCodes::Read))
+        {
+            GetSubsystem<Asynch::ThreadPool>()->Enqueue(std::move(request));
+            return;
+        }
     }
-    return true;
+    request();
+}
 
+void StorageProvider::ReadMany(const std::vector<IO::DataKey>& keys, std::vector<SharedBuffer>& data)
+{
+    // Indices of the records not in cache by table
+    std::unordered_map<std::string, std::vector<size_t>> missing;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        bool found = false;
+        if (ReadCached(keys[i], data[i], found))
+            continue;
+        if (found)
+        {
+            data[i].reset();
+            continue;
+        }
+        std::string table;
+        uuids::uuid id;
+        if (!keys[i].decode(table, id))
+        {
+            LOG_ERROR << "Unable to decode key" << std::endl;
+            data[i].reset();
+            continue;
+        }
+        if (id.nil() || !loadManyCallables_.Exists(sa::StringHashRt(table.data())))
+        {
+            // Reads by name and entities without batch loader are loaded one by one
+            if (!Read(keys[i], data[i]))
+                data[i].reset();
+            continue;
+        }
+        missing[table].push_back(i);
+    }
+    for (const auto& m : missing)
+        LoadMany(m.first, keys, m.second, data);
 }
 
 bool StorageProvider::Delete(const IO::DataKey& key)
 {
-    // You can only delete what you've loaded before
-    auto data = cache_.find(key);
-    if (data == cache_.end())
+    Shard& shard = GetShard(key);
     {
-        return false;
+        std::scoped_lock lock(shard.lock);
+        // You can only delete what you've loaded before
+        auto data = shard.cache.find(key);
+        if (data == shard.cache.end())
+        {
+            return false;
+        }
+        (*data).second.first.deleted = true;
     }
-    (*data).second.first.deleted = true;
+    if (journal_)
+        journal_->Append(Journal::RecordType::Delete, key);
+    MarkDirty(key);
     return true;
 }
 
@@ -348,16 +619,18 @@ bool StorageProvider::Invalidate(const IO::DataKey& key)
         LOG_ERROR << "Error flushing " << key.format() << std::endl;
         return false;
     }
-    return RemoveData(key);
+    return RemoveFlushed(key);
 }
 
 void StorageProvider::PreloadTask(IO::DataKey key)
 {
-    // Dispatcher thread
-
-    auto _data = cache_.find(key);
-    if (_data == cache_.end())
-        return;
+    // ThreadPool thread
+    {
+        Shard& shard = GetShard(key);
+        std::scoped_lock lock(shard.lock);
+        if (shard.cache.find(key) != shard.cache.end())
+            return;
+    }
 
     std::string table;
     uuids::uuid _id;
@@ -366,8 +639,8 @@ void StorageProvider::PreloadTask(IO::DataKey key)
         LOG_ERROR << "Unable to decode key " << key.format() << std::endl;
         return;
     }
-    std::shared_ptr<std::vector<uint8_t>> data = std::make_shared<std::vector<uint8_t>>(0);
-    if (!LoadData(key, data))
+    auto data = std::make_shared<std::vector<uint8_t>>(0);
+    if (!LoadData(key, *data))
         return;
 
     if (_id.nil())
@@ -375,131 +648,223 @@ void StorageProvider::PreloadTask(IO::DataKey key)
         _id = GetUuid(*data);
     IO::DataKey newKey(table, _id);
 
-    auto _newdata = cache_.find(newKey);
-    if (_newdata == cache_.end())
+    Shard& shard = GetShard(newKey);
+    std::scoped_lock lock(shard.lock);
+    auto _newdata = shard.cache.find(newKey);
+    if (_newdata == shard.cache.end())
     {
-        CacheData(table, _id, data, false, true);
+        CacheData(shard, table, _id, data, false, true);
     }
 }
 
 bool StorageProvider::Preload(const IO::DataKey& key)
 {
-    auto _data = cache_.find(key);
-    if (_data == cache_.end())
-        return true;
+    {
+        Shard& shard = GetShard(key);
+        std::scoped_lock lock(shard.lock);
+        if (shard.cache.find(key) != shard.cache.end())
+            return true;
+    }
 
     // Load later
-    GetSubsystem<Asynch::Dispatcher>()->Add(
-        Asynch::CreateTask(std::bind(&StorageProvider::PreloadTask, this, key))
-    );
+    GetSubsystem<Asynch::ThreadPool>()->Enqueue(&StorageProvider::PreloadTask, this, key);
     return true;
 }
 
 bool StorageProvider::Exists(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data)
 {
-    auto _data = cache_.find(key);
-
-    if (_data != cache_.end())
-        return !(*_data).second.first.deleted;
+    {
+        Shard& shard = GetShard(key);
+        std::scoped_lock lock(shard.lock);
+        auto _data = shard.cache.find(key);
+        if (_data != shard.cache.end())
+            return !(*_data).second.first.deleted;
+    }
 
     return ExistsData(key, *data);
 }
 
 bool StorageProvider::Clear(const IO::DataKey&)
 {
-    std::vector<IO::DataKey> toDelete;
-
-    for (const auto& ci : cache_)
+    size_t removed = 0;
+    for (auto& shard : shards_)
     {
-        const IO::DataKey& key = ci.first;
-        std::string table;
-        uuids::uuid id;
-        if (!key.decode(table, id))
-            continue;
-        size_t tableHash = sa::StringHashRt(table.data());
-        if (tableHash == KEY_GAMEINSTANCES_HASH || tableHash == KEY_SERVICE_HASH || tableHash == KEY_PARTIES_HASH)
+        const auto keys = GetKeys(*shard, [](const IO::DataKey& key, const CacheItem&) -> bool
+        {
+            std::string table;
+            uuids::uuid id;
+            if (!key.decode(table, id))
+                return false;
+            size_t tableHash = sa::StringHashRt(table.data());
             // Can not delete these
-            continue;
-
-        if (FlushData(key))
+            return tableHash != KEY_GAMEINSTANCES_HASH && tableHash != KEY_SERVICE_HASH && tableHash != KEY_PARTIES_HASH;
+        });
+        for (const auto& key : keys)
         {
-            currentSize_ -= ci.second.second->size();
-            toDelete.push_back(key);
+            if (FlushData(key) && RemoveFlushed(key))
+                ++removed;
         }
     }
-    for (const auto& k : toDelete)
     {
-        cache_.erase(k);
-        index_.Delete(k);
+        std::scoped_lock lock(namesLock_);
+        namesCache_.Clear();
     }
-    namesCache_.Clear();
-    LOG_INFO << "Cleared cache, removed " << toDelete.size() << " items" << std::endl;
+    LOG_INFO << "Cleared cache, removed " << removed << " items" << std::endl;
     return true;
 }
 
 void StorageProvider::Shutdown()
 {
-    // The only thing that not called from the dispatcher thread, so lock it.
-    std::scoped_lock lock(lock_);
     running_ = false;
-    for (const auto& c : cache_)
-        FlushData(c.first);
+    // Finish all pending DB work
+    GetSubsystem<Asynch::ThreadPool>()->Stop();
+    // If it fails the journal is replayed on the next start
+    Checkpoint();
+    if (journal_)
+        journal_->Close();
 
     DB::DBAccount::LogoutAll();
 }
 
-void StorageProvider::CleanCache()
+std::vector<IO::DataKey> StorageProvider::GetKeys(Shard& shard,
+    const std::function<bool(const IO::DataKey&, const CacheItem&)>& pred)
+{
+    std::vector<IO::DataKey> result;
+    std::scoped_lock lock(shard.lock);
+    for (const auto& item : shard.cache)
+    {
+        if (pred(item.first, item.second))
+            result.push_back(item.first);
+    }
+    return result;
+}
+
+size_t StorageProvider::GetCurrentSize()
+{
+    size_t result = 0;
+    for (auto& shard : shards_)
+    {
+        std::scoped_lock lock(shard->lock);
+        result += shard->currentSize;
+    }
+    return result;
+}
+
+std::vector<CacheShardStats> StorageProvider::GetStats()
+{
+    std::vector<CacheShardStats> result;
+    result.reserve(shards_.size());
+    for (auto& shard : shards_)
+    {
+        std::scoped_lock lock(shard->lock);
+        result.push_back({ shard->cache.size(), shard->currentSize, shard->maxSize,
+            shard->hits.load(), shard->misses.load(), shard->queueDepth.load() });
+    }
+    return result;
+}
+
+std::vector<uint32_t> StorageProvider::GetQueueDepths() const
+{
+    std::vector<uint32_t> result;
+    result.reserve(shards_.size());
+    for (const auto& shard : shards_)
+        result.push_back(shard->queueDepth.load());
+    return result;
+}
+
+void StorageProvider::LogStats()
+{
+    const auto pool = GetSubsystem<DB::DatabasePool>()->GetStats();
+    if (pool.waits != loggedPoolStats_.waits)
+    {
+        // Log the waits since the last time
+        DB::DatabasePool::Stats s = pool;
+        s.waits -= loggedPoolStats_.waits;
+        s.waitTime -= loggedPoolStats_.waitTime;
+        std::stringstream ss;
+        WritePoolStats(ss, s);
+        LOG_INFO << ss.str() << std::endl;
+    }
+    loggedPoolStats_ = pool;
+    const auto stats = GetStats();
+    loggedStats_.resize(stats.size(), CacheShardStats{});
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        // Log the reads since the last time
+        CacheShardStats s = stats[i];
+        s.hits -= loggedStats_[i].hits;
+        s.misses -= loggedStats_[i].misses;
+        loggedStats_[i] = stats[i];
+        if (s.hits + s.misses == 0 && s.queueDepth == 0)
+            continue;
+        std::stringstream ss;
+        WriteShardStats(ss, i, s);
+        LOG_INFO << ss.str() << std::endl;
+    }
+}
+
+std::string StorageProvider::GetStatsString()
+{
+    const auto stats = GetStats();
+    std::stringstream ss;
+    WritePoolStats(ss, GetSubsystem<DB::DatabasePool>()->GetStats());
+    ss << std::endl;
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        WriteShardStats(ss, i, stats[i]);
+        ss << std::endl;
+    }
+    return ss.str();
+}
+
+size_t StorageProvider::CleanCache(Shard& shard)
 {
     // Delete deleted records from DB and remove them from cache.
-    if (cache_.size() == 0)
-        return;
-    size_t oldSize = currentSize_;
-    int removed = 0;
-    auto i = cache_.begin();
-    while ((i = std::find_if(i, cache_.end(), [](const auto& current) -> bool
+    const auto keys = GetKeys(shard, [](const IO::DataKey&, const CacheItem& item) -> bool
     {
-        return current.second.first.deleted;
-    })) != cache_.end())
+        return item.first.deleted;
+    });
+    size_t removed = 0;
+    for (const auto& key : keys)
     {
-        bool ok = true;
-        const IO::DataKey& key = (*i).first;
-        if ((*i).second.first.created)
-        {
-            // If it's in DB (created == true) update changed data in DB
-            ok = FlushData(key);
-        }
-        if (ok)
+        bool created = false;
         {
-            // Remove from players cache
-            RemovePlayerFromCache(key);
-            currentSize_ -= (*i).second.second->size();
-            index_.Delete(key);
-            cache_.erase(i++);
-            ++removed;
+            std::scoped_lock lock(shard.lock);
+            auto data = shard.cache.find(key);
+            if (data == shard.cache.end())
+                continue;
+            created = (*data).second.first.created;
         }
-        else
-        {
+        // If it's in DB (created == true) update changed data in DB
+        if (created && !FlushData(key))
             // Error, break for now and try  the next time.
             // In case of lost connection it would try forever.
             break;
-        }
-    }
-
-    if (removed > 0)
-    {
-        LOG_INFO << "Cleaned cache old size " << Utils::ConvertSize(oldSize) <<
-            " current size " << Utils::ConvertSize(currentSize_) <<
-            " removed " << removed << " record(s)" << std::endl;
+        if (RemoveFlushed(key))
+            ++removed;
     }
+    return removed;
 }
 
 void StorageProvider::CleanTask()
 {
-    AB_PROFILE;
-    CleanCache();
-    DB::DBGuildMembers::DeleteExpired(this);
-    DB::DBReservedName::DeleteExpired(this);
-//    DB::DBConcreteItem::Clean(this);
+    GetSubsystem<Asynch::ThreadPool>()->Enqueue([this]()
+    {
+        AB_PROFILE;
+        const size_t oldSize = GetCurrentSize();
+        size_t removed = 0;
+        for (auto& shard : shards_)
+            removed += CleanCache(*shard);
+        if (removed > 0)
+        {
+            LOG_INFO << "Cleaned cache old size " << Utils::ConvertSize(oldSize) <<
+                " current size " << Utils::ConvertSize(GetCurrentSize()) <<
+                " removed " << removed << " record(s)" << std::endl;
+        }
+        DB::DBGuildMembers::DeleteExpired(this);
+        DB::DBReservedName::DeleteExpired(this);
+//        DB::DBConcreteItem::Clean(this);
+    });
     if (running_)
     {
         GetSubsystem<Asynch::Scheduler>()->Add(
@@ -508,48 +873,58 @@ void StorageProvider::CleanTask()
     }
 }
 
-void StorageProvider::FlushCache()
+bool StorageProvider::FlushCache(Shard& shard)
 {
-    if (cache_.size() == 0)
-        return;
     AB_PROFILE;
-    int written = 0;
-    auto i = cache_.begin();
-    auto* tp = GetSubsystem<Asynch::ThreadPool>();
-    while ((i = std::find_if(i, cache_.end(), [](const auto& current) -> bool
-    {
-        // Don't return deleted, these are flushed in CleanCache()
-        return (current.second.first.modified || !current.second.first.created) &&
-            !current.second.first.deleted;
-    })) != cache_.end())
-    {
-        ++written;
-        const IO::DataKey& key = (*i).first;
-        auto res = tp->EnqueueWithResult(&StorageProvider::FlushData, this, key);
-        bool bRes = false;
-        {
-            std::scoped_lock lock(lock_);
-            bRes = res.get();
-        }
-        if (!bRes)
+    const auto keys = GetKeys(shard, [](const IO::DataKey&, const CacheItem& item) -> bool
+    {
+        return item.first.modified || !item.first.created || item.first.deleted;
+    });
+    const size_t batchSize = std::max<size_t>(1, writeBatchSize_);
+    size_t written = 0;
+    while (written < keys.size())
+    {
+        const size_t count = std::min(batchSize, keys.size() - written);
+        const std::vector<IO::DataKey> batch(keys.begin() + written, keys.begin() + written + count);
+        if (!WriteBatch(batch))
         {
-            LOG_WARNING << "Error flushing " << key.format() << std::endl;
             // Error, break for now and try  the next time.
             // In case of lost connection it would try forever.
-            break;
+            return false;
         }
+        written += count;
     }
     if (written > 0)
     {
         LOG_INFO << "Flushed cache wrote " << written << " record(s)" << std::endl;
     }
+    return true;
+}
+
+bool StorageProvider::Checkpoint()
+{
+    // Everything in the old segments is in the cache, so when the cache was
+    // written they are no longer needed.
+    const uint64_t segment = journal_ ? journal_->Rotate() : 0;
+    bool result = true;
+    for (auto& shard : shards_)
+    {
+        if (!FlushCache(*shard))
+            result = false;
+    }
+    if (journal_ && result)
+        journal_->Remove(segment);
+    return result;
 }
 
 void StorageProvider::FlushCacheTask()
 {
-    DB::Database* db = GetSubsystem<DB::Database>();
-    db->CheckConnection();
-    FlushCache();
+    GetSubsystem<Asynch::ThreadPool>()->Enqueue([this]()
+    {
+        GetSubsystem<DB::DatabasePool>()->CheckConnections();
+        Checkpoint();
+    });
+    LogStats();
     if (running_)
     {
         GetSubsystem<Asynch::Scheduler>()->Add(
@@ -558,7 +933,136 @@ void StorageProvider::FlushCacheTask()
     }
 }
 
-uuids::uuid StorageProvider::GetUuid(std::vector<uint8_t>& data)
+void StorageProvider::MarkDirty(const IO::DataKey& key)
+{
+    bool full = false;
+    {
+        std::scoped_lock lock(dirtyLock_);
+        if (dirtyKeys_.emplace(key).second)
+            dirtyQueue_.push_back(key);
+        full = dirtyQueue_.size() >= writeBatchSize_;
+    }
+    if (full)
+        ScheduleWrite();
+}
+
+void StorageProvider::ScheduleWrite()
+{
+    if (!running_ || writing_.exchange(true))
+        return;
+    GetSubsystem<Asynch::ThreadPool>()->Enqueue(&StorageProvider::WriteTask, this);
+}
+
+void StorageProvider::WriteTask()
+{
+    // ThreadPool thread
+    const size_t batchSize = std::max<size_t>(1, writeBatchSize_);
+    for (;;)
+    {
+        std::vector<IO::DataKey> keys;
+        {
+            std::scoped_lock lock(dirtyLock_);
+            while (!dirtyQueue_.empty() && keys.size() < batchSize)
+            {
+                dirtyKeys_.erase(dirtyQueue_.front());
+                keys.push_back(std::move(dirtyQueue_.front()));
+                dirtyQueue_.pop_front();
+            }
+        }
+        if (keys.empty())
+            break;
+        if (!WriteBatch(keys))
+        {
+            // Try again later
+            std::scoped_lock lock(dirtyLock_);
+            for (auto it = keys.rbegin(); it != keys.rend(); ++it)
+            {
+                if (dirtyKeys_.emplace(*it).second)
+                    dirtyQueue_.push_front(*it);
+            }
+            break;
+        }
+    }
+    writing_ = false;
+}
+
+void StorageProvider::WriteBehindTask()
+{
+    bool empty;
+    {
+        std::scoped_lock lock(dirtyLock_);
+        empty = dirtyQueue_.empty();
+    }
+    if (!empty)
+        ScheduleWrite();
+    if (running_)
+    {
+        GetSubsystem<Asynch::Scheduler>()->Add(
+            Asynch::CreateScheduledTask(writeLatency_, std::bind(&StorageProvider::WriteBehindTask, this))
+        );
+    }
+}
+
+bool StorageProvider::WriteBatch(const std::vector<IO::DataKey>& keys)
+{
+    if (readonly_)
+        return true;
+
+    // The DB classes get this connection, their transactions become savepoints in this one
+    auto db = GetSubsystem<DB::DatabasePool>()->Acquire();
+    std::vector<FlushJob> jobs;
+    jobs.reserve(keys.size());
+    std::vector<IO::DataKey> busy;
+    for (const auto& key : keys)
+    {
+        FlushJob job;
+        // Don't wait here, another batch may wait for a key we already have
+        switch (PrepareFlush(key, job, false))
+        {
+        case FlushPrepare::Ready:
+            jobs.push_back(std::move(job));
+            break;
+        case FlushPrepare::Busy:
+            busy.push_back(key);
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool succ = true;
+    if (!jobs.empty())
+    {
+        DB::DBTransaction transaction(db);
+        succ = transaction.Begin();
+        for (auto& job : jobs)
+        {
+            if (!succ)
+                break;
+            if (!WriteFlush(job))
+            {
+                LOG_WARNING << "Error flushing " << job.key.format() << ", rolling back batch of " << jobs.size() << std::endl;
+                succ = false;
+            }
+        }
+        if (succ)
+            succ = transaction.Commit();
+    }
+    for (auto& job : jobs)
+        CompleteFlush(job, succ, true);
+    if (!succ)
+        return false;
+
+    // Written by another thread right now, it may fail or the record changed in the meantime
+    for (const auto& key : busy)
+    {
+        if (!FlushData(key))
+            return false;
+    }
+    return true;
+}
+
+uuids::uuid StorageProvider::GetUuid(const std::vector<uint8_t>& data)
 {
     // Get UUID from raw data. UUID is serialized first as string
     const std::string suuid(data.begin() + 1,
@@ -566,43 +1070,74 @@ uuids::uuid StorageProvider::GetUuid(std::vector<uint8_t>& data)
     return uuids::uuid(suuid);
 }
 
-bool StorageProvider::EnoughSpace(size_t size)
-{
-    return (currentSize_ + size) <= maxSize_;
-}
-
-void StorageProvider::CreateSpace(size_t size)
+void StorageProvider::CreateSpace(Shard& shard, size_t size)
 {
+    // ThreadPool thread
     // Create more than required space
     const size_t sizeNeeded = size * 2;
-    while ((currentSize_ + sizeNeeded) > maxSize_)
+    for (;;)
     {
-        const IO::DataKey key = index_.Next();
-        if (FlushData(key))
-            RemoveData(key);
-        else
+        IO::DataKey key;
+        {
+            std::scoped_lock lock(shard.lock);
+            if (shard.index.Size() == 0 || (shard.currentSize + sizeNeeded) <= shard.maxSize)
+                break;
+            key = shard.index.Next();
+        }
+        const bool flushed = FlushData(key);
+        std::scoped_lock lock(shard.lock);
+        auto data = shard.cache.find(key);
+        if (data != shard.cache.end())
+        {
+            if (flushed && IsClean((*data).second.first))
+                RemoveCached(shard, data);
+            else
+                // Changed while writing it or writing failed, keep it
+                shard.index.Add(key);
+        }
+        if (!flushed)
             break;
     }
+    shard.evicting = false;
 }
 
 bool StorageProvider::RemoveData(const IO::DataKey& key)
 {
-    auto data = cache_.find(key);
-    if (data != cache_.end())
+    Shard& shard = GetShard(key);
+    std::scoped_lock lock(shard.lock);
+    auto data = shard.cache.find(key);
+    if (data != shard.cache.end())
     {
-        RemovePlayerFromCache(key);
-
-        currentSize_ -= (*data).second.second->size();
-        cache_.erase(key);
-        index_.Delete(key);
-
+        RemoveCached(shard, data);
         return true;
     }
     return false;
 }
 
-bool StorageProvider::LoadData(const IO::DataKey& key,
-    std::shared_ptr<std::vector<uint8_t>> data)
+bool StorageProvider::RemoveFlushed(const IO::DataKey& key)
+{
+    Shard& shard = GetShard(key);
+    std::scoped_lock lock(shard.lock);
+    auto data = shard.cache.find(key);
+    if (data == shard.cache.end())
+        return false;
+    // Changed after it was flushed, it's still dirty and the change must not get lost
+    if (!IsClean((*data).second.first))
+        return false;
+    RemoveCached(shard, data);
+    return true;
+}
+
+void StorageProvider::RemoveCached(Shard& shard, std::unordered_map<IO::DataKey, CacheItem>::iterator it)
+{
+    const IO::DataKey& key = (*it).first;
+    RemovePlayerFromCache(key);
+    shard.index.Delete(key);
+    shard.currentSize -= (*it).second.second->size();
+    shard.cache.erase(it);
+}
+
+bool StorageProvider::LoadData(const IO::DataKey& key, std::vector<uint8_t>& data)
 {
     std::string table;
     uuids::uuid id;
@@ -628,7 +1163,9 @@ bool StorageProvider::LoadData(const IO::DataKey& key,
     default:
     {
         if (loadCallables_.Exists(tableHash))
-            return loadCallables_.Call(tableHash, id, *data);
+        {
+            return loadCallables_.Call(tableHash, id, data);
+        }
         LOG_ERROR << "Unknown table " << table << std::endl;
         break;
     }
@@ -637,6 +1174,48 @@ bool StorageProvider::LoadData(const IO::DataKey& key,
     return false;
 }
 
+void StorageProvider::LoadMany(const std::string& table, const std::vector<IO::DataKey>& keys,
+    const std::vector<size_t>& indices, std::vector<SharedBuffer>& data)
+{
+    const size_t tableHash = sa::StringHashRt(table.data());
+    for (size_t start = 0; start < indices.size(); start += LOAD_BATCH_SIZE)
+    {
+        const size_t end = std::min(indices.size(), start + LOAD_BATCH_SIZE);
+        std::vector<uuids::uuid> ids;
+        ids.reserve(end - start);
+        for (size_t i = start; i < end; ++i)
+        {
+            const IO::DataKey& key = keys[indices[i]];
+            ++GetShard(key).misses;
+            std::string _table;
+            uuids::uuid id;
+            key.decode(_table, id);
+            ids.push_back(id);
+        }
+
+        std::vector<std::vector<uint8_t>> loaded;
+        if (!loadManyCallables_.Call(tableHash, ids, loaded))
+            loaded.clear();
+        std::unordered_map<uuids::uuid, SharedBuffer> records;
+        for (auto& record : loaded)
+        {
+            const uuids::uuid id = GetUuid(record);
+            SharedBuffer buffer = std::make_shared<std::vector<uint8_t>>(std::move(record));
+            if (!AddLoaded(table, id, buffer))
+                buffer.reset();
+            records.emplace(id, std::move(buffer));
+        }
+        for (size_t i = start; i < end; ++i)
+        {
+            const auto it = records.find(ids[i - start]);
+            if (it != records.end())
+                data[indices[i]] = (*it).second;
+            else
+                data[indices[i]].reset();
+        }
+    }
+}
+
 bool StorageProvider::FlushData(const IO::DataKey& key)
 {
     if (readonly_)
@@ -645,21 +1224,47 @@ bool StorageProvider::FlushData(const IO::DataKey& key)
         return true;
     }
 
-    auto data = cache_.find(key);
-    if (data == cache_.end())
-        // Not in cache so no need to flush anything
-        return true;
-    // No need to save to DB when not modified
-    if (!(*data).second.first.modified && !(*data).second.first.deleted && (*data).second.first.created)
+    auto db = GetSubsystem<DB::DatabasePool>()->Acquire();
+    FlushJob job;
+    if (PrepareFlush(key, job, true) != FlushPrepare::Ready)
         return true;
+    const bool succ = WriteFlush(job);
+    CompleteFlush(job, succ, false);
+    return succ;
+}
 
-    CacheItem& item = (*data).second;
+StorageProvider::FlushPrepare StorageProvider::PrepareFlush(const IO::DataKey& key, FlushJob& job, bool wait)
+{
+    Shard& shard = GetShard(key);
+    std::unique_lock lock(shard.lock);
+    if (shard.flushing.find(key) != shard.flushing.end())
+    {
+        if (!wait)
+            return FlushPrepare::Busy;
+        shard.flushed.wait(lock, [&]() { return shard.flushing.find(key) == shard.flushing.end(); });
+    }
+    auto data = shard.cache.find(key);
+    if (data == shard.cache.end())
+        // Not in cache so no need to flush anything
+        return FlushPrepare::Nothing;
+    const CacheFlags& flags = (*data).second.first;
+    // Not modified or deleted and never made it into the DB
+    if (IsClean(flags))
+        return FlushPrepare::Nothing;
+    job.key = key;
+    job.flags = flags;
+    job.cached = (*data).second.second;
+    shard.flushing.emplace(key);
+    return FlushPrepare::Ready;
+}
 
+bool StorageProvider::WriteFlush(FlushJob& job)
+{
     std::string table;
     uuids::uuid id;
-    if (!key.decode(table, id))
+    if (!job.key.decode(table, id))
     {
-        LOG_ERROR << "Unable to decode key " << key.format() << std::endl;
+        LOG_ERROR << "Unable to decode key " << job.key.format() << std::endl;
         return false;
     }
 
@@ -680,14 +1285,18 @@ bool StorageProvider::FlushData(const IO::DataKey& key)
     case KEY_PARTIES_HASH:
         // Not written to DB
         // Mark not modified and created or it will infinitely try to flush it
-        (*data).second.first.created = true;
-        (*data).second.first.modified = false;
+        job.flags.created = true;
+        job.flags.modified = false;
         succ = true;
         break;
     default:
     {
         if (flushCallables_.Exists(tableHash))
-            succ = flushCallables_.Call(tableHash, item);
+        {
+            // Cached buffers are immutable, creating it may change the ID so write a copy
+            job.buffer = std::make_shared<std::vector<uint8_t>>(*job.cached);
+            succ = flushCallables_.Call(tableHash, job.flags, *job.buffer);
+        }
         else
         {
             LOG_ERROR << "Unknown table " << table << std::endl;
@@ -697,8 +1306,59 @@ bool StorageProvider::FlushData(const IO::DataKey& key)
     }
 
     if (!succ)
+    {
         LOG_ERROR << "Unable to write data" << std::endl;
-    return succ;
+        return false;
+    }
+    return true;
+}
+
+void StorageProvider::CompleteFlush(FlushJob& job, bool written, bool removeDeleted)
+{
+    Shard& shard = GetShard(job.key);
+    {
+        std::scoped_lock lock(shard.lock);
+        if (!CompleteFlushLocked(shard, job, written, removeDeleted))
+            return;
+    }
+    // Updated while writing, must be written again
+    MarkDirty(job.key);
+}
+
+bool StorageProvider::CompleteFlushLocked(Shard& shard, FlushJob& job, bool written, bool removeDeleted)
+{
+    shard.flushing.erase(job.key);
+    shard.flushed.notify_all();
+    if (!written)
+        return false;
+    auto data = shard.cache.find(job.key);
+    if (data == shard.cache.end())
+        return false;
+    CacheFlags& cachedFlags = (*data).second.first;
+    if (job.flags.deleted)
+        // No longer in the DB, writing it again creates it
+        cachedFlags.created = false;
+    else
+        // Once created it's in the DB, even when it was updated in the meantime
+        cachedFlags.created = cachedFlags.created || job.flags.created;
+    if ((*data).second.second != job.cached)
+        // Updated while writing
+        return true;
+    if (removeDeleted && job.flags.deleted && cachedFlags.deleted)
+    {
+        // Deleted from DB, no need to keep it
+        RemoveCached(shard, data);
+        return false;
+    }
+    cachedFlags.modified = job.flags.modified;
+    if (job.buffer && *job.buffer != *job.cached)
+    {
+        // The ID may have changed
+        shard.currentSize = (shard.currentSize - job.cached->size()) + job.buffer->size();
+        (*data).second.second = std::move(job.buffer);
+    }
+    // Deleted while writing
+    return !IsClean(cachedFlags);
 }
 
 bool StorageProvider::ExistsData(const IO::DataKey& key, std::vector<uint8_t>& data)
@@ -722,7 +1382,9 @@ bool StorageProvider::ExistsData(const IO::DataKey& key, std::vector<uint8_t>& d
         return false;
     default:
         if (exitsCallables_.Exists(tableHash))
+        {
             return exitsCallables_.Call(tableHash, data);
+        }
         LOG_ERROR << "Unknown table " << table << std::endl;
         break;
     }
@@ -740,9 +1402,7 @@ void StorageProvider::RemovePlayerFromCache(const IO::DataKey& key)
     size_t tableHash = sa::StringHashRt(table.data());
     if (tableHash == KEY_CHARACTERS_HASH)
     {
-        auto _data = cache_.find(key);
-        if (_data == cache_.end())
-            return;
+        std::scoped_lock lock(namesLock_);
         namesCache_.Delete(key);
     }
 }
@@ -21,11 +21,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <sa/PragmaWarning.h>
 #include "CacheIndex.h"
+#include "Journal.h"
 #include "NameIndex.h"
 
 PRAGMA_WARNING_PUSH
@@ -40,12 +47,21 @@ PRAGMA_WARNING_POP
 
 #include <sa/StringHash.h>
 #include <abscommon/DataKey.h>
+#include <abscommon/DataCodes.h>
+#include <abdb/DatabasePool.h>
 #include <sa/CallableTable.h>
 
 // Clean cache every 10min
 #define CLEAN_CACHE_MS (1000 * 60 * 10)
 // Flush cache every minute
 #define FLUSH_CACHE_MS (1000 * 60)
+#define DEFAULT_CACHE_SHARDS 16
+// Changed records are written at latest after this time
+#define WRITE_LATENCY_MS 1000
+// Max records written in one transaction
+#define WRITE_BATCH_SIZE 100
+// Max records loaded with one query
+#define LOAD_BATCH_SIZE 500
 
 struct CacheFlags
 {
@@ -54,14 +70,54 @@ struct CacheFlags
     bool deleted;
 };
 
+/// Cached data is never changed, an update replaces the buffer. So it can be
+/// shared with the connections writing it to the client.
+using SharedBuffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+struct CacheShardStats
+{
+    size_t items;
+    size_t size;
+    size_t maxSize;
+    uint64_t hits;
+    uint64_t misses;
+    /// Requests waiting for the database
+    uint32_t queueDepth;
+};
+
+/// The cache is partitioned into shards by the hash of the key. Each shard has its
+/// own lock, LRU index and size budget. Requests that can be served from the cache
+/// run right away, everything that needs the database runs on the ThreadPool, so
+/// hits don't wait behind misses.
+/// Updates and deletes are written behind: changed keys are queued and written in
+/// batches, one transaction per batch. If a journal is opened the changes are also
+/// appended to it, so they survive a crash of the server.
 class StorageProvider
 {
 public:
-    StorageProvider(size_t maxSize, bool readonly);
+    StorageProvider(size_t maxSize, bool readonly, size_t shards = DEFAULT_CACHE_SHARDS);
+
+    /// Replay what is left in the journal from the last run and start logging
+    /// changes to it.
+    bool OpenJournal(const std::string& dir);
+
+    /// Run a request for key. If it can be served from the cache it is called
+    /// immediately, otherwise it is run on the ThreadPool. Requests for the same
+    /// key are executed in the order they were scheduled. data is the data of the request.
+    void Schedule(const IO::DataKey& key, IO::OpCodes op, const std::vector<uint8_t>& data,
+        std::function<void()>&& request);
 
     bool Create(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data);
     bool Update(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data);
-    bool Read(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data);
+    /// data contains the request and is replaced with the cached buffer
+    bool Read(const IO::DataKey& key, SharedBuffer& data);
+    /// Run a request for many keys. If all are in the cache it is called immediately,
+    /// otherwise it is run on the ThreadPool. It is not ordered with requests for
+    /// these keys which are still running.
+    void ScheduleMany(const std::vector<IO::DataKey>& keys, std::function<void()>&& request);
+    /// Like Read() for many records. Records of the same table which are not in the
+    /// cache are loaded with one query. Records which could not be read are nullptr.
+    void ReadMany(const std::vector<IO::DataKey>& keys, std::vector<SharedBuffer>& data);
     bool Delete(const IO::DataKey& key);
     bool Invalidate(const IO::DataKey& key);
     bool Preload(const IO::DataKey& key);
@@ -73,11 +129,12 @@ public:
     bool EntityRead(E& entity)
     {
         const IO::DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
-        std::shared_ptr<std::vector<uint8_t>> data = std::make_shared<std::vector<uint8_t>>();
-        SetEntity<E>(entity, *data.get());
+        auto request = std::make_shared<std::vector<uint8_t>>();
+        SetEntity<E>(entity, *request);
+        SharedBuffer data = std::move(request);
         if (!Read(aKey, data))
             return false;
-        if (GetEntity(*data.get(), entity))
+        if (GetEntity(*data, entity))
             return true;
         return false;
     }
@@ -136,14 +193,54 @@ public:
     }
     /// Flush all
     void Shutdown();
+    size_t GetShardCount() const { return shards_.size(); }
+    /// Statistics of all shards, hits and misses since the start.
+    std::vector<CacheShardStats> GetStats();
+    /// Statistics of the database pool and all shards as text, one line each
+    std::string GetStatsString();
+    std::vector<uint32_t> GetQueueDepths() const;
     uint32_t flushInterval_;
     uint32_t cleanInterval_;
+    uint32_t writeLatency_;
+    size_t writeBatchSize_;
 private:
     /// first = flags, second = data
-    using CacheItem = std::pair<CacheFlags, std::shared_ptr<std::vector<uint8_t>>>;
+    using CacheItem = std::pair<CacheFlags, SharedBuffer>;
+    struct Shard
+    {
+        /// Protects cache, index, currentSize, pending and flushing
+        std::mutex lock;
+        std::unordered_map<IO::DataKey, CacheItem> cache;
+        CacheIndex index;
+        size_t currentSize{ 0 };
+        size_t maxSize{ 0 };
+        /// Keys with a request running on the ThreadPool. Following requests for
+        /// these keys are queued here and run by the same thread. Reads by name are
+        /// queued by table and name, see GetPendingKey().
+        std::unordered_map<IO::DataKey, std::deque<std::function<void()>>> pending;
+        /// Keys being written to the DB right now, so the same record is not written
+        /// by two connections at the same time.
+        std::unordered_set<IO::DataKey> flushing;
+        std::condition_variable flushed;
+        std::atomic<uint64_t> hits{ 0 };
+        std::atomic<uint64_t> misses{ 0 };
+        std::atomic<uint32_t> queueDepth{ 0 };
+        std::atomic<bool> evicting{ false };
+    };
+    /// A record to be written to the DB
+    struct FlushJob
+    {
+        IO::DataKey key;
+        CacheFlags flags;
+        /// The cached buffer when the job was prepared
+        SharedBuffer cached;
+        /// What was written, creating it may change the ID
+        std::shared_ptr<std::vector<uint8_t>> buffer;
+    };
     sa::CallableTable<size_t, bool, std::vector<uint8_t>&> exitsCallables_;
-    sa::CallableTable<size_t, bool, CacheItem&> flushCallables_;
+    sa::CallableTable<size_t, bool, CacheFlags&, std::vector<uint8_t>&> flushCallables_;
     sa::CallableTable<size_t, bool, const uuids::uuid&, std::vector<uint8_t>&> loadCallables_;
+    sa::CallableTable<size_t, bool, const std::vector<uuids::uuid>&, std::vector<std::vector<uint8_t>>&> loadManyCallables_;
     template<typename D, typename E>
     void AddEntityClass()
     {
@@ -157,38 +254,104 @@ private:
         {
             return ExistsInDB<D, E>(data);
         });
-        flushCallables_.Add(hash, [this](CacheItem& data) -> bool
+        flushCallables_.Add(hash, [this](CacheFlags& flags, auto& data) -> bool
         {
-            return FlushRecord<D, E>(data);
+            return FlushRecord<D, E>(flags, data);
         });
         loadCallables_.Add(hash, [this](const auto& id, auto& data) -> bool
         {
             return LoadFromDB<D, E>(id, data);
         });
     }
+    /// Entities which can load many records with one query
+    template<typename D, typename E>
+    void AddBatchLoader()
+    {
+        static constexpr size_t hash = sa::StringHash(E::KEY());
+        loadManyCallables_.Add(hash, [this](const auto& ids, auto& data) -> bool
+        {
+            return LoadManyFromDB<D, E>(ids, data);
+        });
+    }
     void InitEnitityClasses();
 
     /// Read UUID from data
-    static uuids::uuid GetUuid(std::vector<uint8_t>& data);
+    static uuids::uuid GetUuid(const std::vector<uint8_t>& data);
 
-    bool EnoughSpace(size_t size);
-    void CreateSpace(size_t size);
-    void CacheData(const std::string& table, const uuids::uuid& id,
-        std::shared_ptr<std::vector<uint8_t>> data,
+    Shard& GetShard(const IO::DataKey& key);
+    /// Key of the pending queue for a request
+    static IO::DataKey GetPendingKey(const IO::DataKey& key, const std::vector<uint8_t>& data);
+    /// Caller must hold the lock of the shard
+    bool NeedsIO(Shard& shard, const IO::DataKey& key, IO::OpCodes op);
+    void RunPending(Shard& shard, const IO::DataKey& key, std::function<void()> request);
+    /// Copy a cached item to data. Returns false if it's not in cache or deleted.
+    bool ReadCached(const IO::DataKey& key, SharedBuffer& data, bool& found);
+    /// Add a record loaded from the DB to the cache. If it was cached meanwhile data
+    /// is replaced with the cached buffer. Returns false when it was deleted meanwhile.
+    bool AddLoaded(const std::string& table, const uuids::uuid& id, SharedBuffer& data);
+    void CreateSpace(Shard& shard, size_t size);
+    /// Caller must hold the lock of the shard
+    void CacheData(Shard& shard, const std::string& table, const uuids::uuid& id,
+        SharedBuffer data,
         bool modified, bool created);
     bool RemoveData(const IO::DataKey& key);
+    /// Remove a flushed item unless it was changed after flushing it
+    bool RemoveFlushed(const IO::DataKey& key);
+    /// Caller must hold the lock of the shard
+    void RemoveCached(Shard& shard, std::unordered_map<IO::DataKey, CacheItem>::iterator it);
     void PreloadTask(IO::DataKey key);
     bool ExistsData(const IO::DataKey& key, std::vector<uint8_t>& data);
-    /// If the data is a player and it's in playerNames_ remove it from playerNames_
+    /// If the data is a player and it's in namesCache_ remove it from namesCache_
     void RemovePlayerFromCache(const IO::DataKey& key);
+    /// Returns the keys of all items in the shard matching the predicate
+    std::vector<IO::DataKey> GetKeys(Shard& shard,
+        const std::function<bool(const IO::DataKey&, const CacheItem&)>& pred);
+    size_t GetCurrentSize();
 
-    void CleanCache();
+    size_t CleanCache(Shard& shard);
     void CleanTask();
-    void FlushCache();
+    /// Write all changed and deleted records of the shard
+    bool FlushCache(Shard& shard);
+    /// Start a new journal segment, flush the cache and delete the old segments
+    bool Checkpoint();
     void FlushCacheTask();
+    /// Queue the key for writing it to the DB
+    void MarkDirty(const IO::DataKey& key);
+    void ScheduleWrite();
+    /// Write the dirty queue in batches
+    void WriteTask();
+    void WriteBehindTask();
+    /// Write all keys in one transaction. Deleted records are removed from the cache.
+    bool WriteBatch(const std::vector<IO::DataKey>& keys);
+    void LogStats();
+    /// Statistics at the last LogStats() call, it logs what happened since then
+    std::vector<CacheShardStats> loggedStats_;
+    DB::DatabasePool::Stats loggedPoolStats_{};
 
     /// Loads Data from DB
-    bool LoadData(const IO::DataKey& key, std::shared_ptr<std::vector<uint8_t>> data);
+    bool LoadData(const IO::DataKey& key, std::vector<uint8_t>& data);
+    /// Load the records at indices from the DB and add them to the cache
+    void LoadMany(const std::string& table, const std::vector<IO::DataKey>& keys,
+        const std::vector<size_t>& indices, std::vector<SharedBuffer>& data);
+    template<typename D, typename E>
+    bool LoadManyFromDB(const std::vector<uuids::uuid>& ids, std::vector<std::vector<uint8_t>>& data)
+    {
+        std::vector<std::string> uuids;
+        uuids.reserve(ids.size());
+        for (const auto& id : ids)
+            uuids.push_back(id.to_string());
+        std::vector<E> entities;
+        if (!D::LoadMany(uuids, entities))
+            return false;
+        data.reserve(data.size() + entities.size());
+        for (const auto& e : entities)
+        {
+            data.emplace_back();
+            if (SetEntity<E>(e, data.back()) == 0)
+                data.pop_back();
+        }
+        return true;
+    }
     template<typename D, typename E>
     bool LoadFromDB(const uuids::uuid& id, std::vector<uint8_t>& data)
     {
@@ -211,28 +374,44 @@ private:
     /// So synchronize this item with the DB. Depending on the data header calls
     /// CreateInDB(), SaveToDB() and/or DeleteFromDB()
     bool FlushData(const IO::DataKey& key);
+    enum class FlushPrepare
+    {
+        Nothing,
+        Ready,
+        /// Another thread is writing it
+        Busy
+    };
+    /// Get what needs to be written and mark the key as flushing. When wait is true it
+    /// waits for another thread writing it, otherwise it returns Busy.
+    /// Acquire the DB connection before, a thread marking keys must never wait for a connection.
+    FlushPrepare PrepareFlush(const IO::DataKey& key, FlushJob& job, bool wait);
+    bool WriteFlush(FlushJob& job);
+    /// Unmark the key and update the cache when the job was written
+    void CompleteFlush(FlushJob& job, bool written, bool removeDeleted);
+    /// Caller must hold the lock of the shard. Returns true when it must be written again.
+    bool CompleteFlushLocked(Shard& shard, FlushJob& job, bool written, bool removeDeleted);
     template<typename D, typename E>
-    bool FlushRecord(CacheItem& data)
+    bool FlushRecord(CacheFlags& flags, std::vector<uint8_t>& data)
     {
         bool succ = true;
         // These flags are not mutually exclusive, hoverer creating it implies it is no longer modified
-        if (!data.first.created)
+        if (!flags.created)
         {
-            succ = CreateInDB<D, E>(*data.second.get());
+            succ = CreateInDB<D, E>(data);
             if (succ)
             {
-                data.first.created = true;
-                data.first.modified = false;
+                flags.created = true;
+                flags.modified = false;
             }
         }
-        else if (data.first.modified)
+        else if (flags.modified)
         {
-            succ = SaveToDB<D, E>(*data.second.get());
+            succ = SaveToDB<D, E>(data);
             if (succ)
-                data.first.modified = false;
+                flags.modified = false;
         }
-        if (data.first.deleted)
-            succ = DeleteFromDB<D, E>(*data.second.get());
+        if (flags.deleted)
+            succ = DeleteFromDB<D, E>(data);
 
         return succ;
     }
@@ -276,10 +455,10 @@ private:
     }
 
     template<typename E>
-    static bool GetEntity(std::vector<uint8_t>& data, E& e)
+    static bool GetEntity(const std::vector<uint8_t>& data, E& e)
     {
-        using InputAdapter = bitsery::InputBufferAdapter<std::vector<uint8_t>>;
-        InputAdapter ia(data.begin(), data.size());
+        using InputAdapter = bitsery::InputBufferAdapter<const uint8_t*>;
+        InputAdapter ia(data.data(), data.size());
         auto state = bitsery::quickDeserialization<InputAdapter, E>(ia, e);
         return state.first == bitsery::ReaderError::NoError;
     }
@@ -293,14 +472,20 @@ private:
     }
 
     bool readonly_;
-    bool running_;
+    std::atomic<bool> running_;
     size_t maxSize_;
-    size_t currentSize_;
 
-    std::unordered_map<IO::DataKey, CacheItem> cache_;
-    std::mutex lock_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::mutex namesLock_;
     /// Name -> Cache Key
     NameIndex namesCache_;
-    CacheIndex index_;
+
+    /// Protects dirtyQueue_ and dirtyKeys_
+    std::mutex dirtyLock_;
+    /// Keys to write in the order they were changed, each key is only once in it
+    std::deque<IO::DataKey> dirtyQueue_;
+    std::unordered_set<IO::DataKey> dirtyKeys_;
+    std::atomic<bool> writing_{ false };
+    std::unique_ptr<Journal> journal_;
 };
 
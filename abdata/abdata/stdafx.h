@@ -58,6 +58,7 @@ PRAGMA_WARNING_POP
 #include <abscommon/Utils.h>
 #include <abscommon/StringUtils.h>
 #include <abdb/Database.h>
+#include <abdb/DatabasePool.h>
 
 #define MAX_DATA_SIZE (1024 * 1024)
 #define MAX_KEY_SIZE 256
@@ -85,6 +85,78 @@ std::shared_ptr<DBResult> Database::StoreQuery(const std::string& query)
     return InternalSelectQuery(query);
 }
 
+bool Database::ExecuteQuery(const DBStatement& statement, const DBParams& params)
+{
+    return InternalPreparedQuery(statement, params);
+}
+
+std::shared_ptr<DBResult> Database::StoreQuery(const DBStatement& statement, const DBParams& params)
+{
+    return InternalSelectPreparedQuery(statement, params);
+}
+
+bool Database::InternalPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    return InternalQuery(BuildQuery(statement, params));
+}
+
+std::shared_ptr<DBResult> Database::InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    return InternalSelectQuery(BuildQuery(statement, params));
+}
+
+std::string Database::BuildQuery(const DBStatement& statement, const DBParams& params)
+{
+    std::string query;
+    size_t index = 0;
+    bool inString = false;
+    for (const char* p = statement.query; *p != '\0'; ++p)
+    {
+        if (*p == '\'')
+            inString = !inString;
+        if (*p != '?' || inString)
+        {
+            query += *p;
+            continue;
+        }
+        if (index >= params.Count())
+        {
+            LOG_ERROR << "Statement " << statement.name << ": Missing parameter " << index << std::endl;
+            query += "NULL";
+            continue;
+        }
+        const DBParams::Param& param = params[index++];
+        switch (param.type)
+        {
+        case DBParams::Type::Null:
+            query += "NULL";
+            break;
+        case DBParams::Type::Int:
+            query += std::to_string(param.intValue);
+            break;
+        case DBParams::Type::String:
+            query += EscapeString(param.stringValue);
+            break;
+        case DBParams::Type::Blob:
+            query += EscapeBlob(param.stringValue.data(), param.stringValue.length());
+            break;
+        }
+    }
+    return query;
+}
+
+std::string Database::EscapeStringList(const std::vector<std::string>& values)
+{
+    std::string result;
+    for (const auto& value : values)
+    {
+        if (!result.empty())
+            result += ", ";
+        result += EscapeString(value);
+    }
+    return result;
+}
+
 std::shared_ptr<DBResult> Database::VerifyResult(std::shared_ptr<DBResult> result)
 {
     if (!result->Next())
@@ -99,4 +171,12 @@ void Database::FreeResult(DBResult*)
 
 DBResult::~DBResult() = default;
 
+int DBResult::GetColumnIndex(const std::string& col) const
+{
+    int result = FindColumn(col);
+    if (result < 0)
+        LOG_ERROR << "Unknown column " << col << std::endl;
+    return result;
+}
+
 }
@@ -24,6 +24,9 @@
 #include <mutex>
 #include <sstream>
 #include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace DB {
 
@@ -36,11 +39,74 @@ enum DBParam
     DBPARAM_MULTIINSERT = 1
 };
 
+/// A named statement which is prepared once per connection and then executed with
+/// different parameters. Parameters are written as `?` in the query.
+struct DBStatement
+{
+    const char* name;
+    const char* query;
+};
+
+/// Parameters bound to the placeholders of a DBStatement, in order.
+class DBParams
+{
+public:
+    enum class Type
+    {
+        Null,
+        Int,
+        String,
+        Blob
+    };
+    struct Param
+    {
+        Type type;
+        int64_t intValue;
+        std::string stringValue;
+    };
+private:
+    std::vector<Param> params_;
+public:
+    DBParams() = default;
+    explicit DBParams(size_t count)
+    {
+        params_.reserve(count);
+    }
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, DBParams&>::type
+    Add(T value)
+    {
+        params_.push_back({ Type::Int, static_cast<int64_t>(value), std::string() });
+        return *this;
+    }
+    DBParams& Add(const std::string& value)
+    {
+        params_.push_back({ Type::String, 0, value });
+        return *this;
+    }
+    DBParams& AddBlob(const std::string& value)
+    {
+        params_.push_back({ Type::Blob, 0, value });
+        return *this;
+    }
+    DBParams& AddNull()
+    {
+        params_.push_back({ Type::Null, 0, std::string() });
+        return *this;
+    }
+
+    size_t Count() const { return params_.size(); }
+    const Param& operator[](size_t index) const { return params_[index]; }
+    std::vector<Param>::const_iterator begin() const { return params_.begin(); }
+    std::vector<Param>::const_iterator end() const { return params_.end(); }
+};
+
 class Database
 {
 protected:
     Database() :
-        connected_(false)
+        connected_(false),
+        transactionLevel_(0)
     {}
 
     friend class DBTransaction;
@@ -50,8 +116,16 @@ protected:
 
     virtual bool InternalQuery(const std::string& query) = 0;
     virtual std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) = 0;
+    /// Drivers without support for prepared statements execute the query with the
+    /// escaped parameters inserted.
+    virtual bool InternalPreparedQuery(const DBStatement& statement, const DBParams& params);
+    virtual std::shared_ptr<DBResult> InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params);
+    /// Replace the placeholders with the escaped parameters
+    std::string BuildQuery(const DBStatement& statement, const DBParams& params);
     std::shared_ptr<DBResult> VerifyResult(std::shared_ptr<DBResult> result);
     bool connected_;
+    /// Number of open DBTransactions
+    unsigned transactionLevel_;
 public:
     static std::string driver_;
     static std::string dbHost_;
@@ -72,11 +146,18 @@ public:
 
     bool ExecuteQuery(const std::string& query);
     std::shared_ptr<DBResult> StoreQuery(const std::string& query);
+    /// Execute a prepared statement. The statement is prepared on first use.
+    bool ExecuteQuery(const DBStatement& statement, const DBParams& params);
+    std::shared_ptr<DBResult> StoreQuery(const DBStatement& statement, const DBParams& params);
     virtual void FreeResult(DBResult* res);
     virtual uint64_t GetLastInsertId() = 0;
     virtual std::string EscapeString(const std::string& s) = 0;
     virtual std::string EscapeBlob(const char* s, size_t length) = 0;
+    /// Comma separated escaped strings, e.g. for `IN (...)`
+    std::string EscapeStringList(const std::vector<std::string>& values);
     virtual void CheckConnection() { }
+    /// Max number of connections to the same database, 0 = no limit
+    virtual size_t GetMaxConnections() const { return 0; }
 };
 
 class DBResult : public std::enable_shared_from_this<DBResult>
@@ -84,33 +165,48 @@ class DBResult : public std::enable_shared_from_this<DBResult>
 protected:
     DBResult() = default;
     virtual ~DBResult();
+    virtual int FindColumn(const std::string&) const { return -1; }
 public:
-    virtual int32_t GetInt(const std::string&) {
+    /// Returns the index of a column or -1 if there is no such column. Columns
+    /// don't change while iterating over the rows, so resolve the index once and
+    /// use it for all rows.
+    int GetColumnIndex(const std::string& col) const;
+
+    virtual int32_t GetInt(int) {
         return 0;
     }
-    virtual uint32_t GetUInt(const std::string&) {
+    virtual uint32_t GetUInt(int) {
         return 0;
     }
-    virtual int64_t GetLong(const std::string&) {
+    virtual int64_t GetLong(int) {
         return 0;
     }
-    virtual uint64_t GetULong(const std::string&) {
+    virtual uint64_t GetULong(int) {
         return 0;
     }
-    virtual time_t GetTime(const std::string&) {
+    time_t GetTime(int col) {
         // time_t = int64_t = BIGINT(20)
-        return 0;
+        return static_cast<time_t>(GetLong(col));
     }
-    virtual std::string GetString(const std::string&) {
+    virtual std::string GetString(int) {
         return "''";
     }
-    virtual std::string GetStream(const std::string&) {
+    virtual std::string GetStream(int) {
         return std::string("");
     }
-    virtual bool IsNull(const std::string&) {
+    virtual bool IsNull(int) {
         return true;
     }
 
+    int32_t GetInt(const std::string& col) { return GetInt(GetColumnIndex(col)); }
+    uint32_t GetUInt(const std::string& col) { return GetUInt(GetColumnIndex(col)); }
+    int64_t GetLong(const std::string& col) { return GetLong(GetColumnIndex(col)); }
+    uint64_t GetULong(const std::string& col) { return GetULong(GetColumnIndex(col)); }
+    time_t GetTime(const std::string& col) { return GetTime(GetColumnIndex(col)); }
+    std::string GetString(const std::string& col) { return GetString(GetColumnIndex(col)); }
+    std::string GetStream(const std::string& col) { return GetStream(GetColumnIndex(col)); }
+    bool IsNull(const std::string& col) { return IsNull(GetColumnIndex(col)); }
+
     virtual std::shared_ptr<DBResult> Next() { return std::shared_ptr<DBResult>(); }
     virtual bool Empty() const { return true; }
 };
@@ -126,29 +222,51 @@ private:
     };
     Database* db_;
     State state_;
+    unsigned level_;
+    // Transactions inside another transaction use savepoints, so they can be
+    // committed and rolled back without ending the outer transaction.
+    std::string GetSavepoint() const
+    {
+        return "sp_" + std::to_string(level_);
+    }
+    void End()
+    {
+        --db_->transactionLevel_;
+    }
 public:
     explicit DBTransaction(Database* db) :
         db_(db),
-        state_(State::Unknown)
+        state_(State::Unknown),
+        level_(0)
     {}
     ~DBTransaction()
     {
         if (state_ == State::Started)
         {
-            db_->Rollback();
+            End();
+            if (level_ == 0)
+                db_->Rollback();
+            else
+                db_->ExecuteQuery("ROLLBACK TO SAVEPOINT " + GetSavepoint());
         }
     }
     bool Begin()
     {
         state_ = State::Started;
-        return db_->BeginTransaction();
+        level_ = db_->transactionLevel_++;
+        if (level_ == 0)
+            return db_->BeginTransaction();
+        return db_->ExecuteQuery("SAVEPOINT " + GetSavepoint());
     }
     bool Commit()
     {
         if (state_ == State::Started)
         {
             state_ = State::Committed;
-            return db_->Commit();
+            End();
+            if (level_ == 0)
+                return db_->Commit();
+            return db_->ExecuteQuery("RELEASE SAVEPOINT " + GetSavepoint());
         }
         return false;
     }
@@ -25,6 +25,8 @@
 
 #include "DatabaseMysql.h"
 #include <mysql/errmsg.h>
+#include <algorithm>
+#include <cstring>
 #include "Logger.h"
 
 namespace DB {
@@ -71,6 +73,8 @@ DatabaseMysql::DatabaseMysql() :
 
 DatabaseMysql::~DatabaseMysql()
 {
+    for (const auto& stmt : statements_)
+        mysql_stmt_close(stmt.second);
     mysql_close(&handle_);
 }
 
@@ -227,6 +231,167 @@ std::shared_ptr<DBResult> DatabaseMysql::InternalSelectQuery(const std::string&
     return VerifyResult(res);
 }
 
+MYSQL_STMT* DatabaseMysql::ExecuteStatement(const DBStatement& statement, const DBParams& params, bool& cached)
+{
+    MYSQL_STMT* stmt = nullptr;
+    cached = false;
+    auto it = statements_.find(statement.name);
+    if (it != statements_.end() && inUse_.find(it->second) == inUse_.end())
+    {
+        stmt = it->second;
+        cached = true;
+    }
+    else
+    {
+        stmt = mysql_stmt_init(&handle_);
+        if (!stmt)
+        {
+            LOG_ERROR << "mysql_stmt_init(): " << statement.name << ": MYSQL ERROR: " << mysql_error(&handle_) << std::endl;
+            return nullptr;
+        }
+        if (mysql_stmt_prepare(stmt, statement.query, static_cast<unsigned long>(strlen(statement.query))) != 0)
+        {
+            LOG_ERROR << "mysql_stmt_prepare(): " << statement.query << ": MYSQL ERROR: " << mysql_stmt_error(stmt) << std::endl;
+            mysql_stmt_close(stmt);
+            return nullptr;
+        }
+        if (it == statements_.end())
+        {
+            statements_.emplace(statement.name, stmt);
+            cached = true;
+        }
+    }
+
+#ifdef DEBUG_SQL
+    LOG_DEBUG << "MYSQL EXECUTE: " << statement.name << std::endl;
+#endif
+
+    std::vector<MYSQL_BIND> binds(params.Count());
+    std::vector<unsigned long> lengths(params.Count());
+    memset(binds.data(), 0, sizeof(MYSQL_BIND) * binds.size());
+    for (size_t i = 0; i < params.Count(); ++i)
+    {
+        const DBParams::Param& param = params[i];
+        MYSQL_BIND& bind = binds[i];
+        switch (param.type)
+        {
+        case DBParams::Type::Null:
+            bind.buffer_type = MYSQL_TYPE_NULL;
+            break;
+        case DBParams::Type::Int:
+            bind.buffer_type = MYSQL_TYPE_LONGLONG;
+            bind.buffer = const_cast<int64_t*>(&param.intValue);
+            break;
+        case DBParams::Type::String:
+        case DBParams::Type::Blob:
+            bind.buffer_type = param.type == DBParams::Type::String ? MYSQL_TYPE_STRING : MYSQL_TYPE_BLOB;
+            bind.buffer = const_cast<char*>(param.stringValue.data());
+            bind.buffer_length = static_cast<unsigned long>(param.stringValue.length());
+            lengths[i] = bind.buffer_length;
+            bind.length = &lengths[i];
+            break;
+        }
+    }
+
+    if (!binds.empty() && mysql_stmt_bind_param(stmt, binds.data()) != 0)
+    {
+        HandleStatementError("mysql_stmt_bind_param()", statement, stmt, cached);
+        return nullptr;
+    }
+    if (mysql_stmt_execute(stmt) != 0)
+    {
+        HandleStatementError("mysql_stmt_execute()", statement, stmt, cached);
+        return nullptr;
+    }
+    return stmt;
+}
+
+void DatabaseMysql::HandleStatementError(const char* function, const DBStatement& statement, MYSQL_STMT* stmt, bool cached)
+{
+    LOG_ERROR << function << ": " << statement.name << ": MYSQL ERROR: " << mysql_stmt_error(stmt) << std::endl;
+    int error = mysql_stmt_errno(stmt);
+    if (error == CR_SERVER_LOST || error == CR_SERVER_GONE_ERROR)
+    {
+        connected_ = false;
+        // Statements don't survive a reconnect, prepare it again next time
+        if (cached)
+        {
+            statements_.erase(statement.name);
+            cached = false;
+        }
+    }
+    ReleaseStatement(stmt, cached);
+}
+
+void DatabaseMysql::ReleaseStatement(MYSQL_STMT* stmt, bool cached)
+{
+    if (cached)
+        mysql_stmt_free_result(stmt);
+    else
+        mysql_stmt_close(stmt);
+}
+
+bool DatabaseMysql::InternalPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    if (!connected_)
+        return false;
+
+    bool cached;
+    MYSQL_STMT* stmt = ExecuteStatement(statement, params, cached);
+    if (!stmt)
+        return false;
+    ReleaseStatement(stmt, cached);
+    return true;
+}
+
+std::shared_ptr<DBResult> DatabaseMysql::InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    if (!connected_)
+        return std::shared_ptr<DBResult>();
+
+    bool cached;
+    MYSQL_STMT* stmt = ExecuteStatement(statement, params, cached);
+    if (!stmt)
+        return std::shared_ptr<DBResult>();
+
+    MYSQL_RES* meta = mysql_stmt_result_metadata(stmt);
+    if (!meta)
+    {
+        LOG_ERROR << "mysql_stmt_result_metadata(): " << statement.name << ": MYSQL ERROR: " << mysql_stmt_error(stmt) << std::endl;
+        ReleaseStatement(stmt, cached);
+        return std::shared_ptr<DBResult>();
+    }
+    // Get the size of the largest value of each column, so the buffers can hold them
+    my_bool updateMaxLength = 1;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+    if (mysql_stmt_store_result(stmt) != 0)
+    {
+        LOG_ERROR << "mysql_stmt_store_result(): " << statement.name << ": MYSQL ERROR: " << mysql_stmt_error(stmt) << std::endl;
+        mysql_free_result(meta);
+        ReleaseStatement(stmt, cached);
+        return std::shared_ptr<DBResult>();
+    }
+
+    MysqlStmtResult* result = new MysqlStmtResult(stmt, meta, cached);
+    if (cached)
+        inUse_.emplace(stmt);
+    std::shared_ptr<DBResult> res(result, std::bind(&DatabaseMysql::FreeStmtResult, this, std::placeholders::_1));
+    if (!result->Bind())
+    {
+        LOG_ERROR << "mysql_stmt_bind_result(): " << statement.name << ": MYSQL ERROR: " << mysql_stmt_error(stmt) << std::endl;
+        return std::shared_ptr<DBResult>();
+    }
+    return VerifyResult(res);
+}
+
+void DatabaseMysql::FreeStmtResult(DBResult* res)
+{
+    MysqlStmtResult* result = (MysqlStmtResult*)res;
+    if (result->cached_)
+        inUse_.erase(result->handle_);
+    delete result;
+}
+
 MysqlResult::MysqlResult(MYSQL_RES* res)
 {
     handle_ = res;
@@ -246,111 +411,181 @@ MysqlResult::~MysqlResult()
     mysql_free_result(handle_);
 }
 
-int32_t MysqlResult::GetInt(const std::string& col)
+int MysqlResult::FindColumn(const std::string& col) const
 {
-    ListNames::iterator it = listNames_.find(col);
+    ListNames::const_iterator it = listNames_.find(col);
     if (it != listNames_.end())
-    {
-        if (row_[it->second])
-            return atoi(row_[it->second]);
-        return 0;
-    }
+        return static_cast<int>(it->second);
+    return -1;
+}
 
-    LOG_ERROR << "Error in GetInt(" << col << ")" << std::endl;
-    return 0; // Failed
+int32_t MysqlResult::GetInt(int col)
+{
+    if (col < 0 || !row_[col])
+        return 0;
+    return atoi(row_[col]);
 }
 
-uint32_t MysqlResult::GetUInt(const std::string& col)
+uint32_t MysqlResult::GetUInt(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-    {
-        if (row_[it->second])
-            return strtoul(row_[it->second], nullptr, 0);
+    if (col < 0 || !row_[col])
         return 0;
-    }
+    return strtoul(row_[col], nullptr, 0);
+}
 
-    LOG_ERROR << "Error in GetUInt(" << col << ")" << std::endl;
-    return 0; // Failed
+int64_t MysqlResult::GetLong(int col)
+{
+    if (col < 0 || !row_[col])
+        return 0;
+    return atoll(row_[col]);
 }
 
-int64_t MysqlResult::GetLong(const std::string& col)
+uint64_t MysqlResult::GetULong(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-    {
-        if (row_[it->second])
-            return atoll(row_[it->second]);
+    if (col < 0 || !row_[col])
         return 0;
-    }
+    return strtoull(row_[col], nullptr, 0);
+}
 
-    LOG_ERROR << "Error in GetLong(" << col << ")" << std::endl;
-    return 0; // Failed
+std::string MysqlResult::GetString(int col)
+{
+    if (col < 0 || !row_[col])
+        return std::string("");
+    return std::string(row_[col]);
 }
 
-uint64_t MysqlResult::GetULong(const std::string& col)
+std::string MysqlResult::GetStream(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-    {
-        if (row_[it->second])
-            return strtoull(row_[it->second], nullptr, 0);
-        return 0;
-    }
+    if (col < 0 || !row_[col])
+        return std::string("");
+    unsigned long size = mysql_fetch_lengths(handle_)[col];
+    return std::string(row_[col], size);
+}
 
-    LOG_ERROR << "Error in GetULong(" << col << ")" << std::endl;
-    return 0; // Failed
+bool MysqlResult::IsNull(int col)
+{
+    if (col < 0)
+        return true;
+    return (row_[col] == nullptr);
 }
 
-time_t MysqlResult::GetTime(const std::string& col)
+std::shared_ptr<DBResult> MysqlResult::Next()
 {
-    return static_cast<time_t>(GetLong(col));
+    row_ = mysql_fetch_row(handle_);
+    return row_ != NULL ? shared_from_this() : std::shared_ptr<DBResult>();
 }
 
-std::string MysqlResult::GetString(const std::string& col)
+MysqlStmtResult::MysqlStmtResult(MYSQL_STMT* stmt, MYSQL_RES* meta, bool cached) :
+    handle_(stmt),
+    meta_(meta),
+    cached_(cached),
+    rowAvailable_(false)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    MYSQL_FIELD* field;
+    int i = 0;
+    while ((field = mysql_fetch_field(meta_)) != NULL)
     {
-        if (row_[it->second])
-            return std::string(row_[it->second]);
-        return std::string("");
+        listNames_[field->name] = i;
+        ++i;
     }
+}
 
-    LOG_ERROR << "Error in GetString(" << col << ")" << std::endl;
-    return std::string(""); // Failed
+MysqlStmtResult::~MysqlStmtResult()
+{
+    mysql_free_result(meta_);
+    if (cached_)
+        mysql_stmt_free_result(handle_);
+    else
+        mysql_stmt_close(handle_);
 }
 
-std::string MysqlResult::GetStream(const std::string& col)
+bool MysqlStmtResult::Bind()
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    const unsigned count = mysql_num_fields(meta_);
+    MYSQL_FIELD* fields = mysql_fetch_fields(meta_);
+    binds_.resize(count);
+    memset(binds_.data(), 0, sizeof(MYSQL_BIND) * count);
+    buffers_.resize(count);
+    lengths_.resize(count);
+    nulls_ = std::make_unique<my_bool[]>(count);
+    for (unsigned i = 0; i < count; ++i)
     {
-        if (row_[it->second])
-        {
-            unsigned long size = mysql_fetch_lengths(handle_)[it->second];
-            return std::string(row_[it->second], size);
-        }
+        // max_length is 0 for numeric columns, 64 is enough for any number
+        buffers_[i].resize(std::max<unsigned long>(fields[i].max_length, 64) + 1);
+        binds_[i].buffer_type = MYSQL_TYPE_STRING;
+        binds_[i].buffer = &buffers_[i][0];
+        binds_[i].buffer_length = static_cast<unsigned long>(buffers_[i].size());
+        binds_[i].length = &lengths_[i];
+        binds_[i].is_null = &nulls_[i];
     }
-
-    LOG_ERROR << "Error in GetStream(" << col << ")" << std::endl;
-    return std::string("");
+    return mysql_stmt_bind_result(handle_, binds_.data()) == 0;
 }
 
-bool MysqlResult::IsNull(const std::string& col)
+int MysqlStmtResult::FindColumn(const std::string& col) const
 {
-    ListNames::iterator it = listNames_.find(col);
+    ListNames::const_iterator it = listNames_.find(col);
     if (it != listNames_.end())
-    {
-        return (row_[it->second] == nullptr);
-    }
-    return true;
+        return static_cast<int>(it->second);
+    return -1;
 }
 
-std::shared_ptr<DBResult> MysqlResult::Next()
+const char* MysqlStmtResult::GetValue(int col) const
 {
-    row_ = mysql_fetch_row(handle_);
-    return row_ != NULL ? shared_from_this() : std::shared_ptr<DBResult>();
+    if (col < 0 || nulls_[col])
+        return nullptr;
+    // Zero terminate it for the number conversions
+    std::string& buffer = const_cast<std::string&>(buffers_[col]);
+    buffer[std::min<size_t>(lengths_[col], buffer.size() - 1)] = '\0';
+    return buffer.c_str();
+}
+
+int32_t MysqlStmtResult::GetInt(int col)
+{
+    const char* value = GetValue(col);
+    return value ? atoi(value) : 0;
+}
+
+uint32_t MysqlStmtResult::GetUInt(int col)
+{
+    const char* value = GetValue(col);
+    return value ? strtoul(value, nullptr, 0) : 0;
+}
+
+int64_t MysqlStmtResult::GetLong(int col)
+{
+    const char* value = GetValue(col);
+    return value ? atoll(value) : 0;
+}
+
+uint64_t MysqlStmtResult::GetULong(int col)
+{
+    const char* value = GetValue(col);
+    return value ? strtoull(value, nullptr, 0) : 0;
+}
+
+std::string MysqlStmtResult::GetString(int col)
+{
+    const char* value = GetValue(col);
+    return value ? std::string(value, std::min<size_t>(lengths_[col], buffers_[col].size() - 1)) : std::string("");
+}
+
+std::string MysqlStmtResult::GetStream(int col)
+{
+    return GetString(col);
+}
+
+bool MysqlStmtResult::IsNull(int col)
+{
+    if (col < 0)
+        return true;
+    return nulls_[col] != 0;
+}
+
+std::shared_ptr<DBResult> MysqlStmtResult::Next()
+{
+    const int ret = mysql_stmt_fetch(handle_);
+    rowAvailable_ = (ret == 0 || ret == MYSQL_DATA_TRUNCATED);
+    return rowAvailable_ ? shared_from_this() : std::shared_ptr<DBResult>();
 }
 
 }
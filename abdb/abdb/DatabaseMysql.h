@@ -28,6 +28,9 @@
 #include <winsock2.h>
 #endif
 #include <mysql/mysql.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace DB {
 
@@ -35,8 +38,20 @@ class DatabaseMysql final : public Database
 {
 protected:
     MYSQL handle_;
+    /// Prepared statements by name
+    std::unordered_map<std::string, MYSQL_STMT*> statements_;
+    /// Cached statements a MysqlStmtResult is reading from
+    std::unordered_set<MYSQL_STMT*> inUse_;
     bool InternalQuery(const std::string& query) override;
     std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) override;
+    bool InternalPreparedQuery(const DBStatement& statement, const DBParams& params) override;
+    std::shared_ptr<DBResult> InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params) override;
+    /// Returns the executed statement. If the cached statement is still used by a
+    /// result, a new statement is prepared and cached is false.
+    MYSQL_STMT* ExecuteStatement(const DBStatement& statement, const DBParams& params, bool& cached);
+    void ReleaseStatement(MYSQL_STMT* stmt, bool cached);
+    void HandleStatementError(const char* function, const DBStatement& statement, MYSQL_STMT* stmt, bool cached);
+    void FreeStmtResult(DBResult* res);
 public:
     DatabaseMysql();
     ~DatabaseMysql() override;
@@ -62,21 +77,55 @@ protected:
     ListNames listNames_;
     MYSQL_RES* handle_;
     MYSQL_ROW row_;
+    int FindColumn(const std::string& col) const override;
 public:
     ~MysqlResult() override;
-    int32_t GetInt(const std::string& col) override;
-    uint32_t GetUInt(const std::string& col) override;
-    int64_t GetLong(const std::string& col) override;
-    uint64_t GetULong(const std::string& col) override;
-    time_t GetTime(const std::string& col) override;
-    std::string GetString(const std::string& col) override;
-    std::string GetStream(const std::string& col) override;
-    bool IsNull(const std::string& col) override;
+    int32_t GetInt(int col) override;
+    uint32_t GetUInt(int col) override;
+    int64_t GetLong(int col) override;
+    uint64_t GetULong(int col) override;
+    std::string GetString(int col) override;
+    std::string GetStream(int col) override;
+    bool IsNull(int col) override;
 
     bool Empty() const override { return row_ == NULL; }
     std::shared_ptr<DBResult> Next() override;
 };
 
+/// Result of a prepared statement. All columns are fetched as strings.
+class MysqlStmtResult final : public DBResult
+{
+    friend class DatabaseMysql;
+protected:
+    MysqlStmtResult(MYSQL_STMT* stmt, MYSQL_RES* meta, bool cached);
+
+    typedef std::map<const std::string, uint32_t> ListNames;
+    ListNames listNames_;
+    MYSQL_STMT* handle_;
+    MYSQL_RES* meta_;
+    bool cached_;
+    bool rowAvailable_;
+    std::vector<MYSQL_BIND> binds_;
+    std::vector<std::string> buffers_;
+    std::vector<unsigned long> lengths_;
+    std::unique_ptr<my_bool[]> nulls_;
+    bool Bind();
+    int FindColumn(const std::string& col) const override;
+    const char* GetValue(int col) const;
+public:
+    ~MysqlStmtResult() override;
+    int32_t GetInt(int col) override;
+    uint32_t GetUInt(int col) override;
+    int64_t GetLong(int col) override;
+    uint64_t GetULong(int col) override;
+    std::string GetString(int col) override;
+    std::string GetStream(int col) override;
+    bool IsNull(int col) override;
+
+    bool Empty() const override { return !rowAvailable_; }
+    std::shared_ptr<DBResult> Next() override;
+};
+
 }
 
 #endif
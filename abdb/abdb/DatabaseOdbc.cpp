@@ -342,13 +342,20 @@ OdbcResult::~OdbcResult()
     SQLFreeHandle(SQL_HANDLE_STMT, handle_);
 }
 
-int32_t OdbcResult::GetInt(const std::string& col)
+int OdbcResult::FindColumn(const std::string& col) const
 {
-    ListNames::iterator it = listNames_.find(col);
+    ListNames::const_iterator it = listNames_.find(col);
     if (it != listNames_.end())
+        return static_cast<int>(it->second);
+    return -1;
+}
+
+int32_t OdbcResult::GetInt(int col)
+{
+    if (col > 0)
     {
         int32_t value;
-        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)it->second, SQL_C_SLONG, &value, 0, NULL);
+        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)col, SQL_C_SLONG, &value, 0, NULL);
 
         if (RETURN_SUCCESS(ret))
             return value;
@@ -358,13 +365,12 @@ int32_t OdbcResult::GetInt(const std::string& col)
     return 0; // Failed}
 }
 
-uint32_t OdbcResult::GetUInt(const std::string& col)
+uint32_t OdbcResult::GetUInt(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    if (col > 0)
     {
         uint32_t value;
-        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)it->second, SQL_C_ULONG, &value, 0, NULL);
+        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)col, SQL_C_ULONG, &value, 0, NULL);
 
         if (RETURN_SUCCESS(ret))
             return value;
@@ -374,13 +380,12 @@ uint32_t OdbcResult::GetUInt(const std::string& col)
     return 0; // Failed}
 }
 
-int64_t OdbcResult::GetLong(const std::string& col)
+int64_t OdbcResult::GetLong(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    if (col > 0)
     {
         int64_t value;
-        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)it->second, SQL_C_SBIGINT, &value, 0, NULL);
+        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)col, SQL_C_SBIGINT, &value, 0, NULL);
 
         if (RETURN_SUCCESS(ret))
             return value;
@@ -390,13 +395,12 @@ int64_t OdbcResult::GetLong(const std::string& col)
     return 0; // Failed
 }
 
-uint64_t OdbcResult::GetULong(const std::string& col)
+uint64_t OdbcResult::GetULong(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    if (col > 0)
     {
         uint64_t value;
-        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)it->second, SQL_C_UBIGINT, &value, 0, NULL);
+        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)col, SQL_C_UBIGINT, &value, 0, NULL);
 
         if (RETURN_SUCCESS(ret))
             return value;
@@ -406,19 +410,13 @@ uint64_t OdbcResult::GetULong(const std::string& col)
     return 0; // Failed
 }
 
-time_t OdbcResult::GetTime(const std::string& col)
+std::string OdbcResult::GetString(int col)
 {
-    return static_cast<time_t>(GetLong(col));
-}
-
-std::string OdbcResult::GetString(const std::string& col)
-{
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    if (col > 0)
     {
         char* value = new char[1024];
 
-        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)it->second, SQL_C_CHAR, value, 1024, NULL);
+        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)col, SQL_C_CHAR, value, 1024, NULL);
 
         if (RETURN_SUCCESS(ret))
         {
@@ -432,15 +430,14 @@ std::string OdbcResult::GetString(const std::string& col)
     return std::string(""); // Failed
 }
 
-std::string OdbcResult::GetStream(const std::string& col)
+std::string OdbcResult::GetStream(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    if (col > 0)
     {
         std::string result;
         result.resize(1024);
         unsigned long size;
-        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)it->second, SQL_C_BINARY,
+        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)col, SQL_C_BINARY,
             &result[0], 1024, (SQLLEN*)&size);
 
         if (RETURN_SUCCESS(ret))
@@ -451,13 +448,12 @@ std::string OdbcResult::GetStream(const std::string& col)
     return std::string(""); // Failed
 }
 
-bool OdbcResult::IsNull(const std::string& col)
+bool OdbcResult::IsNull(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
+    if (col > 0)
     {
         uint16_t value;
-        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)it->second, SQL_C_SSHORT, &value, 0, NULL);
+        SQLRETURN ret = SQLGetData(handle_, (SQLUSMALLINT)col, SQL_C_SSHORT, &value, 0, NULL);
 
         if (RETURN_SUCCESS(ret))
             return value == SQL_NULL_DATA;
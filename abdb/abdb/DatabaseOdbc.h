@@ -74,16 +74,17 @@ protected:
     bool rowAvailable_;
 
     SQLHSTMT handle_;
+    /// ODBC column numbers start with 1
+    int FindColumn(const std::string& col) const override;
 public:
     ~OdbcResult() override;
-    int32_t GetInt(const std::string& col) override;
-    uint32_t GetUInt(const std::string& col) override;
-    int64_t GetLong(const std::string& col) override;
-    uint64_t GetULong(const std::string& col) override;
-    time_t GetTime(const std::string& col) override;
-    std::string GetString(const std::string& col) override;
-    std::string GetStream(const std::string& col) override;
-    bool IsNull(const std::string& col) override;
+    int32_t GetInt(int col) override;
+    uint32_t GetUInt(int col) override;
+    int64_t GetLong(int col) override;
+    uint64_t GetULong(int col) override;
+    std::string GetString(int col) override;
+    std::string GetStream(int col) override;
+    bool IsNull(int col) override;
 
     bool Empty() const override { return !rowAvailable_; }
     std::shared_ptr<DBResult> Next() override;
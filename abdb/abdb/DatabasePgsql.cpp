@@ -83,6 +83,8 @@ bool DatabasePgsql::Connect(int numTries /* = 1 */)
             // When ping OK then try to connect
             handle_ = PQconnectdb(dns_.c_str());
             connected_ = PQstatus(handle_) == CONNECTION_OK;
+            // Prepared statements belong to the connection
+            prepared_.clear();
         }
         ++tr;
         if (!connected_ && remaingTries > 0)
@@ -238,10 +240,103 @@ std::shared_ptr<DBResult> DatabasePgsql::InternalSelectQuery(const std::string&
     return VerifyResult(results);
 }
 
-std::string DatabasePgsql::Parse(const std::string& s)
+bool DatabasePgsql::Prepare(const DBStatement& statement, const DBParams& params)
+{
+    if (prepared_.find(statement.name) != prepared_.end())
+        return true;
+
+    const std::string query = Parse(statement.query, true);
+    PGresult* res = PQprepare(handle_, statement.name, query.c_str(), static_cast<int>(params.Count()), nullptr);
+    ExecStatusType stat = PQresultStatus(res);
+    if (stat != PGRES_COMMAND_OK)
+    {
+        LOG_ERROR << "PQprepare(): " << query << ": " << PQresultErrorMessage(res) << std::endl;
+        PQclear(res);
+        return false;
+    }
+    PQclear(res);
+    prepared_.emplace(statement.name);
+    return true;
+}
+
+PGresult* DatabasePgsql::ExecutePrepared(const DBStatement& statement, const DBParams& params)
+{
+    if (!Prepare(statement, params))
+        return nullptr;
+
+#ifdef DEBUG_SQL
+    LOG_DEBUG << "PGSQL EXECUTE: " << statement.name << std::endl;
+#endif
+
+    // All parameters are sent as text
+    std::vector<std::string> buffers;
+    buffers.reserve(params.Count());
+    std::vector<const char*> values;
+    values.reserve(params.Count());
+    for (const auto& param : params)
+    {
+        switch (param.type)
+        {
+        case DBParams::Type::Null:
+            values.push_back(nullptr);
+            break;
+        case DBParams::Type::Int:
+            buffers.push_back(std::to_string(param.intValue));
+            values.push_back(buffers.back().c_str());
+            break;
+        case DBParams::Type::String:
+            values.push_back(param.stringValue.c_str());
+            break;
+        case DBParams::Type::Blob:
+            // Same as EscapeBlob()
+            buffers.push_back(base64::encode((const unsigned char*)param.stringValue.data(), param.stringValue.length()));
+            values.push_back(buffers.back().c_str());
+            break;
+        }
+    }
+
+    PGresult* res = PQexecPrepared(handle_, statement.name, static_cast<int>(values.size()),
+        values.data(), nullptr, nullptr, 0);
+    ExecStatusType stat = PQresultStatus(res);
+    if (stat != PGRES_COMMAND_OK && stat != PGRES_TUPLES_OK)
+    {
+        LOG_ERROR << "PQexecPrepared(): " << statement.name << ": " << PQresultErrorMessage(res) << std::endl;
+        PQclear(res);
+        return nullptr;
+    }
+    return res;
+}
+
+bool DatabasePgsql::InternalPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    if (!connected_)
+        return false;
+
+    PGresult* res = ExecutePrepared(statement, params);
+    if (!res)
+        return false;
+    PQclear(res);
+    return true;
+}
+
+std::shared_ptr<DBResult> DatabasePgsql::InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    if (!connected_)
+        return std::shared_ptr<DBResult>();
+
+    PGresult* res = ExecutePrepared(statement, params);
+    if (!res)
+        return std::shared_ptr<DBResult>();
+
+    std::shared_ptr<DBResult> results(new PgsqlResult(res), std::bind(&Database::FreeResult, this, std::placeholders::_1));
+    return VerifyResult(results);
+}
+
+std::string DatabasePgsql::Parse(const std::string& s, bool placeholders /* = false */)
 {
     std::string query = "";
 
+    int param = 0;
     bool inString = false;
     uint8_t ch;
     for (size_t a = 0; a < s.length(); a++)
@@ -259,6 +354,12 @@ std::string DatabasePgsql::Parse(const std::string& s)
         if (ch == '`' && !inString)
             ch = '"';
 
+        if (placeholders && ch == '?' && !inString)
+        {
+            query += "$" + std::to_string(++param);
+            continue;
+        }
+
         query += ch;
     }
 
@@ -277,46 +378,60 @@ PgsqlResult::~PgsqlResult()
     PQclear(handle_);
 }
 
-int32_t PgsqlResult::GetInt(const std::string& col)
+int PgsqlResult::FindColumn(const std::string& col) const
 {
-    return atoi(PQgetvalue(handle_, cursor_, PQfnumber(handle_, col.c_str())));
+    return PQfnumber(handle_, col.c_str());
 }
 
-uint32_t PgsqlResult::GetUInt(const std::string& col)
+int32_t PgsqlResult::GetInt(int col)
 {
-    return static_cast<uint32_t>(atoi(PQgetvalue(handle_, cursor_, PQfnumber(handle_, col.c_str()))));
+    if (col < 0)
+        return 0;
+    return atoi(PQgetvalue(handle_, cursor_, col));
 }
 
-int64_t PgsqlResult::GetLong(const std::string& col)
+uint32_t PgsqlResult::GetUInt(int col)
 {
-    return atoll(PQgetvalue(handle_, cursor_, PQfnumber(handle_, col.c_str())));
+    if (col < 0)
+        return 0;
+    return static_cast<uint32_t>(atoi(PQgetvalue(handle_, cursor_, col)));
 }
 
-uint64_t PgsqlResult::GetULong(const std::string& col)
+int64_t PgsqlResult::GetLong(int col)
 {
-    return strtoull(PQgetvalue(handle_, cursor_, PQfnumber(handle_, col.c_str())), nullptr, 0);
+    if (col < 0)
+        return 0;
+    return atoll(PQgetvalue(handle_, cursor_, col));
 }
 
-time_t PgsqlResult::GetTime(const std::string& col)
+uint64_t PgsqlResult::GetULong(int col)
 {
-    return static_cast<time_t>(GetLong(col));
+    if (col < 0)
+        return 0;
+    return strtoull(PQgetvalue(handle_, cursor_, col), nullptr, 0);
 }
 
-std::string PgsqlResult::GetString(const std::string& col)
+std::string PgsqlResult::GetString(int col)
 {
-    return std::string(PQgetvalue(handle_, cursor_, PQfnumber(handle_, col.c_str())));
+    if (col < 0)
+        return std::string("");
+    return std::string(PQgetvalue(handle_, cursor_, col));
 }
 
-std::string PgsqlResult::GetStream(const std::string& col)
+std::string PgsqlResult::GetStream(int col)
 {
-    size_t size = PQgetlength(handle_, cursor_, PQfnumber(handle_, col.c_str()));
-    char* buf = PQgetvalue(handle_, cursor_, PQfnumber(handle_, col.c_str()));
+    if (col < 0)
+        return std::string("");
+    size_t size = PQgetlength(handle_, cursor_, col);
+    char* buf = PQgetvalue(handle_, cursor_, col);
     return base64::decode(buf, size);
 }
 
-bool PgsqlResult::IsNull(const std::string& col)
+bool PgsqlResult::IsNull(int col)
 {
-    return PQgetisnull(handle_, cursor_, PQfnumber(handle_, col.c_str())) != 0;
+    if (col < 0)
+        return true;
+    return PQgetisnull(handle_, cursor_, col) != 0;
 }
 
 std::shared_ptr<DBResult> PgsqlResult::Next()
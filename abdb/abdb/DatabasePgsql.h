@@ -25,6 +25,7 @@
 
 #include "Database.h"
 #include <libpq-fe.h>
+#include <unordered_set>
 
 namespace DB {
 
@@ -33,10 +34,17 @@ class DatabasePgsql final : public Database
 protected:
     PGconn* handle_;
     std::string dns_;
+    /// Names of the statements prepared on this connection
+    std::unordered_set<std::string> prepared_;
     bool Connect(int numTries = 1);
     bool InternalQuery(const std::string& query) override;
     std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) override;
-    std::string Parse(const std::string& s);
+    bool InternalPreparedQuery(const DBStatement& statement, const DBParams& params) override;
+    std::shared_ptr<DBResult> InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params) override;
+    bool Prepare(const DBStatement& statement, const DBParams& params);
+    PGresult* ExecutePrepared(const DBStatement& statement, const DBParams& params);
+    /// Replaces backticks with double quotes and, for prepared statements, `?` with $1, $2...
+    std::string Parse(const std::string& s, bool placeholders = false);
 public:
     DatabasePgsql();
     ~DatabasePgsql() override;
@@ -61,16 +69,16 @@ protected:
 
     int32_t rows_, cursor_;
     PGresult* handle_;
+    int FindColumn(const std::string& col) const override;
 public:
     ~PgsqlResult() override;
-    int32_t GetInt(const std::string& col) override;
-    uint32_t GetUInt(const std::string& col) override;
-    int64_t GetLong(const std::string& col) override;
-    uint64_t GetULong(const std::string& col) override;
-    time_t GetTime(const std::string& col) override;
-    std::string GetString(const std::string& col) override;
-    std::string GetStream(const std::string& col) override;
-    bool IsNull(const std::string& col) override;
+    int32_t GetInt(int col) override;
+    uint32_t GetUInt(int col) override;
+    int64_t GetLong(int col) override;
+    uint64_t GetULong(int col) override;
+    std::string GetString(int col) override;
+    std::string GetStream(int col) override;
+    bool IsNull(int col) override;
 
     bool Empty() const override { return cursor_ >= rows_; }
     std::shared_ptr<DBResult> Next() override;
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include "DatabasePool.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+
+namespace DB {
+
+thread_local Database* DatabasePool::current_ = nullptr;
+
+DatabasePool::DatabasePool(size_t size) :
+    size_(size)
+{
+    if (size_ == 0)
+        size_ = std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+DatabasePool::~DatabasePool() = default;
+
+bool DatabasePool::Open(const std::string& driver,
+    const std::string& host, uint16_t port,
+    const std::string& user, const std::string& pass,
+    const std::string& name)
+{
+    std::scoped_lock lock(lock_);
+    std::unique_ptr<Database> first(Database::CreateInstance(driver, host, port, user, pass, name));
+    if (!first || !first->IsConnected())
+        return false;
+
+    const size_t maxConnections = first->GetMaxConnections();
+    if (maxConnections != 0 && size_ > maxConnections)
+        size_ = maxConnections;
+    connections_.push_back(std::move(first));
+    while (connections_.size() < size_)
+    {
+        std::unique_ptr<Database> db(Database::CreateInstance(driver, host, port, user, pass, name));
+        if (!db || !db->IsConnected())
+        {
+            LOG_WARNING << "Could only open " << connections_.size() << " of " << size_ << " database connections" << std::endl;
+            break;
+        }
+        connections_.push_back(std::move(db));
+    }
+    for (const auto& db : connections_)
+        idle_.push_back(db.get());
+    return true;
+}
+
+DatabasePool::Connection DatabasePool::Acquire()
+{
+    if (current_)
+        return Connection(nullptr, current_);
+
+    std::unique_lock lock(lock_);
+    if (idle_.empty())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        released_.wait(lock, [this] { return !idle_.empty(); });
+        const uint64_t waited = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        ++waits_;
+        waitTime_ += waited;
+        maxWaitTime_ = std::max(maxWaitTime_, waited);
+    }
+    Database* db = idle_.back();
+    idle_.pop_back();
+    ++active_;
+    current_ = db;
+    return Connection(this, db);
+}
+
+void DatabasePool::Release(Database* db)
+{
+    current_ = nullptr;
+    {
+        std::scoped_lock lock(lock_);
+        idle_.push_back(db);
+        --active_;
+    }
+    released_.notify_one();
+}
+
+void DatabasePool::CheckConnections()
+{
+    std::vector<Database*> idle;
+    {
+        std::scoped_lock lock(lock_);
+        idle.swap(idle_);
+    }
+    // May reconnect, so don't block the others meanwhile
+    for (auto* db : idle)
+        db->CheckConnection();
+    {
+        std::scoped_lock lock(lock_);
+        idle_.insert(idle_.end(), idle.begin(), idle.end());
+    }
+    released_.notify_all();
+}
+
+DatabasePool::Stats DatabasePool::GetStats()
+{
+    std::scoped_lock lock(lock_);
+    return { connections_.size(), active_, waits_, waitTime_, maxWaitTime_ };
+}
+
+}
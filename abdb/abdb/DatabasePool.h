@@ -0,0 +1,110 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "Database.h"
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace DB {
+
+/// A fixed number of connections shared by all threads doing DB work. A thread
+/// acquires a connection and keeps it until the returned Connection is destroyed,
+/// nested Acquire() calls on the same thread return the same connection, so
+/// transactions span everything done while it is held.
+class DatabasePool
+{
+public:
+    class Connection
+    {
+        friend class DatabasePool;
+    private:
+        /// nullptr when the thread already held this connection
+        DatabasePool* pool_;
+        Database* db_;
+        Connection(DatabasePool* pool, Database* db) :
+            pool_(pool),
+            db_(db)
+        {}
+    public:
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+        Connection(Connection&& other) noexcept :
+            pool_(other.pool_),
+            db_(other.db_)
+        {
+            other.pool_ = nullptr;
+        }
+        ~Connection()
+        {
+            if (pool_)
+                pool_->Release(db_);
+        }
+        Database* Get() const { return db_; }
+        Database* operator->() const { return db_; }
+        operator Database*() const { return db_; }
+    };
+    struct Stats
+    {
+        size_t size;
+        /// Connections currently held by a thread
+        size_t active;
+        /// Number of Acquire() calls which had to wait for a free connection
+        uint64_t waits;
+        /// Microseconds waited in total
+        uint64_t waitTime;
+        /// Longest wait in microseconds
+        uint64_t maxWaitTime;
+    };
+private:
+    static thread_local Database* current_;
+    std::mutex lock_;
+    std::condition_variable released_;
+    std::vector<std::unique_ptr<Database>> connections_;
+    std::vector<Database*> idle_;
+    size_t size_;
+    size_t active_{ 0 };
+    uint64_t waits_{ 0 };
+    uint64_t waitTime_{ 0 };
+    uint64_t maxWaitTime_{ 0 };
+    void Release(Database* db);
+public:
+    /// 0 = one connection per CPU. The driver may limit it further.
+    explicit DatabasePool(size_t size);
+    ~DatabasePool();
+
+    /// Create the connections. Fails when not even one could connect.
+    bool Open(const std::string& driver,
+        const std::string& host, uint16_t port,
+        const std::string& user, const std::string& pass,
+        const std::string& name);
+    /// Blocks until a connection is free
+    Connection Acquire();
+    /// Run CheckConnection() on all connections not in use
+    void CheckConnections();
+    /// Get the stats, the wait counters count since the start
+    Stats GetStats();
+    size_t GetSize() const { return connections_.size(); }
+};
+
+}
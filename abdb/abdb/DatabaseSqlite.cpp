@@ -52,6 +52,8 @@ DatabaseSqlite::DatabaseSqlite(const std::string& file) :
 
 DatabaseSqlite::~DatabaseSqlite()
 {
+    for (const auto& stmt : statements_)
+        sqlite3_finalize(stmt.second);
     sqlite3_close(handle_);
 }
 
@@ -167,6 +169,110 @@ std::shared_ptr<DBResult> DatabaseSqlite::InternalSelectQuery(const std::string
     return VerifyResult(results);
 }
 
+sqlite3_stmt* DatabaseSqlite::GetStatement(const DBStatement& statement, const DBParams& params, bool& cached)
+{
+    sqlite3_stmt* stmt = nullptr;
+    cached = false;
+    auto it = statements_.find(statement.name);
+    if (it != statements_.end() && inUse_.find(it->second) == inUse_.end())
+    {
+        stmt = it->second;
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        cached = true;
+    }
+    else
+    {
+        std::string buf = Parse(statement.query);
+        if (sqlite3_prepare_v2(handle_, buf.c_str(), (int)buf.length(), &stmt, NULL) != SQLITE_OK)
+        {
+            sqlite3_finalize(stmt);
+            LOG_ERROR << "sqlite3_prepare_v2(): SQLITE ERROR: " << sqlite3_errmsg(handle_) << " (" << buf << ")" << std::endl;
+            return nullptr;
+        }
+        if (it == statements_.end())
+        {
+            statements_.emplace(statement.name, stmt);
+            cached = true;
+        }
+    }
+
+#ifdef DEBUG_SQL
+    LOG_DEBUG << "SQLITE EXECUTE: " << statement.name << std::endl;
+#endif
+
+    int index = 1;
+    for (const auto& param : params)
+    {
+        switch (param.type)
+        {
+        case DBParams::Type::Null:
+            sqlite3_bind_null(stmt, index);
+            break;
+        case DBParams::Type::Int:
+            sqlite3_bind_int64(stmt, index, param.intValue);
+            break;
+        case DBParams::Type::String:
+            sqlite3_bind_text(stmt, index, param.stringValue.c_str(), (int)param.stringValue.length(), SQLITE_TRANSIENT);
+            break;
+        case DBParams::Type::Blob:
+        {
+            // Same as EscapeBlob()
+            const std::string value = base64::encode((const unsigned char*)param.stringValue.data(), param.stringValue.length());
+            sqlite3_bind_text(stmt, index, value.c_str(), (int)value.length(), SQLITE_TRANSIENT);
+            break;
+        }
+        }
+        ++index;
+    }
+    return stmt;
+}
+
+bool DatabaseSqlite::InternalPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    std::lock_guard<std::recursive_mutex> lockClass(lock_);
+
+    if (!connected_)
+        return false;
+
+    bool cached;
+    sqlite3_stmt* stmt = GetStatement(statement, params, cached);
+    if (!stmt)
+        return false;
+
+    int ret = sqlite3_step(stmt);
+    if (cached)
+        sqlite3_reset(stmt);
+    else
+        sqlite3_finalize(stmt);
+    if (ret != SQLITE_OK && ret != SQLITE_DONE && ret != SQLITE_ROW)
+    {
+        LOG_ERROR << "sqlite3_step(): SQLITE ERROR: " << sqlite3_errmsg(handle_) << " (" << statement.name << ")" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<DBResult> DatabaseSqlite::InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params)
+{
+    std::lock_guard<std::recursive_mutex> lockClass(lock_);
+
+    if (!connected_)
+        return std::shared_ptr<DBResult>();
+
+    bool cached;
+    sqlite3_stmt* stmt = GetStatement(statement, params, cached);
+    if (!stmt)
+        return std::shared_ptr<DBResult>();
+
+    if (cached)
+        inUse_.emplace(stmt);
+    std::shared_ptr<DBResult> results(new SqliteResult(stmt, cached),
+        std::bind(&Database::FreeResult, this, std::placeholders::_1));
+    return VerifyResult(results);
+}
+
 uint64_t DatabaseSqlite::GetLastInsertId()
 {
     return (uint64_t)sqlite3_last_insert_rowid(handle_);
@@ -193,11 +299,17 @@ std::string DatabaseSqlite::EscapeBlob(const char* s, size_t length)
 
 void DatabaseSqlite::FreeResult(DBResult* res)
 {
-    delete (SqliteResult*)res;
+    std::lock_guard<std::recursive_mutex> lockClass(lock_);
+    SqliteResult* result = (SqliteResult*)res;
+    // Reset the statement before it can be used again
+    if (result->cached_)
+        inUse_.erase(result->handle_);
+    delete result;
 }
 
-SqliteResult::SqliteResult(sqlite3_stmt* res) :
+SqliteResult::SqliteResult(sqlite3_stmt* res, bool cached /* = false */) :
     handle_(res),
+    cached_(cached),
     rowAvailable_(false)
 {
     listNames_.clear();
@@ -210,88 +322,72 @@ SqliteResult::SqliteResult(sqlite3_stmt* res) :
 
 SqliteResult::~SqliteResult()
 {
-    sqlite3_finalize(handle_);
+    if (cached_)
+        sqlite3_reset(handle_);
+    else
+        sqlite3_finalize(handle_);
 }
 
-int32_t SqliteResult::GetInt(const std::string& col)
+int SqliteResult::FindColumn(const std::string& col) const
 {
-    ListNames::iterator it = listNames_.find(col);
+    ListNames::const_iterator it = listNames_.find(col);
     if (it != listNames_.end())
-        return sqlite3_column_int(handle_, it->second);
-
-    LOG_ERROR << "Error during GetInt(" << col << ")." << std::endl;
-    return 0; // Failed
+        return static_cast<int>(it->second);
+    return -1;
 }
 
-uint32_t SqliteResult::GetUInt(const std::string& col)
+int32_t SqliteResult::GetInt(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-        return static_cast<uint32_t>(sqlite3_column_int(handle_, it->second));
-
-    LOG_ERROR << "Error during GetUInt(" << col << ")." << std::endl;
-    return 0; // Failed
+    if (col < 0)
+        return 0;
+    return sqlite3_column_int(handle_, col);
 }
 
-int64_t SqliteResult::GetLong(const std::string& col)
+uint32_t SqliteResult::GetUInt(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-        return sqlite3_column_int64(handle_, it->second);
-
-    LOG_ERROR << "Error during GetLong(" << col << ")." << std::endl;
-    return 0; // Failed
+    if (col < 0)
+        return 0;
+    return static_cast<uint32_t>(sqlite3_column_int(handle_, col));
 }
 
-uint64_t SqliteResult::GetULong(const std::string& col)
+int64_t SqliteResult::GetLong(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-        return static_cast<uint64_t>(sqlite3_column_int64(handle_, it->second));
-
-    LOG_ERROR << "Error during GetULong(" << col << ")." << std::endl;
-    return 0; // Failed
+    if (col < 0)
+        return 0;
+    return sqlite3_column_int64(handle_, col);
 }
 
-time_t SqliteResult::GetTime(const std::string& col)
+uint64_t SqliteResult::GetULong(int col)
 {
-    return static_cast<time_t>(GetLong(col));
+    if (col < 0)
+        return 0;
+    return static_cast<uint64_t>(sqlite3_column_int64(handle_, col));
 }
 
-std::string SqliteResult::GetString(const std::string& col)
+std::string SqliteResult::GetString(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-    {
-        return std::string((const char*)sqlite3_column_text(handle_, it->second));
-    }
-
-    LOG_ERROR << "Error during GetString(" << col << ")." << std::endl;
-    return std::string(""); // Failed
+    if (col < 0)
+        return std::string("");
+    const char* value = (const char*)sqlite3_column_text(handle_, col);
+    if (!value)
+        return std::string("");
+    return std::string(value);
 }
 
-std::string SqliteResult::GetStream(const std::string& col)
+std::string SqliteResult::GetStream(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-    {
-        const char* value = (const char*)sqlite3_column_blob(handle_, it->second);
-        int size = sqlite3_column_bytes(handle_, it->second);
-        return base64::decode(value, size);
-    }
-
-    LOG_ERROR << "Error during GetStream(" << col << ")." << std::endl;
-    return std::string(""); // Failed
+    if (col < 0)
+        return std::string("");
+    const char* value = (const char*)sqlite3_column_blob(handle_, col);
+    int size = sqlite3_column_bytes(handle_, col);
+    return base64::decode(value, size);
 }
 
-bool SqliteResult::IsNull(const std::string& col)
+bool SqliteResult::IsNull(int col)
 {
-    ListNames::iterator it = listNames_.find(col);
-    if (it != listNames_.end())
-        return sqlite3_column_type(handle_, it->second) == SQLITE_NULL;
-
-    LOG_ERROR << "Error during IsNull(" << col << ")." << std::endl;
-    return true; // Failed
+    if (col < 0)
+        return true;
+    return sqlite3_column_type(handle_, col) == SQLITE_NULL;
 }
 
 std::shared_ptr<DBResult> SqliteResult::Next()
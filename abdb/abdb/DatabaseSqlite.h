@@ -26,6 +26,8 @@
 #include "Database.h"
 #include <sqlite3.h>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace DB {
 
@@ -34,9 +36,18 @@ class DatabaseSqlite final : public Database
 protected:
     sqlite3* handle_;
     std::recursive_mutex lock_;
+    /// Prepared statements by name
+    std::unordered_map<std::string, sqlite3_stmt*> statements_;
+    /// Cached statements a SqliteResult is reading from
+    std::unordered_set<sqlite3_stmt*> inUse_;
     std::string Parse(const std::string& s);
     bool InternalQuery(const std::string& query) override;
     std::shared_ptr<DBResult> InternalSelectQuery(const std::string& query) override;
+    bool InternalPreparedQuery(const DBStatement& statement, const DBParams& params) override;
+    std::shared_ptr<DBResult> InternalSelectPreparedQuery(const DBStatement& statement, const DBParams& params) override;
+    /// Returns the cached statement with the parameters bound. If the cached statement
+    /// is still used by a result, a new statement is prepared and cached is false.
+    sqlite3_stmt* GetStatement(const DBStatement& statement, const DBParams& params, bool& cached);
 public:
     DatabaseSqlite(const std::string& file);
     ~DatabaseSqlite() override;
@@ -50,28 +61,32 @@ public:
     std::string EscapeString(const std::string& s) override;
     std::string EscapeBlob(const char* s, size_t length) override;
     void FreeResult(DBResult* res) override;
+    /// Writers lock the whole file
+    size_t GetMaxConnections() const override { return 1; }
 };
 
 class SqliteResult final : public DBResult
 {
     friend class DatabaseSqlite;
 protected:
-    explicit SqliteResult(sqlite3_stmt* res);
+    SqliteResult(sqlite3_stmt* res, bool cached = false);
 
     typedef std::map<const std::string, uint32_t> ListNames;
     ListNames listNames_;
     sqlite3_stmt* handle_;
+    /// The statement is owned by the DatabaseSqlite, reset it instead of finalizing it
+    bool cached_;
     bool rowAvailable_;
+    int FindColumn(const std::string& col) const override;
 public:
     ~SqliteResult() override;
-    int32_t GetInt(const std::string& col) override;
-    uint32_t GetUInt(const std::string& col) override;
-    int64_t GetLong(const std::string& col) override;
-    uint64_t GetULong(const std::string& col) override;
-    time_t GetTime(const std::string& col) override;
-    std::string GetString(const std::string& col) override;
-    std::string GetStream(const std::string& col) override;
-    bool IsNull(const std::string& col) override;
+    int32_t GetInt(int col) override;
+    uint32_t GetUInt(int col) override;
+    int64_t GetLong(int col) override;
+    uint64_t GetULong(int col) override;
+    std::string GetString(int col) override;
+    std::string GetStream(int col) override;
+    bool IsNull(int col) override;
 
     bool Empty() const override { return !rowAvailable_; }
     std::shared_ptr<DBResult> Next() override;
@@ -60,6 +60,7 @@
 #include <abscommon/UuidUtils.h>
 #include <fstream>
 #include <sstream>
+#include <zlib.h>
 
 Application::Application() :
     ServerApp::ServerApp(),
@@ -69,14 +70,16 @@ Application::Application() :
     uptimeRound_(0),
     statusMeasureTime_(0),
     lastLoadCalc_(0),
-    temporary_(false)
+    temporary_(false),
+    maxThroughput_(0),
+    maxClientThroughput_(0)
 {
     serverType_ = AB::Entities::ServiceTypeFileServer;
     ioService_ = std::make_shared<asio::io_service>();
     Subsystems::Instance.CreateSubsystem<Asynch::Dispatcher>();
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
-    Subsystems::Instance.CreateSubsystem<IO::DataClient>(*ioService_);
+    Subsystems::Instance.CreateSubsystem<IO::DataClient>();
     Subsystems::Instance.CreateSubsystem<Auth::BanManager>();
     Subsystems::Instance.CreateSubsystem<Net::MessageClient>(*ioService_);
     cli_.push_back({ "temp", { "-temp", "--temporary" }, "Temporary application", false, false, sa::arg_parser::option_type::none });
@@ -255,6 +258,9 @@ bool Application::Initialize(const std::vector<std::string>& args)
     dataPort_ = static_cast<uint16_t>(config->GetGlobalInt("data_port", 0ll));
     requireAuth_ = config->GetGlobalBool("require_auth", false);
     maxThroughput_ = static_cast<uint64_t>(config->GetGlobalInt("max_throughput", 0ll));
+    maxClientThroughput_ = static_cast<uint64_t>(config->GetGlobalInt("max_client_throughput", 0ll));
+    throughput_.SetRate(maxThroughput_);
+    fileCache_ = std::make_unique<FileCache>(static_cast<size_t>(config->GetGlobalInt("file_cache_size", 64ll * 1024 * 1024)));
 
     Auth::BanManager::LoginTries = static_cast<uint32_t>(config->GetGlobalInt("login_tries", 5ll));
     Auth::BanManager::LoginRetryTimeout = static_cast<uint32_t>(config->GetGlobalInt("login_retrytimeout", 5000ll));
@@ -356,6 +362,8 @@ bool Application::Initialize(const std::vector<std::string>& args)
     LOG_INFO << "  Log dir: " << (IO::Logger::logDir_.empty() ? "(empty)" : IO::Logger::logDir_) << std::endl;
     LOG_INFO << "  Require authentication: " << requireAuth_ << std::endl;
     LOG_INFO << "  Max. throughput: " << Utils::ConvertSize(maxThroughput_) << "/s" << std::endl;
+    LOG_INFO << "  Max. client throughput: " << Utils::ConvertSize(maxClientThroughput_) << "/s" << std::endl;
+    LOG_INFO << "  File cache: " << Utils::ConvertSize(fileCache_->GetMaxSize()) << std::endl;
     LOG_INFO << "  Worker Threads: " << server_->config.thread_pool_size << std::endl;
     if (haveData)
         LOG_INFO << "  Data Server: " << dataClient->GetHost() << ":" << dataClient->GetPort() << std::endl;
@@ -520,164 +528,126 @@ SimpleWeb::CaseInsensitiveMultimap Application::GetDefaultHeader()
     return result;
 }
 
-void Application::GetHandlerDefault(std::shared_ptr<HttpsServer::Response> response,
-    std::shared_ptr<HttpsServer::Request> request)
+static bool GzipCompress(const std::string& data, std::string& result)
 {
-    if (!IsAllowed(request))
-    {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
-        return;
-    }
-    try
-    {
-        auto web_root_path = fs::canonical(root_);
-        auto path = fs::canonical(Utils::AddSlash(root_) + request->path);
-        // Check if path is within web_root_path
-        if (std::distance(web_root_path.begin(), web_root_path.end()) > std::distance(path.begin(), path.end()) ||
-            !std::equal(web_root_path.begin(), web_root_path.end(), path.begin()))
-        {
-            LOG_ERROR << request->remote_endpoint_address() << ":" << request->remote_endpoint_port() << ": "
-                << "Trying to access file outside root " << path.string() << std::endl;
-            throw std::invalid_argument("path must be within root path");
-        }
-        if (fs::is_directory(path))
-        {
-            LOG_ERROR << request->remote_endpoint_address() << ":" << request->remote_endpoint_port() << ": "
-                << "Trying to access a directory " << path.string() << std::endl;
-            throw std::invalid_argument("not a file");
-        }
-        if (Utils::IsHiddenFile(path.string()))
-        {
-            LOG_ERROR << request->remote_endpoint_address() << ":" << request->remote_endpoint_port() << ": "
-                << "Trying to access a hidden file " << path.string() << std::endl;
-            throw std::invalid_argument("hidden file");
-        }
-
-        SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
+    z_stream stream{};
+    // 16 + 15 -> gzip header and max. window size
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + 15, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
 
-        auto ifs = std::make_shared<std::ifstream>();
-        ifs->open(path.string(), std::ifstream::in | std::ios::binary | std::ios::ate);
+    result.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = static_cast<uInt>(result.size());
+    const int ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END)
+        return false;
+    result.resize(stream.total_out);
+    return true;
+}
 
-        if (*ifs)
+static bool AcceptsGzip(const HttpsServer::Request& request)
+{
+    const auto it = request.header.find("Accept-Encoding");
+    if (it == request.header.end())
+        return false;
+    for (const auto& part : Utils::Split((*it).second, ","))
+    {
+        // gzip;q=0.5
+        const auto params = Utils::Split(part, ";");
+        if (params.empty())
+            continue;
+        const std::string coding = sa::Trim(params[0]);
+        if (!SimpleWeb::case_insensitive_equal(coding, "gzip") && coding.compare("*") != 0)
+            continue;
+        if (params.size() > 1)
         {
-            auto length = ifs->tellg();
-            ifs->seekg(0, std::ios::beg);
-            UpdateBytesSent(static_cast<size_t>(length));
-
-            header.emplace("Content-Length", to_string(length));
-            response->write(header);
-
-            // Trick to define a recursive function within this scope (for example purposes)
-            class FileServer
-            {
-            public:
-                static void read_and_send(uint64_t maxBitsPerSec, const std::shared_ptr<HttpsServer::Response> &response,
-                    const std::shared_ptr<std::ifstream> &ifs)
-                {
-                    // Read and send 128 KB at a time
-                    std::vector<char> buffer(131072);
-                    std::streamsize read_length;
-                    if ((read_length = ifs->read(&buffer[0], static_cast<std::streamsize>(buffer.size())).gcount()) > 0)
-                    {
-                        response->write(&buffer[0], read_length);
-                        if (read_length == static_cast<std::streamsize>(buffer.size()))
-                        {
-                            if (maxBitsPerSec > 0)
-                                // Throttle to meet max throughput
-                                std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<unsigned long>(read_length * 8 * 1000) / maxBitsPerSec));
-                            response->send([maxBitsPerSec, response, ifs](const SimpleWeb::error_code& ec)
-                            {
-                                if (!ec)
-                                    read_and_send(maxBitsPerSec, response, ifs);
-                                else
-                                    LOG_ERROR << "Connection interrupted " << ec.default_error_condition().value() << " " <<
-                                              ec.default_error_condition().message() << std::endl;
-                            });
-                        }
-                    }
-                }
-            };
-            FileServer::read_and_send(maxThroughput_ * 8 /* Bit/sec */, response, ifs);
+            const std::string q = sa::Trim(params[1]);
+            if (q.compare(0, 2, "q=") == 0 && std::atof(q.c_str() + 2) <= 0.0)
+                return false;
         }
-        else
-            throw std::invalid_argument("could not read file");
-    }
-    catch (const std::exception&)
-    {
-        response->write(SimpleWeb::StatusCode::client_error_not_found,
-            "Not found " + request->path);
+        return true;
     }
+    return false;
 }
 
-void Application::GetHandlerGames(std::shared_ptr<HttpsServer::Response> response,
-    std::shared_ptr<HttpsServer::Request> request)
+static bool MatchesETag(const HttpsServer::Request& request, const std::string& etag)
 {
-    AB_PROFILE;
+    const auto it = request.header.find("If-None-Match");
+    if (it == request.header.end())
+        return false;
+    for (const auto& part : Utils::Split((*it).second, ","))
+    {
+        std::string tag = sa::Trim(part);
+        if (tag.compare("*") == 0)
+            return true;
+        // Weak comparison
+        if (tag.compare(0, 2, "W/") == 0)
+            tag.erase(0, 2);
+        if (tag == etag)
+            return true;
+    }
+    return false;
+}
 
-    if (!IsAllowed(request))
+std::shared_ptr<const Application::StaticResponse> Application::GetStaticResponse(const AB::Entities::Version& version,
+    const char* rootName, const RenderFunction& render)
+{
+    StaticResource* resource = nullptr;
     {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
-        return;
+        std::scoped_lock lock(staticMutex_);
+        auto& res = staticResources_[version.name];
+        if (!res)
+            res = std::make_unique<StaticResource>();
+        resource = res.get();
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::GameList gl;
-    if (!dataClient->Read(gl))
-    {
-        LOG_ERROR << "Error reading game list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
+    // When the version changed, concurrent requests for this resource wait here until
+    // the first one rendered it, instead of all of them reading the same data.
+    std::scoped_lock lock(resource->lock);
+    if (resource->response && resource->response->version == version.value)
+        return resource->response;
 
-    AB::Entities::Version gamesVersion;
-    gamesVersion.name = "game_maps";
-    if (!dataClient->Read(gamesVersion))
-    {
-        LOG_ERROR << "Error reading game version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
     pugi::xml_document doc;
     auto declarationNode = doc.append_child(pugi::node_declaration);
     declarationNode.append_attribute("version").set_value("1.0");
     declarationNode.append_attribute("encoding").set_value("UTF-8");
     declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("games");
-    root.append_attribute("version").set_value(gamesVersion.value);
+    auto root = doc.append_child(rootName);
+    root.append_attribute("version").set_value(version.value);
+    if (!render(*GetSubsystem<IO::DataClient>(), root))
+        return std::shared_ptr<const StaticResponse>();
 
-    for (const std::string& uuid : gl.gameUuids)
+    auto result = std::make_shared<StaticResponse>();
+    result->version = version.value;
+    std::stringstream stream;
+    doc.save(stream);
+    result->content = stream.str();
+    if (!GzipCompress(result->content, result->gzipContent))
     {
-        AB::Entities::Game g;
-        g.uuid = uuid;
-        if (!dataClient->Read(g))
-            continue;
-        auto gNd = root.append_child("game");
-        gNd.append_attribute("uuid").set_value(g.uuid.c_str());
-        gNd.append_attribute("name").set_value(g.name.c_str());
-        gNd.append_attribute("type").set_value(g.type);
-        gNd.append_attribute("landing").set_value(g.landing);
-        gNd.append_attribute("map_coord_x").set_value(g.mapCoordX);
-        gNd.append_attribute("map_coord_y").set_value(g.mapCoordY);
-        // The client should know about that to show/hide the 'Enter' button
-        gNd.append_attribute("queue_map").set_value(g.queueMapUuid.c_str());
-        // The rest is not interesting for the player, so skip it
+        LOG_WARNING << "Error compressing " << version.name << std::endl;
+        result->gzipContent.clear();
     }
+    std::stringstream etag;
+    etag << version.value << "-" << std::hex << std::hash<std::string>()(result->content);
+    // Both encodings are different representations, they need different strong ETags
+    result->etag = "\"" + etag.str() + "\"";
+    result->gzipEtag = "\"" + etag.str() + "-gz\"";
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+    LOG_INFO << "Rendered " << version.name << " version " << version.value << ": " <<
+        Utils::ConvertSize(result->content.size()) << ", compressed " <<
+        Utils::ConvertSize(result->gzipContent.size()) << std::endl;
+
+    resource->response = result;
+    return result;
 }
 
-void Application::GetHandlerSkills(std::shared_ptr<HttpsServer::Response> response,
-    std::shared_ptr<HttpsServer::Request> request)
+void Application::SendStaticData(std::shared_ptr<HttpsServer::Response> response,
+    std::shared_ptr<HttpsServer::Request> request,
+    const std::string& versionName, const char* rootName, const RenderFunction& render)
 {
-    AB_PROFILE;
-
     if (!IsAllowed(request))
     {
         response->write(SimpleWeb::StatusCode::client_error_forbidden,
@@ -685,435 +655,526 @@ void Application::GetHandlerSkills(std::shared_ptr<HttpsServer::Response> respon
         return;
     }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::SkillList sl;
-    if (!dataClient->Read(sl))
+    AB::Entities::Version v;
+    v.name = versionName;
+    if (!GetSubsystem<IO::DataClient>()->Read(v))
     {
-        LOG_ERROR << "Error reading skill list" << std::endl;
+        LOG_ERROR << "Error reading version " << versionName << std::endl;
         response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
         return;
     }
-    AB::Entities::Version v;
-    v.name = "game_skills";
-    if (!dataClient->Read(v))
+
+    auto data = GetStaticResponse(v, rootName, render);
+    if (!data)
     {
-        LOG_ERROR << "Error reading skill version" << std::endl;
         response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
         return;
     }
 
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("skills");
-    root.append_attribute("version").set_value(v.value);
-
-    for (const std::string& uuid : sl.skillUuids)
+    const bool gzip = !data->gzipContent.empty() && AcceptsGzip(*request);
+    const std::string& etag = gzip ? data->gzipEtag : data->etag;
+    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
+    header.emplace("ETag", etag);
+    header.emplace("Vary", "Accept-Encoding");
+    // Clients may cache it but must revalidate it
+    header.emplace("Cache-Control", "no-cache");
+    if (MatchesETag(*request, etag))
     {
-        AB::Entities::Skill s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("skill");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("attribute").set_value(s.attributeUuid.c_str());
-        gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
-        gNd.append_attribute("type").set_value(static_cast<unsigned long long>(s.type));
-        gNd.append_attribute("elite").set_value(s.isElite);
-        gNd.append_attribute("access").set_value(s.access);
-        gNd.append_attribute("description").set_value(s.description.c_str());
-        gNd.append_attribute("short_description").set_value(s.shortDescription.c_str());
-        gNd.append_attribute("icon").set_value(s.icon.c_str());
-        gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
-        gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
-        gNd.append_attribute("activation").set_value(s.activation);
-        gNd.append_attribute("recharge").set_value(s.recharge);
-        gNd.append_attribute("const_energy").set_value(s.costEnergy);
-        gNd.append_attribute("const_energy_regen").set_value(s.costEnergyRegen);
-        gNd.append_attribute("const_adrenaline").set_value(s.costAdrenaline);
-        gNd.append_attribute("const_overcast").set_value(s.costOvercast);
-        gNd.append_attribute("const_hp").set_value(s.costHp);
+        response->write(SimpleWeb::StatusCode::redirection_not_modified, header);
+        return;
     }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
     header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+    if (gzip)
+    {
+        header.emplace("Content-Encoding", "gzip");
+        UpdateBytesSent(data->gzipContent.size());
+        response->write(data->gzipContent, header);
+        return;
+    }
+    UpdateBytesSent(data->content.size());
+    response->write(data->content, header);
 }
 
-void Application::GetHandlerProfessions(std::shared_ptr<HttpsServer::Response> response,
-    std::shared_ptr<HttpsServer::Request> request)
+enum class RangeResult
 {
-    AB_PROFILE;
+    None,
+    Valid,
+    Unsatisfiable
+};
 
-    if (!IsAllowed(request))
-    {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
-        return;
-    }
+/// Parses a single byte range, e.g. `bytes=0-499`, `bytes=500-` or `bytes=-500`. end is exclusive.
+static RangeResult ParseRange(const std::string& value, uint64_t size, uint64_t& start, uint64_t& end)
+{
+    const std::string unit = "bytes=";
+    if (value.compare(0, unit.length(), unit) != 0)
+        return RangeResult::None;
+    const std::string range = sa::Trim(value.substr(unit.length()));
+    // We don't send multipart responses, ignoring the header is allowed
+    if (range.find(',') != std::string::npos)
+        return RangeResult::None;
+    const size_t dash = range.find('-');
+    if (dash == std::string::npos)
+        return RangeResult::None;
+    const std::string first = range.substr(0, dash);
+    const std::string last = range.substr(dash + 1);
+    if ((!first.empty() && !Utils::IsNumber(first)) || (!last.empty() && !Utils::IsNumber(last)))
+        return RangeResult::None;
+
+    if (first.empty())
+    {
+        // Suffix, the last n bytes
+        if (last.empty())
+            return RangeResult::None;
+        const uint64_t length = std::stoull(last);
+        if (length == 0 || size == 0)
+            return RangeResult::Unsatisfiable;
+        start = size - std::min(length, size);
+        end = size;
+        return RangeResult::Valid;
+    }
+
+    const uint64_t from = std::stoull(first);
+    if (from >= size)
+        return RangeResult::Unsatisfiable;
+    uint64_t to = size - 1;
+    if (!last.empty())
+    {
+        to = std::stoull(last);
+        if (to < from)
+            return RangeResult::None;
+        to = std::min(to, size - 1);
+    }
+    start = from;
+    end = to + 1;
+    return RangeResult::Valid;
+}
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::ProfessionList pl;
-    if (!dataClient->Read(pl))
+std::shared_ptr<sa::TokenBucket<>> Application::GetClientThroughput(uint32_t ip)
+{
+    if (maxClientThroughput_ == 0)
+        return std::shared_ptr<sa::TokenBucket<>>();
+
+    std::scoped_lock lock(throughputLock_);
+    auto it = clientThroughput_.find(ip);
+    if (it != clientThroughput_.end())
     {
-        LOG_ERROR << "Error reading profession list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
+        if (auto result = (*it).second.lock())
+            return result;
     }
-    AB::Entities::Version v;
-    v.name = "game_professions";
-    if (!dataClient->Read(v))
+    // Remove clients without running downloads
+    for (auto i = clientThroughput_.begin(); i != clientThroughput_.end(); )
     {
-        LOG_ERROR << "Error reading profession version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
+        if ((*i).second.expired())
+            i = clientThroughput_.erase(i);
+        else
+            ++i;
     }
+    auto result = std::make_shared<sa::TokenBucket<>>(maxClientThroughput_);
+    clientThroughput_[ip] = result;
+    return result;
+}
 
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("professions");
-    root.append_attribute("version").set_value(v.value);
+std::chrono::milliseconds Application::Throttle(Download& download, size_t bytes)
+{
+    std::scoped_lock lock(throughputLock_);
+    auto result = throughput_.Consume(bytes);
+    if (download.clientThroughput)
+        result = std::max(result, download.clientThroughput->Consume(bytes));
+    return result;
+}
 
-    for (const std::string& uuid : pl.profUuids)
+void Application::SendFileChunk(std::shared_ptr<Download> download)
+{
+    // Send 128 KB at a time
+    static constexpr uint64_t CHUNK_SIZE = 131072;
+    const size_t length = static_cast<size_t>(std::min(CHUNK_SIZE, download->end - download->pos));
+    if (download->data)
+        download->response->write(download->data->data() + download->pos, static_cast<std::streamsize>(length));
+    else
     {
-        AB::Entities::Profession s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("prof");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("abbr").set_value(s.abbr.c_str());
-        gNd.append_attribute("model_index_female").set_value(s.modelIndexFemale);
-        gNd.append_attribute("model_index_male").set_value(s.modelIndexMale);
-        gNd.append_attribute("num_attr").set_value(s.attributeCount);
-        for (const AB::Entities::AttriInfo& a : s.attributes)
+        if (download->buffer.empty())
+            download->buffer.resize(CHUNK_SIZE);
+        if (!download->stream->read(download->buffer.data(), static_cast<std::streamsize>(length)))
         {
-            auto attrNd = gNd.append_child("attr");
-            attrNd.append_attribute("uuid").set_value(a.uuid.c_str());
+            LOG_ERROR << "Error reading file" << std::endl;
+            // Content-Length was already sent, let the client know it's incomplete
+            download->response->close_connection_after_response = true;
+            return;
         }
+        download->response->write(download->buffer.data(), static_cast<std::streamsize>(length));
     }
+    download->pos += length;
+    UpdateBytesSent(length);
+    // The rest is sent when the Response is destroyed
+    if (download->pos >= download->end)
+        return;
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+    const auto wait = Throttle(*download, length);
+    download->response->send([this, download, wait](const SimpleWeb::error_code& ec)
+    {
+        if (ec)
+        {
+            LOG_ERROR << "Connection interrupted " << ec.default_error_condition().value() << " " <<
+                ec.default_error_condition().message() << std::endl;
+            return;
+        }
+        if (wait.count() == 0)
+        {
+            SendFileChunk(download);
+            return;
+        }
+        // Wait without blocking a worker thread
+        auto timer = std::make_shared<asio::steady_timer>(*ioService_, wait);
+        timer->async_wait([this, download, timer](const asio::error_code& ec)
+        {
+            if (!ec)
+                SendFileChunk(download);
+        });
+    });
 }
 
-void Application::GetHandlerAttributes(std::shared_ptr<HttpsServer::Response> response,
+void Application::GetHandlerDefault(std::shared_ptr<HttpsServer::Response> response,
     std::shared_ptr<HttpsServer::Request> request)
 {
-    AB_PROFILE;
-
     if (!IsAllowed(request))
     {
         response->write(SimpleWeb::StatusCode::client_error_forbidden,
             "Forbidden");
         return;
     }
-
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::AttributeList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading attribute list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_attributes";
-    if (!dataClient->Read(v))
+    try
     {
-        LOG_ERROR << "Error reading attribute version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
+        auto web_root_path = fs::canonical(root_);
+        auto path = fs::canonical(Utils::AddSlash(root_) + request->path);
+        // Check if path is within web_root_path
+        if (std::distance(web_root_path.begin(), web_root_path.end()) > std::distance(path.begin(), path.end()) ||
+            !std::equal(web_root_path.begin(), web_root_path.end(), path.begin()))
+        {
+            LOG_ERROR << request->remote_endpoint_address() << ":" << request->remote_endpoint_port() << ": "
+                << "Trying to access file outside root " << path.string() << std::endl;
+            throw std::invalid_argument("path must be within root path");
+        }
+        if (fs::is_directory(path))
+        {
+            LOG_ERROR << request->remote_endpoint_address() << ":" << request->remote_endpoint_port() << ": "
+                << "Trying to access a directory " << path.string() << std::endl;
+            throw std::invalid_argument("not a file");
+        }
+        if (Utils::IsHiddenFile(path.string()))
+        {
+            LOG_ERROR << request->remote_endpoint_address() << ":" << request->remote_endpoint_port() << ": "
+                << "Trying to access a hidden file " << path.string() << std::endl;
+            throw std::invalid_argument("hidden file");
+        }
 
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("attributes");
-    root.append_attribute("version").set_value(v.value);
+        auto download = std::make_shared<Download>();
+        download->response = response;
+        download->data = fileCache_->Get(path);
+        if (!download->data)
+        {
+            download->stream = std::make_unique<std::ifstream>(path.string(), std::ios::in | std::ios::binary);
+            if (!*download->stream)
+                throw std::invalid_argument("could not read file");
+        }
+        const uint64_t size = download->data ? download->data->size() : static_cast<uint64_t>(fs::file_size(path));
+        download->end = size;
 
-    for (const std::string& uuid : pl.uuids)
+        SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
+        header.emplace("Accept-Ranges", "bytes");
+        SimpleWeb::StatusCode status = SimpleWeb::StatusCode::success_ok;
+        const auto rangeIt = request->header.find("Range");
+        if (rangeIt != request->header.end())
+        {
+            switch (ParseRange((*rangeIt).second, size, download->pos, download->end))
+            {
+            case RangeResult::Unsatisfiable:
+                header.emplace("Content-Range", "bytes */" + std::to_string(size));
+                response->write(SimpleWeb::StatusCode::client_error_range_not_satisfiable, header);
+                return;
+            case RangeResult::Valid:
+                status = SimpleWeb::StatusCode::success_partial_content;
+                header.emplace("Content-Range", "bytes " + std::to_string(download->pos) + "-" +
+                    std::to_string(download->end - 1) + "/" + std::to_string(size));
+                break;
+            case RangeResult::None:
+                break;
+            }
+        }
+        if (download->stream && download->pos != 0)
+            download->stream->seekg(static_cast<std::streamoff>(download->pos));
+
+        header.emplace("Content-Length", std::to_string(download->end - download->pos));
+        response->write(status, header);
+        if (download->pos == download->end)
+            return;
+
+        download->clientThroughput = GetClientThroughput(request->remote_endpoint->address().to_v4().to_uint());
+        SendFileChunk(download);
+    }
+    catch (const std::exception&)
     {
-        AB::Entities::Attribute s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("attrib");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
-        gNd.append_attribute("primary").set_value(s.isPrimary);
+        response->write(SimpleWeb::StatusCode::client_error_not_found,
+            "Not found " + request->path);
     }
-
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
 }
 
-void Application::GetHandlerEffects(std::shared_ptr<HttpsServer::Response> response,
+void Application::GetHandlerGames(std::shared_ptr<HttpsServer::Response> response,
     std::shared_ptr<HttpsServer::Request> request)
 {
     AB_PROFILE;
 
-    if (!IsAllowed(request))
+    SendStaticData(response, request, "game_maps", "games",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
-        return;
-    }
+        AB::Entities::GameList gl;
+        if (!dataClient.Read(gl))
+        {
+            LOG_ERROR << "Error reading game list" << std::endl;
+            return false;
+        }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::EffectList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading effect list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_effects";
-    if (!dataClient->Read(v))
-    {
-        LOG_ERROR << "Error reading effect version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
+        for (const AB::Entities::Game& g : dataClient.ReadMany<AB::Entities::Game>(gl.gameUuids))
+        {
+            auto gNd = root.append_child("game");
+            gNd.append_attribute("uuid").set_value(g.uuid.c_str());
+            gNd.append_attribute("name").set_value(g.name.c_str());
+            gNd.append_attribute("type").set_value(g.type);
+            gNd.append_attribute("landing").set_value(g.landing);
+            gNd.append_attribute("map_coord_x").set_value(g.mapCoordX);
+            gNd.append_attribute("map_coord_y").set_value(g.mapCoordY);
+            // The client should know about that to show/hide the 'Enter' button
+            gNd.append_attribute("queue_map").set_value(g.queueMapUuid.c_str());
+            // The rest is not interesting for the player, so skip it
+        }
+        return true;
+    });
+}
 
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("effects");
-    root.append_attribute("version").set_value(v.value);
+void Application::GetHandlerSkills(std::shared_ptr<HttpsServer::Response> response,
+    std::shared_ptr<HttpsServer::Request> request)
+{
+    AB_PROFILE;
 
-    for (const std::string& uuid : pl.effectUuids)
+    SendStaticData(response, request, "game_skills", "skills",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        AB::Entities::Effect s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("effect");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("category").set_value(s.category);
-        gNd.append_attribute("icon").set_value(s.icon.c_str());
-        gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
-        gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
-    }
+        AB::Entities::SkillList sl;
+        if (!dataClient.Read(sl))
+        {
+            LOG_ERROR << "Error reading skill list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const AB::Entities::Skill& s : dataClient.ReadMany<AB::Entities::Skill>(sl.skillUuids))
+        {
+            auto gNd = root.append_child("skill");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("attribute").set_value(s.attributeUuid.c_str());
+            gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
+            gNd.append_attribute("type").set_value(static_cast<unsigned long long>(s.type));
+            gNd.append_attribute("elite").set_value(s.isElite);
+            gNd.append_attribute("access").set_value(s.access);
+            gNd.append_attribute("description").set_value(s.description.c_str());
+            gNd.append_attribute("short_description").set_value(s.shortDescription.c_str());
+            gNd.append_attribute("icon").set_value(s.icon.c_str());
+            gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
+            gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
+            gNd.append_attribute("activation").set_value(s.activation);
+            gNd.append_attribute("recharge").set_value(s.recharge);
+            gNd.append_attribute("const_energy").set_value(s.costEnergy);
+            gNd.append_attribute("const_energy_regen").set_value(s.costEnergyRegen);
+            gNd.append_attribute("const_adrenaline").set_value(s.costAdrenaline);
+            gNd.append_attribute("const_overcast").set_value(s.costOvercast);
+            gNd.append_attribute("const_hp").set_value(s.costHp);
+        }
+        return true;
+    });
 }
 
-void Application::GetHandlerItems(std::shared_ptr<HttpsServer::Response> response,
+void Application::GetHandlerProfessions(std::shared_ptr<HttpsServer::Response> response,
     std::shared_ptr<HttpsServer::Request> request)
 {
     AB_PROFILE;
 
-    if (!IsAllowed(request))
+    SendStaticData(response, request, "game_professions", "professions",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
-        return;
-    }
+        AB::Entities::ProfessionList pl;
+        if (!dataClient.Read(pl))
+        {
+            LOG_ERROR << "Error reading profession list" << std::endl;
+            return false;
+        }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::ItemList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading item list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_items";
-    if (!dataClient->Read(v))
-    {
-        LOG_ERROR << "Error reading items version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
+        for (const AB::Entities::Profession& s : dataClient.ReadMany<AB::Entities::Profession>(pl.profUuids))
+        {
+            auto gNd = root.append_child("prof");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("abbr").set_value(s.abbr.c_str());
+            gNd.append_attribute("model_index_female").set_value(s.modelIndexFemale);
+            gNd.append_attribute("model_index_male").set_value(s.modelIndexMale);
+            gNd.append_attribute("num_attr").set_value(s.attributeCount);
+            for (const AB::Entities::AttriInfo& a : s.attributes)
+            {
+                auto attrNd = gNd.append_child("attr");
+                attrNd.append_attribute("uuid").set_value(a.uuid.c_str());
+            }
+        }
+        return true;
+    });
+}
 
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("items");
-    root.append_attribute("version").set_value(v.value);
+void Application::GetHandlerAttributes(std::shared_ptr<HttpsServer::Response> response,
+    std::shared_ptr<HttpsServer::Request> request)
+{
+    AB_PROFILE;
 
-    for (const std::string& uuid : pl.itemUuids)
+    SendStaticData(response, request, "game_attributes", "attributes",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        AB::Entities::Item s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("item");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("index").set_value(s.index);
-        gNd.append_attribute("model_class").set_value(s.model_class);
-        gNd.append_attribute("name").set_value(s.name.c_str());
-        gNd.append_attribute("type").set_value(static_cast<int>(s.type));
-        gNd.append_attribute("object").set_value(s.objectFile.c_str());
-        gNd.append_attribute("icon").set_value(s.iconFile.c_str());
-        gNd.append_attribute("stack_able").set_value(s.stackAble);
-    }
+        AB::Entities::AttributeList pl;
+        if (!dataClient.Read(pl))
+        {
+            LOG_ERROR << "Error reading attribute list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const AB::Entities::Attribute& s : dataClient.ReadMany<AB::Entities::Attribute>(pl.uuids))
+        {
+            auto gNd = root.append_child("attrib");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("profession").set_value(s.professionUuid.c_str());
+            gNd.append_attribute("primary").set_value(s.isPrimary);
+        }
+        return true;
+    });
 }
 
-void Application::GetHandlerQuests(std::shared_ptr<HttpsServer::Response> response,
+void Application::GetHandlerEffects(std::shared_ptr<HttpsServer::Response> response,
     std::shared_ptr<HttpsServer::Request> request)
 {
     AB_PROFILE;
 
-    if (!IsAllowed(request))
+    SendStaticData(response, request, "game_effects", "effects",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
-        return;
-    }
+        AB::Entities::EffectList pl;
+        if (!dataClient.Read(pl))
+        {
+            LOG_ERROR << "Error reading effect list" << std::endl;
+            return false;
+        }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::QuestList gl;
-    if (!dataClient->Read(gl))
-    {
-        LOG_ERROR << "Error reading game list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
+        for (const AB::Entities::Effect& s : dataClient.ReadMany<AB::Entities::Effect>(pl.effectUuids))
+        {
+            auto gNd = root.append_child("effect");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("category").set_value(s.category);
+            gNd.append_attribute("icon").set_value(s.icon.c_str());
+            gNd.append_attribute("sound_effect").set_value(s.soundEffect.c_str());
+            gNd.append_attribute("particle_effect").set_value(s.particleEffect.c_str());
+        }
+        return true;
+    });
+}
 
-    AB::Entities::Version gamesVersion;
-    gamesVersion.name = "game_quests";
-    if (!dataClient->Read(gamesVersion))
-    {
-        LOG_ERROR << "Error reading game version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("quests");
-    root.append_attribute("version").set_value(gamesVersion.value);
+void Application::GetHandlerItems(std::shared_ptr<HttpsServer::Response> response,
+    std::shared_ptr<HttpsServer::Request> request)
+{
+    AB_PROFILE;
 
-    for (const std::string& uuid : gl.questUuids)
+    SendStaticData(response, request, "game_items", "items",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        AB::Entities::Quest g;
-        g.uuid = uuid;
-        if (!dataClient->Read(g))
-            continue;
-        auto gNd = root.append_child("game");
-        gNd.append_attribute("uuid").set_value(g.uuid.c_str());
-        gNd.append_attribute("index").set_value(g.index);
-        gNd.append_attribute("name").set_value(g.name.c_str());
-        gNd.append_attribute("description").set_value(g.description.c_str());
-        gNd.append_attribute("reward_xp").set_value(g.rewardXp);
-        gNd.append_attribute("reward_money").set_value(g.rewardMoney);
-        gNd.append_attribute("reward_items").set_value(sa::CombineString(g.rewardItems, std::string(";")).c_str());
-    }
+        AB::Entities::ItemList pl;
+        if (!dataClient.Read(pl))
+        {
+            LOG_ERROR << "Error reading item list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const AB::Entities::Item& s : dataClient.ReadMany<AB::Entities::Item>(pl.itemUuids))
+        {
+            auto gNd = root.append_child("item");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("index").set_value(s.index);
+            gNd.append_attribute("model_class").set_value(s.model_class);
+            gNd.append_attribute("name").set_value(s.name.c_str());
+            gNd.append_attribute("type").set_value(static_cast<int>(s.type));
+            gNd.append_attribute("object").set_value(s.objectFile.c_str());
+            gNd.append_attribute("icon").set_value(s.iconFile.c_str());
+            gNd.append_attribute("stack_able").set_value(s.stackAble);
+        }
+        return true;
+    });
 }
 
-void Application::GetHandlerMusic(std::shared_ptr<HttpsServer::Response> response,
+void Application::GetHandlerQuests(std::shared_ptr<HttpsServer::Response> response,
     std::shared_ptr<HttpsServer::Request> request)
 {
     AB_PROFILE;
 
-    if (!IsAllowed(request))
+    SendStaticData(response, request, "game_quests", "quests",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        response->write(SimpleWeb::StatusCode::client_error_forbidden,
-            "Forbidden");
-        return;
-    }
+        AB::Entities::QuestList gl;
+        if (!dataClient.Read(gl))
+        {
+            LOG_ERROR << "Error reading quest list" << std::endl;
+            return false;
+        }
 
-    auto* dataClient = GetSubsystem<IO::DataClient>();
-    AB::Entities::MusicList pl;
-    if (!dataClient->Read(pl))
-    {
-        LOG_ERROR << "Error reading music list" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
-    AB::Entities::Version v;
-    v.name = "game_music";
-    if (!dataClient->Read(v))
-    {
-        LOG_ERROR << "Error reading music version" << std::endl;
-        response->write(SimpleWeb::StatusCode::client_error_not_found, "Not found");
-        return;
-    }
+        for (const AB::Entities::Quest& g : dataClient.ReadMany<AB::Entities::Quest>(gl.questUuids))
+        {
+            auto gNd = root.append_child("game");
+            gNd.append_attribute("uuid").set_value(g.uuid.c_str());
+            gNd.append_attribute("index").set_value(g.index);
+            gNd.append_attribute("name").set_value(g.name.c_str());
+            gNd.append_attribute("description").set_value(g.description.c_str());
+            gNd.append_attribute("reward_xp").set_value(g.rewardXp);
+            gNd.append_attribute("reward_money").set_value(g.rewardMoney);
+            gNd.append_attribute("reward_items").set_value(sa::CombineString(g.rewardItems, std::string(";")).c_str());
+        }
+        return true;
+    });
+}
 
-    pugi::xml_document doc;
-    auto declarationNode = doc.append_child(pugi::node_declaration);
-    declarationNode.append_attribute("version").set_value("1.0");
-    declarationNode.append_attribute("encoding").set_value("UTF-8");
-    declarationNode.append_attribute("standalone").set_value("yes");
-    auto root = doc.append_child("music_list");
-    root.append_attribute("version").set_value(v.value);
+void Application::GetHandlerMusic(std::shared_ptr<HttpsServer::Response> response,
+    std::shared_ptr<HttpsServer::Request> request)
+{
+    AB_PROFILE;
 
-    for (const std::string& uuid : pl.musicUuids)
+    SendStaticData(response, request, "game_music", "music_list",
+        [](IO::DataClient& dataClient, pugi::xml_node& root) -> bool
     {
-        AB::Entities::Music s;
-        s.uuid = uuid;
-        if (!dataClient->Read(s))
-            continue;
-        auto gNd = root.append_child("music");
-        gNd.append_attribute("uuid").set_value(s.uuid.c_str());
-        gNd.append_attribute("map_uuid").set_value(s.mapUuid.c_str());
-        gNd.append_attribute("local_file").set_value(s.localFile.c_str());
-        gNd.append_attribute("remote_file").set_value(s.remoteFile.c_str());
-        gNd.append_attribute("sorting").set_value(s.sorting);
-        gNd.append_attribute("style").set_value(static_cast<uint32_t>(s.style));
-    }
+        AB::Entities::MusicList pl;
+        if (!dataClient.Read(pl))
+        {
+            LOG_ERROR << "Error reading music list" << std::endl;
+            return false;
+        }
 
-    std::stringstream stream;
-    doc.save(stream);
-    SimpleWeb::CaseInsensitiveMultimap header = GetDefaultHeader();
-    header.emplace("Content-Type", "text/xml");
-    UpdateBytesSent(stream_size(stream));
-    response->write(stream, header);
+        for (const AB::Entities::Music& s : dataClient.ReadMany<AB::Entities::Music>(pl.musicUuids))
+        {
+            auto gNd = root.append_child("music");
+            gNd.append_attribute("uuid").set_value(s.uuid.c_str());
+            gNd.append_attribute("map_uuid").set_value(s.mapUuid.c_str());
+            gNd.append_attribute("local_file").set_value(s.localFile.c_str());
+            gNd.append_attribute("remote_file").set_value(s.remoteFile.c_str());
+            gNd.append_attribute("sorting").set_value(s.sorting);
+            gNd.append_attribute("style").set_value(static_cast<uint32_t>(s.style));
+        }
+        return true;
+    });
 }
 
 void Application::GetHandlerVersion(std::shared_ptr<HttpsServer::Response> response,
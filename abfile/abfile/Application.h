@@ -35,7 +35,12 @@
 #include <abscommon/MessageClient.h>
 #include "Servers.h"
 #include <numeric>
+#include <map>
+#include <unordered_map>
+#include <fstream>
 #include <sa/CircularQueue.h>
+#include <sa/TokenBucket.h>
+#include "FileCache.h"
 
 #if __cplusplus < 201703L
 // C++14
@@ -50,6 +55,11 @@ using HttpsServer = SimpleWeb::Server<SimpleWeb::HTTPS>;
 namespace IO {
 class DataClient;
 }
+namespace AB {
+namespace Entities {
+struct Version;
+}
+}
 
 template<typename T>
 inline size_t stream_size(T& s)
@@ -78,10 +88,60 @@ private:
     uint16_t dataPort_;
     /// Byte/sec
     uint64_t maxThroughput_;
+    /// Byte/sec for each client, 0 = unlimited
+    uint64_t maxClientThroughput_;
+    /// Shapes the traffic of all downloads to maxThroughput_
+    sa::TokenBucket<> throughput_;
+    /// IP -> Bucket shared by all downloads of this client
+    std::unordered_map<uint32_t, std::weak_ptr<sa::TokenBucket<>>> clientThroughput_;
+    std::mutex throughputLock_;
+    std::unique_ptr<FileCache> fileCache_;
+    struct Download
+    {
+        std::shared_ptr<HttpsServer::Response> response;
+        /// Content of cached files
+        std::shared_ptr<const std::string> data;
+        /// Files which are not cached are read from the stream
+        std::unique_ptr<std::ifstream> stream;
+        std::vector<char> buffer;
+        uint64_t pos{ 0 };
+        uint64_t end{ 0 };
+        std::shared_ptr<sa::TokenBucket<>> clientThroughput;
+    };
     sa::CircularQueue<unsigned, 10> loads_;
     std::mutex mutex_;
+    /// Rendered response of some static game data, it is valid as long as the version does not change.
+    struct StaticResponse
+    {
+        uint32_t version{ 0 };
+        std::string etag;
+        /// ETag of the gzip encoded content
+        std::string gzipEtag;
+        std::string content;
+        std::string gzipContent;
+    };
+    struct StaticResource
+    {
+        std::mutex lock;
+        std::shared_ptr<const StaticResponse> response;
+    };
+    /// Adds the data to the root node
+    using RenderFunction = std::function<bool(IO::DataClient& dataClient, pugi::xml_node& root)>;
+    /// Version name -> Resource
+    std::map<std::string, std::unique_ptr<StaticResource>> staticResources_;
+    std::mutex staticMutex_;
+    std::shared_ptr<const StaticResponse> GetStaticResponse(const AB::Entities::Version& version,
+        const char* rootName, const RenderFunction& render);
+    /// Sends the response from the cache, renders it when the version changed.
+    void SendStaticData(std::shared_ptr<HttpsServer::Response> response,
+        std::shared_ptr<HttpsServer::Request> request,
+        const std::string& versionName, const char* rootName, const RenderFunction& render);
     void HandleMessage(const Net::MessageMsg& msg);
     void UpdateBytesSent(size_t bytes);
+    std::shared_ptr<sa::TokenBucket<>> GetClientThroughput(uint32_t ip);
+    /// Returns how long to wait before sending the next chunk
+    std::chrono::milliseconds Throttle(Download& download, size_t bytes);
+    void SendFileChunk(std::shared_ptr<Download> download);
     void HeartBeatTask();
     bool IsAllowed(std::shared_ptr<HttpsServer::Request> request);
     static SimpleWeb::CaseInsensitiveMultimap GetDefaultHeader();
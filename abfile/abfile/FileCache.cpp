@@ -0,0 +1,127 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include "FileCache.h"
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+FileCache::FileCache(size_t maxSize) :
+    maxSize_(maxSize),
+    // Don't let one file evict most others
+    maxFileSize_(maxSize / 8)
+{ }
+
+void FileCache::Remove(std::list<Entry>::iterator it)
+{
+    size_ -= it->data->size();
+    index_.erase(it->path);
+    entries_.erase(it);
+}
+
+bool FileCache::Admit(const std::string& path)
+{
+    // Caller holds the lock
+    const int64_t tick = Utils::Tick();
+    const auto it = history_.find(path);
+    if (it != history_.end())
+    {
+        const bool result = tick - it->second <= ADMIT_WINDOW_MS;
+        if (result)
+            history_.erase(it);
+        else
+            it->second = tick;
+        return result;
+    }
+    if (history_.size() >= MAX_HISTORY)
+    {
+        for (auto hit = history_.begin(); hit != history_.end(); )
+        {
+            if (tick - hit->second > ADMIT_WINDOW_MS)
+                hit = history_.erase(hit);
+            else
+                ++hit;
+        }
+        // Still full, forget all
+        if (history_.size() >= MAX_HISTORY)
+            history_.clear();
+    }
+    history_.emplace(path, tick);
+    return false;
+}
+
+void FileCache::Add(const std::string& path, fs::file_time_type time, std::shared_ptr<const std::string> data)
+{
+    std::scoped_lock lock(lock_);
+    const auto it = index_.find(path);
+    if (it != index_.end())
+        Remove(it->second);
+    while (!entries_.empty() && size_ + data->size() > maxSize_)
+        Remove(std::prev(entries_.end()));
+
+    size_ += data->size();
+    entries_.push_front({ path, time, std::move(data) });
+    index_.emplace(path, entries_.begin());
+}
+
+std::shared_ptr<const std::string> FileCache::Get(const fs::path& path)
+{
+    if (maxSize_ == 0)
+        return std::shared_ptr<const std::string>();
+
+    std::error_code ec;
+    const auto time = fs::last_write_time(path, ec);
+    if (ec)
+        return std::shared_ptr<const std::string>();
+    const uintmax_t size = fs::file_size(path, ec);
+    if (ec || size > maxFileSize_)
+        return std::shared_ptr<const std::string>();
+
+    const std::string key = path.string();
+    {
+        std::scoped_lock lock(lock_);
+        const auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            if (it->second->time == time && it->second->data->size() == size)
+            {
+                entries_.splice(entries_.begin(), entries_, it->second);
+                return it->second->data;
+            }
+            // Changed, it was popular so read it again
+            Remove(it->second);
+        }
+        else if (!Admit(key))
+            return std::shared_ptr<const std::string>();
+    }
+
+    // Read it without holding the lock, so other files can be served meanwhile
+    std::ifstream ifs(key, std::ios::in | std::ios::binary);
+    if (!ifs)
+        return std::shared_ptr<const std::string>();
+    auto data = std::make_shared<std::string>(static_cast<size_t>(size), '\0');
+    if (!ifs.read(data->data(), static_cast<std::streamsize>(size)))
+        return std::shared_ptr<const std::string>();
+
+    Add(key, time, data);
+    return data;
+}
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <filesystem>
+
+/// Keeps the content of small, frequently requested files in memory. A file is
+/// admitted when it is requested the second time within ADMIT_WINDOW_MS, so files
+/// requested only once don't evict the popular ones. When it's full the least
+/// recently used files are evicted. Files which changed since they were cached are
+/// read again.
+class FileCache
+{
+public:
+    static constexpr int64_t ADMIT_WINDOW_MS = 1000 * 60 * 10;
+    /// Max. number of requested files which are not cached to remember
+    static constexpr size_t MAX_HISTORY = 4096;
+private:
+    struct Entry
+    {
+        std::string path;
+        std::filesystem::file_time_type time;
+        std::shared_ptr<const std::string> data;
+    };
+    /// Most recently used first
+    std::list<Entry> entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    /// Files not in the cache -> Tick of the last request
+    std::unordered_map<std::string, int64_t> history_;
+    std::mutex lock_;
+    size_t maxSize_;
+    size_t maxFileSize_;
+    size_t size_{ 0 };
+    void Add(const std::string& path, std::filesystem::file_time_type time, std::shared_ptr<const std::string> data);
+    void Remove(std::list<Entry>::iterator it);
+    /// Remember the request of a file which is not cached. Returns true if it was
+    /// requested before within the window.
+    bool Admit(const std::string& path);
+public:
+    /// maxSize: Max. size of all files in Byte, 0 to disable the cache.
+    explicit FileCache(size_t maxSize);
+    /// Returns the content of the file, or nullptr when the file is too big for the cache or can not be read.
+    std::shared_ptr<const std::string> Get(const std::filesystem::path& path);
+    size_t GetMaxSize() const { return maxSize_; }
+};
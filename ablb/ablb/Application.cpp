@@ -40,7 +40,7 @@ Application::Application() :
     serverType_ = AB::Entities::ServiceTypeLoadBalancer;
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
     Subsystems::Instance.CreateSubsystem<Auth::BanManager>();
-    dataClient_ = std::make_unique<IO::DataClient>(ioService_);
+    dataClient_ = std::make_unique<IO::DataClient>();
 }
 
 Application::~Application() = default;
@@ -60,7 +60,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
     Subsystems::Instance.CreateSubsystem<Net::ConnectionManager>();
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
-    Subsystems::Instance.CreateSubsystem<IO::DataClient>(ioService_);
+    Subsystems::Instance.CreateSubsystem<IO::DataClient>();
     Subsystems::Instance.CreateSubsystem<Net::MessageClient>(ioService_);
     Subsystems::Instance.CreateSubsystem<Auth::BanManager>();
     Subsystems::Instance.CreateSubsystem<Crypto::Random>();
@@ -45,11 +45,9 @@ std::string IOGame::GetLandingGameUuid()
         return Utils::Uuid::EMPTY_UUID;
     }
 
-    for (const std::string& uuid : gl.gameUuids)
+    for (const AB::Entities::Game& g : client->ReadMany<AB::Entities::Game>(gl.gameUuids))
     {
-        AB::Entities::Game g;
-        g.uuid = uuid;
-        if (client->Read(g) && g.landing)
+        if (g.landing)
             return g.uuid;
     }
     LOG_ERROR << "No landing game found" << std::endl;
@@ -81,12 +79,8 @@ std::vector<AB::Entities::Game> IOGame::GetGameList(const std::set<AB::Entities:
         return result;
     }
 
-    for (const std::string& uuid : gl.gameUuids)
+    for (const AB::Entities::Game& g : client->ReadMany<AB::Entities::Game>(gl.gameUuids))
     {
-        AB::Entities::Game g;
-        g.uuid = uuid;
-        if (!client->Read(g))
-            continue;
         if (types.empty() || types.find(g.type) != types.end())
             result.push_back(g);
     }
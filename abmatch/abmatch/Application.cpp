@@ -43,7 +43,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
     Subsystems::Instance.CreateSubsystem<MatchQueues>();
-    Subsystems::Instance.CreateSubsystem<IO::DataClient>(ioService_);
+    Subsystems::Instance.CreateSubsystem<IO::DataClient>();
     Subsystems::Instance.CreateSubsystem<Net::MessageClient>(ioService_);
 }
 
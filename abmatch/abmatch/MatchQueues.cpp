@@ -31,8 +31,24 @@ void MatchQueues::Add(const std::string& mapUuid, const std::string& playerUuid)
         LOG_ERROR << "Unable to get queue for game " << mapUuid << std::endl;
         return;
     }
-    queue->Add(playerUuid);
     players_.emplace(playerUuid, mapUuid);
+    if (!queue->IsRandomParty())
+    {
+        queue->Add(playerUuid, AB::Entities::ProfessionPosition::None);
+        return;
+    }
+    // Random teams are balanced by profession. Don't block while reading it.
+    Queue::GetPlayerPosition(playerUuid, [this, mapUuid, playerUuid](AB::Entities::ProfessionPosition position)
+    {
+        std::scoped_lock lock(lock_);
+        const auto it = players_.find(playerUuid);
+        // Removed from the queue in the meantime
+        if (it == players_.end() || it->second != mapUuid)
+            return;
+        Queue* queue = GetQueue(mapUuid);
+        if (queue)
+            queue->Add(playerUuid, position);
+    });
 }
 
 void MatchQueues::Remove(const std::string& playerUuid)
@@ -25,31 +25,47 @@
 #include <AB/Entities/Character.h>
 #include <AB/Entities/Game.h>
 #include <abscommon/DataClient.h>
+#include <abscommon/Dispatcher.h>
 #include <abscommon/MessageClient.h>
 #include <abscommon/Subsystems.h>
 #include <abscommon/UuidUtils.h>
 #include <algorithm>
 #include <sa/Transaction.h>
 
-AB::Entities::ProfessionPosition Queue::GetPlayerPosition(const std::string& uuid)
+void Queue::GetPlayerPosition(const std::string& uuid, std::function<void(AB::Entities::ProfessionPosition position)>&& callback)
 {
     auto* dataclient = GetSubsystem<IO::DataClient>();
     AB::Entities::Character c;
     c.uuid = uuid;
-    if (!dataclient->Read(c))
+    // The profession is requested from the network thread, only the result goes to the Dispatcher
+    dataclient->ReadAsync(c, [dataclient, callback = std::move(callback)](bool success, AB::Entities::Character& character) mutable
     {
-        LOG_ERROR << "Error reading character " << uuid << std::endl;
-        return AB::Entities::ProfessionPosition::None;
-    }
-    AB::Entities::Profession prof;
-    prof.uuid = c.professionUuid;
-    if (!dataclient->Read(prof))
-    {
-        LOG_ERROR << "Error reading profession " << c.professionUuid << std::endl;
-        return AB::Entities::ProfessionPosition::None;
-    }
-
-    return prof.position;
+        auto dispatch = [](std::function<void(void)>&& function)
+        {
+            GetSubsystem<Asynch::Dispatcher>()->Add(Asynch::CreateTask(std::move(function)));
+        };
+        if (!success)
+        {
+            LOG_ERROR << "Error reading character " << character.uuid << std::endl;
+            dispatch([callback = std::move(callback)]()
+            {
+                callback(AB::Entities::ProfessionPosition::None);
+            });
+            return;
+        }
+        AB::Entities::Profession prof;
+        prof.uuid = character.professionUuid;
+        dataclient->ReadAsync(prof, [callback = std::move(callback)](bool success, AB::Entities::Profession& profession)
+        {
+            if (!success)
+            {
+                LOG_ERROR << "Error reading profession " << profession.uuid << std::endl;
+                callback(AB::Entities::ProfessionPosition::None);
+                return;
+            }
+            callback(profession.position);
+        }, dispatch);
+    });
 }
 
 std::string Queue::FindServerForMatch(const MatchTeams& teams)
@@ -123,12 +139,9 @@ bool Queue::Load()
     return true;
 }
 
-void Queue::Add(const std::string& uuid)
+void Queue::Add(const std::string& uuid, AB::Entities::ProfessionPosition position)
 {
-    entries_.push_back({
-       uuid,
-       randomParty_ ? GetPlayerPosition(uuid) : AB::Entities::ProfessionPosition::None
-   });
+    entries_.push_back({ uuid, position });
 
     auto* client = GetSubsystem<Net::MessageClient>();
     Net::MessageMsg msg;
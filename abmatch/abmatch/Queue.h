@@ -44,7 +44,6 @@ typedef std::vector<Team> MatchTeams;
 class Queue
 {
 private:
-    static AB::Entities::ProfessionPosition GetPlayerPosition(const std::string& uuid);
     static std::string FindServerForMatch(const MatchTeams& teams);
     std::string uuid_;
     std::string mapUuid_;
@@ -64,9 +63,13 @@ private:
     std::optional<QueueEntry> GetPlayerByPos(AB::Entities::ProfessionPosition pos);
     bool SendEnterMessage(const MatchTeams& teams);
 public:
+    /// Calls the callback on the Dispatcher thread with the position of the players profession
+    static void GetPlayerPosition(const std::string& uuid, std::function<void(AB::Entities::ProfessionPosition position)>&& callback);
+
     explicit Queue(const std::string& mapUuid);
     bool Load();
-    void Add(const std::string& uuid);
+    bool IsRandomParty() const { return randomParty_; }
+    void Add(const std::string& uuid, AB::Entities::ProfessionPosition position);
     void Remove(const std::string& uuid);
 
     size_t Count() const { return entries_.size(); }
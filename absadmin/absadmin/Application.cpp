@@ -69,7 +69,7 @@ Application::Application() :
     ioService_ = std::make_shared<asio::io_service>();
     Subsystems::Instance.CreateSubsystem<IO::SimpleConfigManager>();
     Subsystems::Instance.CreateSubsystem<HTTP::Sessions>();
-    Subsystems::Instance.CreateSubsystem<IO::DataClient>(*ioService_);
+    Subsystems::Instance.CreateSubsystem<IO::DataClient>();
     Subsystems::Instance.CreateSubsystem<Auth::BanManager>();
     Subsystems::Instance.CreateSubsystem<ContentTypes>();
     Subsystems::Instance.CreateSubsystem<Net::MessageClient>(*ioService_);
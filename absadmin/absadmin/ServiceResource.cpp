@@ -68,6 +68,7 @@ bool ServiceResource::GetObjects(std::map<std::string, ginger::object>& objects)
     ss << ts.hours << "h " << ts.minutes << "m " << ts.seconds << "s";
 
     objects["uptime"] = Utils::XML::Escape(ss.str());
+    objects["stats"] = Utils::XML::Escape(s.stats);
 
     return true;
 }
@@ -65,6 +65,7 @@ void ServicesJsonResource::Render(std::shared_ptr<HttpsServer::Response> respons
         serv["path"] = s.path;
         serv["port"] = s.port;
         serv["run_time"] = static_cast<long>(s.runTime);
+        serv["stats"] = s.stats;
         serv["status"] = static_cast<int>(s.status);
         serv["online"] = s.status == AB::Entities::ServiceStatusOnline;
         serv["type"] = static_cast<int>(s.type);
@@ -21,97 +21,98 @@
 
 #include "stdafx.h"
 #include "DataClient.h"
+#include "Logger.h"
 #include <chrono>
-#include <thread>
+#include <future>
 
 namespace IO {
 
-DataClient::DataClient(asio::io_service& io_service) :
-    socket_(io_service),
-    resolver_(io_service)
+// Must be at least the maximum data size of the data server
+static constexpr size_t MAX_RESPONSE_SIZE = 1024 * 1024 * 16;
+
+DataClient::DataClient() :
+    work_(std::make_unique<asio::io_service::work>(ioService_)),
+    socket_(ioService_),
+    resolver_(ioService_),
+    reconnectTimer_(ioService_)
 {
+    thread_ = std::thread([this]() { ioService_.run(); });
 }
 
 DataClient::~DataClient()
 {
+    {
+        std::scoped_lock lock(shutdownLock_);
+        shutdown_ = true;
+    }
+    // Everyone waiting for a response gets a failure. Requests posted before are
+    // handled before the thread exits, because the service is not stopped.
+    ioService_.post(std::bind(&DataClient::Shutdown, this));
+    work_.reset();
+    if (thread_.joinable())
+        thread_.join();
     socket_.close();
 }
 
 void DataClient::Connect(const std::string& host, uint16_t port)
 {
-    host_ = host;
-    port_ = port;
-    // First time connect, try longer other servers may not be up yet.
-    TryConnect(false, 100);
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    ioService_.post([this, &promise, host, port]()
+    {
+        host_ = host;
+        port_ = port;
+        onConnected_ = [&promise]() { promise.set_value(); };
+        // First time connect, try longer other servers may not be up yet.
+        Reconnect(100);
+    });
+    future.wait();
 }
 
-bool DataClient::MakeRequest(OpCodes opCode, const DataKey& key, DataBuff& data)
+void DataClient::AsyncRequest(OpCodes opCode, const DataKey& key, DataBuff&& data,
+    Completion&& completion, Executor&& executor)
 {
-    const uint8_t ksize1 = static_cast<uint8_t>(key.size());
-    const uint8_t ksize2 = static_cast<uint8_t>(key.size() >> 8);
-    const uint8_t header[] = { static_cast<uint8_t>(opCode), ksize1, ksize2 };
-    // All data must be sent at once. Multiple threads must not send different requests at the same time.
-    std::scoped_lock lock(lock_);
-    if (!TryWrite(asio::buffer(header)))
-        return false;
-
-    if (!TryWrite(asio::buffer(key.data_)))
-        return false;
-
-    const uint8_t dsize4 = static_cast<uint8_t>(data.size() >> 24);
-    const uint8_t dsize3 = static_cast<uint8_t>(data.size() >> 16);
-    const uint8_t dsize2 = static_cast<uint8_t>(data.size() >> 8);
-    const uint8_t dsize1 = static_cast<uint8_t>(data.size());
-
-    const uint8_t data_header[] = { dsize1, dsize2, dsize3, dsize4 };
-    if (!TryWrite(asio::buffer(data_header)))
-        return false;
-
-    if (!TryWrite(asio::buffer(data)))
-        return false;
-
-    std::vector<uint8_t> dataheader(5);
-    /* size_t read = */ asio::read(socket_, asio::buffer(dataheader, 5), asio::transfer_at_least(5));
-    if (static_cast<OpCodes>(dataheader[0]) == OpCodes::Status)
+    auto request = std::make_shared<Request>();
+    request->opCode = opCode;
+    request->key = key;
+    request->data = std::move(data);
+    request->completion = std::move(completion);
+    request->executor = std::move(executor);
     {
-        // Does not return data
-        uint8_t result[128];
-        // Read the rest of the status
-        socket_.read_some(asio::buffer(result));
-        return dataheader[1] == static_cast<unsigned char>(ErrorCodes::Ok);
+        std::scoped_lock lock(shutdownLock_);
+        if (!shutdown_)
+        {
+            ioService_.post(std::bind(&DataClient::Enqueue, this, std::move(request)));
+            return;
+        }
     }
+    // Not while holding the lock, the completion may make another request
+    DataBuff empty;
+    Complete(*request, false, empty);
+}
 
-    // If we are here it returns data
-    const size_t size = static_cast<size_t>(ToInt32(dataheader, 1));
-    data.resize(size);
-    const size_t read2 = asio::read(socket_, asio::buffer(data), asio::transfer_at_least(size));
-    if (read2 != size)
+bool DataClient::MakeRequest(OpCodes opCode, const DataKey& key, DataBuff& data)
+{
+    if (IsNetworkThread())
+    {
+        LOG_ERROR << "Blocking request from the network thread" << std::endl;
         return false;
-
-    return true;
+    }
+    std::promise<bool> promise;
+    auto future = promise.get_future();
+    // We wait for it, so it's safe to capture by reference
+    AsyncRequest(opCode, key, std::move(data), [&promise, &data](bool success, DataBuff& result)
+    {
+        data = std::move(result);
+        promise.set_value(success);
+    }, {});
+    return future.get();
 }
 
 bool DataClient::MakeRequestNoData(OpCodes opCode, const DataKey& key)
 {
-    const uint8_t ksize1 = static_cast<uint8_t>(key.size());
-    const uint8_t ksize2 = static_cast<uint8_t>(key.size() >> 8);
-    const uint8_t header[] = { static_cast<uint8_t>(opCode), ksize1, ksize2 };
-    // All data must be sent at once. Multiple threads must not send different requests at the same time.
-    std::scoped_lock lock(lock_);
-    if (!TryWrite(asio::buffer(header)))
-        return false;
-
-    if (!TryWrite(asio::buffer(key.data_)))
-        return false;
-
-    uint8_t result[128];
-    const size_t read = socket_.read_some(asio::buffer(result));
-    if (read < 2)
-        return false;
-
-    if (static_cast<OpCodes>(result[0]) == OpCodes::Status && static_cast<ErrorCodes>(result[1]) == ErrorCodes::Ok)
-        return true;
-    return false;
+    DataBuff data;
+    return MakeRequest(opCode, key, data);
 }
 
 bool DataClient::ReadData(const DataKey& key, DataBuff& data)
@@ -159,39 +160,281 @@ bool DataClient::Clear()
 
 void DataClient::InternalConnect()
 {
-    if (connected_)
+    if (connected_ || host_.empty())
         return;
 
     const asio::ip::tcp::resolver::query query(asio::ip::tcp::v4(), host_, std::to_string(port_));
-    asio::ip::tcp::resolver::iterator endpoint = resolver_.resolve(query);
     asio::error_code error;
+    asio::ip::tcp::resolver::iterator endpoint = resolver_.resolve(query, error);
+    if (error)
+        return;
     socket_.connect(*endpoint, error);
-    if (!error)
-        connected_ = true;
+    if (error)
+    {
+        socket_.close(error);
+        return;
+    }
+    connected_ = true;
+    ++connectionId_;
+    StartRead();
 }
 
-bool DataClient::TryConnect(bool force, unsigned numTries /* = 10 */)
+void DataClient::Reconnect(unsigned numTries /* = 10 */)
 {
-    if (force)
+    if (reconnecting_)
     {
-        connected_ = false;
-        socket_.close();
+        reconnectTries_ = std::max(reconnectTries_, numTries);
+        return;
     }
-    // By default try for 1 second, 10 tries
-    unsigned tries = 0;
-    while (!connected_ && tries < numTries)
+    reconnecting_ = true;
+    reconnectTries_ = numTries;
+    TryReconnect();
+}
+
+void DataClient::TryReconnect()
+{
+    InternalConnect();
+    if (connected_ || shutdown_ || --reconnectTries_ == 0)
+    {
+        ReconnectDone();
+        return;
+    }
+    reconnectTimer_.expires_from_now(std::chrono::milliseconds(100));
+    reconnectTimer_.async_wait([this](const asio::error_code& error)
+    {
+        // Cancelled by Shutdown()
+        if (error)
+            return;
+        TryReconnect();
+    });
+}
+
+void DataClient::ReconnectDone()
+{
+    reconnecting_ = false;
+    auto waiting = std::move(connectQueue_);
+    connectQueue_.clear();
+    DataBuff empty;
+    for (auto& request : waiting)
     {
-        ++tries;
-        InternalConnect();
         if (connected_)
-            return true;
-        if (tries >= 10)
-            return false;
+            Send(std::move(request));
+        else
+            Complete(*request, false, empty);
+    }
+    if (onConnected_)
+    {
+        auto onConnected = std::move(onConnected_);
+        onConnected_ = {};
+        onConnected();
+    }
+}
+
+void DataClient::Close()
+{
+    if (!connected_)
+        return;
+    connected_ = false;
+    // Pending handlers of this connection are ignored
+    ++connectionId_;
+    asio::error_code error;
+    socket_.shutdown(asio::ip::tcp::socket::shutdown_both, error);
+    socket_.close(error);
+}
 
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(100ms);
+void DataClient::Enqueue(std::shared_ptr<Request> request)
+{
+    if (shutdown_)
+    {
+        DataBuff empty;
+        Complete(*request, false, empty);
+        return;
+    }
+    if (!connected_)
+    {
+        connectQueue_.push_back(std::move(request));
+        Reconnect();
+        return;
+    }
+    Send(std::move(request));
+}
+
+void DataClient::Send(std::shared_ptr<Request> request)
+{
+    // 0 is never used
+    if (++nextRequestId_ == 0)
+        ++nextRequestId_;
+    request->id = nextRequestId_;
+    request->header[0] = static_cast<uint8_t>(request->opCode);
+    FromInt32(request->id, &request->header[1]);
+    request->header[5] = static_cast<uint8_t>(request->key.size());
+    request->header[6] = static_cast<uint8_t>(request->key.size() >> 8);
+    FromInt32(static_cast<uint32_t>(request->data.size()), request->dataHeader.data());
+
+    pending_.emplace(request->id, request);
+    const bool writing = !writeQueue_.empty();
+    writeQueue_.push_back(std::move(request));
+    if (!writing)
+        StartWrite();
+}
+
+void DataClient::StartWrite()
+{
+    const Request& request = *writeQueue_.front();
+    // All data of a request is sent at once
+    const std::array<asio::const_buffer, 4> buffers = {
+        asio::buffer(request.header),
+        asio::buffer(request.key.data_),
+        asio::buffer(request.dataHeader),
+        asio::buffer(request.data)
+    };
+    asio::async_write(socket_, buffers,
+        [this, connectionId = connectionId_](const asio::error_code& error, size_t)
+    {
+        if (connectionId != connectionId_)
+            return;
+        if (error)
+        {
+            HandleError(error);
+            return;
+        }
+        writeQueue_.pop_front();
+        if (!writeQueue_.empty())
+            StartWrite();
+    });
+}
+
+void DataClient::StartRead()
+{
+    asio::async_read(socket_, asio::buffer(responseHeader_),
+        [this, connectionId = connectionId_](const asio::error_code& error, size_t)
+    {
+        if (connectionId != connectionId_)
+            return;
+        if (error)
+        {
+            HandleError(error);
+            return;
+        }
+        const size_t size = static_cast<size_t>(ToInt32(&responseHeader_[6]));
+        if (size > MAX_RESPONSE_SIZE)
+        {
+            HandleError(asio::error::message_size);
+            return;
+        }
+        responseData_.resize(size);
+        if (size == 0)
+        {
+            HandleResponse();
+            StartRead();
+            return;
+        }
+        asio::async_read(socket_, asio::buffer(responseData_),
+            [this, connectionId](const asio::error_code& error, size_t)
+        {
+            if (connectionId != connectionId_)
+                return;
+            if (error)
+            {
+                HandleError(error);
+                return;
+            }
+            HandleResponse();
+            StartRead();
+        });
+    });
+}
+
+void DataClient::HandleResponse()
+{
+    const OpCodes opCode = static_cast<OpCodes>(responseHeader_[0]);
+    const uint32_t id = ToInt32(&responseHeader_[1]);
+    const ErrorCodes code = static_cast<ErrorCodes>(responseHeader_[5]);
+    auto it = pending_.find(id);
+    if (it == pending_.end())
+    {
+        LOG_WARNING << "Response for unknown request " << id << std::endl;
+        return;
+    }
+    auto request = std::move(it->second);
+    pending_.erase(it);
+
+    if (opCode == OpCodes::Data)
+    {
+        Complete(*request, true, responseData_);
+        return;
     }
-    return connected_;
+    // Status responses contain a message instead of data
+    DataBuff empty;
+    Complete(*request, opCode == OpCodes::Status && code == ErrorCodes::Ok, empty);
+}
+
+void DataClient::HandleError(const asio::error_code& error)
+{
+    LOG_ERROR << "Network (" << error.default_error_condition().value() << ") " <<
+        error.default_error_condition().message() << std::endl;
+    Close();
+
+    // Requests which were sent may or may not have been executed, they fail. This includes
+    // the first one in the write queue, which was being written and may have reached the
+    // server. The others are sent again once over a new connection, like it happens when
+    // the server restarted.
+    std::deque<std::shared_ptr<Request>> unsent;
+    unsent.swap(writeQueue_);
+    if (!unsent.empty())
+        unsent.pop_front();
+    for (const auto& request : unsent)
+        pending_.erase(request->id);
+    FailPending();
+
+    DataBuff empty;
+    for (auto& request : unsent)
+    {
+        if (request->retried)
+        {
+            Complete(*request, false, empty);
+            continue;
+        }
+        request->retried = true;
+        // Waits for the new connection
+        Enqueue(std::move(request));
+    }
+}
+
+void DataClient::FailPending()
+{
+    auto pending = std::move(pending_);
+    pending_.clear();
+    DataBuff empty;
+    for (auto& request : pending)
+        Complete(*request.second, false, empty);
+}
+
+void DataClient::Shutdown()
+{
+    Close();
+    asio::error_code error;
+    reconnectTimer_.cancel(error);
+    // Fails the requests waiting for the connection
+    ReconnectDone();
+    // Every request in the write queue is also pending
+    writeQueue_.clear();
+    FailPending();
+}
+
+void DataClient::Complete(Request& request, bool success, DataBuff& data)
+{
+    if (!request.completion)
+        return;
+    if (!request.executor)
+    {
+        request.completion(success, data);
+        return;
+    }
+    request.executor([completion = std::move(request.completion), success, data = std::move(data)]() mutable
+    {
+        completion(success, data);
+    });
 }
 
 }
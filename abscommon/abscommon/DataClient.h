@@ -34,19 +34,76 @@ PRAGMA_WARNING_POP
 #include <uuid.h>
 #include "DataKey.h"
 #include "DataCodes.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <asio.hpp>
 
 namespace IO {
 
 using DataBuff = std::vector<uint8_t>;
 
+/// Client of the data server. Requests are pipelined on one connection, i.e. many
+/// requests can be in flight and a slow request does not block the others. The
+/// connection is served by an own thread. The blocking methods wait for the response,
+/// the asynchronous methods call a completion handler.
 class DataClient
 {
+public:
+    /// Runs a completion handler, e.g. on the Dispatcher. Without an Executor
+    /// completion handlers are called on the network thread and must not block,
+    /// i.e. they must not call blocking methods of the DataClient.
+    using Executor = std::function<void(std::function<void(void)>&&)>;
+    using Callback = std::function<void(bool success)>;
 private:
-    std::mutex lock_;
+    /// Called with the success and the data of a Data response
+    using Completion = std::function<void(bool success, DataBuff& data)>;
+    struct Request
+    {
+        OpCodes opCode;
+        uint32_t id{ 0 };
+        DataKey key;
+        DataBuff data;
+        std::array<uint8_t, REQUEST_HEADER_SIZE> header;
+        std::array<uint8_t, 4> dataHeader;
+        Completion completion;
+        Executor executor;
+        bool retried{ false };
+    };
+    /// Waits for the responses of a number of requests
+    class Batch
+    {
+    private:
+        std::mutex lock_;
+        std::condition_variable signal_;
+        size_t remaining_;
+    public:
+        explicit Batch(size_t count) :
+            remaining_(count)
+        { }
+        std::atomic<size_t> succeeded_{ 0 };
+        void Done(bool success)
+        {
+            if (success)
+                ++succeeded_;
+            std::scoped_lock lock(lock_);
+            if (--remaining_ == 0)
+                signal_.notify_all();
+        }
+        void Wait()
+        {
+            std::unique_lock lock(lock_);
+            signal_.wait(lock, [this]() { return remaining_ == 0; });
+        }
+    };
 public:
-    explicit DataClient(asio::io_service& io_service);
+    DataClient();
     ~DataClient();
 
     void Connect(const std::string& host, uint16_t port);
@@ -63,6 +120,82 @@ public:
             return true;
         return false;
     }
+    /// Reads all entities with one request. Entities which could not be read are
+    /// removed, the others keep their order. Returns the number of entities read.
+    template<typename E>
+    size_t ReadMany(std::vector<E>& entities)
+    {
+        if (entities.empty())
+            return 0;
+        DataBuff data;
+        AppendInt32(data, static_cast<uint32_t>(entities.size()));
+        DataBuff record;
+        for (const auto& entity : entities)
+        {
+            const uuids::uuid id(entity.uuid);
+            data.insert(data.end(), id.begin(), id.end());
+            record.clear();
+            SetEntity<E>(entity, record);
+            AppendInt32(data, static_cast<uint32_t>(record.size()));
+            data.insert(data.end(), record.begin(), record.end());
+        }
+        if (!MakeRequest(OpCodes::ReadMany, DataKey(E::KEY(), uuids::uuid()), data) || data.size() < 4)
+        {
+            entities.clear();
+            return 0;
+        }
+
+        const size_t count = std::min<size_t>(ToInt32(data.data()), entities.size());
+        size_t pos = 4;
+        size_t read = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (pos + 5 > data.size())
+                break;
+            const ErrorCodes code = static_cast<ErrorCodes>(data[pos]);
+            const size_t size = ToInt32(&data[pos + 1]);
+            pos += 5;
+            if (pos + size > data.size())
+                break;
+            if (code == ErrorCodes::Ok)
+            {
+                record.assign(data.begin() + static_cast<std::ptrdiff_t>(pos),
+                    data.begin() + static_cast<std::ptrdiff_t>(pos + size));
+                if (GetEntity(record, entities[i]))
+                {
+                    if (read != i)
+                        entities[read] = std::move(entities[i]);
+                    ++read;
+                }
+            }
+            pos += size;
+        }
+        entities.erase(entities.begin() + static_cast<std::ptrdiff_t>(read), entities.end());
+        return read;
+    }
+    /// Reads the entities with these UUIDs with one request
+    template<typename E>
+    std::vector<E> ReadMany(const std::vector<std::string>& uuids)
+    {
+        std::vector<E> result(uuids.size());
+        for (size_t i = 0; i < uuids.size(); ++i)
+            result[i].uuid = uuids[i];
+        ReadMany(result);
+        return result;
+    }
+    /// Callback signature is void(bool success, E& entity)
+    template<typename E, typename Handler>
+    void ReadAsync(const E& entity, Handler&& callback, Executor executor = {})
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        SetEntity<E>(entity, data);
+        AsyncRequest(OpCodes::Read, aKey, std::move(data), [entity = E(entity), callback = std::forward<Handler>(callback)](bool success, DataBuff& result) mutable
+        {
+            success = success && GetEntity(result, entity);
+            callback(success, entity);
+        }, std::move(executor));
+    }
     /// Delete an entity. This entity must be in cache, if not, use Read first.
     template<typename E>
     bool Delete(const E& entity)
@@ -71,6 +204,12 @@ public:
         return DeleteData(aKey);
     }
     template<typename E>
+    void DeleteAsync(const E& entity, Callback&& callback = {}, Executor executor = {})
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        AsyncRequest(OpCodes::Delete, aKey, {}, MakeCompletion(std::move(callback)), std::move(executor));
+    }
+    template<typename E>
     bool DeleteIfExists(E& entity)
     {
         // Can not use Exists(), because we can only delete records that are in cache,
@@ -88,6 +227,26 @@ public:
         return Create(entity);
     }
     template<typename E>
+    void UpdateOrCreateAsync(const E& entity, Callback&& callback = {}, Executor executor = {})
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        if (SetEntity<E>(entity, data) == 0)
+        {
+            Fail(std::move(callback), executor);
+            return;
+        }
+        DataBuff copy = data;
+        // The second request is sent from the network thread, so requests following
+        // this one are sent before it.
+        AsyncRequest(OpCodes::Exists, aKey, std::move(copy),
+            [this, aKey, data = std::move(data), callback = std::move(callback), executor = std::move(executor)](bool exists, DataBuff&) mutable
+        {
+            AsyncRequest(exists ? OpCodes::Update : OpCodes::Create, aKey, std::move(data),
+                MakeCompletion(std::move(callback)), std::move(executor));
+        }, {});
+    }
+    template<typename E>
     bool Update(const E& entity)
     {
         const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
@@ -96,6 +255,43 @@ public:
             return false;
         return UpdateData(aKey, data);
     }
+    /// Updates all entities at once. Returns the number of entities updated.
+    template<typename E>
+    size_t UpdateMany(const std::vector<E>& entities)
+    {
+        if (entities.empty())
+            return 0;
+        Batch batch(entities.size());
+        for (const auto& entity : entities)
+        {
+            const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+            DataBuff data;
+            if (SetEntity<E>(entity, data) == 0)
+            {
+                batch.Done(false);
+                continue;
+            }
+            AsyncRequest(OpCodes::Update, aKey, std::move(data), [&batch](bool success, DataBuff&)
+            {
+                batch.Done(success);
+            }, {});
+        }
+        batch.Wait();
+        return batch.succeeded_;
+    }
+    /// Does not wait for the response, the entity is serialized before returning.
+    template<typename E>
+    void UpdateAsync(const E& entity, Callback&& callback = {}, Executor executor = {})
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        if (SetEntity<E>(entity, data) == 0)
+        {
+            Fail(std::move(callback), executor);
+            return;
+        }
+        AsyncRequest(OpCodes::Update, aKey, std::move(data), MakeCompletion(std::move(callback)), std::move(executor));
+    }
     template<typename E>
     bool Create(E& entity)
     {
@@ -106,6 +302,18 @@ public:
         return CreateData(aKey, data);
     }
     template<typename E>
+    void CreateAsync(const E& entity, Callback&& callback = {}, Executor executor = {})
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        DataBuff data;
+        if (SetEntity<E>(entity, data) == 0)
+        {
+            Fail(std::move(callback), executor);
+            return;
+        }
+        AsyncRequest(OpCodes::Create, aKey, std::move(data), MakeCompletion(std::move(callback)), std::move(executor));
+    }
+    template<typename E>
     bool Preload(const E& entity)
     {
         const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
@@ -127,6 +335,12 @@ public:
         const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
         return InvalidateData(aKey);
     }
+    template<typename E>
+    void InvalidateAsync(const E& entity, Callback&& callback = {}, Executor executor = {})
+    {
+        const DataKey aKey(E::KEY(), uuids::uuid(entity.uuid));
+        AsyncRequest(OpCodes::Invalidate, aKey, {}, MakeCompletion(std::move(callback)), std::move(executor));
+    }
     /// Clears all cache
     bool Clear();
     bool IsConnected() const
@@ -164,20 +378,52 @@ private:
         auto writtenSize = bitsery::quickSerialization<OutputAdapter, E>(buffer, e);
         return writtenSize;
     }
+    /// Calls the callback of a request which could not be made
+    static void Fail(Callback&& callback, const Executor& executor)
+    {
+        if (!callback)
+            return;
+        if (!executor)
+        {
+            callback(false);
+            return;
+        }
+        executor([callback = std::move(callback)]()
+        {
+            callback(false);
+        });
+    }
+    static Completion MakeCompletion(Callback&& callback)
+    {
+        if (!callback)
+            return {};
+        return [callback = std::move(callback)](bool success, DataBuff&)
+        {
+            callback(success);
+        };
+    }
 
-    static uint32_t ToInt32(const DataBuff& intBytes, uint32_t start)
+    static uint32_t ToInt32(const uint8_t* intBytes)
+    {
+        return (intBytes[3] << 24) | (intBytes[2] << 16) | (intBytes[1] << 8) | intBytes[0];
+    }
+    static void FromInt32(uint32_t value, uint8_t* intBytes)
     {
-        return (intBytes[static_cast<size_t>(start) + 3] << 24) |
-            (intBytes[static_cast<size_t>(start) + 2] << 16) |
-            (intBytes[static_cast<size_t>(start) + 1] << 8) |
-            intBytes[static_cast<size_t>(start)];
+        intBytes[0] = static_cast<uint8_t>(value);
+        intBytes[1] = static_cast<uint8_t>(value >> 8);
+        intBytes[2] = static_cast<uint8_t>(value >> 16);
+        intBytes[3] = static_cast<uint8_t>(value >> 24);
     }
-    static uint16_t ToInt16(const DataBuff& intBytes, uint32_t start)
+    static void AppendInt32(DataBuff& buffer, uint32_t value)
     {
-        return (intBytes[static_cast<size_t>(start) + 1] << 8) |
-            intBytes[static_cast<size_t>(start)];
+        const size_t pos = buffer.size();
+        buffer.resize(pos + 4);
+        FromInt32(value, &buffer[pos]);
     }
 
+    /// Thread safe, the completion is called when the response arrived or the request failed
+    void AsyncRequest(OpCodes opCode, const DataKey& key, DataBuff&& data, Completion&& completion, Executor&& executor);
+    /// Waits for the response, data receives the data of a Data response
     bool MakeRequest(OpCodes opCode, const DataKey& key, DataBuff& data);
     bool MakeRequestNoData(OpCodes opCode, const DataKey& key);
     bool ReadData(const DataKey& key, DataBuff& data);
@@ -187,31 +433,56 @@ private:
     bool CreateData(const DataKey& key, DataBuff& data);
     bool PreloadData(const DataKey& key);
     bool InvalidateData(const DataKey& key);
+    bool IsNetworkThread() const { return std::this_thread::get_id() == thread_.get_id(); }
+
+    // Everything below runs on the network thread
     void InternalConnect();
-    /// Try connect to server.
-    /// @param[in] force If force is true it disconnects first.
-    /// @return true on success.
-    bool TryConnect(bool force, unsigned numTries = 10);
-    /// Try to send some data. If not connected tries to reconnect.
-    template<typename B>
-    bool TryWrite(const B& buffer)
-    {
-        asio::error_code ec;
-        socket_.send(buffer, 0, ec);
-        if (ec)
-        {
-            if (!TryConnect(true))
-                return false;
-            socket_.send(buffer, 0, ec);
-        }
-        return !(bool)ec;
-    }
+    /// Try to connect to the server every 100ms without blocking the network thread.
+    /// Requests in the connect queue are sent or fail when it's done.
+    void Reconnect(unsigned numTries = 10);
+    void TryReconnect();
+    void ReconnectDone();
+    void Close();
+    /// Sends the request, or waits for the connection when not connected
+    void Enqueue(std::shared_ptr<Request> request);
+    void Send(std::shared_ptr<Request> request);
+    void StartWrite();
+    void StartRead();
+    void HandleResponse();
+    void HandleError(const asio::error_code& error);
+    /// Fail all requests waiting for a response
+    void FailPending();
+    /// Close the connection and fail all outstanding requests
+    void Shutdown();
+    static void Complete(Request& request, bool success, DataBuff& data);
 
     std::string host_;
     uint16_t port_{ 0 };
+    asio::io_service ioService_;
+    std::unique_ptr<asio::io_service::work> work_;
+    std::thread thread_;
     asio::ip::tcp::socket socket_;
     asio::ip::tcp::resolver resolver_;
-    bool connected_{ false };
+    asio::steady_timer reconnectTimer_;
+    bool reconnecting_{ false };
+    unsigned reconnectTries_{ 0 };
+    /// Called when the connect of Connect() is done
+    std::function<void(void)> onConnected_;
+    std::atomic<bool> connected_{ false };
+    /// Increased with every connection, to ignore handlers of closed connections
+    uint32_t connectionId_{ 0 };
+    uint32_t nextRequestId_{ 0 };
+    /// Requests waiting for the connection
+    std::deque<std::shared_ptr<Request>> connectQueue_;
+    /// Requests not yet written, the first one is being written
+    std::deque<std::shared_ptr<Request>> writeQueue_;
+    /// Requests waiting for a response
+    std::unordered_map<uint32_t, std::shared_ptr<Request>> pending_;
+    std::array<uint8_t, RESPONSE_HEADER_SIZE> responseHeader_;
+    DataBuff responseData_;
+    std::mutex shutdownLock_;
+    /// Set by the destructor, new requests fail right away
+    std::atomic<bool> shutdown_{ false };
 };
 
 }
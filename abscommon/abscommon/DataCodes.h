@@ -22,9 +22,18 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 namespace IO {
 
+// Requests are tagged with an ID which is sent back with the response, so a client
+// can have many requests in flight on one connection and the server may answer
+// them in any order.
+// Request: OpCode (1), request ID (4), key size (2), key, data size (4), data
+static constexpr size_t REQUEST_HEADER_SIZE = 7;
+// Response: OpCode Status or Data (1), request ID (4), ErrorCode (1), data size (4), data
+static constexpr size_t RESPONSE_HEADER_SIZE = 10;
+
 enum class OpCodes : uint8_t
 {
     None = 0,
@@ -39,6 +48,10 @@ enum class OpCodes : uint8_t
     Exists,
     // Clear all cache
     Clear,
+    // Read many records of one table with one request. The key is the table with an
+    // empty UUID. Data: count (4), for each record UUID (16), data size (4), data.
+    // Response data: count (4), for each record ErrorCode (1), data size (4), data.
+    ReadMany,
     // Responses
     Status,
     Data
@@ -122,7 +122,7 @@ void Dispatcher::DispatcherThread()
                 const uint32_t busyTime = Utils::TimeElapsed(startExecTime);
                 const uint32_t observationTime = Utils::TimeElapsed(observationStart);
                 if (observationTime != 0)
-                    utilization_ = static_cast<uint32_t>(busyTime / observationTime);
+                    utilization_ = static_cast<uint32_t>((busyTime * 100) / observationTime);
             }
 
             delete task;
@@ -48,8 +48,9 @@ void FileWatcher::Update()
 {
     if (!watching_)
         return;
-    auto lastWriteTime = fs::last_write_time(path_);
-    if (lastWriteTime > lastTime_)
+    std::error_code ec;
+    auto lastWriteTime = fs::last_write_time(path_, ec);
+    if (!ec && lastWriteTime > lastTime_)
     {
         if (lastTime_ != fs::file_time_type::min())
         {
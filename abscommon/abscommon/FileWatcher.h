@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <filesystem>
@@ -32,12 +33,14 @@ namespace IO {
 
 inline constexpr uint32_t FILEWATCHER_INTERVAL = 1000;
 
-class FileWatcher : std::enable_shared_from_this<FileWatcher>
+/// Calls onChanged_ on the Dispatcher thread when the modification time of the file changes
+class FileWatcher : public std::enable_shared_from_this<FileWatcher>
 {
 private:
     fs::path path_;
     fs::file_time_type lastTime_{ fs::file_time_type::min() };
-    bool watching_{ false };
+    /// Stopped from other threads
+    std::atomic<bool> watching_{ false };
     void Update();
 public:
     explicit FileWatcher(const std::string& fileName) :
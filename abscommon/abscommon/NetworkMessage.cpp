@@ -23,7 +23,6 @@
 #include "NetworkMessage.h"
 #include <abcrypto.hpp>
 #include <AB/ProtocolCodes.h>
-#include <lz4.h>
 #include "Subsystems.h"
 #include "Dispatcher.h"
 #include "Subsystems.h"
@@ -183,50 +182,4 @@ void NetworkMessage::AddStringEncrypted(const std::string& value)
     delete[] buff;
 }
 
-bool NetworkMessage::Compress()
-{
-#if 0
-    std::unique_ptr<char[]> buff = std::make_unique<char[]>(NETWORKMESSAGE_BUFFER_SIZE);
-    const char* src = reinterpret_cast<const char*>(buffer_ + HeaderLength);
-    int size = LZ4_compress_default(src, buff.get(), GetSize(), NETWORKMESSAGE_BUFFER_SIZE);
-    if (size > 0)
-    {
-/*
-#ifdef _MSC_VER
-        memcpy_s(buffer_ + HeaderLength, NETWORKMESSAGE_BUFFER_SIZE, buff, size);
-#else
-        memcpy(buffer_ + HeaderLength, buff, size);
-#endif
-        info_.position = INITIAL_BUFFER_POSITION;
-        info_.length = size;
-        */
-        return true;
-    }
-#endif
-    return false;
-}
-
-bool NetworkMessage::Uncompress()
-{
-#if 0
-    std::unique_ptr<char[]> buff = std::make_unique<char[]>(NETWORKMESSAGE_BUFFER_SIZE);
-    const char* src = reinterpret_cast<const char*>(buffer_ + HeaderLength);
-    int size = LZ4_decompress_safe(src, buff.get(), GetSize(), NETWORKMESSAGE_BUFFER_SIZE);
-    if (size > 0)
-    {
-        /*
-#ifdef _MSC_VER
-        memcpy_s(buffer_ + HeaderLength, NETWORKMESSAGE_BUFFER_SIZE, buff, size);
-#else
-        memcpy(buffer_ + HeaderLength, buff, size);
-#endif
-        info_.position = INITIAL_BUFFER_POSITION;
-        info_.length = size;
-        */
-        return true;
-    }
-#endif
-    return true;
-}
-
 }
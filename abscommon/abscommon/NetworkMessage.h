@@ -183,9 +183,6 @@ public:
     void SetSize(int32_t size) { info_.length = static_cast<MsgSize_t>(size); }
     int32_t GetReadPos() const { return static_cast<int32_t>(info_.position); }
     int32_t GetSpace() const { return MaxBodyLength - info_.length; }
-
-    bool Compress();
-    bool Uncompress();
 };
 
 template <>
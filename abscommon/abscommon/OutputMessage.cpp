@@ -28,6 +28,7 @@
 #include "Protocol.h"
 #include "Connection.h"
 #include "Subsystems.h"
+#include <AB/Packets/Compression.h>
 
 namespace Net {
 
@@ -35,6 +36,30 @@ const std::chrono::milliseconds OUTPUTMESSAGE_AUTOSEND_DELAY{ 10 };
 
 std::mutex PoolWrapper::lock_;
 
+bool OutputMessage::Compress(int32_t threshold)
+{
+    const int32_t size = static_cast<int32_t>(info_.length);
+    if (size >= threshold)
+    {
+        char buff[NETWORKMESSAGE_BUFFER_SIZE];
+        const int compressedSize = AB::Packets::CompressMessage(reinterpret_cast<const char*>(buffer_ + outputBufferStart_),
+            size, buff, static_cast<int>(sizeof(buff)));
+        // Including the size of the compressed data it must be smaller
+        if (compressedSize > 0 && compressedSize + static_cast<int>(sizeof(uint16_t)) < size)
+        {
+            const uint16_t compressed = static_cast<uint16_t>(compressedSize);
+            memcpy(buffer_ + outputBufferStart_, &compressed, sizeof(uint16_t));
+            memcpy(buffer_ + outputBufferStart_ + sizeof(uint16_t), buff, static_cast<size_t>(compressedSize));
+            info_.length = static_cast<MsgSize_t>(compressedSize + sizeof(uint16_t));
+            info_.position = static_cast<MsgSize_t>(outputBufferStart_ + info_.length);
+            AddHeader<uint8_t>(AB::Packets::MESSAGE_COMPRESSED);
+            return true;
+        }
+    }
+    AddHeader<uint8_t>(AB::Packets::MESSAGE_UNCOMPRESSED);
+    return false;
+}
+
 void OutputMessagePool::SendAll()
 {
     // Dispatcher Thread
@@ -71,6 +71,9 @@ public:
     {
         AddHeader<uint16_t>(info_.length);
     }
+    /// Compress the message when it's at least threshold bytes and it gets smaller.
+    /// Adds the compression header in any case, so must be called before encrypting.
+    bool Compress(int32_t threshold);
 
     void Append(const NetworkMessage& msg)
     {
@@ -25,6 +25,7 @@
 #include "OutputMessage.h"
 #include "Scheduler.h"
 #include <AB/ProtocolCodes.h>
+#include <AB/Packets/Compression.h>
 #include <abcrypto.hpp>
 #include "Connection.h"
 #include "OutputMessage.h"
@@ -38,7 +39,17 @@ Protocol::Protocol(std::shared_ptr<Connection> connection) :
     encryptionEnabled_(false)
 { }
 
-Protocol::~Protocol() = default;
+int32_t Protocol::compressionThreshold_ = AB::Packets::DEFAULT_COMPRESSION_THRESHOLD;
+std::atomic<uint64_t> Protocol::totalRawBytesSent_{ 0 };
+std::atomic<uint64_t> Protocol::totalWireBytesSent_{ 0 };
+
+Protocol::~Protocol()
+{
+#ifdef DEBUG_NET
+    if (compressionEnabled_ && rawBytesSent_ != 0)
+        LOG_DEBUG << "Sent " << rawBytesSent_ << " bytes, " << wireBytesSent_ << " bytes on the wire" << std::endl;
+#endif
+}
 
 void Protocol::Disconnect() const
 {
@@ -90,21 +101,28 @@ bool Protocol::XTEADecrypt(NetworkMessage& msg) const
     return true;
 }
 
-void Protocol::OnSendMessage(OutputMessage& message) const
+void Protocol::OnSendMessage(OutputMessage& message)
 {
 #ifdef DEBUG_NET
 //    LOG_DEBUG << "Sending message" << std::endl;
 #endif
+    const uint64_t rawSize = static_cast<uint64_t>(message.GetSize());
+    rawBytesSent_ += rawSize;
+    totalRawBytesSent_ += rawSize;
+    // Compress the plain message, encrypted data doesn't compress
+    if (compressionEnabled_)
+        message.Compress(compressionThreshold_);
     if (encryptionEnabled_)
     {
         XTEAEncrypt(message);
     }
-    if (compressionEnabled_)
-        message.Compress();
     if (encryptionEnabled_ || checksumEnabled_)
     {
         message.AddCryptoHeader(checksumEnabled_);
     }
+    const uint64_t wireSize = static_cast<uint64_t>(message.GetSize());
+    wireBytesSent_ += wireSize;
+    totalWireBytesSent_ += wireSize;
 }
 
 void Protocol::OnRecvMessage(NetworkMessage& message)
@@ -112,9 +130,7 @@ void Protocol::OnRecvMessage(NetworkMessage& message)
 #ifdef DEBUG_NET
 //    LOG_DEBUG << "Receiving message with size " << message.GetMessageLength() << std::endl;
 #endif
-    if (compressionEnabled_)
-        message.Uncompress();
-
+    // Clients do not compress messages
     if (encryptionEnabled_)
     {
         if (!XTEADecrypt(message))
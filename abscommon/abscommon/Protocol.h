@@ -23,6 +23,7 @@
 
 #include "Logger.h"
 #include <abcrypto.hpp>
+#include <atomic>
 #include <cstring>
 #include <sa/SmartPtr.h>
 #include <sa/Noncopyable.h>
@@ -36,6 +37,12 @@ class NetworkMessage;
 class Protocol : public std::enable_shared_from_this<Protocol>
 {
     NON_COPYABLE(Protocol)
+private:
+    /// Messages smaller than this are not compressed
+    static int32_t compressionThreshold_;
+    /// Bytes sent by all connections
+    static std::atomic<uint64_t> totalRawBytesSent_;
+    static std::atomic<uint64_t> totalWireBytesSent_;
 protected:
     std::weak_ptr<Connection> connection_;
     sa::SharedPtr<OutputMessage> outputBuffer_;
@@ -43,6 +50,9 @@ protected:
     bool compressionEnabled_;
     bool encryptionEnabled_;
     DH_KEY encKey_;
+    /// Bytes before and after compression and encryption
+    std::atomic<uint64_t> rawBytesSent_{ 0 };
+    std::atomic<uint64_t> wireBytesSent_{ 0 };
     void XTEAEncrypt(OutputMessage& msg) const;
     bool XTEADecrypt(NetworkMessage& msg) const;
 
@@ -51,6 +61,11 @@ protected:
 
     friend class Connection;
 public:
+    static void SetCompressionThreshold(int32_t value) { compressionThreshold_ = value; }
+    static int32_t GetCompressionThreshold() { return compressionThreshold_; }
+    static uint64_t GetTotalRawBytesSent() { return totalRawBytesSent_; }
+    static uint64_t GetTotalWireBytesSent() { return totalWireBytesSent_; }
+
     explicit Protocol(std::shared_ptr<Connection> connection);
     virtual ~Protocol();
 
@@ -59,7 +74,7 @@ public:
         memcpy(&encKey_, key, sizeof(encKey_));
     }
 
-    virtual void OnSendMessage(OutputMessage& message) const;
+    virtual void OnSendMessage(OutputMessage& message);
     void OnRecvMessage(NetworkMessage& message);
 
     virtual void OnRecvFirstMessage(NetworkMessage& msg) = 0;
@@ -74,6 +89,10 @@ public:
     void ResetOutputBuffer();
     uint32_t GetIP();
     sa::SharedPtr<OutputMessage>& GetCurrentBuffer();
+    /// Bytes sent by this connection before compression and encryption
+    uint64_t GetRawBytesSent() const { return rawBytesSent_; }
+    /// Bytes this connection sent on the wire
+    uint64_t GetWireBytesSent() const { return wireBytesSent_; }
 
     void Send(sa::SharedPtr<OutputMessage>&& message);
 };
@@ -149,8 +149,8 @@ Actor::Actor() :
     collisionComp_(std::make_unique<Components::CollisionComp>(*this)),    // Actor always collides
     selectionComp_(std::make_unique<Components::SelectionComp>(*this))
 {
-    events_.Subscribe<void(Skill*)>(EVENT_ON_ENDUSESKILL, std::bind(&Actor::OnEndUseSkill, this, std::placeholders::_1));
-    events_.Subscribe<void(Skill*)>(EVENT_ON_STARTUSESKILL, std::bind(&Actor::OnStartUseSkill, this, std::placeholders::_1));
+    SubscribeEvent<EVENT_ON_ENDUSESKILL, &Actor::OnEndUseSkill>(this);
+    SubscribeEvent<EVENT_ON_STARTUSESKILL, &Actor::OnStartUseSkill>(this);
 
     /*
      * Default BB for humans
@@ -326,6 +326,8 @@ bool Actor::AddToInventory(uint32_t itemId)
 void Actor::DropRandomItem()
 {
     auto game = GetGame();
+    if (!game)
+        return;
     if (auto killer = killedBy_.lock())
     {
         // Killed by some killer, get the party of the killer and chose a random player
@@ -341,16 +343,12 @@ void Actor::DropRandomItem()
             // Drop nothing when no target
             return;
 
-        GetSubsystem<Asynch::Scheduler>()->Add(
-            Asynch::CreateScheduledTask(std::bind(&Game::AddRandomItemDropFor, game, this, target))
-        );
+        game->ScheduleTask(std::bind(&Game::AddRandomItemDropFor, game, this, target));
     }
     else
     {
         // Not killed by an actor, drop for any player in game
-        GetSubsystem<Asynch::Scheduler>()->Add(
-            Asynch::CreateScheduledTask(std::bind(&Game::AddRandomItemDrop, game, this))
-        );
+        game->ScheduleTask(std::bind(&Game::AddRandomItemDrop, game, this));
     }
 }
 
@@ -813,7 +811,7 @@ void Actor::SetHealthRegen(int value)
 bool Actor::InterruptAttack()
 {
     bool success = true;
-    CallEvent<void(bool&)>(EVENT_ON_INTERRUPTING_ATTACK, success);
+    CallEvent<EVENT_ON_INTERRUPTING_ATTACK>(success);
     if (!success)
         return false;
     return attackComp_->Interrupt();
@@ -825,7 +823,7 @@ bool Actor::InterruptSkill(AB::Entities::SkillType type)
     if (!skill)
         return false;
     bool success = true;
-    CallEvent<void(AB::Entities::SkillType, Skill*, bool&)>(EVENT_ON_INTERRUPTING_SKILL, type, skill, success);
+    CallEvent<EVENT_ON_INTERRUPTING_SKILL>(type, skill, success);
     if (!success)
         return false;
     return skillsComp_->Interrupt(type);
@@ -983,7 +981,7 @@ bool Actor::Die()
         autorunComp_->SetAutoRun(false);
         DecreaseMorale();
         killedBy_ = damageComp_->GetLastDamager();
-        CallEvent<void(void)>(EVENT_ON_DIED);
+        CallEvent<EVENT_ON_DIED>();
         return true;
     }
     return false;
@@ -999,7 +997,7 @@ bool Actor::Resurrect(int precentHealth, int percentEnergy)
         resourceComp_->SetEnergy(Components::SetValueType::Absolute, energy);
         damageComp_->Touch();
         stateComp_.SetState(AB::GameProtocol::CreatureState::Idle);
-        CallEvent<void(int,int)>(EVENT_ON_RESURRECTED, health, energy);
+        CallEvent<EVENT_ON_RESURRECTED>(health, energy);
         return true;
     }
     return false;
@@ -1015,7 +1013,7 @@ bool Actor::KnockDown(Actor* source, uint32_t time)
     if (time == 0)
         time = DEFAULT_KNOCKDOWN_TIME;
     bool ret = true;
-    CallEvent<void(Actor*, uint32_t, bool&)>(EVENT_ON_KNOCKING_DOWN, source, time, ret);
+    CallEvent<EVENT_ON_KNOCKING_DOWN>(source, time, ret);
     if (!ret)
         return false;
 
@@ -1027,7 +1025,7 @@ bool Actor::KnockDown(Actor* source, uint32_t time)
         attackComp_->Interrupt();
         skillsComp_->Interrupt(AB::Entities::SkillTypeSkill);
         autorunComp_->Reset();
-        CallEvent<void(uint32_t)>(EVENT_ON_KNOCKED_DOWN, time);
+        CallEvent<EVENT_ON_KNOCKED_DOWN>(time);
     }
     return ret;
 }
@@ -1037,9 +1035,9 @@ int Actor::Healing(Actor* source, uint32_t index, int value)
     if (IsDead())
         return 0;
     int val = value;
-    CallEvent<void(Actor*, int&)>(EVENT_ON_HEALING, source, val);
+    CallEvent<EVENT_ON_HEALING>(source, val);
     healComp_->Healing(source, index, val);
-    CallEvent<void(int)>(EVENT_ON_HEALED, val);
+    CallEvent<EVENT_ON_HEALED>(val);
     return val;
 }
 
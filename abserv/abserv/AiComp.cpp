@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include "AiComp.h"
+#include "Game.h"
 #include "Npc.h"
 
 namespace Game {
@@ -33,8 +34,28 @@ AiComp::AiComp(Npc& owner) :
 
 void AiComp::Update(uint32_t timeElapsed)
 {
-    if (!owner_.IsDead())
-        agent_.Update(timeElapsed);
+    if (owner_.IsDead())
+    {
+        elapsed_ = 0;
+        return;
+    }
+
+    elapsed_ += timeElapsed;
+    auto update = [this]()
+    {
+        agent_.Update(elapsed_);
+        elapsed_ = 0;
+    };
+    if (auto game = owner_.GetGame())
+        game->GetAiScheduler().Run(schedule_, owner_.GetId(), update);
+    else
+        update();
+}
+
+void AiComp::Wake()
+{
+    if (auto game = owner_.GetGame())
+        game->GetAiScheduler().Wake(schedule_);
 }
 
 }
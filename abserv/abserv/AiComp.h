@@ -22,6 +22,7 @@
 #pragma once
 
 #include "AiAgent.h"
+#include "AiScheduler.h"
 #include <sa/Noncopyable.h>
 
 namespace Game {
@@ -36,13 +37,19 @@ class AiComp
 private:
     Npc& owner_;
     AI::AiAgent agent_;
+    AI::Scheduler::Schedule schedule_;
+    /// Time since the behavior tree was evaluated the last time
+    uint32_t elapsed_{ 0 };
     AiComp() = delete;
 public:
     explicit AiComp(Npc& owner);
     ~AiComp() = default;
 
     void Update(uint32_t timeElapsed);
+    /// Something happened to the NPC, evaluate the behavior tree soon
+    void Wake();
     AI::AiAgent& GetAgent() { return agent_; }
+    AI::Scheduler::Schedule& GetSchedule() { return schedule_; }
 };
 
 }
@@ -271,12 +271,24 @@ void DebugServer::BroadcastGame(const Game::Game& game)
                 msg.currAction = "None";
             msg.selectedAgentsCount = agent.filteredAgents_.size();
             msg.selectedAgents = agent.filteredAgents_;
-            agent.context_.VisitTypes<AI::node_status_type>([&](const AI::Id& id, const AI::Node::Status& value)
+            if (auto b = agent.GetBehavior())
             {
-                auto st = std::make_pair(static_cast<uint32_t>(id), static_cast<int>(value));
-                msg.nodeStatus.push_back(std::move(st));
-                return Iteration::Continue;
-            });
+                // The context is indexed by the position of the node in the tree,
+                // the client wants the node IDs.
+                auto addStatus = [&](const AI::Node& node)
+                {
+                    if (!agent.context_.Has<AI::node_status_type>(node.GetIndex()))
+                        return;
+                    const AI::Node::Status value = agent.context_.Get<AI::node_status_type>(node.GetIndex());
+                    msg.nodeStatus.push_back(std::make_pair(static_cast<uint32_t>(node.GetId()), static_cast<int>(value)));
+                };
+                addStatus(*b);
+                AI::ForEachChildNode(*b, [&](const AI::Node&, const AI::Node& child)
+                {
+                    addStatus(child);
+                    return Iteration::Continue;
+                });
+            }
             msg.nodeStatusCount = msg.nodeStatus.size();
         }
         else
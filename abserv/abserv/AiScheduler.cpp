@@ -0,0 +1,89 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include "AiScheduler.h"
+
+namespace AI {
+
+static uint32_t GetInterval(Scheduler::Level level)
+{
+    switch (level)
+    {
+    case Scheduler::Level::Active:
+        return Scheduler::ACTIVE_INTERVAL;
+    case Scheduler::Level::Near:
+        return Scheduler::NEAR_INTERVAL;
+    case Scheduler::Level::Dormant:
+        return Scheduler::DORMANT_INTERVAL;
+    }
+    return Scheduler::ACTIVE_INTERVAL;
+}
+
+void Scheduler::BeginTick()
+{
+    stats_.lastTime = used_;
+    if (used_ > stats_.maxTime)
+        stats_.maxTime = used_;
+    stats_.evaluated = evaluated_;
+    stats_.deferred = deferred_;
+    used_ = 0;
+    evaluated_ = 0;
+    deferred_ = 0;
+    ++tick_;
+}
+
+void Scheduler::SetPlayerLevel(Schedule& schedule, Level level)
+{
+    // Another player is already closer
+    if (schedule.playerTick == tick_ && schedule.playerLevel < level)
+        return;
+    schedule.playerTick = tick_;
+    schedule.playerLevel = level;
+    // A player entered the aggro range, don't wait for the next evaluation
+    if (level == Level::Active && schedule.nextTick > tick_)
+        schedule.nextTick = tick_;
+}
+
+Scheduler::Level Scheduler::GetLevel(const Schedule& schedule) const
+{
+    if (schedule.activeUntil > tick_)
+        return Level::Active;
+    if (schedule.playerTick == tick_)
+        return schedule.playerLevel;
+    return Level::Dormant;
+}
+
+uint32_t Scheduler::GetNextTick(const Schedule& schedule, uint32_t id) const
+{
+    const uint32_t interval = GetInterval(GetLevel(schedule));
+    // Agents with the same interval are due in different ticks
+    return tick_ + interval - ((tick_ + id) % interval);
+}
+
+void Scheduler::Wake(Schedule& schedule)
+{
+    if (schedule.nextTick > tick_)
+        schedule.nextTick = tick_;
+    schedule.activeUntil = tick_ + ACTIVE_TICKS;
+}
+
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+#include <sa/Noncopyable.h>
+
+namespace AI {
+
+/// Decides in which game ticks the behavior trees of the NPCs are evaluated.
+/// NPCs close to a player are evaluated often, NPCs far away from all players
+/// rarely. NPCs with the same interval are spread over the ticks by their ID,
+/// and all evaluations of a tick share a time budget. Agents that were due but
+/// didn't fit into the budget are evaluated in the next tick regardless.
+class Scheduler
+{
+    NON_COPYABLE(Scheduler)
+public:
+    enum class Level
+    {
+        /// A player is in aggro range or the NPC is involved in some action
+        Active,
+        /// A player is in compass range
+        Near,
+        /// No player around
+        Dormant
+    };
+    /// Per agent data, owned by the agent
+    struct Schedule
+    {
+        uint32_t nextTick{ 0 };
+        /// The NPC was woken up by an event and stays active until this tick
+        uint32_t activeUntil{ 0 };
+        /// Tick in which a player was near and the level it caused
+        uint32_t playerTick{ 0 };
+        Level playerLevel{ Level::Dormant };
+        bool deferred{ false };
+    };
+    struct Stats
+    {
+        /// Time in us spent evaluating behavior trees in the last tick
+        uint32_t lastTime{ 0 };
+        uint32_t maxTime{ 0 };
+        /// Number of agents evaluated in the last tick
+        uint32_t evaluated{ 0 };
+        /// Number of agents that didn't fit into the budget of the last tick
+        uint32_t deferred{ 0 };
+    };
+private:
+    using Clock = std::chrono::steady_clock;
+    uint32_t tick_{ 0 };
+    /// Time in us used in this tick
+    uint32_t used_{ 0 };
+    uint32_t budget_{ DEFAULT_BUDGET };
+    uint32_t evaluated_{ 0 };
+    uint32_t deferred_{ 0 };
+    Stats stats_;
+    uint32_t GetNextTick(const Schedule& schedule, uint32_t id) const;
+public:
+    /// Ticks between two evaluations for each level
+    static constexpr uint32_t ACTIVE_INTERVAL = 1;
+    static constexpr uint32_t NEAR_INTERVAL = 4;
+    static constexpr uint32_t DORMANT_INTERVAL = 20;
+    /// Ticks an NPC stays active after an event woke it up
+    static constexpr uint32_t ACTIVE_TICKS = 100;
+    static constexpr uint32_t DEFAULT_BUDGET = 5000;
+
+    Scheduler() = default;
+    ~Scheduler() = default;
+
+    /// Must be called at the beginning of a tick, before SetPlayerLevel() and
+    /// before the NPCs are updated.
+    void BeginTick();
+    /// A player is close to the NPC in this tick. When several players are close
+    /// the closest level wins.
+    void SetPlayerLevel(Schedule& schedule, Level level);
+    /// Run callback when the agent is due
+    /// @return true when the callback was called
+    template <typename Callback>
+    bool Run(Schedule& schedule, uint32_t id, Callback&& callback)
+    {
+        if (tick_ < schedule.nextTick)
+            return false;
+        if (!schedule.deferred && used_ >= budget_)
+        {
+            schedule.deferred = true;
+            ++deferred_;
+            return false;
+        }
+        const auto start = Clock::now();
+        callback();
+        used_ += static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+        schedule.deferred = false;
+        schedule.nextTick = GetNextTick(schedule, id);
+        ++evaluated_;
+        return true;
+    }
+    /// Evaluate the agent in this tick and keep it active for a while. Called when
+    /// something happens to the NPC, e.g. it gets attacked.
+    void Wake(Schedule& schedule);
+    Level GetLevel(const Schedule& schedule) const;
+    /// Budget in us
+    void SetBudget(uint32_t value) { budget_ = value; }
+    uint32_t GetBudget() const { return budget_; }
+    const Stats& GetStats() const { return stats_; }
+};
+
+}
@@ -74,7 +74,7 @@ Application::Application() :
     Subsystems::Instance.CreateSubsystem<Asynch::Scheduler>();
     Subsystems::Instance.CreateSubsystem<Asynch::ThreadPool>();
     Subsystems::Instance.CreateSubsystem<Net::ConnectionManager>();
-    Subsystems::Instance.CreateSubsystem<IO::DataClient>(ioService_);
+    Subsystems::Instance.CreateSubsystem<IO::DataClient>();
     Subsystems::Instance.CreateSubsystem<Net::MessageClient>(ioService_);
 
     Subsystems::Instance.CreateSubsystem<Crypto::Random>();
@@ -315,6 +315,8 @@ bool Application::LoadMain()
     if (serverLocation_.empty())
         serverLocation_ = (*config)[ConfigManager::Key::Location].GetString();
     Net::ProtocolGame::serverId_ = GetServerId();
+    Net::Protocol::SetCompressionThreshold(static_cast<int32_t>((*config)[ConfigManager::Key::CompressionThreshold].GetInt64()));
+    GetSubsystem<IO::DataProvider>()->watchAssets_ = (*config)[ConfigManager::Key::WatchAssets].GetBool();
 
     Net::ConnectionManager::maxPacketsPerSec = static_cast<uint32_t>((*config)[ConfigManager::Key::MaxPacketsPerSecond].GetInt64());
     // Not relevant for the game server since it does not count login attempts,
@@ -506,9 +508,13 @@ void Application::PrintServerInfo()
     LOG_INFO << "  Auto terminate: " << autoTerminate_ << std::endl;
     LOG_INFO << "  Temporary: " << temporary_ << std::endl;
     LOG_INFO << "  Log dir: " << (IO::Logger::logDir_.empty() ? "(empty)" : IO::Logger::logDir_) << std::endl;
+    LOG_INFO << "  Compression threshold: " << Net::Protocol::GetCompressionThreshold() << " bytes" << std::endl;
     LOG_INFO << "  Recording games: " << (*config)[ConfigManager::Key::RecordGames].GetBool() << std::endl;
     const std::string& recDir = (*config)[ConfigManager::Key::RecordingsDir].GetString();
     LOG_INFO << "  Recording directory: " << (recDir.empty() ? "(empty)" : recDir) << std::endl;
+    const std::string& scriptCacheDir = (*config)[ConfigManager::Key::ScriptCacheDir].GetString();
+    LOG_INFO << "  Script cache directory: " << (scriptCacheDir.empty() ? "(empty)" : scriptCacheDir) << std::endl;
+    LOG_INFO << "  Watch assets: " << (*config)[ConfigManager::Key::WatchAssets].GetBool() << std::endl;
     LOG_INFO << "  Background threads: " << GetSubsystem<Asynch::ThreadPool>()->GetNumThreads() << std::endl;
     if ((*config)[ConfigManager::Key::AiServer])
     {
@@ -677,3 +683,37 @@ unsigned Application::GetLoad()
     }
     return GetAvgLoad();
 }
+
+std::string Application::GetStats() const
+{
+    std::stringstream ss;
+    ss << "Players: " << GetSubsystem<Game::PlayerManager>()->GetPlayerCount() << std::endl;
+    // Game messages are compressed, this shows how much it saves
+    const uint64_t raw = Net::Protocol::GetTotalRawBytesSent();
+    const uint64_t wire = Net::Protocol::GetTotalWireBytesSent();
+    ss << "Bytes sent: " << Utils::ConvertSize(static_cast<size_t>(raw)) << std::endl;
+    ss << "Bytes sent on the wire: " << Utils::ConvertSize(static_cast<size_t>(wire));
+    if (raw != 0)
+        ss << " (" << (wire * 100 / raw) << "%)";
+    ss << std::endl;
+
+    // Time spent collecting Lua garbage in the ticks of all running games
+    uint64_t gcTime = 0;
+    uint64_t gcTicks = 0;
+    uint32_t gcMaxTime = 0;
+    uint64_t gcCycles = 0;
+    uint64_t gcOverruns = 0;
+    GetSubsystem<Game::GameManager>()->VisitGames([&](Game::Game& game)
+    {
+        const auto& gcStats = game.GetLuaGcStats();
+        gcTime += gcStats.totalTime;
+        gcTicks += gcStats.ticks;
+        gcMaxTime = std::max(gcMaxTime, gcStats.maxTime.load());
+        gcCycles += gcStats.cycles;
+        gcOverruns += gcStats.overruns;
+        return Iteration::Continue;
+    });
+    ss << "Lua GC: " << (gcTicks != 0 ? gcTime / gcTicks : 0) << " us/tick, max " << gcMaxTime << " us, " <<
+        gcCycles << " cycles, " << gcOverruns << " overruns" << std::endl;
+    return ss.str();
+}
@@ -77,6 +77,8 @@ public:
     std::string GetKeysFile() const;
     /// Returns a value between 0..100
     unsigned GetLoad();
+    /// Statistics shown by the admin interface
+    std::string GetStats() const;
 
     void SpawnServer();
 
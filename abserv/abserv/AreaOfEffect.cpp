@@ -51,9 +51,9 @@ AreaOfEffect::AreaOfEffect() :
     GameObject(),
     startTime_(Utils::Tick())
 {
-    events_.Subscribe<void(GameObject*)>(EVENT_ON_COLLIDE, std::bind(&AreaOfEffect::OnCollide, this, std::placeholders::_1));
-    events_.Subscribe<void(GameObject*)>(EVENT_ON_TRIGGER, std::bind(&AreaOfEffect::OnTrigger, this, std::placeholders::_1));
-    events_.Subscribe<void(GameObject*)>(EVENT_ON_LEFTAREA, std::bind(&AreaOfEffect::OnLeftArea, this, std::placeholders::_1));
+    SubscribeEvent<EVENT_ON_COLLIDE, &AreaOfEffect::OnCollide>(this);
+    SubscribeEvent<EVENT_ON_TRIGGER, &AreaOfEffect::OnTrigger>(this);
+    SubscribeEvent<EVENT_ON_LEFTAREA, &AreaOfEffect::OnLeftArea>(this);
     // By default AOE has a sphere shape with the range as radius
     SetCollisionShape(
         std::make_unique<Math::CollisionShape<Math::Sphere>>(Math::ShapeType::Sphere,
@@ -64,16 +64,14 @@ AreaOfEffect::AreaOfEffect() :
     // AOE usually not colliding
     collisionMask_ = 0;
     selectable_ = false;
-
-    InitializeLua();
 }
 
 AreaOfEffect::~AreaOfEffect() = default;
 
 void AreaOfEffect::InitializeLua()
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(GetLuaState());
+    luaEnv_["self"] = this;
     luaInitialized_ = true;
 }
 
@@ -95,37 +93,39 @@ Actor* AreaOfEffect::_LuaGetSource()
 
 bool AreaOfEffect::LoadScript(const std::string& fileName)
 {
+    InitializeLua();
     script_ = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script_)
         return false;
-    if (!script_->Execute(luaState_))
+    if (!luaEnv_.Execute(*script_))
         return false;
 
-    if (Lua::IsNumber(luaState_, "itemIndex"))
-        itemIndex_ = luaState_["itemIndex"];
+    if (Lua::IsNumber(luaEnv_, "itemIndex"))
+        itemIndex_ = luaEnv_["itemIndex"];
     else
         LOG_WARNING << "AOE " << fileName << " does not have an itemIndex" << std::endl;
-    if (Lua::IsNumber(luaState_, "creatureState"))
-        stateComp_.SetState(luaState_["creatureState"], true);
+    if (Lua::IsNumber(luaEnv_, "creatureState"))
+        stateComp_.SetState(luaEnv_["creatureState"], true);
     else
         stateComp_.SetState(AB::GameProtocol::CreatureState::Idle, true);
-    if (Lua::IsNumber(luaState_, "effect"))
-        skillEffect_ = luaState_["effect"];
-    if (Lua::IsNumber(luaState_, "effectTarget"))
-        effectTarget_ = luaState_["effectTarget"];
-
-    if (Lua::IsFunction(luaState_, "onUpdate"))
-        functions_ |= FunctionUpdate;
-    if (Lua::IsFunction(luaState_, "onEnded"))
-        functions_ |= FunctionEnded;
-    if (Lua::IsFunction(luaState_, "onCollide"))
-        functions_ |= FunctionOnCollide;
-    if (Lua::IsFunction(luaState_, "onTrigger"))
-        functions_ |= FunctionOnTrigger;
-    if (Lua::IsFunction(luaState_, "onLeftArea"))
-        functions_ |= FunctionOnLeftArea;
-
-    bool ret = luaState_["onInit"]();
+    if (Lua::IsNumber(luaEnv_, "effect"))
+        skillEffect_ = luaEnv_["effect"];
+    if (Lua::IsNumber(luaEnv_, "effectTarget"))
+        effectTarget_ = luaEnv_["effectTarget"];
+
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "onUpdate",
+        "onEnded",
+        "onCollide",
+        "onTrigger",
+        "onLeftArea",
+        "onInit"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
+
+    if (!HaveFunction(FunctionOnInit))
+        return false;
+    bool ret = luaEnv_.GetFunction(FunctionOnInit)();
     return ret;
 }
 
@@ -138,11 +138,11 @@ void AreaOfEffect::Update(uint32_t timeElapsed, Net::NetworkMessage& message)
     stateComp_.Write(message);
 
     if (HaveFunction(FunctionUpdate))
-        Lua::CallFunction(luaState_, "onUpdate", timeElapsed);
+        luaEnv_.CallFunction(FunctionUpdate, timeElapsed);
     if (Utils::TimeElapsed(startTime_) > lifetime_)
     {
         if (HaveFunction(FunctionEnded))
-            Lua::CallFunction(luaState_, "onEnded");
+            luaEnv_.CallFunction(FunctionEnded);
         Remove();
     }
 }
@@ -152,21 +152,21 @@ void AreaOfEffect::OnCollide(GameObject* other)
     // Called from collisionComp_ of the moving object
     // AOE can also be a trap for example
     if (HaveFunction(FunctionOnCollide))
-        Lua::CallFunction(luaState_, "onCollide", other);
+        luaEnv_.CallFunction(FunctionOnCollide, other);
 }
 
 void AreaOfEffect::OnTrigger(GameObject* other)
 {
     // AOE can also be a trap for example
     if (HaveFunction(FunctionOnTrigger))
-        Lua::CallFunction(luaState_, "onTrigger", other);
+        luaEnv_.CallFunction(FunctionOnTrigger, other);
 }
 
 void AreaOfEffect::OnLeftArea(GameObject* other)
 {
     // AOE can also be a trap for example
     if (HaveFunction(FunctionOnLeftArea))
-        Lua::CallFunction(luaState_, "onLeftArea", other);
+        luaEnv_.CallFunction(FunctionOnLeftArea, other);
 }
 
 Math::ShapeType AreaOfEffect::GetShapeType() const
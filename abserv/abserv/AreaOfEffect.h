@@ -32,17 +32,18 @@ class Actor;
 class AreaOfEffect final : public GameObject
 {
 private:
-    enum Function : uint32_t
+    enum Function : size_t
     {
-        FunctionNone = 0,
-        FunctionUpdate = 1,
-        FunctionEnded = 1 << 1,
-        FunctionOnTrigger = 1 << 2,
-        FunctionOnLeftArea = 1 << 3,
-        FunctionOnCollide = 1 << 4,
+        FunctionUpdate,
+        FunctionEnded,
+        FunctionOnCollide,
+        FunctionOnTrigger,
+        FunctionOnLeftArea,
+        FunctionOnInit,
+        FunctionCount
     };
     std::weak_ptr<Actor> source_;
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     bool luaInitialized_{ false };
     std::shared_ptr<Script> script_;
     /// Effect or skill index
@@ -50,14 +51,13 @@ private:
     Ranges range_{ Ranges::Adjecent };
     uint32_t skillEffect_{ SkillEffectNone };
     uint32_t effectTarget_{ SkillTargetNone };
-    uint32_t functions_{ FunctionNone };
     int64_t startTime_;
     // Lifetime
     uint32_t lifetime_{ std::numeric_limits<uint32_t>::max() };
     uint32_t itemIndex_{ 0 };
     bool HaveFunction(Function func) const
     {
-        return luaInitialized_ && ((functions_ & func) == func);
+        return luaInitialized_ && luaEnv_.HaveFunction(func);
     }
     void InitializeLua();
     void _LuaSetSource(Actor* source);
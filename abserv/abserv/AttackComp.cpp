@@ -68,7 +68,7 @@ void AttackComp::Hit(Actor& target)
     if (interrupted_)
     {
         lastError_ = AB::GameProtocol::AttackErrorInterrupted;
-        owner_.CallEvent<void(void)>(EVENT_ON_INTERRUPTEDATTACK);
+        owner_.CallEvent<EVENT_ON_INTERRUPTEDATTACK>();
     }
     else
     {
@@ -80,14 +80,13 @@ void AttackComp::Hit(Actor& target)
         // Source effects may modify the damage
         owner_.effectsComp_->GetDamage(damageType_, damage, critical);
         bool canGettingAttacked = true;
-        target.CallEvent<void(Actor*, DamageType, int32_t, bool&)>(EVENT_ON_ATTACKED,
-            &owner_, damageType_, damage, canGettingAttacked);
+        target.CallEvent<EVENT_ON_ATTACKED>(&owner_, damageType_, damage, canGettingAttacked);
         if (canGettingAttacked)
         {
             // Some effects may prevent attacks, e.g. blocking
             if (critical)
                 // Some effect may prevent critical hits
-                target.CallEvent<void(Actor*,bool&)>(EVENT_ON_GET_CRITICAL_HIT, &owner_, critical);
+                target.CallEvent<EVENT_ON_GET_CRITICAL_HIT>(&owner_, critical);
             if (critical)
                 damage = static_cast<int>(static_cast<float>(damage) * std::sqrt(2.0f));
             target.damageComp_->ApplyDamage(&owner_, 0, damageType_, damage, owner_.GetArmorPenetration(), true);
@@ -95,7 +94,7 @@ void AttackComp::Hit(Actor& target)
         else
         {
             lastError_ = AB::GameProtocol::AttackErrorInterrupted;
-            owner_.CallEvent<void(void)>(EVENT_ON_INTERRUPTEDATTACK);
+            owner_.CallEvent<EVENT_ON_INTERRUPTEDATTACK>();
         }
     }
 }
@@ -208,7 +207,7 @@ void AttackComp::Cancel()
 bool AttackComp::Attack(std::shared_ptr<Actor> target, bool ping)
 {
     bool canAttack = true;
-    owner_.CallEvent<void(Actor*,bool&)>(EVENT_ON_ATTACK, target.get(), canAttack);
+    owner_.CallEvent<EVENT_ON_ATTACK>(target.get(), canAttack);
     if (!canAttack)
     {
         lastError_ = AB::GameProtocol::AttackErrorInvalidTarget;
@@ -221,7 +220,7 @@ bool AttackComp::Attack(std::shared_ptr<Actor> target, bool ping)
         return false;
     }
     bool canGettingAttacked = true;
-    target->CallEvent<void(Actor*, bool&)>(EVENT_ON_GETTING_ATTACKED, &owner_, canGettingAttacked);
+    target->CallEvent<EVENT_ON_GETTING_ATTACKED>(&owner_, canGettingAttacked);
     if (target->IsUndestroyable() && canGettingAttacked)
     {
         // Can not attack an destroyable target
@@ -231,8 +230,7 @@ bool AttackComp::Attack(std::shared_ptr<Actor> target, bool ping)
 
     target_ = target;
     if (ping)
-        owner_.CallEvent<void(uint32_t, AB::GameProtocol::ObjectCallType, int)>(EVENT_ON_PINGOBJECT,
-            target ? target->id_ : 0, AB::GameProtocol::ObjectCallTypeAttack, 0);
+        owner_.CallEvent<EVENT_ON_PINGOBJECT>(target ? target->id_ : 0, AB::GameProtocol::ObjectCallTypeAttack, 0);
     attacking_ = true;
     lastAttackTime_ = 0;
     return true;
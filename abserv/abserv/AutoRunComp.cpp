@@ -36,8 +36,13 @@ namespace Components {
 AutoRunComp::AutoRunComp(Actor& owner) :
     owner_(owner)
 {
-    owner_.SubscribeEvent<void(GameObject*)>(EVENT_ON_COLLIDE, std::bind(&AutoRunComp::OnCollide, this, std::placeholders::_1));
-    owner_.SubscribeEvent<void(void)>(EVENT_ON_STUCK, std::bind(&AutoRunComp::OnStuck, this));
+    owner_.SubscribeEvent<EVENT_ON_COLLIDE, &AutoRunComp::OnCollide>(this);
+    owner_.SubscribeEvent<EVENT_ON_STUCK, &AutoRunComp::OnStuck>(this);
+}
+
+AutoRunComp::~AutoRunComp()
+{
+    RemoveFromCrowd();
 }
 
 bool AutoRunComp::Follow(std::shared_ptr<GameObject> object, bool ping, float maxDist /* = RANGE_TOUCH */)
@@ -54,12 +59,14 @@ bool AutoRunComp::Follow(std::shared_ptr<GameObject> object, bool ping, float ma
 
     following_ = actor;
     maxDist_ = maxDist;
+    if (corridor_)
+        corridor_->Reset();
     if (auto f = following_.lock())
     {
         wayPoints_.clear();
         bool succ = FindPath(f->transformation_.position_);
         if (succ && ping)
-            owner_.CallEvent<void(uint32_t,AB::GameProtocol::ObjectCallType,int)>(EVENT_ON_PINGOBJECT, actor->id_, AB::GameProtocol::ObjectCallTypeFollow, 0);
+            owner_.CallEvent<EVENT_ON_PINGOBJECT>(actor->id_, AB::GameProtocol::ObjectCallTypeFollow, 0);
         return succ;
     }
     return false;
@@ -69,6 +76,10 @@ bool AutoRunComp::Goto(const Math::Vector3& dest)
 {
     maxDist_ = AT_POSITION_THRESHOLD;
     following_.reset();
+    if (corridor_)
+        corridor_->Reset();
+    if (!destination_.Equals(dest, AT_POSITION_THRESHOLD))
+        wayPoints_.clear();
     return FindPath(dest);
 }
 
@@ -82,13 +93,19 @@ bool AutoRunComp::GotoDirection(const Math::Quaternion& direction, float distanc
 void AutoRunComp::Reset()
 {
     wayPoints_.clear();
+    // Drop the result of a pending request
+    pathPending_ = false;
+    ++pathRequestId_;
+    if (corridor_)
+        corridor_->Reset();
+    StopCrowd();
     SetAutoRun(false);
     following_.reset();
 }
 
 bool AutoRunComp::FindPath(const Math::Vector3& dest)
 {
-    if (destination_.Equals(dest, AT_POSITION_THRESHOLD) && wayPoints_.size() != 0)
+    if (destination_.Equals(dest, AT_POSITION_THRESHOLD) && (wayPoints_.size() != 0 || pathPending_))
         return true;
 
     static constexpr Math::Vector3 EXTENDS{ 1.0f, 8.0f, 1.0f };
@@ -97,24 +114,203 @@ bool AutoRunComp::FindPath(const Math::Vector3& dest)
     if (pos.Distance(dest) < maxDist_)
         return false;
 
-    std::vector<Math::Vector3> wp;
-    bool succ = owner_.GetGame()->map_->FindPath(wp, pos, dest, EXTENDS);
+    if (useCrowd_ && (crowdAgent_ != -1 || AddToCrowd()))
+        return SetCrowdTarget(dest);
+
+    auto& map = *owner_.GetGame()->map_;
+    // Fail early when we can't get there at all, everything else is up to the path finder.
+    dtPolyRef destRef = 0;
+    map.FindNearestPoint(dest, EXTENDS, nullptr, &destRef);
+    if (!destRef)
+    {
+        lastCalc_ = 0;
+        return false;
+    }
+
+    const uint32_t requestId = ++pathRequestId_;
+    pathPending_ = true;
+    destination_ = dest;
+    lastCalc_ = Utils::Tick();
+    map.FindPathAsync(pos, dest, EXTENDS,
+        [owner = std::weak_ptr<Actor>(owner_.GetPtr<Actor>()), requestId](bool success, Navigation::Path& path)
+    {
+        if (auto actor = owner.lock())
+            actor->autorunComp_->OnPathFound(requestId, success, path);
+    });
+    return true;
+}
+
+void AutoRunComp::OnPathFound(uint32_t requestId, bool success, Navigation::Path& path)
+{
+    if (requestId != pathRequestId_)
+        // There is a newer request
+        return;
+    pathPending_ = false;
 #ifdef DEBUG_NAVIGATION
     std::stringstream ss;
-    ss << "Goto from " << pos << " to " << dest << " via " << wp.size() << " waypoints:";
-    for (const auto& _wp : wp)
+    ss << "Goto from " << owner_.transformation_.position_ << " to " << destination_ << " via " << path.points.size() << " waypoints:";
+    for (const auto& _wp : path.points)
         ss << " " << _wp;
     LOG_DEBUG << ss.str() << std::endl;
 #endif
-    if (succ && wp.size() != 0)
+    if (success && path.points.size() != 0)
     {
-        wayPoints_ = wp;
-        destination_ = dest;
+        if (!following_.expired())
+        {
+            if (!corridor_)
+            {
+                if (auto navMesh = owner_.GetGame()->map_->navMesh_)
+                    corridor_ = std::make_unique<Navigation::PathCorridor>(navMesh);
+            }
+            if (corridor_)
+                corridor_->SetPath(path);
+        }
+        wayPoints_ = std::move(path.points);
         lastCalc_ = Utils::Tick();
-        return true;
+        return;
     }
     lastCalc_ = 0;
-    return false;
+    // When following we still have the old way, otherwise there is no way to get there
+    if (!HasWaypoints())
+        StopAutoRun();
+}
+
+bool AutoRunComp::UpdateCorridor(const Math::Vector3& target)
+{
+    if (!corridor_ || !corridor_->IsValid())
+        return false;
+
+    // Every now and then look for shortcuts, like we searched a new path before
+    const bool optimize = Utils::TimeElapsed(lastCalc_) > RECALCULATE_PATH_TIME;
+    if (!corridor_->Update(owner_.transformation_.position_, target, optimize, wayPoints_))
+        return false;
+
+    auto& map = *owner_.GetGame()->map_;
+    for (auto& wp : wayPoints_)
+        map.UpdatePointHeight(wp);
+    destination_ = target;
+    lastCorridorUpdate_ = Utils::Tick();
+    if (optimize)
+        lastCalc_ = lastCorridorUpdate_;
+    return true;
+}
+
+Navigation::CrowdManager* AutoRunComp::GetCrowdManager() const
+{
+    if (auto game = owner_.GetGame())
+        return game->map_->GetCrowdManager();
+    return nullptr;
+}
+
+bool AutoRunComp::AddToCrowd()
+{
+    auto* crowd = GetCrowdManager();
+    if (!crowd)
+        return false;
+    const Math::BoundingBox bb = owner_.GetWorldBoundingBox();
+    float radius = std::max(bb.max_.x_ - bb.min_.x_, bb.max_.z_ - bb.min_.z_) * 0.5f;
+    if (radius <= 0.0f || radius > RANGE_TOUCH)
+        radius = AVERAGE_BB_EXTENDS;
+    crowdAgent_ = crowd->AddAgent(owner_.id_, owner_.transformation_.position_, radius,
+        owner_.moveComp_->GetSpeed(1000, BASE_MOVE_SPEED));
+    return crowdAgent_ != -1;
+}
+
+void AutoRunComp::RemoveFromCrowd()
+{
+    if (crowdAgent_ == -1)
+        return;
+    if (auto* crowd = GetCrowdManager())
+        crowd->RemoveAgent(crowdAgent_);
+    crowdAgent_ = -1;
+    crowdMoving_ = false;
+}
+
+bool AutoRunComp::SetCrowdTarget(const Math::Vector3& dest)
+{
+    if (crowdMoving_ && destination_.Equals(dest, AT_POSITION_THRESHOLD))
+        return true;
+
+    auto* crowd = GetCrowdManager();
+    crowd->SetMaxSpeed(crowdAgent_, owner_.moveComp_->GetSpeed(1000, BASE_MOVE_SPEED));
+    if (!crowd->SetTarget(crowdAgent_, dest))
+    {
+        lastCalc_ = 0;
+        return false;
+    }
+    // The crowd finds the path
+    wayPoints_.clear();
+    pathPending_ = false;
+    ++pathRequestId_;
+    crowdMoving_ = true;
+    destination_ = dest;
+    lastCalc_ = Utils::Tick();
+    return true;
+}
+
+void AutoRunComp::StopCrowd()
+{
+    if (!crowdMoving_)
+        return;
+    crowdMoving_ = false;
+    if (auto* crowd = GetCrowdManager())
+        crowd->ResetTarget(crowdAgent_);
+}
+
+void AutoRunComp::UpdateCrowd()
+{
+    const Math::Vector3& pos = owner_.transformation_.position_;
+    if (auto f = following_.lock())
+    {
+        const Math::Vector3& target = f->transformation_.position_;
+        if (!destination_.Equals(target, AT_POSITION_THRESHOLD) &&
+            Utils::TimeElapsed(lastCorridorUpdate_) >= UPDATE_CORRIDOR_TIME)
+        {
+            lastCorridorUpdate_ = Utils::Tick();
+            SetCrowdTarget(target);
+        }
+    }
+
+    if (!crowdMoving_)
+        return;
+    if (GetCrowdManager()->IsTargetFailed(crowdAgent_))
+    {
+        // No way to get there
+        StopAutoRun();
+        return;
+    }
+    if (pos.Distance(destination_) <= maxDist_)
+    {
+        StopAutoRun();
+        owner_.CallEvent<EVENT_ON_ARRIVED>();
+    }
+}
+
+void AutoRunComp::OnCrowdUpdate(uint32_t timeElapsed)
+{
+    auto* crowd = GetCrowdManager();
+    if (autoRun_ && crowdMoving_)
+    {
+        owner_.moveComp_->SetSteeredPosition(crowd->GetPosition(crowdAgent_), crowd->GetVelocity(crowdAgent_),
+            timeElapsed);
+        return;
+    }
+    StopCrowd();
+    // Something else moved us, e.g. we were teleported, so keep the agent where we are.
+    const Math::Vector3& pos = owner_.transformation_.position_;
+    const Math::Vector3 agentPos = crowd->GetPosition(crowdAgent_);
+    if (!Math::Equals(pos.x_, agentPos.x_, Navigation::PathCorridor::MAX_DRIFT) ||
+        !Math::Equals(pos.z_, agentPos.z_, Navigation::PathCorridor::MAX_DRIFT))
+        crowd->SetPosition(crowdAgent_, pos);
+}
+
+void AutoRunComp::SetUseCrowd(bool value)
+{
+    if (useCrowd_ == value)
+        return;
+    useCrowd_ = value;
+    if (!useCrowd_)
+        RemoveFromCrowd();
 }
 
 void AutoRunComp::StopAutoRun()
@@ -140,7 +336,7 @@ void AutoRunComp::OnCollide(GameObject* other)
         {
             // If at dest reset
             StopAutoRun();
-            owner_.CallEvent<void(void)>(EVENT_ON_ARRIVED);
+            owner_.CallEvent<EVENT_ON_ARRIVED>();
         }
         else
             // If that's not the target just stop
@@ -173,7 +369,7 @@ Math::Vector3 AutoRunComp::AvoidObstaclesInternal(const Math::Vector3& destinati
 #ifdef DEBUG_NAVIGATION
     LOG_DEBUG << "Stuck: new destination " << newDest.ToString() << std::endl;
 #endif
-        owner_.CallEvent<void(void)>(EVENT_ON_STUCK);
+        owner_.CallEvent<EVENT_ON_STUCK>();
         return destination;
     }
 
@@ -248,20 +444,35 @@ void AutoRunComp::Update(uint32_t timeElapsed)
 {
     if (!autoRun_)
         return;
+    if (crowdMoving_)
+    {
+        UpdateCrowd();
+        return;
+    }
 
     const Math::Vector3& pos = owner_.transformation_.position_;
     if (auto f = following_.lock())
     {
-        if ((lastCalc_ != 0 && Utils::TimeElapsed(lastCalc_) > RECALCULATE_PATH_TIME)
-            && (!destination_.Equals(f->transformation_.position_, AT_POSITION_THRESHOLD)))
+        const Math::Vector3& target = f->transformation_.position_;
+        const bool moved = !destination_.Equals(target, AT_POSITION_THRESHOLD);
+        // The corridor gives only the next few way points, so also update it when we ran out of them
+        if (!pathPending_ &&
+            ((moved && Utils::TimeElapsed(lastCorridorUpdate_) >= UPDATE_CORRIDOR_TIME) || !HasWaypoints()))
         {
-            // Find new path when following object moved and enough time passed
-            FindPath(f->transformation_.position_);
+            if (!UpdateCorridor(target) && moved &&
+                (lastCalc_ != 0 && Utils::TimeElapsed(lastCalc_) > RECALCULATE_PATH_TIME))
+            {
+                // Find new path when following object moved too far and enough time passed
+                FindPath(target);
+            }
         }
     }
 
     if (!HasWaypoints())
     {
+        if (pathPending_)
+            // Wait for the path finder
+            return;
 #ifdef DEBUG_NAVIGATION
         LOG_DEBUG << owner_.GetName() << " has no (more) waypoints" << std::endl;
 #endif
@@ -277,7 +488,7 @@ void AutoRunComp::Update(uint32_t timeElapsed)
         {
             // If at dest reset
             StopAutoRun();
-            owner_.CallEvent<void(void)>(EVENT_ON_ARRIVED);
+            owner_.CallEvent<EVENT_ON_ARRIVED>();
         }
         return;
     }
@@ -303,6 +514,8 @@ void AutoRunComp::SetAutoRun(bool value)
     if (autoRun_ != value)
     {
         autoRun_ = value;
+        if (!autoRun_)
+            StopCrowd();
         if (Is<Player>(owner_))
         {
             // This tells the players client to switch off client prediction and use server positions instead
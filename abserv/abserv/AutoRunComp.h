@@ -22,6 +22,8 @@
 #pragma once
 
 #include <memory>
+#include "CrowdManager.h"
+#include "PathCorridor.h"
 #include <absmath/Vector3.h>
 #include <absmath/Quaternion.h>
 #include <abshared/Mechanic.h>
@@ -41,20 +43,43 @@ class AutoRunComp
     NON_COPYABLE(AutoRunComp)
 private:
     static constexpr uint32_t RECALCULATE_PATH_TIME = 1000;
+    static constexpr uint32_t UPDATE_CORRIDOR_TIME = 250;
     Actor& owner_;
     int64_t lastCalc_{ 0 };
+    int64_t lastCorridorUpdate_{ 0 };
     /// Maximum distance to consider being there
     float maxDist_{ RANGE_TOUCH };
     bool autoRun_{ false };
+    /// Waiting for the path finder
+    bool pathPending_{ false };
+    /// Results of older requests are ignored
+    uint32_t pathRequestId_{ 0 };
     std::vector<Math::Vector3> wayPoints_;
     Math::Vector3 destination_;
     std::weak_ptr<Actor> following_;
+    /// When following the path is adjusted while the target moves around
+    std::unique_ptr<Navigation::PathCorridor> corridor_;
+    /// Members of a Crowd are moved by the crowd of the map
+    bool useCrowd_{ false };
+    int crowdAgent_{ -1 };
+    /// The crowd moves us to destination_
+    bool crowdMoving_{ false };
     // Remove the first way points
     void Pop();
     // Get next waypoint
     Math::Vector3 Next();
     void MoveTo(uint32_t timeElapsed, const Math::Vector3& dest);
+    /// Request a path to dest. Returns false if there is no way to get there.
     bool FindPath(const Math::Vector3& dest);
+    void OnPathFound(uint32_t requestId, bool success, Navigation::Path& path);
+    /// Let the corridor follow the target. Returns false if we need a new path.
+    bool UpdateCorridor(const Math::Vector3& target);
+    Navigation::CrowdManager* GetCrowdManager() const;
+    bool AddToCrowd();
+    void RemoveFromCrowd();
+    bool SetCrowdTarget(const Math::Vector3& dest);
+    void StopCrowd();
+    void UpdateCrowd();
     // Stop auto running and set state to idle
     void StopAutoRun();
     void OnCollide(GameObject* other);
@@ -64,7 +89,7 @@ private:
 public:
     AutoRunComp() = delete;
     explicit AutoRunComp(Actor& owner);
-    ~AutoRunComp() = default;
+    ~AutoRunComp();
 
     bool Follow(std::shared_ptr<GameObject> object, bool ping, float maxDist = RANGE_TOUCH);
     bool Goto(const Math::Vector3& dest);
@@ -78,6 +103,10 @@ public:
     void SetAutoRun(bool value);
     bool IsAutoRun() const { return autoRun_; }
     bool IsFollowing(const Actor& actor) const;
+    void SetUseCrowd(bool value);
+    bool IsCrowdAgent() const { return crowdAgent_ != -1; }
+    /// The crowd moved all agents
+    void OnCrowdUpdate(uint32_t timeElapsed);
 };
 
 }
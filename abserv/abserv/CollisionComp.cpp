@@ -57,7 +57,7 @@ bool CollisionComp::Slide(const Math::BoundingBox& myBB, const GameObject& other
         LOG_DEBUG << "Going back to " << safePos.ToString() << std::endl;
 #endif
         GotoSafePosition();
-        owner_.CallEvent<void(void)>(EVENT_ON_STUCK);
+        owner_.CallEvent<EVENT_ON_STUCK>();
         return false;
     }
 
@@ -124,7 +124,10 @@ Iteration CollisionComp::CollisionCallback(const Math::BoundingBox& myBB,
             return Iteration::Continue;
     }
 
-    if (owner_.CollisionMaskMatches(other.GetCollisionMask()))
+    // The crowd keeps its agents apart
+    const bool crowdAgents = owner_.autorunComp_->IsCrowdAgent() &&
+        Is<Actor>(other) && To<Actor>(other).autorunComp_->IsCrowdAgent();
+    if (!crowdAgents && owner_.CollisionMaskMatches(other.GetCollisionMask()))
     {
         // Don't move the character when the object actually does not collide,
         // but we may still need the trigger stuff.
@@ -144,9 +147,9 @@ Iteration CollisionComp::CollisionCallback(const Math::BoundingBox& myBB,
 
     // Need to notify both, because we test collisions only for moving objects
     // Notify ci for colliding with us
-    other.CallEvent<void(GameObject*)>(EVENT_ON_COLLIDE, &owner_);
+    other.CallEvent<EVENT_ON_COLLIDE>(&owner_);
     // Notify us for colliding with ci
-    owner_.CallEvent<void(GameObject*)>(EVENT_ON_COLLIDE, &other);
+    owner_.CallEvent<EVENT_ON_COLLIDE>(&other);
 
     return Iteration::Continue;
 }
@@ -45,6 +45,9 @@ bool ConfigManager::Load(const std::string& file)
     config_[Key::GameIP] = Utils::ConvertStringToIP(GetGlobalString("game_ip", "0.0.0.0"));
     config_[Key::LogDir] = GetGlobalString("log_dir", "");
     config_[Key::DataDir] = GetGlobalString("data_dir", "");
+    config_[Key::ScriptCacheDir] = GetGlobalString("script_cache_dir", "cache/scripts");
+    config_[Key::WatchAssets] = GetGlobalBool("watch_assets", false);
+    config_[Key::LuaGcBudget] = static_cast<int>(GetGlobalInt("lua_gc_budget", 1000ll));
     config_[Key::RecordingsDir] = GetGlobalString("recordings_dir", "");
     config_[Key::RecordGames] = GetGlobalBool("record_games", false);
     config_[Key::GamePort] = static_cast<int>(GetGlobalInt("game_port", 0ll));
@@ -57,12 +60,14 @@ bool ConfigManager::Load(const std::string& file)
     config_[Key::MessageServerPort] = static_cast<int>(GetGlobalInt("message_port", 2771ll));
 
     config_[Key::MaxPacketsPerSecond] = static_cast<int>(GetGlobalInt("max_packets_per_second", 25ll));
+    config_[Key::CompressionThreshold] = static_cast<int>(GetGlobalInt("compression_threshold", 128ll));
 
     config_[Key::Behaviours] = GetGlobalString("behaviours", "/scripts/behaviors/behaviors.lua");
     config_[Key::AiServer] = GetGlobalBool("ai_server", false);
     config_[Key::AiServerIp] = GetGlobalString("ai_server_ip", "127.0.0.1");
     config_[Key::AiServerPort] = static_cast<int>(GetGlobalInt("ai_server_port", 12345ll));
     config_[Key::AiUpdateInterval] = static_cast<int>(GetGlobalInt("ai_server_interval", 1000ll));
+    config_[Key::AiBudget] = static_cast<int>(GetGlobalInt("ai_budget", 5000ll));
 
     Close();
     return true;
@@ -40,6 +40,9 @@ public:
 
         LogDir,
         DataDir,
+        ScriptCacheDir,
+        WatchAssets,
+        LuaGcBudget,
         RecordingsDir,
         RecordGames,
 
@@ -49,12 +52,14 @@ public:
         MessageServerPort,
 
         MaxPacketsPerSecond,
+        CompressionThreshold,
 
         Behaviours,
         AiServer,
         AiServerIp,
         AiServerPort,
-        AiUpdateInterval
+        AiUpdateInterval,
+        AiBudget
     };
 public:
     ConfigManager();
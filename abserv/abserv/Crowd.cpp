@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include "Crowd.h"
+#include "Actor.h"
 #include <algorithm>
 
 namespace Game {
@@ -28,6 +29,8 @@ namespace Game {
 void Crowd::RegisterLua(kaguya::State& state)
 {
     state["Crowd"].setClass(kaguya::UserdataMetatable<Crowd, Group>()
+        .addFunction("Add", &Crowd::_LuaAdd)
+        .addFunction("Remove", &Crowd::_LuaRemove)
     );
 }
 
@@ -39,4 +42,47 @@ Crowd::Crowd(uint32_t id) :
     Group(id)
 { }
 
+bool Crowd::_LuaAdd(Actor* actor)
+{
+    if (!actor)
+        return false;
+    return Add(actor->GetPtr<Actor>());
+}
+
+bool Crowd::_LuaRemove(Actor* actor)
+{
+    if (!actor)
+        return false;
+    return Remove(actor->id_);
+}
+
+bool Crowd::Add(std::shared_ptr<Actor> actor)
+{
+    if (!Group::Add(actor))
+        return false;
+    actor->autorunComp_->SetUseCrowd(true);
+    return true;
+}
+
+bool Crowd::Remove(uint32_t id)
+{
+    std::shared_ptr<Actor> actor;
+    for (const auto& m : members_)
+    {
+        if (auto sm = m.lock())
+        {
+            if (sm->id_ == id)
+            {
+                actor = sm;
+                break;
+            }
+        }
+    }
+    if (!Group::Remove(id))
+        return false;
+    if (actor)
+        actor->autorunComp_->SetUseCrowd(false);
+    return true;
+}
+
 }
@@ -27,13 +27,20 @@
 
 namespace Game {
 
+/// NPCs in a Crowd are moved by the crowd of the map, they avoid each other.
 class Crowd : public Group
 {
+private:
+    bool _LuaAdd(Actor* actor);
+    bool _LuaRemove(Actor* actor);
 public:
     static void RegisterLua(kaguya::State& state);
 
     Crowd();
     explicit Crowd(uint32_t id);
+
+    bool Add(std::shared_ptr<Actor> actor);
+    bool Remove(uint32_t id);
 };
 
 }
@@ -0,0 +1,177 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "stdafx.h"
+#include "CrowdManager.h"
+#include <DetourCommon.h>
+
+namespace Navigation {
+
+// Same as AutoRunComp uses for finding paths, the terrain may be quite a bit above or below the navigation mesh
+static constexpr Math::Vector3 EXTENDS{ 1.0f, 8.0f, 1.0f };
+
+CrowdManager::CrowdManager(std::shared_ptr<NavigationMesh> navMesh) :
+    navMesh_(std::move(navMesh)),
+    crowd_(dtAllocCrowd())
+{
+    crowd_->init(MAX_AGENTS, MAX_AGENT_RADIUS, navMesh_->GetNavMesh());
+    objectIds_.resize(MAX_AGENTS, 0);
+}
+
+CrowdManager::~CrowdManager()
+{
+    dtFreeCrowd(crowd_);
+}
+
+bool CrowdManager::FindNearestPoly(const Math::Vector3& pos, dtPolyRef& ref, Math::Vector3& nearest) const
+{
+    ref = 0;
+    // This query belongs to our crowd, and findNearestPoly() does not change it
+    const dtNavMeshQuery* query = crowd_->getNavMeshQuery();
+    dtStatus status = query->findNearestPoly(&pos.x_, &EXTENDS.x_, crowd_->getFilter(0), &ref, &nearest.x_);
+    return !dtStatusFailed(status) && ref != 0;
+}
+
+int CrowdManager::AddAgent(uint32_t objectId, const Math::Vector3& pos, float radius, float maxSpeed)
+{
+    dtPolyRef ref;
+    Math::Vector3 nearest;
+    if (!FindNearestPoly(pos, ref, nearest))
+        return -1;
+
+    dtCrowdAgentParams params{};
+    params.radius = std::min(radius, MAX_AGENT_RADIUS);
+    params.height = 2.0f;
+    params.maxAcceleration = 20.0f;
+    params.maxSpeed = maxSpeed;
+    params.collisionQueryRange = params.radius * 12.0f;
+    params.pathOptimizationRange = params.radius * 30.0f;
+    params.separationWeight = 2.0f;
+    params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION |
+        DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO;
+    params.obstacleAvoidanceType = 1;
+    params.queryFilterType = 0;
+
+    const int agent = crowd_->addAgent(&nearest.x_, &params);
+    if (agent == -1)
+        return -1;
+    objectIds_[static_cast<size_t>(agent)] = objectId;
+    ++agentCount_;
+    return agent;
+}
+
+void CrowdManager::RemoveAgent(int agent)
+{
+    if (agent < 0 || agent >= MAX_AGENTS || objectIds_[static_cast<size_t>(agent)] == 0)
+        return;
+    crowd_->removeAgent(agent);
+    --agentCount_;
+    objectIds_[static_cast<size_t>(agent)] = 0;
+}
+
+void CrowdManager::SetPosition(int agent, const Math::Vector3& pos)
+{
+    dtCrowdAgent* ag = crowd_->getEditableAgent(agent);
+    if (!ag || !ag->active)
+        return;
+    dtPolyRef ref;
+    Math::Vector3 nearest;
+    if (!FindNearestPoly(pos, ref, nearest))
+        return;
+    // Like dtCrowd::addAgent() places it
+    ag->corridor.reset(ref, &nearest.x_);
+    ag->boundary.reset();
+    ag->topologyOptTime = 0;
+    ag->nneis = 0;
+    ag->ncorners = 0;
+    dtVset(ag->dvel, 0.0f, 0.0f, 0.0f);
+    dtVset(ag->nvel, 0.0f, 0.0f, 0.0f);
+    dtVset(ag->vel, 0.0f, 0.0f, 0.0f);
+    dtVcopy(ag->npos, &nearest.x_);
+    ag->state = DT_CROWDAGENT_STATE_WALKING;
+    ag->targetState = DT_CROWDAGENT_TARGET_NONE;
+}
+
+void CrowdManager::SetMaxSpeed(int agent, float maxSpeed)
+{
+    const dtCrowdAgent* ag = crowd_->getAgent(agent);
+    if (!ag || !ag->active || Math::Equals(ag->params.maxSpeed, maxSpeed))
+        return;
+    dtCrowdAgentParams params = ag->params;
+    params.maxSpeed = maxSpeed;
+    crowd_->updateAgentParameters(agent, &params);
+}
+
+bool CrowdManager::SetTarget(int agent, const Math::Vector3& pos)
+{
+    dtPolyRef ref;
+    Math::Vector3 nearest;
+    if (!FindNearestPoly(pos, ref, nearest))
+        return false;
+    return crowd_->requestMoveTarget(agent, ref, &nearest.x_);
+}
+
+void CrowdManager::ResetTarget(int agent)
+{
+    crowd_->resetMoveTarget(agent);
+}
+
+bool CrowdManager::HasTarget(int agent) const
+{
+    const dtCrowdAgent* ag = crowd_->getAgent(agent);
+    if (!ag || !ag->active)
+        return false;
+    return ag->targetState != DT_CROWDAGENT_TARGET_NONE && ag->targetState != DT_CROWDAGENT_TARGET_FAILED;
+}
+
+bool CrowdManager::IsTargetFailed(int agent) const
+{
+    const dtCrowdAgent* ag = crowd_->getAgent(agent);
+    if (!ag || !ag->active)
+        return true;
+    return ag->targetState == DT_CROWDAGENT_TARGET_FAILED;
+}
+
+Math::Vector3 CrowdManager::GetPosition(int agent) const
+{
+    const dtCrowdAgent* ag = crowd_->getAgent(agent);
+    if (!ag)
+        return Math::Vector3::Zero;
+    return { ag->npos[0], ag->npos[1], ag->npos[2] };
+}
+
+Math::Vector3 CrowdManager::GetVelocity(int agent) const
+{
+    const dtCrowdAgent* ag = crowd_->getAgent(agent);
+    if (!ag)
+        return Math::Vector3::Zero;
+    return { ag->vel[0], ag->vel[1], ag->vel[2] };
+}
+
+void CrowdManager::Update(uint32_t timeElapsed)
+{
+    if (agentCount_ == 0)
+        return;
+    crowd_->update(static_cast<float>(timeElapsed) / 1000.0f, nullptr);
+}
+
+}
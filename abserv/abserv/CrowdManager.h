@@ -0,0 +1,86 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "NavigationMesh.h"
+#include <DetourCrowd.h>
+#include <absmath/Vector3.h>
+#include <memory>
+#include <sa/Iteration.h>
+#include <sa/Noncopyable.h>
+#include <vector>
+
+namespace Navigation {
+
+/// Steers the NPCs of Crowds of a game with dtCrowd. All agents are moved at once in Update(),
+/// they follow their paths and avoid each other.
+class CrowdManager
+{
+    NON_COPYABLE(CrowdManager)
+private:
+    static constexpr int MAX_AGENTS = 256;
+    static constexpr float MAX_AGENT_RADIUS = 2.0f;
+    std::shared_ptr<NavigationMesh> navMesh_;
+    dtCrowd* crowd_;
+    /// Game object ID of each agent
+    std::vector<uint32_t> objectIds_;
+    int agentCount_{ 0 };
+    bool FindNearestPoly(const Math::Vector3& pos, dtPolyRef& ref, Math::Vector3& nearest) const;
+public:
+    explicit CrowdManager(std::shared_ptr<NavigationMesh> navMesh);
+    ~CrowdManager();
+
+    /// Returns the agent index or -1 if the crowd is full or the position is not on the navigation mesh.
+    /// Speed is in units/s.
+    int AddAgent(uint32_t objectId, const Math::Vector3& pos, float radius, float maxSpeed);
+    void RemoveAgent(int agent);
+    /// Place the agent, e.g. after it was teleported.
+    void SetPosition(int agent, const Math::Vector3& pos);
+    void SetMaxSpeed(int agent, float maxSpeed);
+    /// Let the agent move to pos. The crowd finds the path.
+    bool SetTarget(int agent, const Math::Vector3& pos);
+    /// Stop moving
+    void ResetTarget(int agent);
+    bool HasTarget(int agent) const;
+    bool IsTargetFailed(int agent) const;
+    Math::Vector3 GetPosition(int agent) const;
+    Math::Vector3 GetVelocity(int agent) const;
+    /// Move all agents
+    void Update(uint32_t timeElapsed);
+    int GetAgentCount() const { return agentCount_; }
+
+    /// callback(int agent, uint32_t objectId)
+    template <typename Callback>
+    void VisitAgents(Callback&& callback)
+    {
+        for (int i = 0; i < static_cast<int>(objectIds_.size()); ++i)
+        {
+            if (objectIds_[static_cast<size_t>(i)] == 0)
+                continue;
+            if (callback(i, objectIds_[static_cast<size_t>(i)]) != Iteration::Continue)
+                break;
+        }
+    }
+};
+
+}
@@ -69,6 +69,7 @@ std::string DataProvider::GetFile(const std::string& name) const
 
 void DataProvider::CleanCache()
 {
+    std::scoped_lock lock(lock_);
     if (cache_.size() == 0)
         return;
 
@@ -81,7 +82,45 @@ void DataProvider::CleanCache()
     {
         return current.second.use_count() == 1;
     })) != cache_.end())
+    {
+        Unwatch((*i).first);
         cache_.erase(i++);
+    }
+}
+
+void DataProvider::ClearCache()
+{
+    std::scoped_lock lock(lock_);
+    for (auto& watcher : watchers_)
+        watcher.second->Stop();
+    watchers_.clear();
+    cache_.clear();
+}
+
+void DataProvider::Watch(const CacheKey& key)
+{
+    if (watchers_.find(key) != watchers_.end())
+        return;
+    auto watcher = std::make_shared<FileWatcher>(key.second);
+    watcher->onChanged_ = [this, key]()
+    {
+        LOG_INFO << "File " << key.second << " changed" << std::endl;
+        std::scoped_lock lock(lock_);
+        // Who has it keeps the old one, everyone else gets the new one
+        cache_.erase(key);
+        Unwatch(key);
+    };
+    watcher->Start();
+    watchers_.emplace(key, std::move(watcher));
+}
+
+void DataProvider::Unwatch(const CacheKey& key)
+{
+    auto it = watchers_.find(key);
+    if (it == watchers_.end())
+        return;
+    (*it).second->Stop();
+    watchers_.erase(it);
 }
 
 }
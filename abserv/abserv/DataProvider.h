@@ -24,12 +24,16 @@
 #include "Asset.h"
 #include "IOAsset.h"
 #include <abscommon/FileUtils.h>
+#include <abscommon/FileWatcher.h>
 #include <abscommon/Logger.h>
 #include <abscommon/StringUtils.h>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sa/StringHash.h>
 #include <sa/TypeName.h>
+#include <thread>
 #include <unordered_map>
 
 namespace IO {
@@ -56,8 +60,25 @@ class DataProvider
 private:
     std::map<size_t, std::unique_ptr<IOAsset>> importers_;
     std::unordered_map<CacheKey, std::shared_ptr<Asset>, KeyHasher> cache_;
+    std::unordered_map<CacheKey, std::shared_ptr<FileWatcher>, KeyHasher> watchers_;
+    /// An asset being imported, others requesting it wait for the result
+    struct Loading
+    {
+        std::thread::id thread;
+        std::shared_future<std::shared_ptr<Asset>> result;
+    };
+    std::unordered_map<CacheKey, Loading, KeyHasher> loading_;
+    /// Games load their assets on the ThreadPool, and FileWatchers run on the Dispatcher.
+    /// Guards cache_, loading_ and watchers_. It is not held while importing.
+    std::mutex lock_;
+    /// Remove the asset from the cache when the file changes, so it's loaded again
+    /// Must be called with lock_ held.
+    void Watch(const CacheKey& key);
+    void Unwatch(const CacheKey& key);
 public:
     DataProvider();
+    /// Watch the files of cached assets for changes
+    bool watchAssets_{ false };
     ~DataProvider() = default;
 
     std::string GetDataFile(const std::string& name) const;
@@ -72,6 +93,7 @@ public:
         const std::string normal_name = GetFile(Utils::NormalizeFilename(name));
         constexpr size_t hash = sa::StringHash(sa::TypeName<T>::Get());
         const CacheKey key = std::make_pair(hash, normal_name);
+        std::scoped_lock lock(lock_);
         auto it = cache_.find(key);
         if (it != cache_.end())
             return true;
@@ -83,6 +105,7 @@ public:
         const std::string normal_name = GetFile(Utils::NormalizeFilename(name));
         constexpr size_t hash = sa::StringHash(sa::TypeName<T>::Get());
         const CacheKey key = std::make_pair(hash, normal_name);
+        std::scoped_lock lock(lock_);
         auto it = cache_.find(key);
         return (it != cache_.end());
     }
@@ -94,6 +117,7 @@ public:
         const std::string normal_name = GetFile(Utils::NormalizeFilename(name));
         constexpr size_t hash = sa::StringHash(sa::TypeName<T>::Get());
         const CacheKey key = std::make_pair(hash, normal_name);
+        std::scoped_lock lock(lock_);
         auto it = cache_.find(key);
         if (it != cache_.end())
             return false;
@@ -106,10 +130,12 @@ public:
         const std::string normal_name = GetFile(Utils::NormalizeFilename(name));
         constexpr size_t hash = sa::StringHash(sa::TypeName<T>::Get());
         const CacheKey key = std::make_pair(hash, normal_name);
+        std::scoped_lock lock(lock_);
         auto it = cache_.find(key);
         if (it != cache_.end() && (*it).second.get() == asset.get())
         {
             cache_.erase(it);
+            Unwatch(key);
             return true;
         }
         return false;
@@ -120,6 +146,7 @@ public:
         const std::string normal_name = GetFile(Utils::NormalizeFilename(name));
         constexpr size_t hash = sa::StringHash(sa::TypeName<T>::Get());
         const CacheKey key = std::make_pair(hash, normal_name);
+        std::scoped_lock lock(lock_);
         auto it = cache_.find(key);
         if (it != cache_.end())
         {
@@ -128,10 +155,7 @@ public:
         return std::shared_ptr<T>();
     }
     /// Remove all objects from the cache
-    void ClearCache()
-    {
-        cache_.clear();
-    }
+    void ClearCache();
     /// Remove all objects that are only referenced by the cache, i.e. nobody
     /// else owns it anymore.
     void CleanCache();
@@ -181,28 +205,57 @@ public:
     std::shared_ptr<T> GetAsset(const std::string& name, bool cacheAble = true)
     {
         const std::string normal_name = GetFile(Utils::NormalizeFilename(name));
+        if (!cacheAble)
+        {
+            std::shared_ptr<T> asset = std::make_shared<T>();
+            if (Import<T>(*asset, normal_name))
+                return asset;
+            return std::shared_ptr<T>();
+        }
+
         constexpr size_t hash = sa::StringHash(sa::TypeName<T>::Get());
         const CacheKey key = std::make_pair(hash, normal_name);
-        // Lookup in cache
-        if (cacheAble)
+        std::promise<std::shared_ptr<Asset>> promise;
+        std::shared_future<std::shared_ptr<Asset>> loading;
         {
+            std::scoped_lock lock(lock_);
+            // Lookup in cache
             auto it = cache_.find(key);
             if (it != cache_.end())
-            {
                 return std::static_pointer_cast<T>((*it).second);
+            auto loadingIt = loading_.find(key);
+            if (loadingIt != loading_.end())
+            {
+                // The importer of this asset wants it, e.g. a script including itself
+                if ((*loadingIt).second.thread == std::this_thread::get_id())
+                    return std::shared_ptr<T>();
+                loading = (*loadingIt).second.result;
             }
+            else
+                loading_.emplace(key, Loading{ std::this_thread::get_id(), promise.get_future().share() });
         }
+        if (loading.valid())
+            // Another thread is loading it, don't load it twice
+            return std::static_pointer_cast<T>(loading.get());
 
         // Not in cache make a new one and load it
         std::shared_ptr<T> asset = std::make_shared<T>();
         assert(asset);
-        if (Import<T>(*asset, normal_name))
+        const bool imported = Import<T>(*asset, normal_name);
+        if (!imported)
+            asset.reset();
         {
-            if (cacheAble)
+            std::scoped_lock lock(lock_);
+            if (imported)
+            {
                 cache_[key] = asset;
-            return asset;
+                if (watchAssets_)
+                    Watch(key);
+            }
+            loading_.erase(key);
         }
-        return std::shared_ptr<T>();
+        promise.set_value(asset);
+        return asset;
     }
 };
 
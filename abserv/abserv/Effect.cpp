@@ -41,10 +41,10 @@ void Effect::RegisterLua(kaguya::State& state)
     );
 }
 
-void Effect::InitializeLua()
+void Effect::InitializeLua(Lua::SharedState luaState)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(luaState));
+    luaEnv_["self"] = this;
 }
 
 bool Effect::LoadScript(const std::string& fileName)
@@ -52,57 +52,41 @@ bool Effect::LoadScript(const std::string& fileName)
     script_ = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script_)
         return false;
-    if (!script_->Execute(luaState_))
+    if (!luaEnv_.Execute(*script_))
         return false;
 
-    persistent_ = luaState_["isPersistent"];
-    if (Lua::IsBool(luaState_, "internal"))
-        internal_ = luaState_["internal"];
-
-    if (Lua::IsFunction(luaState_, "onUpdate"))
-        functions_ |= FunctionUpdate;
-    if (Lua::IsFunction(luaState_, "getSkillCost"))
-        functions_ |= FunctionGetSkillCost;
-    if (Lua::IsFunction(luaState_, "getDamage"))
-        functions_ |= FunctionGetDamage;
-    if (Lua::IsFunction(luaState_, "getAttackSpeed"))
-        functions_ |= FunctionGetAttackSpeed;
-    if (Lua::IsFunction(luaState_, "getAttackDamageType"))
-        functions_ |= FunctionGetAttackDamageType;
-    if (Lua::IsFunction(luaState_, "getAttackDamage"))
-        functions_ |= FunctionGetAttackDamage;
-    if (Lua::IsFunction(luaState_, "onAttack"))
-        functions_ |= FunctionOnAttack;
-    if (Lua::IsFunction(luaState_, "onGettingAttacked"))
-        functions_ |= FunctionOnGettingAttacked;
-    if (Lua::IsFunction(luaState_, "onUseSkill"))
-        functions_ |= FunctionOnUseSkill;
-    if (Lua::IsFunction(luaState_, "onSkillTargeted"))
-        functions_ |= FunctionOnSkillTargeted;
-    if (Lua::IsFunction(luaState_, "onAttacked"))
-        functions_ |= FunctionOnAttacked;
-    if (Lua::IsFunction(luaState_, "onInterruptingAttack"))
-        functions_ |= FunctionOnInterruptingAttack;
-    if (Lua::IsFunction(luaState_, "onInterruptingSkill"))
-        functions_ |= FunctionOnInterruptingSkill;
-    if (Lua::IsFunction(luaState_, "onKnockingDown"))
-        functions_ |= FunctionOnKnockingDown;
-    if (Lua::IsFunction(luaState_, "onHealing"))
-        functions_ |= FunctionOnHealing;
-    if (Lua::IsFunction(luaState_, "onGetCriticalHit"))
-        functions_ |= FunctionOnGetCriticalHit;
-    if (Lua::IsFunction(luaState_, "getArmor"))
-        functions_ |= FunctionGetArmor;
-    if (Lua::IsFunction(luaState_, "getArmorPenetration"))
-        functions_ |= FunctionGetArmorPenetration;
-    if (Lua::IsFunction(luaState_, "getAttributeRank"))
-        functions_ |= FunctionGetAttributeRank;
-    if (Lua::IsFunction(luaState_, "getResources"))
-        functions_ |= FunctionGetResources;
-    if (Lua::IsFunction(luaState_, "getSkillRecharge"))
-        functions_ |= FunctionGetSkillRecharge;
-    if (Lua::IsFunction(luaState_, "onRemove"))
-        functions_ |= FunctionOnRemoved;
+    persistent_ = luaEnv_["isPersistent"];
+    if (Lua::IsBool(luaEnv_, "internal"))
+        internal_ = luaEnv_["internal"];
+
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "onUpdate",
+        "getSkillCost",
+        "getDamage",
+        "getAttackSpeed",
+        "getAttackDamageType",
+        "getAttackDamage",
+        "onAttack",
+        "onGettingAttacked",
+        "onUseSkill",
+        "onSkillTargeted",
+        "onAttacked",
+        "onInterruptingAttack",
+        "onInterruptingSkill",
+        "onKnockingDown",
+        "onHealing",
+        "onGetCriticalHit",
+        "getArmor",
+        "getArmorPenetration",
+        "getAttributeRank",
+        "getResources",
+        "getSkillRecharge",
+        "onRemove",
+        "getDuration",
+        "onEnd",
+        "onStart"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
     return true;
 }
 
@@ -128,10 +112,10 @@ void Effect::Update(uint32_t timeElapsed)
     auto source = source_.lock();
     auto target = target_.lock();
     if (HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](source.get(), target.get(), timeElapsed);
+        luaEnv_.GetFunction(FunctionUpdate)(source.get(), target.get(), timeElapsed);
     if (endTime_ <= Utils::Tick())
     {
-        luaState_["onEnd"](source.get(), target.get());
+        luaEnv_.CallFunction(FunctionOnEnd, source.get(), target.get());
         ended_ = true;
     }
 }
@@ -142,11 +126,11 @@ bool Effect::Start(std::shared_ptr<Actor> source, std::shared_ptr<Actor> target,
     source_ = source;
     startTime_ = Utils::Tick();
     if (time == 0)
-        ticks_ = luaState_["getDuration"](source.get(), target.get());
+        ticks_ = luaEnv_.GetFunction(FunctionGetDuration)(source.get(), target.get());
     else
         ticks_ = time;
     endTime_ = startTime_ + ticks_;
-    const bool succ = luaState_["onStart"](source.get(), target.get());
+    const bool succ = luaEnv_.GetFunction(FunctionOnStart)(source.get(), target.get());
     if (!succ)
         endTime_ = 0;
     return succ;
@@ -159,7 +143,7 @@ void Effect::Remove()
     {
         auto source = source_.lock();
         auto target = target_.lock();
-        Lua::CallFunction(luaState_, "onRemove", source.get(), target.get());
+        luaEnv_.CallFunction(FunctionOnRemoved, source.get(), target.get());
     }
     cancelled_ = true;
 }
@@ -169,7 +153,7 @@ void Effect::GetSkillRecharge(Skill* skill, uint32_t& recharge)
     if (!HaveFunction(FunctionGetSkillRecharge))
         return;
 
-    recharge = luaState_["getSkillRecharge"](skill, recharge);
+    recharge = luaEnv_.GetFunction(FunctionGetSkillRecharge)(skill, recharge);
 }
 
 void Effect::GetSkillCost(Skill* skill,
@@ -179,7 +163,7 @@ void Effect::GetSkillCost(Skill* skill,
         return;
 
     kaguya::tie(activation, energy, adrenaline, overcast, hp) =
-        luaState_["getSkillCost"](skill, activation, energy, adrenaline, overcast, hp);
+        luaEnv_.GetFunction(FunctionGetSkillCost)(skill, activation, energy, adrenaline, overcast, hp);
 }
 
 void Effect::GetDamage(DamageType type, int32_t& value, bool& critical)
@@ -188,116 +172,116 @@ void Effect::GetDamage(DamageType type, int32_t& value, bool& critical)
         return;
 
     kaguya::tie(value, critical) =
-        luaState_["getDamage"](static_cast<int>(type), value, critical);
+        luaEnv_.GetFunction(FunctionGetDamage)(static_cast<int>(type), value, critical);
 }
 
 void Effect::GetAttackSpeed(Item* weapon, uint32_t& value)
 {
     if (!HaveFunction(FunctionGetAttackSpeed))
         return;
-    value = luaState_["getAttackSpeed"](weapon, value);
+    value = luaEnv_.GetFunction(FunctionGetAttackSpeed)(weapon, value);
 }
 
 void Effect::GetAttackDamageType(DamageType& type)
 {
     if (!HaveFunction(FunctionGetAttackDamageType))
         return;
-    type = luaState_["getAttackDamageType"](type);
+    type = luaEnv_.GetFunction(FunctionGetAttackDamageType)(type);
 }
 
 void Effect::GetArmor(DamageType type, int& value)
 {
     if (!HaveFunction(FunctionGetArmor))
         return;
-    value = luaState_["getArmor"](type, value);
+    value = luaEnv_.GetFunction(FunctionGetArmor)(type, value);
 }
 
 void Effect::GetArmorPenetration(float& value)
 {
     if (!HaveFunction(FunctionGetArmorPenetration))
         return;
-    value = luaState_["getArmorPenetration"](value);
+    value = luaEnv_.GetFunction(FunctionGetArmorPenetration)(value);
 }
 
 void Effect::GetAttributeRank(Attribute index, int32_t& value)
 {
     if (!HaveFunction(FunctionGetAttributeRank))
         return;
-    value = luaState_["getAttributeRank"](static_cast<uint32_t>(index), value);
+    value = luaEnv_.GetFunction(FunctionGetAttributeRank)(static_cast<uint32_t>(index), value);
 }
 
 void Effect::GetAttackDamage(int32_t& value)
 {
     if (!HaveFunction(FunctionGetAttackDamage))
         return;
-    value = luaState_["getAttackDamage"](value);
+    value = luaEnv_.GetFunction(FunctionGetAttackDamage)(value);
 }
 
 void Effect::GetRecources(int& maxHealth, int& maxEnergy)
 {
     if (!HaveFunction(FunctionGetResources))
         return;
-    kaguya::tie(maxHealth, maxEnergy) = luaState_["getResources"](maxHealth, maxEnergy);
+    kaguya::tie(maxHealth, maxEnergy) = luaEnv_.GetFunction(FunctionGetResources)(maxHealth, maxEnergy);
 }
 
 void Effect::OnAttack(Actor* source, Actor* target, bool& value)
 {
     if (HaveFunction(FunctionOnAttack))
-        value = luaState_["onAttack"](source, target);
+        value = luaEnv_.GetFunction(FunctionOnAttack)(source, target);
 }
 
 void Effect::OnAttacked(Actor* source, Actor* target, DamageType type, int32_t damage, bool& success)
 {
     if (HaveFunction(FunctionOnAttacked))
-        success = luaState_["onAttacked"](source, target, type, damage);
+        success = luaEnv_.GetFunction(FunctionOnAttacked)(source, target, type, damage);
 }
 
 void Effect::OnGettingAttacked(Actor* source, Actor* target, bool& value)
 {
     if (HaveFunction(FunctionOnGettingAttacked))
-        value = luaState_["onGettingAttacked"](source, target);
+        value = luaEnv_.GetFunction(FunctionOnGettingAttacked)(source, target);
 }
 
 void Effect::OnUseSkill(Actor* source, Actor* target, Skill* skill, bool& value)
 {
     if (HaveFunction(FunctionOnUseSkill))
-        value = luaState_["onUseSkill"](source, target, skill);
+        value = luaEnv_.GetFunction(FunctionOnUseSkill)(source, target, skill);
 }
 
 void Effect::OnSkillTargeted(Actor* source, Actor* target, Skill* skill, bool& value)
 {
     if (HaveFunction(FunctionOnSkillTargeted))
-        value = luaState_["onSkillTargeted"](source, target, skill);
+        value = luaEnv_.GetFunction(FunctionOnSkillTargeted)(source, target, skill);
 }
 
 void Effect::OnInterruptingAttack(bool& value)
 {
     if (HaveFunction(FunctionOnInterruptingAttack))
-        value = luaState_["onInterruptingAttack"]();
+        value = luaEnv_.GetFunction(FunctionOnInterruptingAttack)();
 }
 
 void Effect::OnInterruptingSkill(AB::Entities::SkillType type, Skill* skill, bool& value)
 {
     if (HaveFunction(FunctionOnInterruptingSkill))
-        value = luaState_["onInterruptingSkill"](type, skill);
+        value = luaEnv_.GetFunction(FunctionOnInterruptingSkill)(type, skill);
 }
 
 void Effect::OnKnockingDown(Actor* source, Actor* target, uint32_t time, bool& value)
 {
     if (HaveFunction(FunctionOnKnockingDown))
-        value = luaState_["onKnockingDown"](source, target, time);
+        value = luaEnv_.GetFunction(FunctionOnKnockingDown)(source, target, time);
 }
 
 void Effect::OnGetCriticalHit(Actor* source, Actor* target, bool& value)
 {
-    if (HaveFunction(FunctionOnKnockingDown))
-        value = luaState_["onGetCriticalHit"](source, target);
+    if (HaveFunction(FunctionOnGetCriticalHit))
+        value = luaEnv_.GetFunction(FunctionOnGetCriticalHit)(source, target);
 }
 
 void Effect::OnHealing(Actor* source, Actor* target, int& value)
 {
     if (HaveFunction(FunctionOnHealing))
-        value = luaState_["onHealing"](source, target, value);
+        value = luaEnv_.GetFunction(FunctionOnHealing)(source, target, value);
 }
 
 bool Effect::Serialize(IO::PropWriteStream& stream)
@@ -27,6 +27,7 @@
 #include <AB/Entities/Effect.h>
 #include <AB/Entities/Skill.h>
 #include "Script.h"
+#include "ScriptManager.h"
 #include "Damage.h"
 #include <abshared/Attributes.h>
 
@@ -48,45 +49,47 @@ enum EffectAttr : uint8_t
 class Effect
 {
 private:
-    enum Function : uint32_t
+    enum Function : size_t
     {
-        FunctionNone         = 0,
-        FunctionUpdate       = 1,
-        FunctionGetSkillCost = 1 << 1,
-        FunctionGetDamage    = 1 << 2,
-        FunctionGetAttackSpeed = 1 << 3,
-        FunctionGetAttackDamageType = 1 << 4,
-        FunctionGetAttackDamage = 1 << 5,
-        FunctionOnAttack = 1 << 6,
-        FunctionOnGettingAttacked = 1 << 7,
-        FunctionOnUseSkill = 1 << 8,
-        FunctionOnSkillTargeted = 1 << 9,
-        FunctionOnAttacked = 1 << 10,
-        FunctionOnInterruptingAttack = 1 << 11,
-        FunctionOnInterruptingSkill = 1 << 12,
-        FunctionOnKnockingDown = 1 << 13,
-        FunctionOnHealing = 1 << 14,
-        FunctionOnGetCriticalHit = 1 << 15,
-        FunctionGetArmor = 1 << 16,
-        FunctionGetArmorPenetration = 1 << 17,
-        FunctionGetAttributeRank = 1 << 18,
-        FunctionGetResources = 1 << 19,
-        FunctionGetSkillRecharge = 1 << 20,
-        FunctionOnRemoved = 1 << 21,
+        FunctionUpdate,
+        FunctionGetSkillCost,
+        FunctionGetDamage,
+        FunctionGetAttackSpeed,
+        FunctionGetAttackDamageType,
+        FunctionGetAttackDamage,
+        FunctionOnAttack,
+        FunctionOnGettingAttacked,
+        FunctionOnUseSkill,
+        FunctionOnSkillTargeted,
+        FunctionOnAttacked,
+        FunctionOnInterruptingAttack,
+        FunctionOnInterruptingSkill,
+        FunctionOnKnockingDown,
+        FunctionOnHealing,
+        FunctionOnGetCriticalHit,
+        FunctionGetArmor,
+        FunctionGetArmorPenetration,
+        FunctionGetAttributeRank,
+        FunctionGetResources,
+        FunctionGetSkillRecharge,
+        FunctionOnRemoved,
+        FunctionGetDuration,
+        FunctionOnEnd,
+        FunctionOnStart,
+        FunctionCount
     };
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     std::shared_ptr<Script> script_;
     std::weak_ptr<Actor> target_;
     std::weak_ptr<Actor> source_;
     bool persistent_{ false };
-    uint32_t functions_{ FunctionNone };
     /// Internal effects are not visible to the player, e.g. Effects from the equipments (+armor from Armor, Shield...).
     bool internal_{ false };
     bool UnserializeProp(EffectAttr attr, IO::PropReadStream& stream);
-    void InitializeLua();
+    void InitializeLua(Lua::SharedState luaState);
     bool HaveFunction(Function func) const
     {
-        return (functions_ & func) == func;
+        return luaEnv_.HaveFunction(func);
     }
     Actor* _LuaGetTarget();
     Actor* _LuaGetSource();
@@ -94,7 +97,8 @@ public:
     static void RegisterLua(kaguya::State& state);
 
     Effect() = delete;
-    explicit Effect(const AB::Entities::Effect& effect) :
+    /// luaState is the VM of the owner
+    Effect(const AB::Entities::Effect& effect, Lua::SharedState luaState) :
         data_(effect),
         startTime_(0),
         endTime_(0),
@@ -102,7 +106,7 @@ public:
         ended_(false),
         cancelled_(false)
     {
-        InitializeLua();
+        InitializeLua(std::move(luaState));
     }
     // non-copyable
     Effect(const Effect&) = delete;
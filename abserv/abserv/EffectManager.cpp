@@ -61,13 +61,13 @@ AB::Entities::EffectCategory EffectCatNameToEffectCat(const std::string& name)
     }
 }
 
-std::shared_ptr<Effect> EffectManager::Get(uint32_t index)
+std::shared_ptr<Effect> EffectManager::Get(uint32_t index, Lua::SharedState luaState)
 {
     std::shared_ptr<Effect> result;
     auto it = effects_.find(index);
     if (it != effects_.end())
     {
-        result = std::make_shared<Effect>((*it).second);
+        result = std::make_shared<Effect>((*it).second, std::move(luaState));
     }
     else
     {
@@ -79,7 +79,7 @@ std::shared_ptr<Effect> EffectManager::Get(uint32_t index)
             LOG_ERROR << "Error reading effect with index " << index << std::endl;
             return std::shared_ptr<Effect>();
         }
-        result = std::make_shared<Effect>(effect);
+        result = std::make_shared<Effect>(effect, std::move(luaState));
         // Move to cache
         effects_.emplace(index, effect);
     }
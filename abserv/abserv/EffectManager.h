@@ -25,6 +25,7 @@
 #include <memory>
 #include <AB/Entities/Effect.h>
 #include <sa/StringHash.h>
+#include "ScriptManager.h"
 
 namespace Game {
 
@@ -54,7 +55,7 @@ public:
     EffectManager() = default;
     ~EffectManager() = default;
 
-    std::shared_ptr<Effect> Get(uint32_t index);
+    std::shared_ptr<Effect> Get(uint32_t index, Lua::SharedState luaState);
 };
 
 }
@@ -33,20 +33,18 @@ namespace Components {
 EffectsComp::EffectsComp(Actor& owner) :
     owner_(owner)
 {
-    owner_.SubscribeEvent<void(Actor*, bool&)>(EVENT_ON_GET_CRITICAL_HIT, std::bind(&EffectsComp::OnGetCriticalHit, this, std::placeholders::_1, std::placeholders::_2));
-    owner_.SubscribeEvent<void(Actor*, DamageType, int32_t, bool&)>(EVENT_ON_ATTACKED, std::bind(
-        &EffectsComp::OnAttacked, this,
-        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
-    owner_.SubscribeEvent<void(Actor*, bool&)>(EVENT_ON_GETTING_ATTACKED, std::bind(&EffectsComp::OnGettingAttacked, this, std::placeholders::_1, std::placeholders::_2));
-    owner_.SubscribeEvent<void(Actor*, bool&)>(EVENT_ON_ATTACK, std::bind(&EffectsComp::OnAttack, this, std::placeholders::_1, std::placeholders::_2));
-    owner_.SubscribeEvent<void(bool&)>(EVENT_ON_INTERRUPTING_ATTACK, std::bind(&EffectsComp::OnInterruptingAttack, this, std::placeholders::_1));
-    owner_.SubscribeEvent<void(AB::Entities::SkillType, Skill*, bool&)>(EVENT_ON_INTERRUPTING_SKILL, std::bind(&EffectsComp::OnInterruptingSkill, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    owner_.SubscribeEvent<void(Actor*, Skill*, bool&)>(EVENT_ON_USESKILL, std::bind(&EffectsComp::OnUseSkill, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    owner_.SubscribeEvent<void(Actor*, Skill*, bool&)>(EVENT_ON_SKILLTARGETED, std::bind(&EffectsComp::OnSkillTargeted, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    owner_.SubscribeEvent<void(Actor*, uint32_t, bool&)>(EVENT_ON_KNOCKING_DOWN, std::bind(&EffectsComp::OnKnockingDown, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    owner_.SubscribeEvent<void(Actor*, int&)>(EVENT_ON_HEALING, std::bind(&EffectsComp::OnHealing, this, std::placeholders::_1, std::placeholders::_2));
-    owner_.SubscribeEvent<void(int)>(EVENT_ON_INCMORALE, std::bind(&EffectsComp::OnMorale, this, std::placeholders::_1));
-    owner_.SubscribeEvent<void(int)>(EVENT_ON_DECMORALE, std::bind(&EffectsComp::OnMorale, this, std::placeholders::_1));
+    owner_.SubscribeEvent<EVENT_ON_GET_CRITICAL_HIT, &EffectsComp::OnGetCriticalHit>(this);
+    owner_.SubscribeEvent<EVENT_ON_ATTACKED, &EffectsComp::OnAttacked>(this);
+    owner_.SubscribeEvent<EVENT_ON_GETTING_ATTACKED, &EffectsComp::OnGettingAttacked>(this);
+    owner_.SubscribeEvent<EVENT_ON_ATTACK, &EffectsComp::OnAttack>(this);
+    owner_.SubscribeEvent<EVENT_ON_INTERRUPTING_ATTACK, &EffectsComp::OnInterruptingAttack>(this);
+    owner_.SubscribeEvent<EVENT_ON_INTERRUPTING_SKILL, &EffectsComp::OnInterruptingSkill>(this);
+    owner_.SubscribeEvent<EVENT_ON_USESKILL, &EffectsComp::OnUseSkill>(this);
+    owner_.SubscribeEvent<EVENT_ON_SKILLTARGETED, &EffectsComp::OnSkillTargeted>(this);
+    owner_.SubscribeEvent<EVENT_ON_KNOCKING_DOWN, &EffectsComp::OnKnockingDown>(this);
+    owner_.SubscribeEvent<EVENT_ON_HEALING, &EffectsComp::OnHealing>(this);
+    owner_.SubscribeEvent<EVENT_ON_INCMORALE, &EffectsComp::OnMorale>(this);
+    owner_.SubscribeEvent<EVENT_ON_DECMORALE, &EffectsComp::OnMorale>(this);
 }
 
 void EffectsComp::OnMorale(int morale)
@@ -88,7 +86,7 @@ bool EffectsComp::HasEffectOf(AB::Entities::EffectCategory category)
 
 void EffectsComp::AddEffect(std::shared_ptr<Actor> source, uint32_t index, uint32_t time)
 {
-    auto effect = GetSubsystem<EffectManager>()->Get(index);
+    auto effect = GetSubsystem<EffectManager>()->Get(index, owner_.GetLuaState());
     if (effect)
     {
         // Effects are not stackable:
@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include "Game.h"
+#include "AiComp.h"
 #include "AreaOfEffect.h"
 #include "ConfigManager.h"
 #include "Crowd.h"
@@ -58,7 +59,7 @@ Game::~Game()
     instanceData_.stopTime = Utils::Tick();
     UpdateEntity(instanceData_);
     players_.clear();
-    objects_.clear();
+    objects_.Clear();
     GetSubsystem<Chat>()->Remove(ChatType::Map, id_);
 }
 
@@ -163,8 +164,12 @@ void Game::RegisterLua(kaguya::State& state)
 
 void Game::InitializeLua()
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaState_ = Lua::CreateState();
+    luaEnv_.Create(luaState_);
+    luaEnv_["self"] = this;
+    luaGc_.Add(luaState_);
+    luaGcBudget_ = static_cast<uint32_t>((*GetSubsystem<ConfigManager>())[ConfigManager::Key::LuaGcBudget].GetInt());
+    aiScheduler_.SetBudget(static_cast<uint32_t>((*GetSubsystem<ConfigManager>())[ConfigManager::Key::AiBudget].GetInt()));
 }
 
 void Game::Start()
@@ -179,11 +184,22 @@ void Game::Start()
         instanceData_.name = map_->data_.name;
         LOG_INFO << "Starting game " << id_ << ", " << map_->data_.name << std::endl;
 
+        const Math::BoundingBox bounds = map_->GetBounds();
+        positionQuantizer_ = AB::Packets::Server::PositionQuantizer::FromBounds(
+            { bounds.min_.x_, bounds.min_.y_, bounds.min_.z_ },
+            { bounds.max_.x_, bounds.max_.y_, bounds.max_.z_ });
+
         if ((*config)[ConfigManager::Key::RecordGames])
         {
             writeStream_ = std::make_unique<IO::GameWriteStream>();
             if (writeStream_->Open((*config)[ConfigManager::Key::RecordingsDir], this))
+            {
                 instanceData_.recording = writeStream_->GetFilename();
+                // Recordings contain the compact transformations
+                auto msg = Net::NetworkMessage::GetNew();
+                WritePositionQuantizer(*msg);
+                writeStream_->Write(*msg);
+            }
         }
         instanceData_.running = true;
         CreateEntity(instanceData_);
@@ -203,9 +219,7 @@ void Game::Start()
         }
 
         // Initial game update
-        GetSubsystem<Asynch::Dispatcher>()->Add(
-            Asynch::CreateTask(std::bind(&Game::Update, shared_from_this()))
-        );
+        PostTask(std::bind(&Game::Update, shared_from_this()));
     }
 #ifdef DEBUG_GAME
     else
@@ -222,7 +236,7 @@ void Game::Update()
         if (lastUpdate_ == 0)
         {
             noplayerTime_ = 0;
-            Lua::CallFunction(luaState_, "onStart");
+            luaEnv_.CallFunction(FunctionOnStart);
             // Add start tick at the beginning
             gameStatus_->AddByte(AB::GameProtocol::ServerPacketType::GameStart);
             AB::Packets::Server::GameStart packet = { startTime_ };
@@ -242,24 +256,41 @@ void Game::Update()
             AB::Packets::Add(packet, *gameStatus_);
         }
 
-        // First Update all objects
+        // Find NPCs close to players before the NPCs decide whether to run their BT
+        UpdateAiSchedule();
+
+        // Paths requested in the last tick
+        map_->DeliverPaths();
+        // Move all NPCs of crowds at once, they write their new positions when they are updated
+        map_->UpdateCrowd(delta);
+
+        // Objects that moved refresh their ranges and those of their neighbours,
+        // so all objects see the same ranges when they are updated.
+        objects_.VisitAll([](const std::shared_ptr<GameObject>& o)
+        {
+            o->UpdateRanges();
+            return Iteration::Continue;
+        });
+
+        // First Update all objects. Objects added or removed meanwhile are
+        // added or removed after all objects are updated.
+        objects_.VisitAll([&](const std::shared_ptr<GameObject>& o)
         {
-            // We need a copy of the objects because the iterator may become
-            // invalid if objects are added.
-            const auto localObjs = objects_;
-            for (const auto& o : localObjs)
+            WriteObjectStatus(*o, [&](Net::NetworkMessage& message)
             {
-                if (!o.second)
-                    return;
-                o.second->Update(delta, *gameStatus_);
-            }
-        }
+                o->Update(delta, message);
+            });
+            return Iteration::Continue;
+        });
 
         // Update Octree
         map_->UpdateOctree(delta);
 
         // Then call Lua Update function
-        Lua::CallFunction(luaState_, "onUpdate", delta);
+        luaEnv_.CallFunction(FunctionOnUpdate, delta);
+
+        // Find the paths requested in this tick while we are waiting for the next tick
+        map_->DispatchPaths();
 
         // Send game status to players
         SendStatus();
@@ -282,18 +313,22 @@ void Game::Update()
             // Keep empty games for 10 seconds
             LOG_INFO << "Shutting down game " << id_ << ", " << map_->data_.name << " no players for " << noplayerTime_ << std::endl;
             SetState(ExecutionState::Terminated);
-            Lua::CallFunction(luaState_, "onStop");
+            luaEnv_.CallFunction(FunctionOnStop);
         }
 
+        // Collect garbage in the time left of this tick
+        const uint32_t elapsed = static_cast<uint32_t>(Utils::Tick() - lastUpdate_);
+        luaGc_.Update(NETWORK_TICK > elapsed ?
+            std::min(luaGcBudget_, (NETWORK_TICK - elapsed) * 1000) :
+            0);
+
         // Schedule next update
         const int64_t end = Utils::Tick();
         const uint32_t duration = static_cast<uint32_t>(end - lastUpdate_);
         const uint32_t sleepTime = NETWORK_TICK > duration ?
                     NETWORK_TICK - duration :
                     0;
-        GetSubsystem<Asynch::Scheduler>()->Add(
-            Asynch::CreateScheduledTask(sleepTime, std::bind(&Game::Update, shared_from_this()))
-        );
+        ScheduleTask(sleepTime, std::bind(&Game::Update, shared_from_this()));
 
         break;
     }
@@ -309,7 +344,46 @@ void Game::Update()
         // Do nothing
         break;
     }
-    Lua::CollectGarbage(luaState_);
+}
+
+void Game::UpdateAiSchedule()
+{
+    aiScheduler_.BeginTick();
+    const auto setLevel = [this](AI::Scheduler::Level level)
+    {
+        return [this, level](GameObject& object)
+        {
+            if (Is<Npc>(object))
+            {
+                auto& npc = To<Npc>(object);
+                if (npc.aiComp_)
+                    aiScheduler_.SetPlayerLevel(npc.aiComp_->GetSchedule(), level);
+            }
+            return Iteration::Continue;
+        };
+    };
+    VisitPlayers([&](Player* player)
+    {
+        // The aggro range is within the compass range, so it comes last
+        player->VisitInRange(Ranges::Compass, setLevel(AI::Scheduler::Level::Near));
+        player->VisitInRange(Ranges::Aggro, setLevel(AI::Scheduler::Level::Active));
+        return Iteration::Continue;
+    });
+}
+
+void Game::PostTask(std::function<void(void)>&& function)
+{
+    GetSubsystem<Asynch::Dispatcher>()->Add(Asynch::CreateTask(std::move(function)));
+}
+
+void Game::ScheduleTask(std::function<void(void)>&& function)
+{
+    GetSubsystem<Asynch::Scheduler>()->Add(Asynch::CreateScheduledTask(std::move(function)));
+}
+
+void Game::ScheduleTask(uint32_t delay, std::function<void(void)>&& function)
+{
+    GetSubsystem<Asynch::Scheduler>()->Add(Asynch::CreateScheduledTask(delay, std::move(function)));
 }
 
 void Game::SendStatus()
@@ -318,20 +392,239 @@ void Game::SendStatus()
     assert(gameStatus_->GetSize() != 0);
 
     for (const auto& p : players_)
-    {
-        // Write to buffered, auto-sent output message
-        p.second->WriteToOutput(*gameStatus_);
-    }
+        SendStatusToPlayer(*p.second);
 
     if (writeStream_ && writeStream_->IsOpen())
+    {
+        // Record everything
         writeStream_->Write(*gameStatus_);
+        for (const auto& msg : objectStatus_)
+            writeStream_->Write(*msg);
+        auto msg = Net::NetworkMessage::GetNew();
+        WriteTransformations(nullptr, true, msg, [&](int32_t required)
+        {
+            if (msg->GetSpace() >= required)
+                return;
+            writeStream_->Write(*msg);
+            msg = Net::NetworkMessage::GetNew();
+        });
+        if (msg->GetSize() != 0)
+            writeStream_->Write(*msg);
+    }
 
     ResetStatus();
 }
 
+void Game::GetInterest(const Player& player, std::vector<uint32_t>& result) const
+{
+    result.clear();
+    result.push_back(player.id_);
+    player.VisitInRange(Ranges::Compass, [&result](const GameObject& current)
+    {
+        result.push_back(current.id_);
+        return Iteration::Continue;
+    });
+    // Party members are always visible in the party window
+    if (auto party = player.GetParty())
+    {
+        party->VisitMembers([this, &result](const Actor& current)
+        {
+            if (current.GetGame().get() == this)
+                result.push_back(current.id_);
+            return Iteration::Continue;
+        });
+    }
+    // Ranges of new objects are not calculated yet
+    for (const auto& o : spawned_)
+    {
+        if (o->GetType() <= AB::GameProtocol::ObjectTypeSentToPlayer)
+            continue;
+        if (player.GetDistance(o.get()) - AVERAGE_BB_EXTENDS <= RANGE_COMPASS)
+            result.push_back(o->id_);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+void Game::SendStatusToPlayer(Player& player)
+{
+    const bool compact = player.HasProtocolCapability(AB::PROTOCOL_CAPABILITY_COMPACT_MOVEMENT);
+    auto [interest, firstStatus] = interests_.try_emplace(player.id_);
+    std::vector<uint32_t>& known = interest->second;
+    GetInterest(player, interestBuffer_);
+
+    // Changes to the game first, it starts with the time stamp
+    player.WriteToOutput(*gameStatus_);
+
+    auto msg = Net::NetworkMessage::GetNew();
+    const std::function<void(int32_t)> flush = [&](int32_t required)
+    {
+        if (msg->GetSpace() >= required)
+            return;
+        player.WriteToOutput(*msg);
+        msg = Net::NetworkMessage::GetNew();
+    };
+    if (firstStatus && compact)
+        // The player just entered, the client needs it for the transformations
+        WritePositionQuantizer(*msg);
+    const auto isSpawned = [this](uint32_t id)
+    {
+        return std::find_if(spawned_.begin(), spawned_.end(), [id](const std::shared_ptr<GameObject>& current)
+        {
+            return current->id_ == id;
+        }) != spawned_.end();
+    };
+
+    // Objects entering or leaving the interest of this player
+    auto knownIt = known.begin();
+    auto interestIt = interestBuffer_.begin();
+    while (knownIt != known.end() || interestIt != interestBuffer_.end())
+    {
+        if (interestIt == interestBuffer_.end() || (knownIt != known.end() && *knownIt < *interestIt))
+        {
+            // Removed objects were already sent to all players
+            if (objects_.Contains(*knownIt))
+            {
+                flush(512);
+                msg->AddByte(AB::GameProtocol::ServerPacketType::GameLeaveObject);
+                AB::Packets::Server::ObjectDespawn packet = {
+                    *knownIt
+                };
+                AB::Packets::Add(packet, *msg);
+            }
+            ++knownIt;
+        }
+        else if (knownIt == known.end() || *interestIt < *knownIt)
+        {
+            // Spawns of new objects are part of their status
+            if (!isSpawned(*interestIt))
+            {
+                if (const auto* o = objects_.Get(*interestIt))
+                {
+                    flush(512);
+                    msg->AddByte(AB::GameProtocol::ServerPacketType::GameSpawnObjectExisting);
+                    (*o)->WriteSpawnData(*msg);
+                }
+            }
+            ++interestIt;
+        }
+        else
+        {
+            ++knownIt;
+            ++interestIt;
+        }
+    }
+    known.assign(interestBuffer_.begin(), interestBuffer_.end());
+
+    for (const auto& span : objectSpans_)
+    {
+        if (!std::binary_search(known.begin(), known.end(), span.objectId))
+            continue;
+        flush(span.length);
+        const Net::NetworkMessage& source = *objectStatus_[span.message];
+        msg->AddBytes(reinterpret_cast<const char*>(source.GetBuffer() + Net::NetworkMessage::INITIAL_BUFFER_POSITION + span.start),
+            static_cast<uint32_t>(span.length));
+    }
+
+    WriteTransformations(&known, compact, msg, flush);
+
+    if (msg->GetSize() != 0)
+        player.WriteToOutput(*msg);
+}
+
+void Game::AddObjectTransformation(const GameObject& object, uint8_t flags)
+{
+    transformations_.push_back({
+        object.id_,
+        flags,
+        object.transformation_.position_,
+        object.transformation_.GetYRotation()
+    });
+}
+
+void Game::WriteTransformations(const std::vector<uint32_t>* interest, bool compact,
+    std::unique_ptr<Net::NetworkMessage>& message, const std::function<void(int32_t)>& flush)
+{
+    using namespace AB::Packets::Server;
+    // Max size of a compact transformation
+    static constexpr int32_t TRANSFORMATION_SIZE = 13;
+    static constexpr size_t MAX_TRANSFORMATIONS = 128;
+
+    ObjectTransformations packet;
+    const auto writePacket = [&]()
+    {
+        if (packet.objects.empty())
+            return;
+        packet.count = static_cast<uint16_t>(packet.objects.size());
+        flush(3 + static_cast<int32_t>(packet.objects.size()) * TRANSFORMATION_SIZE);
+        message->AddByte(AB::GameProtocol::ServerPacketType::GameObjectTransformations);
+        AB::Packets::Add(packet, *message);
+        packet.objects.clear();
+    };
+
+    for (const auto& t : transformations_)
+    {
+        if (interest && !std::binary_search(interest->begin(), interest->end(), t.objectId))
+            continue;
+
+        // Objects outside of the map bounds fall back to the float packets
+        std::array<int16_t, 3> pos{};
+        if (compact &&
+            (!(t.flags & (ObjectTransformationPosition | ObjectTransformationSetPosition)) ||
+                positionQuantizer_.Quantize({ t.position.x_, t.position.y_, t.position.z_ }, pos)))
+        {
+            packet.objects.push_back({
+                t.objectId,
+                t.flags,
+                pos,
+                QuantizeRotation(t.yRot)
+            });
+            if (packet.objects.size() == MAX_TRANSFORMATIONS)
+                writePacket();
+            continue;
+        }
+
+        flush(32);
+        if (t.flags & (ObjectTransformationPosition | ObjectTransformationSetPosition))
+        {
+            if (t.flags & ObjectTransformationSetPosition)
+                message->AddByte(AB::GameProtocol::ServerPacketType::GameObjectSetPosition);
+            else
+                message->AddByte(AB::GameProtocol::ServerPacketType::GameObjectPositionChange);
+            ObjectPosUpdate posPacket = {
+                t.objectId,
+                { t.position.x_, t.position.y_, t.position.z_ }
+            };
+            AB::Packets::Add(posPacket, *message);
+        }
+        if (t.flags & ObjectTransformationRotation)
+        {
+            message->AddByte(AB::GameProtocol::ServerPacketType::GameObjectRotationChange);
+            ObjectRotationUpdate rotPacket = {
+                t.objectId,
+                t.yRot,
+                (t.flags & ObjectTransformationManualRotation) != 0
+            };
+            AB::Packets::Add(rotPacket, *message);
+        }
+    }
+    writePacket();
+}
+
+void Game::WritePositionQuantizer(Net::NetworkMessage& message) const
+{
+    message.AddByte(AB::GameProtocol::ServerPacketType::GamePositionQuantizer);
+    AB::Packets::Server::PositionQuantizer packet = positionQuantizer_;
+    AB::Packets::Add(packet, message);
+}
+
 void Game::ResetStatus()
 {
     gameStatus_ = Net::NetworkMessage::GetNew();
+    objectStatus_.clear();
+    objectSpans_.clear();
+    spawned_.clear();
+    transformations_.clear();
 }
 
 Player* Game::GetPlayerById(uint32_t playerId)
@@ -353,24 +646,22 @@ Player* Game::GetPlayerByName(const std::string& name)
 void Game::AddObject(std::shared_ptr<GameObject> object)
 {
     AddObjectInternal(object);
-    Lua::CallFunction(luaState_, "onAddObject", object.get());
+    luaEnv_.CallFunction(FunctionOnAddObject, object.get());
 }
 
 void Game::AddObjectInternal(std::shared_ptr<GameObject> object)
 {
-    objects_.emplace(object->id_, object);
+    objects_.Add(object->id_, object);
     object->SetGame(shared_from_this());
 }
 
 void Game::InternalRemoveObject(GameObject* object)
 {
-    auto it = objects_.find(object->id_);
-    if (it == objects_.end())
+    if (!objects_.Contains(object->id_))
         return;
-    Lua::CallFunction(luaState_, "onRemoveObject", object);
+    luaEnv_.CallFunction(FunctionOnRemoveObject, object);
     object->SetGame(std::shared_ptr<Game>());
-    if (it != objects_.end())
-        objects_.erase(it);
+    objects_.Remove(object->id_);
 }
 
 std::shared_ptr<Npc> Game::AddNpc(const std::string& script)
@@ -381,10 +672,7 @@ std::shared_ptr<Npc> Game::AddNpc(const std::string& script)
         return std::shared_ptr<Npc>();
 
     // After all initialization is done, we can call this
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendSpawnObject,
-            shared_from_this(), result))
-    );
+    ScheduleTask(std::bind(&Game::SendSpawnObject, shared_from_this(), result));
 
     return result;
 }
@@ -405,10 +693,7 @@ std::shared_ptr<AreaOfEffect> Game::AddAreaOfEffect(const std::string& script,
         return std::shared_ptr<AreaOfEffect>();
 
     // After all initialization is done, we can call this
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendSpawnObject,
-            shared_from_this(), result))
-    );
+    ScheduleTask(std::bind(&Game::SendSpawnObject, shared_from_this(), result));
 
     return result;
 }
@@ -425,10 +710,7 @@ void Game::AddProjectile(const std::string& itemUuid,
     if (!result->Load())
         return;
 
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendSpawnObject,
-            shared_from_this(), result))
-    );
+    ScheduleTask(std::bind(&Game::SendSpawnObject, shared_from_this(), result));
 }
 
 std::shared_ptr<ItemDrop> Game::AddRandomItemDropFor(Actor* dropper, Actor* target)
@@ -488,17 +770,20 @@ void Game::SpawnItemDrop(std::shared_ptr<ItemDrop> item)
     // Also adds it to the objects array
     SendSpawnObject(item);
 
-    gameStatus_->AddByte(AB::GameProtocol::ServerPacketType::GameObjectDropItem);
-    const Item* pItem = item->GetItem();
-    AB::Packets::Server::ObjectDroppedItem packet = {
-        item->GetSourceId(),
-        item->actorId_,
-        item->id_,
-        item->GetItemIndex(),
-        static_cast<uint32_t>(pItem ? pItem->concreteItem_.count : 1u),
-        static_cast<uint16_t>(pItem ? pItem->concreteItem_.value : 0u)
-    };
-    AB::Packets::Add(packet, *gameStatus_);
+    WriteObjectStatus(*item, [&item](Net::NetworkMessage& message)
+    {
+        message.AddByte(AB::GameProtocol::ServerPacketType::GameObjectDropItem);
+        const Item* pItem = item->GetItem();
+        AB::Packets::Server::ObjectDroppedItem packet = {
+            item->GetSourceId(),
+            item->actorId_,
+            item->id_,
+            item->GetItemIndex(),
+            static_cast<uint32_t>(pItem ? pItem->concreteItem_.count : 1u),
+            static_cast<uint16_t>(pItem ? pItem->concreteItem_.value : 0u)
+        };
+        AB::Packets::Add(packet, message);
+    });
 }
 
 std::vector<Party*> Game::_LuaGetParties() const
@@ -509,8 +794,8 @@ std::vector<Party*> Game::_LuaGetParties() const
 
 void Game::CallLuaEvent(const std::string& name, GameObject* sender, GameObject* data)
 {
-    if (Lua::IsFunction(luaState_, name))
-        luaState_[name](sender, data);
+    if (Lua::IsFunction(luaEnv_, name))
+        luaEnv_[name](sender, data);
 }
 
 void Game::SetState(ExecutionState state)
@@ -554,8 +839,18 @@ void Game::Load(const std::string& mapUuid)
     script_ = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(data_.script);
     if (!script_)
         return;
-    if (!script_->Execute(luaState_))
+    if (!luaEnv_.Execute(*script_))
         return;
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "onAddObject",
+        "onPlayerJoin",
+        "onPlayerLeave",
+        "onRemoveObject",
+        "onStart",
+        "onStop",
+        "onUpdate"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
 
     auto* thPool = GetSubsystem<Asynch::ThreadPool>();
     // Load Game Assets
@@ -581,8 +876,12 @@ void Game::SendSpawnObject(std::shared_ptr<GameObject> object)
         object->transformation_.SetYRotation(p.rotation.EulerAngles().y_);
     }
 
-    gameStatus_->AddByte(AB::GameProtocol::ServerPacketType::GameSpawnObject);
-    object->WriteSpawnData(*gameStatus_);
+    WriteObjectStatus(*object, [&object](Net::NetworkMessage& message)
+    {
+        message.AddByte(AB::GameProtocol::ServerPacketType::GameSpawnObject);
+        object->WriteSpawnData(message);
+    });
+    spawned_.push_back(object);
     AddObject(object);
 }
 
@@ -597,48 +896,10 @@ void Game::SendLeaveObject(uint32_t objectId)
 
 void Game::SendInitStateToPlayer(Player& player)
 {
-    // Send all already existing objects to the player, excluding the player itself.
-    // This is sent to all players when they enter a game.
-    // Only called when the player enters a game. All spawns during the game are sent
-    // when they happen.
-    const auto write = [&player](Net::NetworkMessage& msg, const std::shared_ptr<GameObject>& o)
-    {
-        if (o->GetType() < AB::GameProtocol::ObjectTypeSentToPlayer)
-            // No need to send terrain patch to client
-            return;
-        if (o->id_ == player.id_)
-            // Don't send spawn of our self
-            return;
-
-        msg.AddByte(AB::GameProtocol::ServerPacketType::GameSpawnObjectExisting);
-        o->WriteSpawnData(msg);
-    };
-
-    auto msg = Net::NetworkMessage::GetNew();
-    for (const auto& o : objects_)
-    {
-        write(*msg, o.second);
-        // When there are many objects this may exceed the buffer size.
-        if (msg->GetSpace() < 512)
-        {
-            player.WriteToOutput(*msg);
-            msg = Net::NetworkMessage::GetNew();
-        }
-    }
-
-    // Also send queued objects
-    for (const auto& o : queuedObjects_)
-    {
-        write(*msg, o);
-        if (msg->GetSpace() < 512)
-        {
-            player.WriteToOutput(*msg);
-            msg = Net::NetworkMessage::GetNew();
-        }
-    }
-
-    if (msg->GetSize() != 0)
-        player.WriteToOutput(*msg);
+    // The client doesn't know any object yet. Objects around the player are
+    // sent with the next status, and while they come into range.
+    // Only called when the player enters a game.
+    interests_.erase(player.id_);
 }
 
 void Game::PlayerJoin(uint32_t playerId)
@@ -649,13 +910,14 @@ void Game::PlayerJoin(uint32_t playerId)
         {
             std::scoped_lock lock(lock_);
             players_[player->id_] = player.get();
+            luaGc_.Add(player->GetLuaState());
             if (AB::Entities::IsOutpost(data_.type))
                 player->data_.lastOutpostUuid = data_.uuid;
             player->data_.instanceUuid = instanceData_.uuid;
         }
         UpdateEntity(player->data_);
 
-        Lua::CallFunction(luaState_, "onPlayerJoin", player.get());
+        luaEnv_.CallFunction(FunctionOnPlayerJoin, player.get());
         SendInitStateToPlayer(*player);
 
         if (GetState() == ExecutionState::Running)
@@ -668,11 +930,7 @@ void Game::PlayerJoin(uint32_t playerId)
             queuedObjects_.push_back(player);
 
         // Notify other servers that a player joined, e.g. for friend list
-        GetSubsystem<Asynch::Scheduler>()->Add(
-            Asynch::CreateScheduledTask(std::bind(&Game::BroadcastPlayerLoggedIn,
-                shared_from_this(),
-                player))
-        );
+        ScheduleTask(std::bind(&Game::BroadcastPlayerLoggedIn, shared_from_this(), player));
     }
 }
 
@@ -680,13 +938,10 @@ void Game::RemoveObject(GameObject* object)
 {
     if (!object)
         return;
-    auto it = objects_.find(object->id_);
-    if (it == objects_.end())
+    if (!objects_.Contains(object->id_))
         return;
 
-    GetSubsystem<Asynch::Scheduler>()->Add(
-        Asynch::CreateScheduledTask(std::bind(&Game::SendLeaveObject, shared_from_this(), object->id_))
-    );
+    ScheduleTask(std::bind(&Game::SendLeaveObject, shared_from_this(), object->id_));
     InternalRemoveObject(object);
 }
 
@@ -697,25 +952,20 @@ void Game::PlayerLeave(uint32_t playerId)
     {
         std::scoped_lock lock(lock_);
         player->SetGame(std::shared_ptr<Game>());
+        luaGc_.Remove(player->GetLuaState());
         auto it = players_.find(playerId);
         if (it != players_.end())
         {
-            Lua::CallFunction(luaState_, "onPlayerLeave", player);
+            luaEnv_.CallFunction(FunctionOnPlayerLeave, player);
             players_.erase(it);
         }
         player->data_.instanceUuid = "";
         UpdateEntity(player->data_);
 
-        auto* sched = GetSubsystem<Asynch::Scheduler>();
-        sched->Add(
-            Asynch::CreateScheduledTask(std::bind(&Game::SendLeaveObject, shared_from_this(), playerId))
-        );
+        interests_.erase(playerId);
+        ScheduleTask(std::bind(&Game::SendLeaveObject, shared_from_this(), playerId));
         // Notify other servers that a player left, e.g. for friend list
-        sched->Add(
-            Asynch::CreateScheduledTask(std::bind(&Game::BroadcastPlayerLoggedOut,
-                shared_from_this(),
-                player->GetPtr<Player>()))
-        );
+        ScheduleTask(std::bind(&Game::BroadcastPlayerLoggedOut, shared_from_this(), player->GetPtr<Player>()));
         InternalRemoveObject(player);
     }
 }
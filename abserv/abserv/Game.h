@@ -21,21 +21,26 @@
 
 #pragma once
 
+#include "AiScheduler.h"
 #include "Chat.h"
 #include "Config.h"
 #include "GameObject.h"
 #include "GameStream.h"
+#include "GarbageCollector.h"
 #include "Map.h"
 #include "NavigationMesh.h"
 #include "PartyManager.h"
 #include "Script.h"
 #include <AB/Entities/Game.h>
 #include <AB/Entities/GameInstance.h>
+#include <AB/Packets/ServerPackets.h>
 #include <CleanupNs.h>
+#include <abscommon/Logger.h>
 #include <abscommon/NetworkMessage.h>
 #include <atomic>
 #include <mutex>
 #include <sa/Iteration.h>
+#include <sa/Registry.h>
 
 namespace Game {
 
@@ -46,9 +51,9 @@ class ItemDrop;
 class Projectile;
 class Crowd;
 
-/// The list which owns the objects. We use a std::map because we want to
-/// have it in the order of creation (allocation) when Update() is called.
-using ObjectList = std::map<uint32_t, std::shared_ptr<GameObject>>;
+/// The list which owns the objects. Ordered by ID because we want to have it in
+/// the order of creation (allocation) when Update() is called.
+using ObjectList = sa::Registry<uint32_t, std::shared_ptr<GameObject>>;
 using PlayersList = std::unordered_map<uint32_t, Player*>;
 using CrowdList = std::unordered_map<uint32_t, std::unique_ptr<Crowd>>;
 
@@ -71,24 +76,100 @@ private:
     ObjectList objects_;
     PlayersList players_;
     CrowdList crowds_;
-    kaguya::State luaState_;
+    enum Function : size_t
+    {
+        FunctionOnAddObject,
+        FunctionOnPlayerJoin,
+        FunctionOnPlayerLeave,
+        FunctionOnRemoveObject,
+        FunctionOnStart,
+        FunctionOnStop,
+        FunctionOnUpdate,
+        FunctionCount
+    };
+    /// VM of the game script and all objects in this game
+    Lua::SharedState luaState_;
+    Lua::Environment luaEnv_;
+    /// Collects the VMs of the game and the players in it
+    Lua::GarbageCollector luaGc_;
+    /// Time in us per tick the garbage collector may use
+    uint32_t luaGcBudget_{ 0 };
+    /// Decides which NPCs run their behavior tree in a tick
+    AI::Scheduler aiScheduler_;
     std::shared_ptr<Script> script_;
     /// First player(s) triggering the creation of this game
     std::vector<std::shared_ptr<GameObject>> queuedObjects_;
     void InitializeLua();
     void InternalLoad();
     void Update();
+    /// Find NPCs close to players
+    void UpdateAiSchedule();
     void SendStatus();
     void ResetStatus();
     /// Changes to the game are written to this message and sent to all players
     std::unique_ptr<Net::NetworkMessage> gameStatus_;
+    struct ObjectStatus
+    {
+        uint32_t objectId;
+        /// Index in objectStatus_
+        size_t message;
+        int32_t start;
+        int32_t length;
+    };
+    /// Changes of objects. Players get only the changes of the objects they are interested in.
+    std::vector<std::unique_ptr<Net::NetworkMessage>> objectStatus_;
+    std::vector<ObjectStatus> objectSpans_;
+    /// Objects spawned since the last status was sent
+    std::vector<std::shared_ptr<GameObject>> spawned_;
+    /// Player ID -> sorted IDs of objects the client knows
+    std::unordered_map<uint32_t, std::vector<uint32_t>> interests_;
+    std::vector<uint32_t> interestBuffer_;
+    /// Everything written by the callback is sent only to players interested in the object
+    template<typename Callback>
+    void WriteObjectStatus(const GameObject& object, Callback&& callback)
+    {
+        // Start a new message when an update may not fit anymore
+        if (objectStatus_.empty() || objectStatus_.back()->GetSpace() < 1024)
+            objectStatus_.push_back(Net::NetworkMessage::GetNew());
+        Net::NetworkMessage& message = *objectStatus_.back();
+        const int32_t start = message.GetSize();
+        callback(message);
+        const int32_t length = message.GetSize() - start;
+        if (length > 0)
+            objectSpans_.push_back({ object.id_, objectStatus_.size() - 1, start, length });
+    }
+    struct ObjectTransformation
+    {
+        uint32_t objectId;
+        /// AB::Packets::Server::ObjectTransformationFlags
+        uint8_t flags;
+        Math::Vector3 position;
+        float yRot;
+    };
+    /// Position and rotation changes since the last status was sent
+    std::vector<ObjectTransformation> transformations_;
+    /// Made from the map bounds when the game starts
+    AB::Packets::Server::PositionQuantizer positionQuantizer_;
+    void WritePositionQuantizer(Net::NetworkMessage& message) const;
+    /// Write the transformations of the objects in interest, or all when interest is nullptr.
+    /// flush must make sure there are at least n bytes free in message.
+    void WriteTransformations(const std::vector<uint32_t>* interest, bool compact,
+        std::unique_ptr<Net::NetworkMessage>& message, const std::function<void(int32_t)>& flush);
+    /// Get sorted IDs of the objects the player is interested in
+    void GetInterest(const Player& player, std::vector<uint32_t>& result) const;
+    void SendStatusToPlayer(Player& player);
     /// Stream to record games
     std::unique_ptr<IO::GameWriteStream> writeStream_;
+    /// Does not wait for the data server
     template<typename E>
-    bool UpdateEntity(const E& e)
+    void UpdateEntity(const E& e)
     {
         IO::DataClient* cli = GetSubsystem<IO::DataClient>();
-        return cli->Update(e);
+        cli->UpdateAsync(e, [uuid = e.uuid](bool success)
+        {
+            if (!success)
+                LOG_ERROR << "Error updating " << E::KEY() << " " << uuid << std::endl;
+        });
     }
     template<typename E>
     bool DeleteEntity(const E& e)
@@ -97,10 +178,14 @@ private:
         return cli->Delete(e);
     }
     template<typename E>
-    bool CreateEntity(const E& e)
+    void CreateEntity(const E& e)
     {
         IO::DataClient* cli = GetSubsystem<IO::DataClient>();
-        return cli->Create(e);
+        cli->CreateAsync(e, [uuid = e.uuid](bool success)
+        {
+            if (!success)
+                LOG_ERROR << "Error creating " << E::KEY() << " " << uuid << std::endl;
+        });
     }
     float _LuaGetTerrainHeight(float x, float z) const
     {
@@ -130,7 +215,7 @@ private:
     void InternalRemoveObject(GameObject* object);
     void SendSpawnObject(std::shared_ptr<GameObject> object);
     void SendLeaveObject(uint32_t objectId);
-    /// Send spawn message for all existing objects
+    /// Start sending the objects around the player
     void SendInitStateToPlayer(Player& player);
 public:
     static void RegisterLua(kaguya::State& state);
@@ -149,9 +234,17 @@ public:
     std::unique_ptr<Map> map_;
 
     int64_t GetUpdateTick() const { return lastUpdate_; }
+    /// Run a task for this game on the Dispatcher
+    void PostTask(std::function<void(void)>&& function);
+    /// Run a scheduled task for this game on the Dispatcher
+    void ScheduleTask(std::function<void(void)>&& function);
+    void ScheduleTask(uint32_t delay, std::function<void(void)>&& function);
     uint32_t GetPlayerCount() const { return static_cast<uint32_t>(players_.size()); }
+    AI::Scheduler& GetAiScheduler() { return aiScheduler_; }
     int64_t GetInstanceTime() const { return Utils::TimeElapsed(startTime_); }
     std::string GetName() const { return map_->data_.name; }
+    const Lua::SharedState& GetLuaState() const { return luaState_; }
+    const Lua::GarbageCollector::Stats& GetLuaGcStats() const { return luaGc_.GetStats(); }
     /// Default level on this map
     uint32_t GetDefaultLevel() const { return static_cast<uint32_t>(data_.defaultLevel); }
     /// Returns only players that are part of this game
@@ -161,10 +254,10 @@ public:
     template <typename T>
     T* GetObject(uint32_t id)
     {
-        auto it = objects_.find(id);
-        if (it == objects_.end())
+        const auto* object = objects_.Get(id);
+        if (!object)
             return nullptr;
-        GameObject* o = (*it).second.get();
+        GameObject* o = object->get();
         if (Is<T>(o))
             return To<T>(o);
         return nullptr;
@@ -185,6 +278,8 @@ public:
     std::shared_ptr<ItemDrop> AddRandomItemDrop(Actor* dropper);
     std::shared_ptr<ItemDrop> AddRandomItemDropFor(Actor* dropper, Actor* target);
     void SpawnItemDrop(std::shared_ptr<ItemDrop> item);
+    /// Position and rotation changes are sent together after all other changes
+    void AddObjectTransformation(const GameObject& object, uint8_t flags);
 
     ExecutionState GetState() const { return state_; }
     Net::NetworkMessage& GetGameStatus()
@@ -212,26 +307,22 @@ public:
     template<typename O = GameObject, typename Callback>
     void VisitObjects(Callback&& callback)
     {
-        for (auto& object : objects_)
+        objects_.VisitAll([&](const std::shared_ptr<GameObject>& object)
         {
-            if (object.second && Is<O>(*object.second))
-            {
-                if (callback(To<O>(*object.second)) != Iteration::Continue)
-                    break;
-            }
-        }
+            if (Is<O>(*object))
+                return callback(To<O>(*object));
+            return Iteration::Continue;
+        });
     }
     template<typename O = GameObject, typename Callback>
     void VisitObjects(Callback&& callback) const
     {
-        for (auto& object : objects_)
+        objects_.VisitAll([&](const std::shared_ptr<GameObject>& object)
         {
-            if (object.second && Is<O>(*object.second))
-            {
-                if (callback(To<O>(*object.second)) != Iteration::Continue)
-                    break;
-            }
-        }
+            if (Is<O>(*object))
+                return callback(To<O>(*object));
+            return Iteration::Continue;
+        });
     }
     template<typename Callback>
     void VisitPlayers(Callback&& callback)
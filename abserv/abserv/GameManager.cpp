@@ -106,6 +106,8 @@ std::shared_ptr<Game> GameManager::GetOrCreateInstance(const std::string& mapUui
 
 bool GameManager::InstanceExists(const std::string& uuid)
 {
+    // May be called from other threads
+    std::scoped_lock lock(lock_);
     auto it = std::find_if(games_.begin(), games_.end(), [&](auto const& current)
     {
         return Utils::Uuid::IsEqual(current.second->instanceData_.uuid, uuid);
@@ -115,6 +117,7 @@ bool GameManager::InstanceExists(const std::string& uuid)
 
 std::shared_ptr<Game> GameManager::GetInstance(const std::string& instanceUuid)
 {
+    std::scoped_lock lock(lock_);
     auto it = std::find_if(games_.begin(), games_.end(), [&](auto const& current)
     {
         return Utils::Uuid::IsEqual(current.second->instanceData_.uuid, instanceUuid);
@@ -132,22 +135,27 @@ std::shared_ptr<Game> GameManager::GetGame(const std::string& mapUuid, bool canC
         // These games are exclusive
         return CreateGame(mapUuid);
 
-    const auto it = maps_.find(mapUuid);
-    if (it == maps_.end())
-    {
-        // No instance of this map exists
-        if (!canCreate)
-            return std::shared_ptr<Game>();
-        return CreateGame(mapUuid);
-    }
-    // There are already some games with this map
-    for (const auto& g : it->second)
     {
-        if (g->GetPlayerCount() < GAME_MAX_PLAYER &&
-            (g->GetState() == Game::ExecutionState::Running || g->GetState() == Game::ExecutionState::Startup))
+        std::scoped_lock lock(lock_);
+        const auto it = maps_.find(mapUuid);
+        if (it == maps_.end())
+        {
+            // No instance of this map exists
+            if (!canCreate)
+                return std::shared_ptr<Game>();
+        }
+        else
         {
-            const auto git = games_.find(g->id_);
-            return (*git).second;
+            // There are already some games with this map
+            for (const auto& g : it->second)
+            {
+                if (g->GetPlayerCount() < GAME_MAX_PLAYER &&
+                    (g->GetState() == Game::ExecutionState::Running || g->GetState() == Game::ExecutionState::Startup))
+                {
+                    const auto git = games_.find(g->id_);
+                    return (*git).second;
+                }
+            }
         }
     }
     if (canCreate)
@@ -158,6 +166,7 @@ std::shared_ptr<Game> GameManager::GetGame(const std::string& mapUuid, bool canC
 
 std::shared_ptr<Game> GameManager::Get(uint32_t gameId)
 {
+    std::scoped_lock lock(lock_);
     auto it = games_.find(gameId);
     if (it != games_.end())
     {
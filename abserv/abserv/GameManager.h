@@ -79,6 +79,16 @@ public:
     GameManager::State GetState() const { return state_; }
     size_t GetGameCount() const { return games_.size(); }
     const std::map<uint32_t, std::shared_ptr<Game>>& GetGames() const { return games_; }
+    template<typename Callback>
+    void VisitGames(Callback&& callback)
+    {
+        std::scoped_lock lock(lock_);
+        for (const auto& game : games_)
+        {
+            if (callback(*game.second) != Iteration::Continue)
+                break;
+        }
+    }
 };
 
 }
@@ -97,57 +97,147 @@ GameObject::~GameObject()
     RemoveFromOctree();
 }
 
-void GameObject::UpdateRanges()
+uint16_t GameObject::GetRangeBands(float dist)
+{
+    uint16_t result = 0;
+    for (size_t i = 0; i < static_cast<size_t>(Ranges::Map); ++i)
+    {
+        if (dist <= RangeDistances[i])
+            result |= GetRangeBit(static_cast<Ranges>(i));
+    }
+    return result;
+}
+
+const GameObject::RangeEntry* GameObject::FindRangeEntry(uint32_t id) const
 {
+    const auto it = std::lower_bound(ranges_.begin(), ranges_.end(), id, [](const RangeEntry& current, uint32_t value)
+    {
+        return current.id < value;
+    });
+    if (it == ranges_.end() || (*it).id != id)
+        return nullptr;
+    return &(*it);
+}
+
+void GameObject::SetRangeBands(const GameObject& object, uint16_t bands)
+{
+    // Static objects and terrain are never in range
+    if (object.GetType() <= AB::GameProtocol::ObjectTypeSentToPlayer)
+        return;
+    auto it = std::lower_bound(ranges_.begin(), ranges_.end(), object.id_, [](const RangeEntry& current, uint32_t value)
+    {
+        return current.id < value;
+    });
+    const bool found = it != ranges_.end() && (*it).id == object.id_;
+    if (bands == 0)
+    {
+        if (found)
+            ranges_.erase(it);
+        return;
+    }
+    if (found)
+    {
+        (*it).bands = bands;
+        return;
+    }
+    ranges_.insert(it, {
+        object.id_,
+        bands,
+        std::const_pointer_cast<GameObject>(object.shared_from_this())
+    });
+}
+
+void GameObject::ClearRanges()
+{
+    for (const auto& o : ranges_)
+    {
+        if (auto so = o.object.lock())
+            so->SetRangeBands(*this, 0);
+    }
     ranges_.clear();
-    std::vector<GameObject*> res;
+    rangesValid_ = false;
+}
 
+void GameObject::UpdateRanges()
+{
+    // Nothing changed for us since the last time, and neighbours that moved
+    // already updated our list.
+    if (rangesValid_ && rangesPosition_ == transformation_.position_)
+        return;
+
+    rangesBuffer_.clear();
+    std::vector<GameObject*> res;
     // Compass radius
     if (QueryObjects(res, RANGE_COMPASS))
     {
         const Math::Vector3& myPos = GetPosition();
+        rangesBuffer_.reserve(res.size());
         for (const auto& o : res)
         {
-            if (o->GetType() > AB::GameProtocol::ObjectTypeSentToPlayer)
+            if (o->GetType() <= AB::GameProtocol::ObjectTypeSentToPlayer)
+                continue;
+            const float dist = myPos.Distance(o->GetPosition()) - AVERAGE_BB_EXTENDS;
+            const uint16_t bands = GetRangeBands(dist);
+            if (bands == 0)
+                continue;
+            rangesBuffer_.push_back({
+                o->id_,
+                bands,
+                o->shared_from_this()
+            });
+        }
+        std::sort(rangesBuffer_.begin(), rangesBuffer_.end(), [](const RangeEntry& lhs, const RangeEntry& rhs)
+        {
+            return lhs.id < rhs.id;
+        });
+    }
+
+    // Both lists are sorted by id, walk them together and tell only the
+    // neighbours where something changed.
+    auto oldIt = ranges_.begin();
+    auto newIt = rangesBuffer_.begin();
+    while (oldIt != ranges_.end() || newIt != rangesBuffer_.end())
+    {
+        if (newIt == rangesBuffer_.end() || (oldIt != ranges_.end() && (*oldIt).id < (*newIt).id))
+        {
+            // Left compass range
+            if (auto so = (*oldIt).object.lock())
+                so->SetRangeBands(*this, 0);
+            ++oldIt;
+        }
+        else if (oldIt == ranges_.end() || (*newIt).id < (*oldIt).id)
+        {
+            // Entered compass range
+            if (auto so = (*newIt).object.lock())
+                so->SetRangeBands(*this, (*newIt).bands);
+            ++newIt;
+        }
+        else
+        {
+            if ((*oldIt).bands != (*newIt).bands)
             {
-                auto so = o->shared_from_this();
-                const Math::Vector3& objectPos = o->GetPosition();
-                const float dist = myPos.Distance(objectPos) - AVERAGE_BB_EXTENDS;
-                if (dist <= RANGE_AGGRO)
-                    ranges_[Ranges::Aggro].push_back(so);
-                if (dist <= RANGE_COMPASS)
-                    ranges_[Ranges::Compass].push_back(so);
-                if (dist <= RANGE_SPIRIT)
-                    ranges_[Ranges::Spirit].push_back(so);
-                if (dist <= RANGE_EARSHOT)
-                    ranges_[Ranges::Earshot].push_back(so);
-                if (dist <= RANGE_CASTING)
-                    ranges_[Ranges::Casting].push_back(so);
-                if (dist <= RANGE_PROJECTILE)
-                    ranges_[Ranges::Projectile].push_back(so);
-                if (dist <= RANGE_HALF_COMPASS)
-                    ranges_[Ranges::HalfCompass].push_back(so);
-                if (dist <= RANGE_TOUCH)
-                    ranges_[Ranges::Touch].push_back(so);
-                if (dist <= RANGE_ADJECENT)
-                    ranges_[Ranges::Adjecent].push_back(so);
-                if (dist <= RANGE_VISIBLE)
-                    ranges_[Ranges::Visible].push_back(so);
+                if (auto so = (*newIt).object.lock())
+                    so->SetRangeBands(*this, (*newIt).bands);
             }
+            ++oldIt;
+            ++newIt;
         }
     }
+
+    ranges_.swap(rangesBuffer_);
+    rangesPosition_ = transformation_.position_;
+    rangesValid_ = true;
 }
 
 void GameObject::Update(uint32_t timeElapsed, Net::NetworkMessage&)
 {
-    UpdateRanges();
     if (triggerComp_)
         triggerComp_->Update(timeElapsed);
 
     if (removeAt_ != 0 && removeAt_ <= Utils::Tick())
     {
-        auto* disp = GetSubsystem<Asynch::Dispatcher>();
-        disp->Add(Asynch::CreateTask(std::bind(&GameObject::Remove, shared_from_this())));
+        if (auto game = GetGame())
+            game->PostTask(std::bind(&GameObject::Remove, shared_from_this()));
     }
 }
 
@@ -491,17 +581,10 @@ bool GameObject::IsInRange(Ranges range, const GameObject* object) const
     if (range == Ranges::Map)
         return true;
     // Don't calculate the distance now, but use previously calculated values.
-    const auto rIt = ranges_.find(range);
-    if (rIt == ranges_.end())
+    const RangeEntry* entry = FindRangeEntry(object->id_);
+    if (!entry)
         return false;
-    const auto& r = (*rIt).second;
-    const auto it = std::find_if(r.begin(), r.end(), [&object](const std::weak_ptr<GameObject>& current) -> bool
-    {
-        if (auto c = current.lock())
-            return c->id_ == object->id_;
-        return false;
-    });
-    return it != r.end();
+    return (entry->bands & GetRangeBit(range)) != 0;
 }
 
 bool GameObject::IsCloserThan(float maxDist, const GameObject* object) const
@@ -687,6 +770,14 @@ void GameObject::_LuaSetVarNumber(const std::string& name, float value)
     SetVar(name, Utils::Variant(value));
 }
 
+Lua::SharedState GameObject::GetLuaState() const
+{
+    if (auto game = GetGame())
+        return game->GetLuaState();
+    // Not in a game, must not share a VM with objects that may run on another thread
+    return Lua::CreateState();
+}
+
 Game* GameObject::_LuaGetGame()
 {
     if (auto g = game_.lock())
@@ -729,6 +820,7 @@ void GameObject::AddToOctree()
 
 void GameObject::RemoveFromOctree()
 {
+    ClearRanges();
     if (octant_)
     {
 #ifdef DEBUG_OCTREE
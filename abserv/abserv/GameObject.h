@@ -23,6 +23,7 @@
 
 #include "Damage.h"
 #include "Octree.h"
+#include "ScriptManager.h"
 #include "StateComp.h"
 #include <AB/Entities/Character.h>
 #include <AB/Entities/Skill.h>
@@ -37,7 +38,7 @@
 #include <absmath/Transformation.h>
 #include <kaguya/kaguya.hpp>
 #include <mutex>
-#include <sa/Events.h>
+#include <sa/EventTable.h>
 #include <sa/IdGenerator.h>
 #include <sa/Iteration.h>
 #include <sa/Noncopyable.h>
@@ -74,8 +75,70 @@ static constexpr sa::event_t EVENT_ON_COLLIDE = sa::StringHash("OnCollide");
 static constexpr sa::event_t EVENT_ON_LEFTAREA = sa::StringHash("OnLeftArea");
 static constexpr sa::event_t EVENT_ON_SELECTED = sa::StringHash("OnSelected");
 static constexpr sa::event_t EVENT_ON_TRIGGER = sa::StringHash("OnTrigger");
+// Actor
+static constexpr sa::event_t EVENT_ON_ARRIVED = sa::StringHash("OnArrived");
+static constexpr sa::event_t EVENT_ON_INTERRUPTEDATTACK = sa::StringHash("OnInterruptedAttack");
+static constexpr sa::event_t EVENT_ON_INTERRUPTEDSKILL = sa::StringHash("OnInterruptedSkill");
+static constexpr sa::event_t EVENT_ON_KNOCKED_DOWN = sa::StringHash("OnKnockedDown");
+static constexpr sa::event_t EVENT_ON_HEALED = sa::StringHash("OnHealed");
+static constexpr sa::event_t EVENT_ON_DIED = sa::StringHash("OnDied");
+static constexpr sa::event_t EVENT_ON_RESURRECTED = sa::StringHash("OnResurrected");
+static constexpr sa::event_t EVENT_ON_PINGOBJECT = sa::StringHash("OnPingObject");
+static constexpr sa::event_t EVENT_ON_INVENTORYFULL = sa::StringHash("OnInventoryFull");
+static constexpr sa::event_t EVENT_ON_ATTACK = sa::StringHash("OnAttack");
+static constexpr sa::event_t EVENT_ON_ATTACKED = sa::StringHash("OnAttacked");
+static constexpr sa::event_t EVENT_ON_GETTING_ATTACKED = sa::StringHash("OnGettingAttacked");
+static constexpr sa::event_t EVENT_ON_USESKILL = sa::StringHash("OnUseSkill");
+static constexpr sa::event_t EVENT_ON_SKILLTARGETED = sa::StringHash("OnSkillTargeted");
+static constexpr sa::event_t EVENT_ON_GET_CRITICAL_HIT = sa::StringHash("OnGetCriticalHit");
+static constexpr sa::event_t EVENT_ON_ENDUSESKILL = sa::StringHash("OnEndUseSkill");
+static constexpr sa::event_t EVENT_ON_STARTUSESKILL = sa::StringHash("OnStartUseSkill");
+static constexpr sa::event_t EVENT_ON_HANDLECOMMAND = sa::StringHash("OnHandleCommand");
+static constexpr sa::event_t EVENT_ON_INTERRUPTING_ATTACK = sa::StringHash("OnInterruptingAttack");
+static constexpr sa::event_t EVENT_ON_INTERRUPTING_SKILL = sa::StringHash("OnInterruptingSkill");
+static constexpr sa::event_t EVENT_ON_KNOCKING_DOWN = sa::StringHash("OnKnockingDown");
+static constexpr sa::event_t EVENT_ON_HEALING = sa::StringHash("OnHealing");
+static constexpr sa::event_t EVENT_ON_STUCK = sa::StringHash("OnStuck");
+static constexpr sa::event_t EVENT_ON_INCMORALE = sa::StringHash("OnIncMorale");
+static constexpr sa::event_t EVENT_ON_DECMORALE = sa::StringHash("OnDecMorale");
+static constexpr sa::event_t EVENT_ON_KILLEDFOE = sa::StringHash("OnKilledFoe");
+
+using GameObjectEvents = sa::EventTable<
+    sa::Event<EVENT_ON_CLICKED, void(Actor*)>,
+    sa::Event<EVENT_ON_COLLIDE, void(GameObject*)>,
+    sa::Event<EVENT_ON_LEFTAREA, void(GameObject*)>,
+    sa::Event<EVENT_ON_SELECTED, void(Actor*)>,
+    sa::Event<EVENT_ON_TRIGGER, void(GameObject*)>,
+    sa::Event<EVENT_ON_ARRIVED, void(void)>,
+    sa::Event<EVENT_ON_INTERRUPTEDATTACK, void(void)>,
+    sa::Event<EVENT_ON_INTERRUPTEDSKILL, void(Skill*)>,
+    sa::Event<EVENT_ON_KNOCKED_DOWN, void(uint32_t)>,
+    sa::Event<EVENT_ON_HEALED, void(int)>,
+    sa::Event<EVENT_ON_DIED, void(void)>,
+    sa::Event<EVENT_ON_RESURRECTED, void(int, int)>,
+    sa::Event<EVENT_ON_PINGOBJECT, void(uint32_t, AB::GameProtocol::ObjectCallType, int)>,
+    sa::Event<EVENT_ON_INVENTORYFULL, void(void)>,
+    sa::Event<EVENT_ON_ATTACK, void(Actor*, bool&)>,
+    sa::Event<EVENT_ON_ATTACKED, void(Actor*, DamageType, int32_t, bool&)>,
+    sa::Event<EVENT_ON_GETTING_ATTACKED, void(Actor*, bool&)>,
+    sa::Event<EVENT_ON_USESKILL, void(Actor*, Skill*, bool&)>,
+    sa::Event<EVENT_ON_SKILLTARGETED, void(Actor*, Skill*, bool&)>,
+    sa::Event<EVENT_ON_GET_CRITICAL_HIT, void(Actor*, bool&)>,
+    sa::Event<EVENT_ON_ENDUSESKILL, void(Skill*)>,
+    sa::Event<EVENT_ON_STARTUSESKILL, void(Skill*)>,
+    sa::Event<EVENT_ON_HANDLECOMMAND, void(AB::GameProtocol::CommandType, const std::string&, Net::NetworkMessage&)>,
+    sa::Event<EVENT_ON_INTERRUPTING_ATTACK, void(bool&)>,
+    sa::Event<EVENT_ON_INTERRUPTING_SKILL, void(AB::Entities::SkillType, Skill*, bool&)>,
+    sa::Event<EVENT_ON_KNOCKING_DOWN, void(Actor*, uint32_t, bool&)>,
+    sa::Event<EVENT_ON_HEALING, void(Actor*, int&)>,
+    sa::Event<EVENT_ON_STUCK, void(void)>,
+    sa::Event<EVENT_ON_INCMORALE, void(int)>,
+    sa::Event<EVENT_ON_DECMORALE, void(int)>,
+    sa::Event<EVENT_ON_KILLEDFOE, void(Actor*, Actor*)>
+>;
 
-using GameObjectEvents = sa::Events<
+/// For subscribers which are not member functions, e.g. from scripts
+using GameObjectDynamicEvents = sa::Events<
     void(void),
     void(uint32_t),
     void(int),
@@ -88,8 +151,8 @@ using GameObjectEvents = sa::Events<
     void(Actor*, uint32_t, bool&),
     void(Actor*, DamageType, int32_t, bool&),
     void(AB::Entities::SkillType, Skill*, bool&),
-    void(uint32_t, AB::GameProtocol::ObjectCallType, int),   // OnPingObject
-    void(Actor*, Skill*, bool&),                             // OnUseSkill, OnSkillTargeted
+    void(uint32_t, AB::GameProtocol::ObjectCallType, int),
+    void(Actor*, Skill*, bool&),
     void(Actor*, bool&),
     void(Actor*, int&),
     void(AB::GameProtocol::CommandType, const std::string&, Net::NetworkMessage&)
@@ -143,11 +206,36 @@ protected:
     Utils::VariantMap variables_;
     std::weak_ptr<Game> game_;
     GameObjectEvents events_;
+    /// Created when something subscribes a std::function
+    std::unique_ptr<GameObjectDynamicEvents> dynamicEvents_;
     /// Octree octant.
     Math::Octant* octant_{ nullptr };
     float sortValue_{ 0.0f };
-    std::map<Ranges, std::vector<std::weak_ptr<GameObject>>> ranges_;
-    void UpdateRanges();
+    /// Neighbour within compass range. Distances are symmetric, so when an
+    /// object moves it updates both its own list and the lists of its neighbours.
+    struct RangeEntry
+    {
+        uint32_t id;
+        /// Bit mask of Ranges this neighbour is in
+        uint16_t bands;
+        std::weak_ptr<GameObject> object;
+    };
+    /// Sorted by id
+    std::vector<RangeEntry> ranges_;
+    /// Reused for the next calculation, so it doesn't allocate every time
+    std::vector<RangeEntry> rangesBuffer_;
+    Math::Vector3 rangesPosition_;
+    bool rangesValid_{ false };
+    static constexpr uint16_t GetRangeBit(Ranges range)
+    {
+        return static_cast<uint16_t>(1u << static_cast<unsigned>(range));
+    }
+    static uint16_t GetRangeBands(float dist);
+    const RangeEntry* FindRangeEntry(uint32_t id) const;
+    /// Called by a neighbour when the distance to it changed. bands == 0 removes it.
+    void SetRangeBands(const GameObject& object, uint16_t bands);
+    /// Remove this object from all neighbours ranges
+    void ClearRanges();
     uint32_t GetNewId()
     {
         return objectIds_.Next();
@@ -168,6 +256,9 @@ public:
     template <typename T>
     inline std::shared_ptr<T> GetPtr();
 
+    /// Recalculate the objects in range when this object moved. Must be called
+    /// for all objects before they are updated.
+    void UpdateRanges();
     virtual void Update(uint32_t timeElapsed, Net::NetworkMessage& message);
 
     void SetBoundingSize(const Math::Vector3& size);
@@ -182,6 +273,9 @@ public:
     }
     // Returns true when the object is currently in an outpost
     bool IsInOutpost() const;
+    /// The VM in which the scripts of this object and everything it owns run.
+    /// Objects in a game share the VM of the game.
+    virtual Lua::SharedState GetLuaState() const;
     virtual void SetGame(std::shared_ptr<Game> game)
     {
         RemoveFromOctree();
@@ -222,12 +316,14 @@ public:
     template<typename Func>
     void VisitInRange(Ranges range, Func&& func) const
     {
-        const auto r = ranges_.find(range);
-        if (r == ranges_.end())
+        if (range == Ranges::Map)
             return;
-        for (const auto& o : (*r).second)
+        const uint16_t bit = GetRangeBit(range);
+        for (const auto& o : ranges_)
         {
-            if (auto so = o.lock())
+            if ((o.bands & bit) == 0)
+                continue;
+            if (auto so = o.object.lock())
                 if (func(*so) != Iteration::Continue)
                     break;
         }
@@ -280,27 +376,38 @@ public:
     /// Remove this object in time ms
     void RemoveIn(uint32_t time);
 
+    /// Subscribe a member function, e.g. SubscribeEvent<EVENT_ON_DIED, &Foo::OnDied>(foo)
+    template <sa::event_t Id, auto Method, typename T>
+    size_t SubscribeEvent(T* object)
+    {
+        return events_.Subscribe<Id>(GameObjectEvents::DelegateOf<Id>::template Make<Method>(object));
+    }
+    template <sa::event_t Id>
+    void UnsubscribeEvent(size_t index)
+    {
+        events_.Unsubscribe<Id>(index);
+    }
+    /// Subscribe something else, e.g. a Lambda. This is slower.
     template <typename Signature>
     size_t SubscribeEvent(sa::event_t id, std::function<Signature>&& func)
     {
-        return events_.Subscribe<Signature>(id, std::move(func));
+        if (!dynamicEvents_)
+            dynamicEvents_ = std::make_unique<GameObjectDynamicEvents>();
+        return dynamicEvents_->Subscribe<Signature>(id, std::move(func));
     }
     template <typename Signature>
     void UnsubscribeEvent(sa::event_t id, size_t index)
     {
-        events_.Unsubscribe<Signature>(id, index);
-    }
-    /// Call the first subscriber
-    template <typename Signature, typename... _CArgs>
-    auto CallEventOne(sa::event_t id, _CArgs&& ... _Args)
-    {
-        return events_.CallOne<Signature, _CArgs...>(id, std::forward<_CArgs>(_Args)...);
+        if (dynamicEvents_)
+            dynamicEvents_->Unsubscribe<Signature>(id, index);
     }
     /// Calls all subscribers
-    template <typename Signature, typename... _CArgs>
-    auto CallEvent(sa::event_t id, _CArgs&& ... _Args)
+    template <sa::event_t Id, typename... _CArgs>
+    void CallEvent(_CArgs&& ... _Args)
     {
-        return events_.CallAll<Signature, _CArgs...>(id, std::forward<_CArgs>(_Args)...);
+        events_.CallAll<Id>(_Args...);
+        if (dynamicEvents_)
+            dynamicEvents_->CallAll<GameObjectEvents::SignatureOf<Id>>(Id, _Args...);
     }
 
     virtual bool Serialize(IO::PropWriteStream& stream);
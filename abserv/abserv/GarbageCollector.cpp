@@ -0,0 +1,148 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stdafx.h"
+#include "GarbageCollector.h"
+#include <chrono>
+
+namespace Game {
+namespace Lua {
+
+static size_t GetMemory(lua_State* L)
+{
+    return static_cast<size_t>(lua_gc(L, LUA_GCCOUNT, 0));
+}
+
+static size_t GetThreshold(size_t memory)
+{
+    return std::max(memory * GarbageCollector::PAUSE / 100, GarbageCollector::MIN_THRESHOLD);
+}
+
+GarbageCollector::~GarbageCollector()
+{
+    for (auto& entry : states_)
+    {
+        if (auto state = entry.state.lock())
+            lua_gc(state->state(), LUA_GCRESTART, 0);
+    }
+}
+
+void GarbageCollector::Add(const SharedState& state)
+{
+    const bool exists = std::any_of(states_.begin(), states_.end(), [&state](const Entry& current)
+    {
+        return current.state.lock() == state;
+    });
+    if (exists)
+        return;
+    lua_State* L = state->state();
+    lua_gc(L, LUA_GCSTOP, 0);
+    states_.push_back({ state, GetThreshold(GetMemory(L)), false, false });
+}
+
+void GarbageCollector::Remove(const SharedState& state)
+{
+    auto it = std::find_if(states_.begin(), states_.end(), [&state](const Entry& current)
+    {
+        return current.state.lock() == state;
+    });
+    if (it == states_.end())
+        return;
+    lua_gc(state->state(), LUA_GCRESTART, 0);
+    states_.erase(it);
+}
+
+bool GarbageCollector::Step(Entry& entry, lua_State* L)
+{
+    // Returns 1 when the step finished a cycle
+    if (lua_gc(L, LUA_GCSTEP, STEP_SIZE) == 0)
+        return false;
+    entry.collecting = false;
+    entry.threshold = GetThreshold(GetMemory(L));
+    ++stats_.cycles;
+    return true;
+}
+
+void GarbageCollector::Update(uint32_t budget)
+{
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    auto elapsed = [&start]() -> uint32_t
+    {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count());
+    };
+
+    // Drop VMs whose owners are gone
+    states_.erase(std::remove_if(states_.begin(), states_.end(), [](const Entry& current)
+    {
+        return current.state.expired();
+    }), states_.end());
+
+    std::vector<std::pair<Entry*, SharedState>> active;
+    for (auto& entry : states_)
+    {
+        auto state = entry.state.lock();
+        lua_State* L = state->state();
+        const size_t memory = GetMemory(L);
+        if (entry.automatic)
+        {
+            if (memory >= entry.threshold)
+                continue;
+            lua_gc(L, LUA_GCSTOP, 0);
+            entry.automatic = false;
+            entry.collecting = false;
+            entry.threshold = GetThreshold(memory);
+        }
+        if (memory >= entry.threshold * 2)
+        {
+            // The budget is too small to keep up, don't let the heap grow without limit
+            lua_gc(L, LUA_GCRESTART, 0);
+            entry.automatic = true;
+            ++stats_.overruns;
+            continue;
+        }
+        if (!entry.collecting && memory >= entry.threshold)
+            entry.collecting = true;
+        if (entry.collecting)
+            active.push_back({ &entry, std::move(state) });
+    }
+
+    while (!active.empty() && elapsed() < budget)
+    {
+        if (next_ >= active.size())
+            next_ = 0;
+        auto& current = active[next_];
+        if (Step(*current.first, current.second->state()))
+            active.erase(active.begin() + static_cast<std::ptrdiff_t>(next_));
+        else
+            ++next_;
+    }
+
+    const uint32_t time = elapsed();
+    stats_.lastTime = time;
+    if (time > stats_.maxTime)
+        stats_.maxTime = time;
+    stats_.totalTime += time;
+    ++stats_.ticks;
+}
+
+}
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "ScriptManager.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Game {
+namespace Lua {
+
+/// Runs the garbage collectors of the Lua VMs of a Game in small incremental steps
+/// within a time budget per tick. The automatic collector of a VM is stopped while
+/// it is managed here, so no collection work happens at random points during a tick.
+/// When the budget is too small to keep up with a VM, the automatic collector of
+/// this VM runs until its heap is back to normal.
+/// Lua 5.3 has no generational mode, all VMs are collected incrementally.
+class GarbageCollector
+{
+public:
+    struct Stats
+    {
+        /// Time in us spent collecting in the last tick
+        std::atomic<uint32_t> lastTime{ 0 };
+        std::atomic<uint32_t> maxTime{ 0 };
+        std::atomic<uint64_t> totalTime{ 0 };
+        std::atomic<uint64_t> ticks{ 0 };
+        /// Number of finished collection cycles
+        std::atomic<uint64_t> cycles{ 0 };
+        /// How often the automatic collector had to take over
+        std::atomic<uint64_t> overruns{ 0 };
+    };
+private:
+    struct Entry
+    {
+        std::weak_ptr<kaguya::State> state;
+        /// Start a new cycle when the heap grows beyond this size in KB
+        size_t threshold;
+        bool collecting;
+        /// The budget wasn't enough and the automatic collector of the VM is running
+        bool automatic;
+    };
+    std::vector<Entry> states_;
+    /// Round robin, so all VMs make progress when the budget is small
+    size_t next_{ 0 };
+    Stats stats_;
+    bool Step(Entry& entry, lua_State* L);
+public:
+    /// Work done by one step in KB. Must be larger than the debt Lua
+    /// sets when the collector is stopped, otherwise a step does nothing.
+    static constexpr int STEP_SIZE = 64;
+    /// Like LUAI_GCPAUSE, a new cycle starts when the heap has doubled since the last one
+    static constexpr size_t PAUSE = 200;
+    static constexpr size_t MIN_THRESHOLD = 256;
+
+    GarbageCollector() = default;
+    ~GarbageCollector();
+
+    /// VMs are held weakly and dropped when their owner is gone
+    void Add(const SharedState& state);
+    /// Stop managing the VM, e.g. when a player leaves the game. Its automatic
+    /// collector runs again.
+    void Remove(const SharedState& state);
+    /// Do collection steps until budget (us) is used up or all VMs are done
+    void Update(uint32_t budget);
+    const Stats& GetStats() const { return stats_; }
+};
+
+}
+}
@@ -59,11 +59,9 @@ std::string GetLandingGameUuid()
         return Utils::Uuid::EMPTY_UUID;
     }
 
-    for (const std::string& uuid : gl.gameUuids)
+    for (const AB::Entities::Game& g : client->ReadMany<AB::Entities::Game>(gl.gameUuids))
     {
-        AB::Entities::Game g;
-        g.uuid = uuid;
-        if (client->Read(g) && g.landing)
+        if (g.landing)
             return g.uuid;
     }
     LOG_ERROR << "No landing game found" << std::endl;
@@ -95,14 +93,7 @@ std::vector<AB::Entities::Game> GetGameList()
         return result;
     }
 
-    for (const std::string& uuid : gl.gameUuids)
-    {
-        AB::Entities::Game g;
-        g.uuid = uuid;
-        if (!client->Read(g))
-            continue;
-        result.push_back(g);
-    }
+    result = client->ReadMany<AB::Entities::Game>(gl.gameUuids);
 
     if (result.size() == 0)
         LOG_WARNING << "No Games found!" << std::endl;
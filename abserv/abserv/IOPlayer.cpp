@@ -23,6 +23,7 @@
 #include "IOPlayer.h"
 #include "ConfigManager.h"
 #include "IOGame.h"
+#include "ItemFactory.h"
 #include "SkillManager.h"
 #include "QuestComp.h"
 #include "Player.h"
@@ -45,69 +46,72 @@ static bool LoadPlayerInventory(Game::Player& player)
 {
     IO::DataClient* client = GetSubsystem<IO::DataClient>();
 
-    // Equipment
     AB::Entities::EquippedItems equipmenet;
     equipmenet.uuid = player.data_.uuid;
-    if (client->Read(equipmenet))
-    {
-        for (const auto& e : equipmenet.itemUuids)
-            player.SetEquipment(e);
-    }
-
-    // Inventory
+    if (!client->Read(equipmenet))
+        equipmenet.itemUuids.clear();
     AB::Entities::InventoryItems inventory;
     inventory.uuid = player.data_.uuid;
-    if (client->Read(inventory))
-    {
-        for (const auto& e : inventory.itemUuids)
-            player.SetInventory(e);
-    }
-
-    // Chest
+    if (!client->Read(inventory))
+        inventory.itemUuids.clear();
     AB::Entities::ChestItems chest;
     chest.uuid = player.account_.uuid;
-    if (client->Read(chest))
-    {
-        for (const auto& e : chest.itemUuids)
-            player.SetChest(e);
-    }
+    if (!client->Read(chest))
+        chest.itemUuids.clear();
+
+    // Load all items with one request
+    std::vector<std::string> itemUuids;
+    itemUuids.reserve(equipmenet.itemUuids.size() + inventory.itemUuids.size() + chest.itemUuids.size());
+    itemUuids.insert(itemUuids.end(), equipmenet.itemUuids.begin(), equipmenet.itemUuids.end());
+    itemUuids.insert(itemUuids.end(), inventory.itemUuids.begin(), inventory.itemUuids.end());
+    itemUuids.insert(itemUuids.end(), chest.itemUuids.begin(), chest.itemUuids.end());
+    GetSubsystem<Game::ItemFactory>()->PreloadConcrete(itemUuids);
+
+    for (const auto& e : equipmenet.itemUuids)
+        player.SetEquipment(e);
+    for (const auto& e : inventory.itemUuids)
+        player.SetInventory(e);
+    for (const auto& e : chest.itemUuids)
+        player.SetChest(e);
 
     return true;
 }
 
+// Saving does not wait for the data server. The requests are executed in the order
+// they are sent, so the Invalidate follows the Update.
 static bool SavePlayerInventory(Game::Player& player)
 {
     IO::DataClient* client = GetSubsystem<IO::DataClient>();
     // Equipment
     player.inventoryComp_->VisitEquipement([client](Game::Item& item)
     {
-        client->Update(item.concreteItem_);
-        client->Invalidate(item.concreteItem_);
+        client->UpdateAsync(item.concreteItem_);
+        client->InvalidateAsync(item.concreteItem_);
         return Iteration::Continue;
     });
 
     // Inventory
     player.inventoryComp_->VisitInventory([client](Game::Item& item)
     {
-        client->Update(item.concreteItem_);
-        client->Invalidate(item.concreteItem_);
+        client->UpdateAsync(item.concreteItem_);
+        client->InvalidateAsync(item.concreteItem_);
         return Iteration::Continue;
     });
     AB::Entities::InventoryItems inventory;
     inventory.uuid = player.data_.uuid;
-    client->Invalidate(inventory);
+    client->InvalidateAsync(inventory);
 
     // Chest
     player.inventoryComp_->VisitChest([client](Game::Item& item)
     {
-        client->Update(item.concreteItem_);
-        client->Invalidate(item.concreteItem_);
+        client->UpdateAsync(item.concreteItem_);
+        client->InvalidateAsync(item.concreteItem_);
         return Iteration::Continue;
     });
 
     AB::Entities::ChestItems chest;
     chest.uuid = player.account_.uuid;
-    client->Invalidate(chest);
+    client->InvalidateAsync(chest);
     return true;
 }
 
@@ -120,22 +124,26 @@ static bool LoadQuestLog(Game::Player& player)
     if (!client->Read(ql))
         return false;
 
-    Game::Components::QuestComp& questComp = *player.questComp_;
-    for (const auto& q : ql.questUuids)
+    std::vector<AB::Entities::PlayerQuest> playerQuests;
+    std::vector<std::string> questUuids;
+    for (auto& pq : client->ReadMany<AB::Entities::PlayerQuest>(ql.questUuids))
     {
-        AB::Entities::PlayerQuest pq;
-        pq.uuid = q;
-        if (!client->Read(pq))
-            continue;
         if (pq.deleted)
             continue;
+        questUuids.push_back(pq.questUuid);
+        playerQuests.push_back(std::move(pq));
+    }
+    std::unordered_map<std::string, AB::Entities::Quest> quests;
+    for (auto& quest : client->ReadMany<AB::Entities::Quest>(questUuids))
+        quests.emplace(quest.uuid, std::move(quest));
 
-        AB::Entities::Quest quest;
-        quest.uuid = pq.questUuid;
-        if (!client->Read(quest))
+    Game::Components::QuestComp& questComp = *player.questComp_;
+    for (auto& pq : playerQuests)
+    {
+        const auto it = quests.find(pq.questUuid);
+        if (it == quests.end())
             continue;
-
-        questComp.Add(quest, std::move(pq));
+        questComp.Add((*it).second, std::move(pq));
     }
     return true;
 }
@@ -147,7 +155,7 @@ static bool SaveQuestLog(Game::Player& player)
     questComp.VisitQuests([client](Game::Quest& current)
     {
         current.SaveProgress();
-        client->UpdateOrCreate(current.playerQuest_);
+        client->UpdateOrCreateAsync(current.playerQuest_);
         return Iteration::Continue;
     });
     return true;
@@ -240,8 +248,12 @@ bool SavePlayer(Game::Player& player)
     player.data_.profession2Uuid = player.skills_->prof2_.uuid;
     player.data_.skillTemplate = player.skills_->Encode();
     player.data_.onlineTime += static_cast<int64_t>((player.logoutTime_ - player.loginTime_) / 1000);
-    if (!client->Update(player.data_))
-        return false;
+    const std::string uuid = player.data_.uuid;
+    client->UpdateAsync(player.data_, [uuid](bool success)
+    {
+        if (!success)
+            LOG_ERROR << "Error saving player " << uuid << std::endl;
+    });
     if (!SavePlayerInventory(player))
         return false;
     if (!SaveQuestLog(player))
@@ -21,23 +21,169 @@
 
 #include "stdafx.h"
 #include "IOScript.h"
+#include "ConfigManager.h"
+#include <abscommon/UuidUtils.h>
 #include <lua.hpp>
 #include <llimits.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
 
 namespace IO {
 
-static int writer(lua_State*, const void* p, size_t size, void* u)
+namespace {
+
+struct CacheHeader
+{
+    char magic[4];
+    uint32_t luaVersion;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    uint32_t nameSize;
+};
+
+constexpr char CACHE_MAGIC[4] = { 'A', 'B', 'S', 'C' };
+
+int writer(lua_State*, const void* p, size_t size, void* u)
 {
     if (size == 0)
         return 1;
     const char* addr = reinterpret_cast<const char*>(p);
-    std::vector<char>& buffer = reinterpret_cast<Game::Script*>(u)->GetBuffer();
+    std::vector<char>& buffer = *reinterpret_cast<std::vector<char>*>(u);
     std::copy(addr, addr + size, std::back_inserter(buffer));
     return 0;
 }
 
+/// The modification time is not reliable, e.g. after a checkout or when copying
+/// files, so the content of the source decides whether the byte code is current.
+bool GetSourceInfo(const std::string& name, uint64_t& hash, uint64_t& size)
+{
+    std::ifstream input(name, std::ios::binary);
+    if (!input.is_open())
+        return false;
+    const std::string source((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    hash = static_cast<uint64_t>(sa::StringHashRt(source.data(), source.size()));
+    size = static_cast<uint64_t>(source.size());
+    return true;
+}
+
+/// Header of the byte code this Lua library writes: Signature, version, format,
+/// LUAC_DATA, sizes of int, size_t, Instruction, lua_Integer and lua_Number,
+/// LUAC_INT and LUAC_NUM. Byte code with another header can not be loaded.
+const std::string& GetLuaHeader()
+{
+    static const std::string header = []()
+    {
+        static constexpr size_t HEADER_SIZE = (sizeof(LUA_SIGNATURE) - 1) + 2 + 6 + 5 +
+            sizeof(lua_Integer) + sizeof(lua_Number);
+        std::vector<char> byteCode;
+        lua_State* L = luaL_newstate();
+        if (luaL_loadstring(L, "") == LUA_OK)
+            lua_dump(L, writer, &byteCode, 1);
+        lua_close(L);
+        if (byteCode.size() < HEADER_SIZE)
+            return std::string();
+        return std::string(byteCode.data(), HEADER_SIZE);
+    }();
+    return header;
+}
+
+}
+
+bool IOScript::LoadCached(Game::Script& asset, const std::string& name, const std::string& cacheFile)
+{
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    if (!GetSourceInfo(name, sourceHash, sourceSize))
+        return false;
+
+    std::ifstream input(cacheFile, std::ios::binary);
+    if (!input.is_open())
+        return false;
+    CacheHeader header;
+    if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.luaVersion != LUA_VERSION_NUM ||
+        header.sourceHash != sourceHash || header.sourceSize != sourceSize ||
+        header.nameSize != name.size())
+        return false;
+    std::string cachedName(header.nameSize, '\0');
+    if (!input.read(cachedName.data(), static_cast<std::streamsize>(cachedName.size())) || cachedName != name)
+        // Different file with the same hash
+        return false;
+
+    std::vector<char>& buffer = asset.GetBuffer();
+    buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    // Written by another Lua version or build
+    const std::string& luaHeader = GetLuaHeader();
+    if (luaHeader.empty() || buffer.size() <= luaHeader.size() ||
+        memcmp(buffer.data(), luaHeader.data(), luaHeader.size()) != 0)
+    {
+        buffer.clear();
+        return false;
+    }
+    // Truncated or damaged
+    lua_State* L = luaL_newstate();
+    const bool valid = luaL_loadbufferx(L, buffer.data(), buffer.size(), name.c_str(), "b") == LUA_OK;
+    lua_close(L);
+    if (!valid)
+    {
+        LOG_WARNING << "Invalid script cache " << cacheFile << " of " << name << std::endl;
+        buffer.clear();
+        return false;
+    }
+    return true;
+}
+
+void IOScript::SaveCached(const Game::Script& asset, const std::string& name, const std::string& cacheFile)
+{
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.luaVersion = LUA_VERSION_NUM;
+    if (!GetSourceInfo(name, header.sourceHash, header.sourceSize))
+        return;
+    header.nameSize = static_cast<uint32_t>(name.size());
+
+    std::error_code ec;
+    fs::create_directories(fs::path(cacheFile).parent_path(), ec);
+    // Several servers may share the cache directory, write it to a temporary file
+    // and rename it, so nobody reads a half written file.
+    const std::string tmpFile = cacheFile + "." + Utils::Uuid::New() + ".tmp";
+    {
+        std::ofstream output(tmpFile, std::ios::binary | std::ios::trunc);
+        if (!output.is_open())
+        {
+            LOG_WARNING << "Unable to write script cache " << tmpFile << std::endl;
+            return;
+        }
+        const auto& buffer = asset.GetBuffer();
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(name.data(), static_cast<std::streamsize>(name.size()));
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+    fs::rename(tmpFile, cacheFile, ec);
+    if (ec)
+        fs::remove(tmpFile, ec);
+}
+
 bool IOScript::Import(Game::Script& asset, const std::string& name)
 {
+    const std::string& cacheDir = (*GetSubsystem<ConfigManager>())[ConfigManager::ScriptCacheDir].GetString();
+    std::string cacheFile;
+    if (!cacheDir.empty())
+    {
+        std::stringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << sa::StringHashRt(name.c_str()) << ".luac";
+        cacheFile = (fs::path(cacheDir) / ss.str()).string();
+        if (LoadCached(asset, name, cacheFile))
+            return true;
+    }
+
     // https://stackoverflow.com/questions/8936369/compile-lua-code-store-bytecode-then-load-and-execute-it
     // https://stackoverflow.com/questions/17597816/lua-dump-in-c
     lua_State* L;
@@ -50,10 +196,12 @@ bool IOScript::Import(Game::Script& asset, const std::string& name)
         return false;
     }
     lua_lock(L);
-    lua_dump(L, writer, &asset, 1);
+    lua_dump(L, writer, &asset.GetBuffer(), 1);
     lua_unlock(L);
     lua_close(L);
 
+    if (!cacheFile.empty())
+        SaveCached(asset, name, cacheFile);
     return true;
 }
 
@@ -26,9 +26,14 @@
 
 namespace IO {
 
-/// Loads a Lua script and stores the compiled byte code.
+/// Loads a Lua script and stores the compiled byte code. If a cache directory is
+/// configured the byte code is also written there, so a script is only compiled
+/// again when it was changed.
 class IOScript : public IOAssetImpl<Game::Script>
 {
+private:
+    static bool LoadCached(Game::Script& asset, const std::string& name, const std::string& cacheFile);
+    static void SaveCached(const Game::Script& asset, const std::string& name, const std::string& cacheFile);
 public:
     bool Import(Game::Script& asset, const std::string& name) override;
 };
@@ -196,9 +196,7 @@ void InputComp::Update(uint32_t, Net::NetworkMessage& message)
         {
             AB::GameProtocol::CommandType type = static_cast<AB::GameProtocol::CommandType>(input.data[InputDataCommandType].GetInt());
             const std::string& cmd = input.data[InputDataCommandData].GetString();
-            owner_.CallEvent<void(AB::GameProtocol::CommandType, const std::string&, Net::NetworkMessage&)>(
-                EVENT_ON_HANDLECOMMAND,
-                type, cmd, message);
+            owner_.CallEvent<EVENT_ON_HANDLECOMMAND>(type, cmd, message);
             break;
         }
         case InputType::None:
@@ -44,8 +44,10 @@ void Item::RegisterLua(kaguya::State& state)
 
 void Item::InitializeLua()
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    // Items outlive their owners and may be passed between players in different games,
+    // so each item has a VM of its own.
+    luaEnv_.Create(Lua::CreateState());
+    luaEnv_["self"] = this;
 }
 
 bool Item::LoadConcrete(const AB::Entities::ConcreteItem& item)
@@ -78,42 +80,42 @@ bool Item::LoadScript(const std::string& fileName)
     script_ = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script_)
         return false;
-    if (!script_->Execute(luaState_))
+    if (!luaEnv_.Execute(*script_))
         return false;
 
-    if (Lua::IsFunction(luaState_, "onUpdate"))
-        functions_ |= FunctionUpdate;
-    if (Lua::IsFunction(luaState_, "getDamage"))
-        functions_ |= FunctionGetDamage;
-    if (Lua::IsFunction(luaState_, "getDamageType"))
-        functions_ |= FunctionGetDamageType;
-    if (Lua::IsFunction(luaState_, "onEquip"))
-        functions_ |= FunctionOnEquip;
-    if (Lua::IsFunction(luaState_, "onUnequip"))
-        functions_ |= FunctionOnUnequip;
-    if (Lua::IsFunction(luaState_, "getSkillCost"))
-        functions_ |= FunctionGetSkillCost;
-    if (Lua::IsFunction(luaState_, "getSkillRecharge"))
-        functions_ |= FunctionGetSkillRecharge;
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "onUpdate",
+        "getDamage",
+        "getDamageType",
+        "onEquip",
+        "onUnequip",
+        "getSkillCost",
+        "getSkillRecharge",
+        "getArmorStats",
+        "getDamageStats",
+        "getEnergyStats",
+        "getHealthStats"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
     return true;
 }
 
 void Item::CreateInsigniaStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getHealthStats"))
+    if (luaEnv_.HaveFunction(FunctionGetHealthStats))
     {
-        int32_t health = luaState_["getHealthStats"](level, maxStats);
+        int32_t health = luaEnv_.GetFunction(FunctionGetHealthStats)(level, maxStats);
         stats_.SetValue(Stat::Health, health);
     }
 }
 
 void Item::CreateWeaponStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getDamageStats"))
+    if (luaEnv_.HaveFunction(FunctionGetDamageStats))
     {
         int32_t minDamage = 0;
         int32_t maxDamage = 0;
-        kaguya::tie(minDamage, maxDamage) = luaState_["getDamageStats"](level, maxStats);
+        kaguya::tie(minDamage, maxDamage) = luaEnv_.GetFunction(FunctionGetDamageStats)(level, maxStats);
         stats_.SetValue(Stat::MinDamage, minDamage);
         stats_.SetValue(Stat::MaxDamage, maxDamage);
     }
@@ -121,18 +123,18 @@ void Item::CreateWeaponStats(uint32_t level, bool maxStats)
 
 void Item::CreateFocusStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getEnergyStats"))
+    if (luaEnv_.HaveFunction(FunctionGetEnergyStats))
     {
-        int32_t energy = luaState_["getEnergyStats"](level, maxStats);
+        int32_t energy = luaEnv_.GetFunction(FunctionGetEnergyStats)(level, maxStats);
         stats_.SetValue(Stat::Energy, energy);
     }
 }
 
 void Item::CreateShieldStats(uint32_t level, bool maxStats)
 {
-    if (Lua::IsFunction(luaState_, "getArmorStats"))
+    if (luaEnv_.HaveFunction(FunctionGetArmorStats))
     {
-        int32_t armor = luaState_["getArmorStats"](level, maxStats);
+        int32_t armor = luaEnv_.GetFunction(FunctionGetArmorStats)(level, maxStats);
         stats_.SetValue(Stat::Armor, armor);
     }
 }
@@ -185,7 +187,7 @@ bool Item::GenerateConcrete(AB::Entities::ConcreteItem& ci, uint32_t level, bool
 void Item::Update(uint32_t timeElapsed)
 {
     if (HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](timeElapsed);
+        luaEnv_.GetFunction(FunctionUpdate)(timeElapsed);
 
     auto* cache = GetSubsystem<ItemsCache>();
     for (auto& i : upgrades_)
@@ -518,7 +520,7 @@ void Item::GetSkillRecharge(Skill *skill, uint32_t &recharge)
 {
     if (HaveFunction(FunctionGetSkillRecharge))
     {
-        recharge = luaState_["getSkillRecharge"](skill, recharge);
+        recharge = luaEnv_.GetFunction(FunctionGetSkillRecharge)(skill, recharge);
     }
 
     auto* cache = GetSubsystem<ItemsCache>();
@@ -535,7 +537,7 @@ void Item::GetSkillCost(Skill* skill, int32_t& activation, int32_t& energy, int3
     if (HaveFunction(FunctionGetSkillCost))
     {
         kaguya::tie(activation, energy, adrenaline, overcast, hp) =
-            luaState_["getSkillCost"](skill, activation, energy, adrenaline, overcast, hp);
+            luaEnv_.GetFunction(FunctionGetSkillCost)(skill, activation, energy, adrenaline, overcast, hp);
     }
 
     auto* cache = GetSubsystem<ItemsCache>();
@@ -564,7 +566,7 @@ void Item::GetAttributeRank(Attribute index, uint32_t& value)
 void Item::OnEquip(Actor* target)
 {
     if (HaveFunction(FunctionOnEquip))
-        luaState_["onEquip"](target);
+        luaEnv_.GetFunction(FunctionOnEquip)(target);
 
     auto* cache = GetSubsystem<ItemsCache>();
     for (auto& i : upgrades_)
@@ -578,7 +580,7 @@ void Item::OnEquip(Actor* target)
 void Item::OnUnequip(Actor* target)
 {
     if (HaveFunction(FunctionOnUnequip))
-        luaState_["onUnequip"](target);
+        luaEnv_.GetFunction(FunctionOnUnequip)(target);
 
     auto* cache = GetSubsystem<ItemsCache>();
     for (auto& i : upgrades_)
@@ -616,7 +618,7 @@ void Item::GetWeaponDamage(int32_t& value, bool critical)
 {
     if (HaveFunction(FunctionGetDamage))
     {
-        float val = luaState_["getDamage"](baseMinDamage_, baseMaxDamage_, critical);
+        float val = luaEnv_.GetFunction(FunctionGetDamage)(baseMinDamage_, baseMaxDamage_, critical);
         value = static_cast<int32_t>(val);
     }
 
@@ -26,6 +26,7 @@
 #include <AB/Entities/Item.h>
 #include <AB/Entities/ConcreteItem.h>
 #include "Script.h"
+#include "ScriptManager.h"
 #include "Damage.h"
 #include "ItemStats.h"
 #include <abshared/Attributes.h>
@@ -62,20 +63,23 @@ typedef std::map<EquipPos, uint32_t> EquipmentMap;
 class Item
 {
 private:
-    enum Function : uint32_t
+    enum Function : size_t
     {
-        FunctionNone = 0,
-        FunctionUpdate = 1,
-        FunctionGetDamage = 1 << 1,
-        FunctionGetDamageType = 1 << 2,
-        FunctionOnEquip = 1 << 3,
-        FunctionOnUnequip = 1 << 4,
-        FunctionGetSkillCost = 1 << 5,
-        FunctionGetSkillRecharge = 1 << 6,
+        FunctionUpdate,
+        FunctionGetDamage,
+        FunctionGetDamageType,
+        FunctionOnEquip,
+        FunctionOnUnequip,
+        FunctionGetSkillCost,
+        FunctionGetSkillRecharge,
+        FunctionGetArmorStats,
+        FunctionGetDamageStats,
+        FunctionGetEnergyStats,
+        FunctionGetHealthStats,
+        FunctionCount
     };
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     std::shared_ptr<Script> script_;
-    uint32_t functions_{ FunctionNone };
     UpgradesMap upgrades_;
     int32_t baseMinDamage_{ 0 };
     int32_t baseMaxDamage_{ 0 };
@@ -83,7 +87,7 @@ private:
     void InitializeLua();
     bool HaveFunction(Function func) const
     {
-        return (functions_ & func) == func;
+        return luaEnv_.HaveFunction(func);
     }
     void CreateInsigniaStats(uint32_t level, bool maxStats);
     void CreateWeaponStats(uint32_t level, bool maxStats);
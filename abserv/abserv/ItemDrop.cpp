@@ -39,8 +39,8 @@ ItemDrop::ItemDrop(uint32_t itemId) :
     GameObject(),
     itemId_(itemId)
 {
-    events_.Subscribe<void(Actor*)>(EVENT_ON_CLICKED, std::bind(&ItemDrop::OnClicked, this, std::placeholders::_1));
-    events_.Subscribe<void(Actor*)>(EVENT_ON_SELECTED, std::bind(&ItemDrop::OnSelected, this, std::placeholders::_1));
+    SubscribeEvent<EVENT_ON_CLICKED, &ItemDrop::OnClicked>(this);
+    SubscribeEvent<EVENT_ON_SELECTED, &ItemDrop::OnSelected>(this);
     // Drops can not hide other objects
     occluder_ = false;
     selectable_ = true;
@@ -280,6 +280,11 @@ std::unique_ptr<Item> ItemFactory::LoadConcrete(const std::string& concreteUuid)
         LOG_ERROR << "Error loading item " << ci.itemUuid << std::endl;
         return std::unique_ptr<Item>();
     }
+    return CreateConcrete(gameItem, ci);
+}
+
+std::unique_ptr<Item> ItemFactory::CreateConcrete(const AB::Entities::Item& gameItem, const AB::Entities::ConcreteItem& ci)
+{
     std::unique_ptr<Item> result = std::make_unique<Item>(gameItem);
     if (!result->LoadConcrete(ci))
         return std::unique_ptr<Item>();
@@ -289,6 +294,59 @@ std::unique_ptr<Item> ItemFactory::LoadConcrete(const std::string& concreteUuid)
     return result;
 }
 
+void ItemFactory::PreloadConcrete(const std::vector<std::string>& concreteUuids)
+{
+    auto* cache = GetSubsystem<ItemsCache>();
+    std::vector<std::string> missing;
+    for (const auto& uuid : concreteUuids)
+    {
+        if (cache->GetConcreteId(uuid) == 0)
+            missing.push_back(uuid);
+    }
+    if (missing.empty())
+        return;
+
+    auto* client = GetSubsystem<IO::DataClient>();
+    std::vector<AB::Entities::ConcreteItem> concretes = client->ReadMany<AB::Entities::ConcreteItem>(missing);
+    std::vector<std::string> upgrades;
+    std::vector<std::string> itemUuids;
+    for (const auto& ci : concretes)
+    {
+        if (ci.deleted != 0)
+            continue;
+        for (const auto* upgrade : { &ci.upgrade1Uuid, &ci.upgrade2Uuid, &ci.upgrade3Uuid })
+        {
+            if (!Utils::Uuid::IsEmpty(*upgrade))
+                upgrades.push_back(*upgrade);
+        }
+        itemUuids.push_back(ci.itemUuid);
+    }
+    // Items get the IDs of their upgrades when they are created
+    if (!upgrades.empty())
+        PreloadConcrete(upgrades);
+
+    std::sort(itemUuids.begin(), itemUuids.end());
+    itemUuids.erase(std::unique(itemUuids.begin(), itemUuids.end()), itemUuids.end());
+    std::unordered_map<std::string, AB::Entities::Item> gameItems;
+    for (auto& gameItem : client->ReadMany<AB::Entities::Item>(itemUuids))
+        gameItems.emplace(gameItem.uuid, std::move(gameItem));
+
+    for (const auto& ci : concretes)
+    {
+        if (ci.deleted != 0)
+            continue;
+        const auto it = gameItems.find(ci.itemUuid);
+        if (it == gameItems.end())
+        {
+            LOG_ERROR << "Error loading item " << ci.itemUuid << std::endl;
+            continue;
+        }
+        std::unique_ptr<Item> item = CreateConcrete((*it).second, ci);
+        if (item)
+            cache->Add(std::move(item));
+    }
+}
+
 uint32_t ItemFactory::GetConcreteId(const std::string& concreteUuid)
 {
     auto* cache = GetSubsystem<ItemsCache>();
@@ -50,6 +50,7 @@ private:
     void CalculateValue(const AB::Entities::Item& item, uint32_t level, AB::Entities::ConcreteItem& result);
     bool CreateDBItem(AB::Entities::ConcreteItem item);
     std::unique_ptr<Item> LoadConcrete(const std::string& concreteUuid);
+    std::unique_ptr<Item> CreateConcrete(const AB::Entities::Item& gameItem, const AB::Entities::ConcreteItem& ci);
 public:
     ItemFactory();
     ~ItemFactory() = default;
@@ -65,6 +66,9 @@ public:
         const std::string& accUuid = Utils::Uuid::EMPTY_UUID,
         const std::string& playerUuid = Utils::Uuid::EMPTY_UUID);
     uint32_t GetConcreteId(const std::string& concreteUuid);
+    /// Load the concrete items which are not in the cache with one request, so following
+    /// calls to GetConcreteId() don't need to wait for the data server.
+    void PreloadConcrete(const std::vector<std::string>& concreteUuids);
     void IdentiyItem(Item* item, Player* player);
     /// Create temporary item, does not create a concrete item.
     std::unique_ptr<Item> CreateTempItem(const std::string& itemUuid);
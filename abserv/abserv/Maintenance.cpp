@@ -104,6 +104,7 @@ void Maintenance::UpdateServerLoadTask()
         if (load != serv.load || Utils::TimeElapsed(serv.heartbeat) >= AB::Entities::HEARTBEAT_INTERVAL)
         {
             serv.load = load;
+            serv.stats = Application::Instance->GetStats();
             serv.heartbeat = Utils::Tick();
             cli->Update(serv);
         }
@@ -21,6 +21,8 @@
 
 #include "stdafx.h"
 #include "Map.h"
+#include "Actor.h"
+#include "AutoRunComp.h"
 #include "DataProvider.h"
 #include "Game.h"
 #include "IOMap.h"
@@ -57,6 +59,24 @@ void Map::CreatePatches()
     }
 }
 
+Math::BoundingBox Map::GetBounds() const
+{
+    Math::BoundingBox result;
+    for (const auto& patch : patches_)
+    {
+        const Math::BoundingBox box = patch->GetWorldBoundingBox();
+        if (!box.IsDefined())
+            continue;
+        result.Merge(box.min_);
+        result.Merge(box.max_);
+    }
+    if (!result.IsDefined())
+        return Math::BoundingBox(-1024.0f, 1024.0f);
+    // Objects may jump, fly or stand at the edge
+    result.AddSize(16.0f);
+    return result;
+}
+
 TerrainPatch* Map::GetPatch(unsigned index) const
 {
     return index < patches_.size() ? patches_[index].get() : nullptr;
@@ -204,6 +224,68 @@ bool Map::FindPath(std::vector<Math::Vector3>& dest,
     return res;
 }
 
+void Map::FindPathAsync(const Math::Vector3& start, const Math::Vector3& end,
+    const Math::Vector3& extends, Navigation::PathFinder::Callback&& callback)
+{
+    if (!navMesh_)
+    {
+        Navigation::Path path;
+        callback(false, path);
+        return;
+    }
+    if (!pathFinder_)
+        pathFinder_ = std::make_shared<Navigation::PathFinder>(navMesh_);
+
+    pathFinder_->FindPath(start, end, extends, [this, callback = std::move(callback)](bool success, Navigation::Path& path)
+    {
+        if (success)
+        {
+            for (auto& v : path.points)
+                v.y_ = GetTerrainHeight(v);
+        }
+        callback(success, path);
+    });
+}
+
+Navigation::CrowdManager* Map::GetCrowdManager()
+{
+    if (!crowdManager_ && navMesh_)
+        crowdManager_ = std::make_unique<Navigation::CrowdManager>(navMesh_);
+    return crowdManager_.get();
+}
+
+void Map::UpdateCrowd(uint32_t delta)
+{
+    if (!crowdManager_ || crowdManager_->GetAgentCount() == 0)
+        return;
+    auto game = GetGame();
+    if (!game)
+        return;
+
+    crowdManager_->Update(delta);
+    crowdManager_->VisitAgents([&](int agent, uint32_t objectId)
+    {
+        auto* actor = game->GetObject<Actor>(objectId);
+        if (!actor)
+            crowdManager_->RemoveAgent(agent);
+        else
+            actor->autorunComp_->OnCrowdUpdate(delta);
+        return Iteration::Continue;
+    });
+}
+
+void Map::DeliverPaths()
+{
+    if (pathFinder_)
+        pathFinder_->Deliver();
+}
+
+void Map::DispatchPaths()
+{
+    if (pathFinder_)
+        pathFinder_->Dispatch();
+}
+
 Math::Vector3 Map::FindNearestPoint(const Math::Vector3& point,
     const Math::Vector3& extents,
     const dtQueryFilter* filter, dtPolyRef* nearestRef)
@@ -21,8 +21,10 @@
 
 #pragma once
 
+#include "CrowdManager.h"
 #include "NavigationMesh.h"
 #include "Octree.h"
+#include "PathFinder.h"
 #include "Terrain.h"
 #include <absmath/Vector3.h>
 #include <pugixml.hpp>
@@ -69,6 +71,8 @@ private:
     std::weak_ptr<Game> game_;
     // TerrainPatches are also owned by the game
     std::vector<std::shared_ptr<TerrainPatch>> patches_;
+    std::shared_ptr<Navigation::PathFinder> pathFinder_;
+    std::unique_ptr<Navigation::CrowdManager> crowdManager_;
 public:
     Map(std::shared_ptr<Game> game);
     Map() = delete;
@@ -90,6 +94,8 @@ public:
         return game_.lock();
     }
 
+    /// Bounds of the terrain in world coordinates with some room above and around it
+    Math::BoundingBox GetBounds() const;
     void AddGameObject(std::shared_ptr<GameObject> object);
     void UpdateOctree(uint32_t delta);
     SpawnPoint GetFreeSpawnPoint();
@@ -102,6 +108,17 @@ public:
     /// Extents specifies how far off the navigation mesh the points can be.
     bool FindPath(std::vector<Math::Vector3>& dest, const Math::Vector3& start, const Math::Vector3& end,
         const Math::Vector3& extends = Math::Vector3::One, const dtQueryFilter* filter = nullptr);
+    /// Find a path on a worker thread. The callback is called from the game thread in one of the next ticks.
+    void FindPathAsync(const Math::Vector3& start, const Math::Vector3& end,
+        const Math::Vector3& extends, Navigation::PathFinder::Callback&& callback);
+    /// Returns nullptr if the map has no navigation mesh
+    Navigation::CrowdManager* GetCrowdManager();
+    /// Move the NPCs of crowds. Called at the beginning of a game tick.
+    void UpdateCrowd(uint32_t delta);
+    /// Deliver found paths. Called at the beginning of a game tick.
+    void DeliverPaths();
+    /// Send path requests of this tick to a worker. Called at the end of a game tick.
+    void DispatchPaths();
     Math::Vector3 FindNearestPoint(const Math::Vector3& point, const Math::Vector3& extents,
         const dtQueryFilter* filter = nullptr, dtPolyRef* nearestRef = nullptr);
     bool CanStepOn(const Math::Vector3& point, const Math::Vector3& extents = Math::Vector3::One,
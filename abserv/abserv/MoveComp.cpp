@@ -94,6 +94,18 @@ void MoveComp::HeadTo(const Math::Vector3& pos)
     SetDirection(worldAngle);
 }
 
+void MoveComp::SetSteeredPosition(const Math::Vector3& pos, const Math::Vector3& velocity, uint32_t timeElapsed)
+{
+    StoreOldPosition();
+    if (velocity.LengthSqr() > Math::M_EPSILON)
+        HeadTo(owner_.transformation_.position_ + velocity);
+    owner_.transformation_.position_ = pos;
+    StickToGround();
+    CalculateVelocity(timeElapsed);
+    if (!oldPosition_.Equals(owner_.transformation_.position_))
+        moved_ = true;
+}
+
 void MoveComp::Move(float speed, const Math::Vector3& amount)
 {
 /*
@@ -178,38 +190,26 @@ void MoveComp::Write(Net::NetworkMessage& message)
         AB::Packets::Add(packet, message);
     }
 
-    if (moved_ || forcePosition_)
-    {
-        if (forcePosition_)
-            message.AddByte(AB::GameProtocol::ServerPacketType::GameObjectSetPosition);
-        else
-            message.AddByte(AB::GameProtocol::ServerPacketType::GameObjectPositionChange);
-        AB::Packets::Server::ObjectPosUpdate packet = {
-            owner_.id_,
-            {
-                owner_.transformation_.position_.x_,
-                owner_.transformation_.position_.y_,
-                owner_.transformation_.position_.z_
-            }
-        };
-        AB::Packets::Add(packet, message);
-        moved_ = false;
-        forcePosition_ = false;
-    }
-
+    uint8_t flags = 0;
+    if (forcePosition_)
+        flags |= AB::Packets::Server::ObjectTransformationSetPosition;
+    else if (moved_)
+        flags |= AB::Packets::Server::ObjectTransformationPosition;
     // The rotation may change in 2 ways: Turn and SetWorldDirection
     if (turned_ || directionSet_)
-    {
-        message.AddByte(AB::GameProtocol::ServerPacketType::GameObjectRotationChange);
-        AB::Packets::Server::ObjectRotationUpdate packet = {
-            owner_.id_,
-            owner_.transformation_.GetYRotation(),
-            directionSet_
-        };
-        AB::Packets::Add(packet, message);
-        turned_ = false;
-        directionSet_ = false;
-    }
+        flags |= AB::Packets::Server::ObjectTransformationRotation;
+    if (directionSet_)
+        flags |= AB::Packets::Server::ObjectTransformationManualRotation;
+    moved_ = false;
+    forcePosition_ = false;
+    turned_ = false;
+    directionSet_ = false;
+
+    if (flags == 0)
+        return;
+    // Sent with the transformations of all other objects
+    if (auto game = owner_.GetGame())
+        game->AddObjectTransformation(owner_, flags);
 }
 
 void MoveComp::StoreOldPosition()
@@ -67,6 +67,8 @@ public:
     bool SetPosition(const Math::Vector3& pos);
     void StickToGround();
     void HeadTo(const Math::Vector3& pos);
+    /// Set the position and velocity calculated by the crowd
+    void SetSteeredPosition(const Math::Vector3& pos, const Math::Vector3& velocity, uint32_t timeElapsed);
     /// Move in direction of rotation
     void Move(float speed, const Math::Vector3& amount);
     void Turn(float angle);
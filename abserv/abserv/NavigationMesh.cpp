@@ -41,16 +41,31 @@ struct FindPathData
     unsigned char pathFlags_[MAX_POLYS];
 };
 
+PathQuery::PathQuery() :
+    query_(dtAllocNavMeshQuery()),
+    data_(std::make_unique<FindPathData>())
+{ }
+
+PathQuery::~PathQuery()
+{
+    dtFreeNavMeshQuery(query_);
+}
+
+void NavigationMesh::QueryReleaser::operator()(PathQuery* query) const
+{
+    owner_->ReleaseQuery(query);
+}
+
 NavigationMesh::NavigationMesh() :
     IO::Asset(),
     navQuery_(dtAllocNavMeshQuery()),
-    queryFilter_(std::make_unique<dtQueryFilter>()),
-    pathData_(std::make_unique<FindPathData>())
+    queryFilter_(std::make_unique<dtQueryFilter>())
 {
 }
 
 NavigationMesh::~NavigationMesh()
 {
+    queries_.clear();
     dtFreeNavMeshQuery(navQuery_);
     if (navMesh_)
         dtFreeNavMesh(navMesh_);
@@ -63,21 +78,41 @@ void NavigationMesh::SetNavMesh(dtNavMesh* value)
 
     navMesh_ = value;
     navQuery_->init(navMesh_, MAX_POLYS);
+    std::scoped_lock lock(queriesLock_);
+    queries_.clear();
 }
 
-bool NavigationMesh::FindPath(std::vector<Math::Vector3>& dest,
+NavigationMesh::QueryPtr NavigationMesh::AcquireQuery()
+{
+    {
+        std::scoped_lock lock(queriesLock_);
+        if (!queries_.empty())
+        {
+            PathQuery* result = queries_.back().release();
+            queries_.pop_back();
+            return QueryPtr(result, { this });
+        }
+    }
+    auto result = std::make_unique<PathQuery>();
+    result->query_->init(navMesh_, MAX_POLYS);
+    return QueryPtr(result.release(), { this });
+}
+
+void NavigationMesh::ReleaseQuery(PathQuery* query)
+{
+    std::scoped_lock lock(queriesLock_);
+    queries_.emplace_back(query);
+}
+
+bool NavigationMesh::BeginFindPath(PathQuery& query,
     const Math::Vector3& start, const Math::Vector3& end,
     const Math::Vector3& extends /* = Math::Vector3::One */,
     const dtQueryFilter* filter /* = nullptr */)
 {
-    dest.clear();
-
-//    AB_PROFILE;
-
     const dtQueryFilter* queryFilter = filter ? filter : queryFilter_.get();
     dtPolyRef startRef = 0;
     dtPolyRef endRef = 0;
-    dtStatus startStatus = navQuery_->findNearestPoly(start.Data(), extends.Data(), queryFilter, &startRef, nullptr);
+    dtStatus startStatus = query.query_->findNearestPoly(start.Data(), extends.Data(), queryFilter, &startRef, nullptr);
     if (dtStatusFailed(startStatus))
     {
 #ifdef DEBUG_NAVIGATION
@@ -87,7 +122,7 @@ bool NavigationMesh::FindPath(std::vector<Math::Vector3>& dest,
         return false;
     }
 
-    dtStatus endStatus = navQuery_->findNearestPoly(end.Data(), extends.Data(), queryFilter, &endRef, nullptr);
+    dtStatus endStatus = query.query_->findNearestPoly(end.Data(), extends.Data(), queryFilter, &endRef, nullptr);
     if (dtStatusFailed(endStatus))
     {
 #ifdef DEBUG_NAVIGATION
@@ -103,31 +138,88 @@ bool NavigationMesh::FindPath(std::vector<Math::Vector3>& dest,
     if (!startRef || !endRef)
         return false;
 
-    int numPolys = 0;
-    int numPathPoints = 0;
+    query.start_ = start;
+    query.end_ = end;
+    query.startRef_ = startRef;
+    query.endRef_ = endRef;
+    dtStatus initStatus = query.query_->initSlicedFindPath(startRef, endRef, &start.x_, &end.x_, queryFilter);
+    return !dtStatusFailed(initStatus);
+}
 
-    dtStatus findStatus = navQuery_->findPath(startRef, endRef, &start.x_, &end.x_, queryFilter,
-        pathData_->polys_, &numPolys, MAX_POLYS);
-    if (dtStatusFailed(findStatus) || !numPolys)
-        return false;
+dtStatus NavigationMesh::UpdateFindPath(PathQuery& query, int maxIter, int& doneIter)
+{
+    doneIter = 0;
+    return query.query_->updateSlicedFindPath(maxIter, &doneIter);
+}
 
-    Math::Vector3 actualEnd = end;
+static void StraightPath(PathQuery& query, const dtPolyRef* polys, int numPolys, std::vector<Math::Vector3>& dest)
+{
+    FindPathData& data = *query.data_;
+    int numPathPoints = 0;
+    Math::Vector3 actualEnd = query.end_;
 
     // If full path was not found, clamp end point to the end polygon
-    if (pathData_->polys_[numPolys - 1] != endRef)
-        navQuery_->closestPointOnPoly(pathData_->polys_[numPolys - 1], &end.x_, &actualEnd.x_, nullptr);
+    if (polys[numPolys - 1] != query.endRef_)
+        query.query_->closestPointOnPoly(polys[numPolys - 1], &query.end_.x_, &actualEnd.x_, nullptr);
 
-    navQuery_->findStraightPath(&start.x_, &actualEnd.x_, pathData_->polys_, numPolys,
-        &pathData_->pathPoints_[0].x_, pathData_->pathFlags_, pathData_->pathPolys_, &numPathPoints, MAX_POLYS);
+    query.query_->findStraightPath(&query.start_.x_, &actualEnd.x_, polys, numPolys,
+        &data.pathPoints_[0].x_, data.pathFlags_, data.pathPolys_, &numPathPoints, MAX_POLYS);
 
+    dest.reserve(static_cast<size_t>(numPathPoints));
     for (int i = 0; i < numPathPoints; ++i)
     {
-        dest.push_back(pathData_->pathPoints_[i]);
+        dest.push_back(data.pathPoints_[i]);
     }
+}
 
+bool NavigationMesh::EndFindPath(PathQuery& query, std::vector<Math::Vector3>& dest, std::vector<dtPolyRef>* polys)
+{
+    dest.clear();
+
+    FindPathData& data = *query.data_;
+    int numPolys = 0;
+
+    dtStatus findStatus = query.query_->finalizeSlicedFindPath(data.polys_, &numPolys, MAX_POLYS);
+    if (dtStatusFailed(findStatus) || !numPolys)
+        return false;
+
+    StraightPath(query, data.polys_, numPolys, dest);
+    if (polys)
+        polys->assign(data.polys_, data.polys_ + numPolys);
     return true;
 }
 
+bool NavigationMesh::GetStraightPath(PathQuery& query, const std::vector<dtPolyRef>& polys, std::vector<Math::Vector3>& dest)
+{
+    dest.clear();
+    if (polys.empty() || polys.size() > MAX_POLYS)
+        return false;
+    if (polys.front() != query.startRef_)
+        return false;
+
+    StraightPath(query, polys.data(), static_cast<int>(polys.size()), dest);
+    return true;
+}
+
+bool NavigationMesh::FindPath(std::vector<Math::Vector3>& dest,
+    const Math::Vector3& start, const Math::Vector3& end,
+    const Math::Vector3& extends /* = Math::Vector3::One */,
+    const dtQueryFilter* filter /* = nullptr */)
+{
+    dest.clear();
+
+//    AB_PROFILE;
+
+    auto query = AcquireQuery();
+    if (!BeginFindPath(*query, start, end, extends, filter))
+        return false;
+    int doneIter = 0;
+    dtStatus status = UpdateFindPath(*query, std::numeric_limits<int>::max(), doneIter);
+    if (!dtStatusSucceed(status))
+        return false;
+    return EndFindPath(*query, dest);
+}
+
 Math::Vector3 NavigationMesh::FindNearestPoint(const Math::Vector3& point,
     const Math::Vector3& extents,
     const dtQueryFilter* filter, dtPolyRef* nearestRef)
@@ -172,8 +264,9 @@ bool NavigationMesh::FindRandomPoint(Math::Vector3& result, const Math::Vector3&
         nearestRef = &pointRef;
 
     const dtQueryFilter* queryFilter = filter ? filter : queryFilter_.get();
+    auto query = AcquireQuery();
     dtPolyRef startRef = 0;
-    dtStatus startStatus = navQuery_->findNearestPoly(point.Data(), extents.Data(), queryFilter, &startRef, nullptr);
+    dtStatus startStatus = query->query_->findNearestPoly(point.Data(), extents.Data(), queryFilter, &startRef, nullptr);
     if (dtStatusFailed(startStatus))
     {
 #ifdef DEBUG_NAVIGATION
@@ -190,7 +283,7 @@ bool NavigationMesh::FindRandomPoint(Math::Vector3& result, const Math::Vector3&
     };
 
     dtPolyRef randomRef;
-    startStatus = navQuery_->findRandomPointAroundCircle(startRef, point.Data(), radius, queryFilter, frng, &randomRef, &result.x_);
+    startStatus = query->query_->findRandomPointAroundCircle(startRef, point.Data(), radius, queryFilter, frng, &randomRef, &result.x_);
     if (dtStatusFailed(startStatus))
     {
 #ifdef DEBUG_NAVIGATION
@@ -22,6 +22,8 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <DetourNavMesh.h>
 #include <DetourNavMeshQuery.h>
 #include "Asset.h"
@@ -31,14 +33,39 @@ namespace Navigation {
 
 struct FindPathData;
 
+/// A dtNavMeshQuery with its own buffers and the state of a sliced path search.
+struct PathQuery
+{
+    dtNavMeshQuery* query_;
+    std::unique_ptr<FindPathData> data_;
+    Math::Vector3 start_;
+    Math::Vector3 end_;
+    dtPolyRef startRef_{ 0 };
+    dtPolyRef endRef_{ 0 };
+    PathQuery();
+    ~PathQuery();
+};
+
 /// Navigation Mesh constructed from Map and Obstacles
 class NavigationMesh final : public IO::Asset
 {
+public:
+    struct QueryReleaser
+    {
+        NavigationMesh* owner_;
+        void operator()(PathQuery* query) const;
+    };
+    /// A query with its own dtNavMeshQuery and buffers. It returns to the pool when released.
+    using QueryPtr = std::unique_ptr<PathQuery, QueryReleaser>;
 private:
     dtNavMesh* navMesh_{ nullptr };
+    /// Only used for lookups which do not touch the node pool of the query, i.e. findNearestPoly(),
+    /// so it can be shared by all games using this mesh.
     dtNavMeshQuery* navQuery_;
     std::unique_ptr<dtQueryFilter> queryFilter_;
-    std::unique_ptr<FindPathData> pathData_;
+    std::mutex queriesLock_;
+    std::vector<std::unique_ptr<PathQuery>> queries_;
+    void ReleaseQuery(PathQuery* query);
 public:
     NavigationMesh();
     ~NavigationMesh() override;
@@ -49,6 +76,20 @@ public:
 
     dtNavMesh* GetNavMesh() const { return navMesh_; }
     dtNavMeshQuery* GetNavQuery() const { return navQuery_; }
+    const dtQueryFilter* GetQueryFilter() const { return queryFilter_.get(); }
+
+    /// Get an unused query. Queries can be used by different threads at the same time,
+    /// but a query can only be used by one thread.
+    QueryPtr AcquireQuery();
+    /// Start a sliced path search with the query. Returns false if start or end are not on the navigation mesh.
+    bool BeginFindPath(PathQuery& query, const Math::Vector3& start, const Math::Vector3& end,
+        const Math::Vector3& extends = Math::Vector3::One, const dtQueryFilter* filter = nullptr);
+    /// Continue the search for at most maxIter iterations. Check the result with dtStatusInProgress() and dtStatusSucceed().
+    dtStatus UpdateFindPath(PathQuery& query, int maxIter, int& doneIter);
+    /// Get the path of a succeeded search. If polys is not null it also gets the polygons of the path.
+    bool EndFindPath(PathQuery& query, std::vector<Math::Vector3>& dest, std::vector<dtPolyRef>* polys = nullptr);
+    /// Get the points of a path along polys, which must start at the start polygon and end at the end polygon of the query.
+    bool GetStraightPath(PathQuery& query, const std::vector<dtPolyRef>& polys, std::vector<Math::Vector3>& dest);
 
     /// Find a path between world space points. Return non-empty list of points if successful.
     /// Extents specifies how far off the navigation mesh the points can be.
@@ -36,8 +36,8 @@ namespace Game {
 
 void Npc::InitializeLua()
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(GetLuaState());
+    luaEnv_["self"] = this;
     luaInitialized_ = true;
 }
 
@@ -65,34 +65,29 @@ Npc::Npc() :
     Actor(),
     luaInitialized_(false)
 {
-    events_.Subscribe<void(Actor*, bool&)>(EVENT_ON_ATTACK, std::bind(&Npc::OnAttack, this, std::placeholders::_1, std::placeholders::_2));
-    events_.Subscribe<void(Actor*, bool&)>(EVENT_ON_GETTING_ATTACKED, std::bind(&Npc::OnGettingAttacked, this, std::placeholders::_1, std::placeholders::_2));
-    events_.Subscribe<void(Actor*, DamageType, int32_t, bool&)>(EVENT_ON_ATTACKED, std::bind(
-        &Npc::OnAttacked, this,
-        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
-    events_.Subscribe<void(bool&)>(EVENT_ON_INTERRUPTING_ATTACK, std::bind(&Npc::OnInterruptingAttack, this, std::placeholders::_1));
-    events_.Subscribe<void(AB::Entities::SkillType, Skill*, bool&)>(EVENT_ON_INTERRUPTING_SKILL,
-        std::bind(&Npc::OnInterruptingSkill, this,
-            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    events_.Subscribe<void(Actor*, Skill*, bool&)>(EVENT_ON_SKILLTARGETED, std::bind(&Npc::OnSkillTargeted, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    events_.Subscribe<void(Actor*, Skill*, bool&)>(EVENT_ON_USESKILL, std::bind(&Npc::OnUseSkill, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    events_.Subscribe<void(void)>(EVENT_ON_DIED, std::bind(&Npc::OnDied, this));
-    events_.Subscribe<void(Skill*)>(EVENT_ON_ENDUSESKILL, std::bind(&Npc::OnEndUseSkill, this, std::placeholders::_1));
-    events_.Subscribe<void(Skill*)>(EVENT_ON_STARTUSESKILL, std::bind(&Npc::OnStartUseSkill, this, std::placeholders::_1));
-    events_.Subscribe<void(Actor*)>(EVENT_ON_CLICKED, std::bind(&Npc::OnClicked, this, std::placeholders::_1));
-    events_.Subscribe<void(GameObject*)>(EVENT_ON_COLLIDE, std::bind(&Npc::OnCollide, this, std::placeholders::_1));
-    events_.Subscribe<void(Actor*)>(EVENT_ON_SELECTED, std::bind(&Npc::OnSelected, this, std::placeholders::_1));
-    events_.Subscribe<void(GameObject*)>(EVENT_ON_TRIGGER, std::bind(&Npc::OnTrigger, this, std::placeholders::_1));
-    events_.Subscribe<void(GameObject*)>(EVENT_ON_LEFTAREA, std::bind(&Npc::OnLeftArea, this, std::placeholders::_1));
-    events_.Subscribe<void(void)>(EVENT_ON_ARRIVED, std::bind(&Npc::OnArrived, this));
-    events_.Subscribe<void(void)>(EVENT_ON_INTERRUPTEDATTACK, std::bind(&Npc::OnInterruptedAttack, this));
-    events_.Subscribe<void(Skill*)>(EVENT_ON_INTERRUPTEDSKILL, std::bind(&Npc::OnInterruptedSkill, this, std::placeholders::_1));
-    events_.Subscribe<void(uint32_t)>(EVENT_ON_KNOCKED_DOWN, std::bind(&Npc::OnKnockedDown, this, std::placeholders::_1));
-    events_.Subscribe<void(int)>(EVENT_ON_HEALED, std::bind(&Npc::OnHealed, this, std::placeholders::_1));
-    events_.Subscribe<void(int, int)>(EVENT_ON_RESURRECTED, std::bind(&Npc::OnResurrected, this, std::placeholders::_1, std::placeholders::_2));
+    SubscribeEvent<EVENT_ON_ATTACK, &Npc::OnAttack>(this);
+    SubscribeEvent<EVENT_ON_GETTING_ATTACKED, &Npc::OnGettingAttacked>(this);
+    SubscribeEvent<EVENT_ON_ATTACKED, &Npc::OnAttacked>(this);
+    SubscribeEvent<EVENT_ON_INTERRUPTING_ATTACK, &Npc::OnInterruptingAttack>(this);
+    SubscribeEvent<EVENT_ON_INTERRUPTING_SKILL, &Npc::OnInterruptingSkill>(this);
+    SubscribeEvent<EVENT_ON_SKILLTARGETED, &Npc::OnSkillTargeted>(this);
+    SubscribeEvent<EVENT_ON_USESKILL, &Npc::OnUseSkill>(this);
+    SubscribeEvent<EVENT_ON_DIED, &Npc::OnDied>(this);
+    SubscribeEvent<EVENT_ON_ENDUSESKILL, &Npc::OnEndUseSkill>(this);
+    SubscribeEvent<EVENT_ON_STARTUSESKILL, &Npc::OnStartUseSkill>(this);
+    SubscribeEvent<EVENT_ON_CLICKED, &Npc::OnClicked>(this);
+    SubscribeEvent<EVENT_ON_COLLIDE, &Npc::OnCollide>(this);
+    SubscribeEvent<EVENT_ON_SELECTED, &Npc::OnSelected>(this);
+    SubscribeEvent<EVENT_ON_TRIGGER, &Npc::OnTrigger>(this);
+    SubscribeEvent<EVENT_ON_LEFTAREA, &Npc::OnLeftArea>(this);
+    SubscribeEvent<EVENT_ON_ARRIVED, &Npc::OnArrived>(this);
+    SubscribeEvent<EVENT_ON_INTERRUPTEDATTACK, &Npc::OnInterruptedAttack>(this);
+    SubscribeEvent<EVENT_ON_INTERRUPTEDSKILL, &Npc::OnInterruptedSkill>(this);
+    SubscribeEvent<EVENT_ON_KNOCKED_DOWN, &Npc::OnKnockedDown>(this);
+    SubscribeEvent<EVENT_ON_HEALED, &Npc::OnHealed>(this);
+    SubscribeEvent<EVENT_ON_RESURRECTED, &Npc::OnResurrected>(this);
     // Party and Groups must be unique, i.e. share the same ID pool.
     groupId_ = Group::GetNewId();
-    InitializeLua();
 }
 
 Npc::~Npc()
@@ -104,32 +99,33 @@ Npc::~Npc()
 
 bool Npc::LoadScript(const std::string& fileName)
 {
+    InitializeLua();
     script_ = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script_)
         return false;
-    if (!script_->Execute(luaState_))
+    if (!luaEnv_.Execute(*script_))
         return false;
 
-    name_ = static_cast<const char*>(luaState_["name"]);
-    level_ = luaState_["level"];
-    itemIndex_ = luaState_["itemIndex"];
-    if (Lua::IsNumber(luaState_, "sex"))
-        sex_ = luaState_["sex"];
-    if (Lua::IsNumber(luaState_, "group_id"))
-        groupId_ = luaState_["group_id"];
-    if (Lua::IsBool(luaState_, "wander"))
-        SetWander(luaState_("wander"));
-
-    if (Lua::IsNumber(luaState_, "creatureState"))
-        stateComp_.SetState(luaState_["creatureState"], true);
+    name_ = static_cast<const char*>(luaEnv_["name"]);
+    level_ = luaEnv_["level"];
+    itemIndex_ = luaEnv_["itemIndex"];
+    if (Lua::IsNumber(luaEnv_, "sex"))
+        sex_ = luaEnv_["sex"];
+    if (Lua::IsNumber(luaEnv_, "group_id"))
+        groupId_ = luaEnv_["group_id"];
+    if (Lua::IsBool(luaEnv_, "wander"))
+        SetWander(luaEnv_["wander"]);
+
+    if (Lua::IsNumber(luaEnv_, "creatureState"))
+        stateComp_.SetState(luaEnv_["creatureState"], true);
     else
         stateComp_.SetState(AB::GameProtocol::CreatureState::Idle, true);
 
     IO::DataClient* client = GetSubsystem<IO::DataClient>();
 
-    if (Lua::IsNumber(luaState_, "prof1Index"))
+    if (Lua::IsNumber(luaEnv_, "prof1Index"))
     {
-        skills_->prof1_.index = luaState_["prof1Index"];
+        skills_->prof1_.index = luaEnv_["prof1Index"];
         if (skills_->prof1_.index != 0)
         {
             if (!client->Read(skills_->prof1_))
@@ -138,9 +134,9 @@ bool Npc::LoadScript(const std::string& fileName)
             }
         }
     }
-    if (Lua::IsNumber(luaState_, "prof2Index"))
+    if (Lua::IsNumber(luaEnv_, "prof2Index"))
     {
-        skills_->prof2_.index = luaState_["prof2Index"];
+        skills_->prof2_.index = luaEnv_["prof2Index"];
         if (skills_->prof2_.index != 0)
         {
             if (!client->Read(skills_->prof2_))
@@ -151,16 +147,35 @@ bool Npc::LoadScript(const std::string& fileName)
     }
 
     std::string bt;
-    if (Lua::IsString(luaState_, "behavior"))
-        bt = static_cast<const char*>(luaState_["behavior"]);
-    if (Lua::IsFunction(luaState_, "onUpdate"))
-        functions_ |= FunctionUpdate;
-    if (Lua::IsFunction(luaState_, "onTrigger"))
-        functions_ |= FunctionOnTrigger;
-    if (Lua::IsFunction(luaState_, "onLeftArea"))
-        functions_ |= FunctionOnLeftArea;
-    if (Lua::IsFunction(luaState_, "onGetQuote"))
-        functions_ |= FunctionOnGetQuote;
+    if (Lua::IsString(luaEnv_, "behavior"))
+        bt = static_cast<const char*>(luaEnv_["behavior"]);
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "onUpdate",
+        "onTrigger",
+        "onLeftArea",
+        "onGetQuote",
+        "onArrived",
+        "onAttack",
+        "onAttacked",
+        "onClicked",
+        "onCollide",
+        "onDied",
+        "onEndUseSkill",
+        "onGettingAttacked",
+        "onHealed",
+        "onInit",
+        "onInterruptedAttack",
+        "onInterruptedSkill",
+        "onInterruptingAttack",
+        "onInterruptingSkill",
+        "onKnockedDown",
+        "onResurrected",
+        "onSelected",
+        "onSkillTargeted",
+        "onStartUseSkill",
+        "onUseSkill"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
 
     GetSkillBar()->InitAttributes();
     // Initialize resources, etc. may be overwritten in onInit() in the NPC script bellow.
@@ -169,7 +184,9 @@ bool Npc::LoadScript(const std::string& fileName)
     if (!bt.empty())
         SetBehavior(bt);
 
-    return luaState_["onInit"]();
+    if (!HaveFunction(FunctionOnInit))
+        return false;
+    return luaEnv_.GetFunction(FunctionOnInit)();
 }
 
 void Npc::SetLevel(uint32_t value)
@@ -189,9 +206,7 @@ void Npc::Update(uint32_t timeElapsed, Net::NetworkMessage& message)
     Actor::Update(timeElapsed, message);
 
     if (luaInitialized_ && HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](timeElapsed);
-
-    Lua::CollectGarbage(luaState_);
+        luaEnv_.GetFunction(FunctionUpdate)(timeElapsed);
 }
 
 bool Npc::SetBehavior(const std::string& name)
@@ -361,8 +376,7 @@ std::string Npc::GetQuote(int index)
 {
     if (!HaveFunction(FunctionOnGetQuote))
         return "";
-    const char* q = static_cast<const char*>(luaState_["onGetQuote"](index));
-    return q;
+    return luaEnv_.GetFunction(FunctionOnGetQuote).call<std::string>(index);
 }
 
 void Npc::_LuaSetName(const std::string& name)
@@ -410,13 +424,13 @@ void Npc::ShootAt(const std::string& itemUuid, Actor* target)
 void Npc::OnSelected(Actor* selector)
 {
     if (luaInitialized_ && selector)
-        Lua::CallFunction(luaState_, "onSelected", selector);
+        luaEnv_.CallFunction(FunctionOnSelected, selector);
 }
 
 void Npc::OnClicked(Actor* selector)
 {
     if (luaInitialized_ && selector)
-        Lua::CallFunction(luaState_, "onClicked", selector);
+        luaEnv_.CallFunction(FunctionOnClicked, selector);
     if (Is<Player>(selector))
     {
         if (!IsInRange(Ranges::Adjecent, selector))
@@ -431,115 +445,129 @@ void Npc::OnClicked(Actor* selector)
 void Npc::OnArrived()
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onArrived");
+        luaEnv_.CallFunction(FunctionOnArrived);
 }
 
 void Npc::OnCollide(GameObject* other)
 {
     if (luaInitialized_ && other)
-        Lua::CallFunction(luaState_, "onCollide", other);
+        luaEnv_.CallFunction(FunctionOnCollide, other);
 }
 
 void Npc::OnTrigger(GameObject* other)
 {
     if (luaInitialized_ && HaveFunction(FunctionOnTrigger))
-        Lua::CallFunction(luaState_, "onTrigger", other);
+        luaEnv_.CallFunction(FunctionOnTrigger, other);
 }
 
 void Npc::OnLeftArea(GameObject* other)
 {
     if (luaInitialized_ && HaveFunction(FunctionOnLeftArea))
-        Lua::CallFunction(luaState_, "onLeftArea", other);
+        luaEnv_.CallFunction(FunctionOnLeftArea, other);
 }
 
 void Npc::OnEndUseSkill(Skill* skill)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onEndUseSkill", skill);
+        luaEnv_.CallFunction(FunctionOnEndUseSkill, skill);
 }
 
 void Npc::OnStartUseSkill(Skill* skill)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onStartUseSkill", skill);
+        luaEnv_.CallFunction(FunctionOnStartUseSkill, skill);
 }
 
 void Npc::OnAttack(Actor* target, bool& canAttack)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onAttack", target, canAttack);
+        luaEnv_.CallFunction(FunctionOnAttack, target, canAttack);
 }
 
 void Npc::OnAttacked(Actor* source, DamageType type, int32_t damage, bool& canGetAttacked)
 {
+    if (aiComp_)
+        aiComp_->Wake();
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onAttacked", source, type, damage, canGetAttacked);
+        luaEnv_.CallFunction(FunctionOnAttacked, source, type, damage, canGetAttacked);
 }
 
 void Npc::OnGettingAttacked(Actor* source, bool& canGetAttacked)
 {
+    if (aiComp_)
+        aiComp_->Wake();
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onGettingAttacked", source, canGetAttacked);
+        luaEnv_.CallFunction(FunctionOnGettingAttacked, source, canGetAttacked);
 }
 
 void Npc::OnUseSkill(Actor* target, Skill* skill, bool& success)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onUseSkill", target, skill, success);
+        luaEnv_.CallFunction(FunctionOnUseSkill, target, skill, success);
 }
 
 void Npc::OnSkillTargeted(Actor* source, Skill* skill, bool& success)
 {
+    if (aiComp_)
+        aiComp_->Wake();
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onSkillTargeted", source, skill, success);
+        luaEnv_.CallFunction(FunctionOnSkillTargeted, source, skill, success);
 }
 
 void Npc::OnInterruptingAttack(bool& success)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptingAttack", success);
+        luaEnv_.CallFunction(FunctionOnInterruptingAttack, success);
 }
 
 void Npc::OnInterruptingSkill(AB::Entities::SkillType type, Skill* skill, bool& success)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptingSkill", type, skill, success);
+        luaEnv_.CallFunction(FunctionOnInterruptingSkill, type, skill, success);
 }
 
 void Npc::OnInterruptedAttack()
 {
+    if (aiComp_)
+        aiComp_->Wake();
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptedAttack");
+        luaEnv_.CallFunction(FunctionOnInterruptedAttack);
 }
 
 void Npc::OnInterruptedSkill(Skill* skill)
 {
+    if (aiComp_)
+        aiComp_->Wake();
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onInterruptedSkill", skill);
+        luaEnv_.CallFunction(FunctionOnInterruptedSkill, skill);
 }
 
 void Npc::OnKnockedDown(uint32_t time)
 {
+    if (aiComp_)
+        aiComp_->Wake();
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onKnockedDown", time);
+        luaEnv_.CallFunction(FunctionOnKnockedDown, time);
 }
 
 void Npc::OnHealed(int hp)
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onHealed", hp);
+        luaEnv_.CallFunction(FunctionOnHealed, hp);
 }
 
 void Npc::OnDied()
 {
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onDied");
+        luaEnv_.CallFunction(FunctionOnDied);
 }
 
 void Npc::OnResurrected(int, int)
 {
+    if (aiComp_)
+        aiComp_->Wake();
     if (luaInitialized_)
-        Lua::CallFunction(luaState_, "onResurrected");
+        luaEnv_.CallFunction(FunctionOnResurrected);
 }
 
 void Npc::_LuaAddQuest(uint32_t index)
@@ -38,13 +38,33 @@ class Crowd;
 class Npc final : public Actor
 {
 private:
-    enum Function : uint32_t
+    enum Function : size_t
     {
-        FunctionNone = 0,
-        FunctionUpdate = 1,
-        FunctionOnTrigger = 1 << 1,
-        FunctionOnLeftArea = 1 << 2,
-        FunctionOnGetQuote = 1 << 3
+        FunctionUpdate,
+        FunctionOnTrigger,
+        FunctionOnLeftArea,
+        FunctionOnGetQuote,
+        FunctionOnArrived,
+        FunctionOnAttack,
+        FunctionOnAttacked,
+        FunctionOnClicked,
+        FunctionOnCollide,
+        FunctionOnDied,
+        FunctionOnEndUseSkill,
+        FunctionOnGettingAttacked,
+        FunctionOnHealed,
+        FunctionOnInit,
+        FunctionOnInterruptedAttack,
+        FunctionOnInterruptedSkill,
+        FunctionOnInterruptingAttack,
+        FunctionOnInterruptingSkill,
+        FunctionOnKnockedDown,
+        FunctionOnResurrected,
+        FunctionOnSelected,
+        FunctionOnSkillTargeted,
+        FunctionOnStartUseSkill,
+        FunctionOnUseSkill,
+        FunctionCount
     };
 
     /// This NPC exists only on the server, i.e. is not spawned on the client, e.g. a trigger box.
@@ -55,12 +75,11 @@ private:
     std::shared_ptr<Script> script_;
     /// Quests this NPC may have for the player
     std::set<uint32_t> quests_;
-    uint32_t functions_{ FunctionNone };
     bool HaveFunction(Function func) const
     {
-        return (functions_ & func) == func;
+        return luaEnv_.HaveFunction(func);
     }
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     bool luaInitialized_;
     void InitializeLua();
     std::string GetQuote(int index);
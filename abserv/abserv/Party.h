@@ -24,6 +24,7 @@
 #include "Group.h"
 #include <AB/Entities/Party.h>
 #include <abscommon/DataClient.h>
+#include <abscommon/Logger.h>
 #include <abscommon/NetworkMessage.h>
 #include <abscommon/Subsystems.h>
 #include <abscommon/Variant.h>
@@ -51,10 +52,14 @@ private:
     bool defeated_{ false };
     Utils::VariantMap variables_;
     template<typename E>
-    bool UpdateEntity(const E& e)
+    void UpdateEntity(const E& e)
     {
         IO::DataClient* cli = GetSubsystem<IO::DataClient>();
-        return cli->Update(e);
+        cli->UpdateAsync(e, [uuid = e.uuid](bool success)
+        {
+            if (!success)
+                LOG_ERROR << "Error updating " << E::KEY() << " " << uuid << std::endl;
+        });
     }
     /// 1-base position
     size_t GetDataPos(const Player& player);
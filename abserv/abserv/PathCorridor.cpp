@@ -0,0 +1,90 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "stdafx.h"
+#include "PathCorridor.h"
+
+namespace Navigation {
+
+static bool IsClose(const float* pos, const Math::Vector3& point)
+{
+    return Math::Equals(pos[0], point.x_, PathCorridor::MAX_DRIFT) &&
+        Math::Equals(pos[2], point.z_, PathCorridor::MAX_DRIFT);
+}
+
+PathCorridor::PathCorridor(std::shared_ptr<NavigationMesh> navMesh) :
+    navMesh_(std::move(navMesh))
+{
+    corridor_.init(MAX_PATH);
+}
+
+bool PathCorridor::SetPath(const Path& path)
+{
+    valid_ = false;
+    if (path.polys.empty() || path.points.empty())
+        return false;
+    // The target must be in the last polygon of the corridor
+    if (path.polys.size() > MAX_PATH)
+        return false;
+
+    corridor_.reset(path.polys.front(), &path.points.front().x_);
+    corridor_.setCorridor(&path.points.back().x_, path.polys.data(), static_cast<int>(path.polys.size()));
+    valid_ = true;
+    return true;
+}
+
+bool PathCorridor::Update(const Math::Vector3& start, const Math::Vector3& end, bool optimize,
+    std::vector<Math::Vector3>& wayPoints)
+{
+    if (!valid_)
+        return false;
+
+    auto query = navMesh_->AcquireQuery();
+    const dtQueryFilter* filter = navMesh_->GetQueryFilter();
+    if (!corridor_.movePosition(&start.x_, query->query_, filter) ||
+        !corridor_.moveTargetPosition(&end.x_, query->query_, filter))
+    {
+        valid_ = false;
+        return false;
+    }
+    // The local search could not follow, e.g. the target is now on the other side of a wall
+    if (!IsClose(corridor_.getPos(), start) || !IsClose(corridor_.getTarget(), end))
+    {
+        valid_ = false;
+        return false;
+    }
+
+    if (optimize)
+        // Moving the target around adds detours to the corridor
+        corridor_.optimizePathTopology(query->query_, filter);
+
+    float cornerVerts[MAX_CORNERS * 3];
+    unsigned char cornerFlags[MAX_CORNERS];
+    dtPolyRef cornerPolys[MAX_CORNERS];
+    const int count = corridor_.findCorners(cornerVerts, cornerFlags, cornerPolys, MAX_CORNERS, query->query_, filter);
+    wayPoints.clear();
+    for (int i = 0; i < count; ++i)
+        wayPoints.push_back({ cornerVerts[i * 3], cornerVerts[i * 3 + 1], cornerVerts[i * 3 + 2] });
+    return true;
+}
+
+}
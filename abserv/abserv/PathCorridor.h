@@ -0,0 +1,63 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "NavigationMesh.h"
+#include "PathFinder.h"
+#include <DetourPathCorridor.h>
+#include <absmath/Vector3.h>
+#include <memory>
+#include <sa/Noncopyable.h>
+#include <vector>
+
+namespace Navigation {
+
+/// Keeps the polygons of a found path. When the start or the end moves a bit, the path
+/// is adjusted with a local search instead of searching a new path.
+class PathCorridor
+{
+    NON_COPYABLE(PathCorridor)
+private:
+    static constexpr int MAX_PATH = 1024;
+    static constexpr int MAX_CORNERS = 8;
+    std::shared_ptr<NavigationMesh> navMesh_;
+    dtPathCorridor corridor_;
+    bool valid_{ false };
+public:
+    /// How far start and end can be away from where the corridor could move them
+    static constexpr float MAX_DRIFT = 1.0f;
+
+    explicit PathCorridor(std::shared_ptr<NavigationMesh> navMesh);
+    ~PathCorridor() = default;
+
+    /// Use the polygons of a path. Returns false if the path is too long for the corridor.
+    bool SetPath(const Path& path);
+    /// Move start and end and get the next way points. Returns false if they moved too far,
+    /// then a new path must be searched.
+    bool Update(const Math::Vector3& start, const Math::Vector3& end, bool optimize,
+        std::vector<Math::Vector3>& wayPoints);
+    void Reset() { valid_ = false; }
+    bool IsValid() const { return valid_; }
+};
+
+}
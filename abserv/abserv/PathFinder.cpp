@@ -0,0 +1,143 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "stdafx.h"
+#include "PathFinder.h"
+#include <abscommon/Subsystems.h>
+#include <abscommon/ThreadPool.h>
+
+namespace Navigation {
+
+PathFinder::PathFinder(std::shared_ptr<NavigationMesh> navMesh) :
+    navMesh_(std::move(navMesh)),
+    query_(nullptr, { navMesh_.get() }),
+    cache_(CACHE_SIZE)
+{ }
+
+PathFinder::~PathFinder() = default;
+
+void PathFinder::FindPath(const Math::Vector3& start, const Math::Vector3& end,
+    const Math::Vector3& extends, Callback&& callback)
+{
+    Request request;
+    request.start = start;
+    request.end = end;
+    request.extends = extends;
+    request.callback = std::move(callback);
+    incoming_.push_back(std::move(request));
+}
+
+void PathFinder::Deliver()
+{
+    std::vector<Request> finished;
+    {
+        std::scoped_lock lock(lock_);
+        if (finished_.empty())
+            return;
+        finished_.swap(finished);
+    }
+    for (auto& request : finished)
+        request.callback(request.success, request.path);
+}
+
+void PathFinder::Dispatch()
+{
+    if (IsBusy())
+        // Still working on the last batch, send them with the next tick
+        return;
+    for (auto& request : incoming_)
+        queue_.push_back(std::move(request));
+    incoming_.clear();
+    if (queue_.empty())
+        return;
+
+    auto* pool = GetSubsystem<Asynch::ThreadPool>();
+    if (!pool)
+    {
+        Process();
+        return;
+    }
+    running_.store(true, std::memory_order_release);
+    pool->Enqueue([self = shared_from_this()]()
+    {
+        self->Process();
+    });
+}
+
+void PathFinder::Process()
+{
+    // Worker thread
+    std::vector<Request> finished;
+    int budget = iterationBudget_;
+    while (!queue_.empty() && budget > 0)
+    {
+        Request& request = queue_.front();
+        if (!query_)
+            query_ = navMesh_->AcquireQuery();
+        if (!request.started)
+        {
+            request.started = true;
+            if (!navMesh_->BeginFindPath(*query_, request.start, request.end, request.extends))
+            {
+                finished.push_back(std::move(request));
+                queue_.pop_front();
+                continue;
+            }
+            if (const auto* polys = cache_.Get({ query_->startRef_, query_->endRef_ }))
+            {
+                request.path.polys = *polys;
+                request.success = navMesh_->GetStraightPath(*query_, request.path.polys, request.path.points);
+                finished.push_back(std::move(request));
+                queue_.pop_front();
+                continue;
+            }
+        }
+
+        int doneIter = 0;
+        dtStatus status = navMesh_->UpdateFindPath(*query_, budget, doneIter);
+        budget -= doneIter;
+        if (dtStatusInProgress(status))
+            // Out of budget, continue with this search in the next tick
+            break;
+        if (dtStatusSucceed(status))
+        {
+            request.success = navMesh_->EndFindPath(*query_, request.path.points, &request.path.polys);
+            // Partial paths depend on where the search gave up
+            if (request.success && request.path.polys.back() == query_->endRef_)
+                cache_.Put({ query_->startRef_, query_->endRef_ }, request.path.polys);
+        }
+        finished.push_back(std::move(request));
+        queue_.pop_front();
+    }
+    if (queue_.empty())
+        query_.reset();
+
+    if (!finished.empty())
+    {
+        std::scoped_lock lock(lock_);
+        for (auto& request : finished)
+            finished_.push_back(std::move(request));
+    }
+    running_.store(false, std::memory_order_release);
+}
+
+}
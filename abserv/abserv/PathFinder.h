@@ -0,0 +1,110 @@
+/**
+ * Copyright 2017-2020 Stefan Ascher
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "NavigationMesh.h"
+#include <absmath/Vector3.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sa/LruCache.h>
+#include <vector>
+
+namespace Navigation {
+
+struct Path
+{
+    std::vector<Math::Vector3> points;
+    /// The polygons the path goes through
+    std::vector<dtPolyRef> polys;
+};
+
+/// Finds paths of one game on a worker thread. Requests made during a game tick are
+/// sent to a worker at the end of the tick and the results are delivered to the
+/// callbacks at the beginning of the next tick on the game thread. Searches which
+/// exceed the iteration budget of a tick continue in the next tick.
+class PathFinder : public std::enable_shared_from_this<PathFinder>
+{
+public:
+    using Callback = std::function<void(bool success, Path& path)>;
+    /// Maximum number of search iterations a game may use in one tick
+    static constexpr int DEFAULT_ITERATION_BUDGET = 8192;
+    /// Number of polygon paths to remember
+    static constexpr size_t CACHE_SIZE = 256;
+private:
+    struct Request
+    {
+        Math::Vector3 start;
+        Math::Vector3 end;
+        Math::Vector3 extends;
+        Callback callback;
+        bool started{ false };
+        bool success{ false };
+        Path path;
+    };
+    struct CacheKey
+    {
+        dtPolyRef startRef;
+        dtPolyRef endRef;
+        bool operator==(const CacheKey& rhs) const { return startRef == rhs.startRef && endRef == rhs.endRef; }
+    };
+    struct CacheKeyHash
+    {
+        size_t operator()(const CacheKey& key) const
+        {
+            return std::hash<dtPolyRef>()(key.startRef) * 31 + std::hash<dtPolyRef>()(key.endRef);
+        }
+    };
+    std::shared_ptr<NavigationMesh> navMesh_;
+    int iterationBudget_{ DEFAULT_ITERATION_BUDGET };
+    // Game thread only
+    std::vector<Request> incoming_;
+    // Owned by the worker while running_ is true
+    std::deque<Request> queue_;
+    // The query of a search which is still in progress is kept until the search is finished
+    NavigationMesh::QueryPtr query_;
+    std::atomic<bool> running_{ false };
+    std::mutex lock_;
+    std::vector<Request> finished_;
+    // Polygons of complete paths, agents of this game often go the same way. Worker only.
+    sa::LruCache<CacheKey, std::vector<dtPolyRef>, CacheKeyHash> cache_;
+    void Process();
+public:
+    explicit PathFinder(std::shared_ptr<NavigationMesh> navMesh);
+    ~PathFinder();
+
+    /// Queue a path request. The callback is called from the game thread in one of the next ticks.
+    void FindPath(const Math::Vector3& start, const Math::Vector3& end,
+        const Math::Vector3& extends, Callback&& callback);
+    /// Call the callbacks of finished requests. Call from the game thread at the beginning of a tick.
+    void Deliver();
+    /// Send queued requests to a worker thread. Call from the game thread at the end of a tick.
+    void Dispatch();
+    void SetIterationBudget(int value) { iterationBudget_ = value; }
+    int GetIterationBudget() const { return iterationBudget_; }
+    bool IsBusy() const { return running_.load(std::memory_order_acquire); }
+};
+
+}
@@ -68,17 +68,13 @@ void Player::RegisterLua(kaguya::State& state)
 
 Player::Player(std::shared_ptr<Net::ProtocolGame> client) :
     Actor(),
+    luaState_(Lua::CreateState()),
     client_(client),
     questComp_(std::make_unique<Components::QuestComp>(*this))
 {
-    events_.Subscribe<void(AB::GameProtocol::CommandType, const std::string&, Net::NetworkMessage&)>(EVENT_ON_HANDLECOMMAND,
-        std::bind(&Player::OnHandleCommand, this,
-            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    events_.Subscribe<void(void)>(EVENT_ON_INVENTORYFULL, std::bind(&Player::OnInventoryFull, this));
-    events_.Subscribe<void(uint32_t, AB::GameProtocol::ObjectCallType, int)>(EVENT_ON_PINGOBJECT,
-        std::bind(
-            &Player::OnPingObject, this,
-            std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+    SubscribeEvent<EVENT_ON_HANDLECOMMAND, &Player::OnHandleCommand>(this);
+    SubscribeEvent<EVENT_ON_INVENTORYFULL, &Player::OnInventoryFull>(this);
+    SubscribeEvent<EVENT_ON_PINGOBJECT, &Player::OnPingObject>(this);
 }
 
 Player::~Player() = default;
@@ -819,6 +815,13 @@ void Player::WriteToOutput(const Net::NetworkMessage& message)
         client_->WriteToOutput(message);
 }
 
+bool Player::HasProtocolCapability(uint32_t capability) const
+{
+    if (!client_)
+        return false;
+    return client_->HasCapability(capability);
+}
+
 void Player::OnPingObject(uint32_t targetId, AB::GameProtocol::ObjectCallType type, int skillIndex)
 {
     auto msg = Net::NetworkMessage::GetNew();
@@ -879,7 +882,11 @@ void Player::Update(uint32_t timeElapsed, Net::NetworkMessage& message)
     questComp_->Write(message);
     auto party = GetParty();
     if (party->IsLeader(*this))
-        party->Update(timeElapsed, message);
+    {
+        // Other parties must know it too
+        if (auto game = GetGame())
+            party->Update(timeElapsed, game->GetGameStatus());
+    }
 }
 
 bool Player::RemoveMoney(uint32_t count)
@@ -1145,7 +1152,7 @@ void Player::CRQSetOnlineStatus(AB::Entities::OnlineStatus status)
 
     account_.onlineStatus = status;
     auto* client = GetSubsystem<IO::DataClient>();
-    client->Update(account_);
+    client->UpdateAsync(account_);
     GetGame()->BroadcastPlayerChanged(*this, AB::GameProtocol::PlayerInfoFieldOnlineStatus);
 }
 
@@ -1288,7 +1295,7 @@ void Player::CRQEquipSkill(uint32_t skillIndex, uint8_t pos)
         if (skillIndex != 0)
         {
             auto* sm = GetSubsystem<SkillManager>();
-            auto skill = sm->Get(skillIndex);
+            auto skill = sm->Get(skillIndex, luaState_);
             if (skill)
             {
                 if (haveAccess(skill->data_, account_.type >= AB::Entities::AccountTypeGamemaster) &&
@@ -1785,7 +1792,11 @@ void Player::HandleInstancesCommand(const std::string&, Net::NetworkMessage&)
     {
         ss << game.second->instanceData_.uuid << ",";
         ss << game.second->data_.uuid << ",";
-        ss << game.second->data_.name << ";";
+        ss << game.second->data_.name << ",";
+        const auto& gc = game.second->GetLuaGcStats();
+        const uint64_t ticks = gc.ticks;
+        // Lua GC time per tick in us, average/max
+        ss << (ticks != 0 ? gc.totalTime / ticks : 0) << "/" << gc.maxTime << ";";
     }
 
     AB::Packets::Server::ServerMessage packet = {
@@ -45,6 +45,9 @@ class Player final : public Actor
 {
     friend class PlayerManager;
 private:
+    /// Skills, effects and quests of the player. The player is created before it enters
+    /// a game and recreated when it changes the game, so it can't use the VM of the game.
+    Lua::SharedState luaState_;
     // The Player and ConnectionManager owns the client. The client has a weak ref of the player.
     std::shared_ptr<Net::ProtocolGame> client_;
     std::unique_ptr<MailBox> mailBox_;
@@ -98,6 +101,7 @@ public:
 
     /// We are entering a game
     void SetGame(std::shared_ptr<Game> game) override;
+    Lua::SharedState GetLuaState() const override { return luaState_; }
     const std::string& GetName() const override { return data_.name; }
     AB::Entities::CharacterSex GetSex() const override
     {
@@ -146,6 +150,8 @@ public:
     bool SatisfyQuestRequirements(uint32_t index) const;
 
     void WriteToOutput(const Net::NetworkMessage& message);
+    /// Check if the client supports a AB::PROTOCOL_CAPABILITY_*
+    bool HasProtocolCapability(uint32_t capability) const;
     bool IsResigned() const { return resigned_; }
 
     void SetParty(std::shared_ptr<Party> party);
@@ -31,9 +31,8 @@ namespace Components {
 ProgressComp::ProgressComp(Actor& owner) :
     owner_(owner)
 {
-    owner_.SubscribeEvent<void(void)>(EVENT_ON_DIED, std::bind(&ProgressComp::OnDied, this));
-    owner_.SubscribeEvent<void(Actor*, Actor*)>(EVENT_ON_KILLEDFOE, std::bind(&ProgressComp::OnKilledFoe,
-        this, std::placeholders::_1, std::placeholders::_2));
+    owner_.SubscribeEvent<EVENT_ON_DIED, &ProgressComp::OnDied>(this);
+    owner_.SubscribeEvent<EVENT_ON_KILLEDFOE, &ProgressComp::OnKilledFoe>(this);
 }
 
 void ProgressComp::Write(Net::NetworkMessage& message)
@@ -108,7 +107,7 @@ void ProgressComp::OnDied()
     // When we die all Enemies in range get XP for that
     owner_.VisitEnemiesInRange(Ranges::Aggro, [&](const Actor& actor)
     {
-        const_cast<Actor&>(actor).CallEvent<void(Actor*, Actor*)>(EVENT_ON_KILLEDFOE, &owner_, killer);
+        const_cast<Actor&>(actor).CallEvent<EVENT_ON_KILLEDFOE>(&owner_, killer);
         return Iteration::Continue;
     });
     ++deaths_;
@@ -41,7 +41,7 @@ void Projectile::RegisterLua(kaguya::State& state)
 Projectile::Projectile(const std::string& itemUuid) :
     Actor()
 {
-    events_.Subscribe<void(GameObject*)>(EVENT_ON_COLLIDE, std::bind(&Projectile::OnCollide, this, std::placeholders::_1));
+    SubscribeEvent<EVENT_ON_COLLIDE, &Projectile::OnCollide>(this);
     SetCollisionShape(
         std::make_unique<Math::CollisionShape<Math::Sphere>>(Math::ShapeType::Sphere,
             Math::Vector3::Zero, PROJECTILE_SIZE)
@@ -51,35 +51,37 @@ Projectile::Projectile(const std::string& itemUuid) :
     undestroyable_ = true;
     selectable_ = false;
     itemUuid_ = itemUuid;
-
-    InitializeLua();
 }
 
 Projectile::~Projectile() = default;
 
 void Projectile::InitializeLua()
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(GetLuaState());
+    luaEnv_["self"] = this;
     luaInitialized_ = true;
 }
 
 bool Projectile::LoadScript(const std::string& fileName)
 {
+    InitializeLua();
     script_ = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script_)
         return false;
-    if (!script_->Execute(luaState_))
+    if (!luaEnv_.Execute(*script_))
         return false;
 
-    if (Lua::IsFunction(luaState_, "onCollide"))
-        functions_ |= FunctionOnCollide;
-    if (Lua::IsFunction(luaState_, "onHitTarget"))
-        functions_ |= FunctionOnHitTarget;
-    if (Lua::IsFunction(luaState_, "onStart"))
-        functions_ |= FunctionOnStart;
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "onCollide",
+        "onHitTarget",
+        "onStart",
+        "onInit"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
 
-    bool ret = luaState_["onInit"]();
+    if (!HaveFunction(FunctionOnInit))
+        return false;
+    bool ret = luaEnv_.GetFunction(FunctionOnInit)();
     return ret;
 }
 
@@ -234,7 +236,7 @@ void Projectile::Update(uint32_t timeElapsed, Net::NetworkMessage& message)
             // We may not really collide because of the low game update rate, so let's
             // approximate if we would collide
             if (error_ == AB::GameProtocol::AttackErrorNone)
-                CallEvent<void(GameObject*)>(EVENT_ON_COLLIDE, target.get());
+                CallEvent<EVENT_ON_COLLIDE>(target.get());
         }
         else if (dist < currentDistance_)
             currentDistance_ = dist;
@@ -266,7 +268,7 @@ uint32_t Projectile::GetLevel() const
 void Projectile::OnCollide(GameObject* other)
 {
     if (HaveFunction(FunctionOnCollide))
-        Lua::CallFunction(luaState_, "onCollide", other);
+        luaEnv_.CallFunction(FunctionOnCollide, other);
 
     if (other)
     {
@@ -275,7 +277,7 @@ void Projectile::OnCollide(GameObject* other)
             if (other->id_ == spt->id_)
             {
                 if (HaveFunction(FunctionOnHitTarget))
-                    Lua::CallFunction(luaState_, "onHitTarget", other);
+                    luaEnv_.CallFunction(FunctionOnHitTarget, other);
             }
         }
     }
@@ -290,7 +292,7 @@ bool Projectile::DoStart()
     assert(t);
     bool ret = true;
     if (HaveFunction(FunctionOnStart))
-        ret = luaState_["onStart"](t.get());
+        ret = luaEnv_.GetFunction(FunctionOnStart)(t.get());
     if (ret)
         startTick_ = Utils::Tick();
     return true;
@@ -35,14 +35,15 @@ class Projectile final : public Actor
 private:
     static const uint32_t DEFAULT_LIFETIME = 1000;
     std::unique_ptr<Item> item_;
-    enum Function : uint32_t
+    enum Function : size_t
     {
-        FunctionNone = 0,
-        FunctionOnCollide = 1 << 1,
-        FunctionOnHitTarget = 1 << 2,
-        FunctionOnStart = 1 << 3,
+        FunctionOnCollide,
+        FunctionOnHitTarget,
+        FunctionOnStart,
+        FunctionOnInit,
+        FunctionCount
     };
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     bool luaInitialized_{ false };
     bool startSet_{ false };
     std::shared_ptr<Script> script_;
@@ -58,13 +59,12 @@ private:
     std::string itemUuid_;
     int64_t startTick_{ 0 };
     uint32_t lifeTime_{ DEFAULT_LIFETIME };
-    uint32_t functions_{ FunctionNone };
     AB::GameProtocol::AttackError error_{ AB::GameProtocol::AttackErrorNone };
     void InitializeLua();
     bool LoadScript(const std::string& fileName);
     bool HaveFunction(Function func) const
     {
-        return luaInitialized_ && ((functions_ & func) == func);
+        return luaInitialized_ && luaEnv_.HaveFunction(func);
     }
     void SetError(AB::GameProtocol::AttackError error);
     Actor* _LuaGetSource();
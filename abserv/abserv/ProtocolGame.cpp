@@ -101,14 +101,14 @@ void ProtocolGame::Login(AB::Packets::Client::GameLogin packet)
     player->account_.onlineStatus = AB::Entities::OnlineStatus::OnlineStatusOnline;
     player->account_.currentCharacterUuid = player->data_.uuid;
     player->account_.currentServerUuid = ProtocolGame::serverId_;
-    client->Update(player->account_);
+    client->UpdateAsync(player->account_);
 
     player->Initialize();
     player->data_.currentMapUuid = packet.mapUuid;
     player->data_.lastLogin = Utils::Tick();
     if (!uuids::uuid(packet.instanceUuid).nil())
         player->data_.instanceUuid = packet.instanceUuid;
-    client->Update(player->data_);
+    client->UpdateAsync(player->data_);
     OutputMessagePool::Instance()->AddToAutoSend(shared_from_this());
     LOG_INFO << "User " << player->account_.name << " logged in with " << player->data_.name << " entering " << g.name << std::endl;
     player_ = player;
@@ -484,6 +484,7 @@ void ProtocolGame::OnRecvFirstMessage(NetworkMessage& msg)
         DisconnectClient(AB::ErrorCodes::WrongProtocolVersion);
         return;
     }
+    capabilities_ = packet.capabilities;
     for (int i = 0; i < DH_KEY_LENGTH; ++i)
         clientKey_[i] = packet.key[i];
     auto* keys = GetSubsystem<Crypto::DHKeys>();
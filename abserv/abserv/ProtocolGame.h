@@ -50,6 +50,8 @@ public:
 private:
     std::weak_ptr<Game::Player> player_;
     DH_KEY clientKey_;
+    /// AB::PROTOCOL_CAPABILITY_* flags supported by the client
+    uint32_t capabilities_{ 0 };
     std::shared_ptr<Game::Player> GetPlayer()
     {
         return player_.lock();
@@ -76,6 +78,7 @@ public:
     void ChangeServerInstance(const std::string& serverUuid,
         const std::string& mapUuid, const std::string& instanceUuid);
     void WriteToOutput(const NetworkMessage& message);
+    bool HasCapability(uint32_t capability) const { return (capabilities_ & capability) == capability; }
 private:
     template <typename Callable, typename... Args>
     void AddPlayerTask(Callable&& function, Args&&... args)
@@ -53,16 +53,15 @@ Quest::Quest(Player& owner,
     repeatable_(q.repeatable),
     playerQuest_(std::move(playerQuest))
 {
-    owner_.SubscribeEvent<void(Actor*, Actor*)>(EVENT_ON_KILLEDFOE, std::bind(&Quest::OnKilledFoe,
-        this, std::placeholders::_1, std::placeholders::_2));
+    owner_.SubscribeEvent<EVENT_ON_KILLEDFOE, &Quest::OnKilledFoe>(this);
     InitializeLua();
     LoadProgress();
 }
 
 void Quest::InitializeLua()
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(owner_.GetLuaState());
+    luaEnv_["self"] = this;
 }
 
 bool Quest::LoadScript(const std::string& fileName)
@@ -73,11 +72,14 @@ bool Quest::LoadScript(const std::string& fileName)
     auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script)
         return false;
-    if (!script->Execute(luaState_))
+    if (!luaEnv_.Execute(*script))
         return false;
 
-    if (Lua::IsFunction(luaState_, "onUpdate"))
-        functions_ |= FunctionUpdate;
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "onUpdate",
+        "onKilledFoe"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
     return true;
 }
 
@@ -138,7 +140,7 @@ void Quest::Update(uint32_t timeElapsed)
         return;
 
     if (HaveFunction(FunctionUpdate))
-        luaState_["onUpdate"](timeElapsed);
+        luaEnv_.GetFunction(FunctionUpdate)(timeElapsed);
 }
 
 void Quest::Write(Net::NetworkMessage& message)
@@ -209,7 +211,7 @@ void Quest::SetVar(const std::string& name, const Utils::Variant& val)
 
 void Quest::OnKilledFoe(Actor* foe, Actor* killer)
 {
-    Lua::CallFunction(luaState_, "onKilledFoe", foe, killer);
+    luaEnv_.CallFunction(FunctionOnKilledFoe, foe, killer);
 }
 
 bool Quest::IsActive() const
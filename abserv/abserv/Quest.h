@@ -26,6 +26,7 @@
 #include <kaguya/kaguya.hpp>
 #include <AB/Entities/Quest.h>
 #include <AB/Entities/PlayerQuest.h>
+#include "ScriptManager.h"
 
 namespace Net {
 class NetworkMessage;
@@ -39,13 +40,13 @@ class Actor;
 class Quest
 {
 private:
-    enum Function : uint32_t
+    enum Function : size_t
     {
-        FunctionNone,
-        FunctionUpdate = 1,
+        FunctionUpdate,
+        FunctionOnKilledFoe,
+        FunctionCount
     };
-    uint32_t functions_{ FunctionNone };
-    kaguya::State luaState_;
+    Lua::Environment luaEnv_;
     Utils::VariantMap variables_;
     Player& owner_;
     uint32_t index_;
@@ -55,7 +56,7 @@ private:
     void InitializeLua();
     bool HaveFunction(Function func) const
     {
-        return (functions_ & func) == func;
+        return luaEnv_.HaveFunction(func);
     }
     std::string _LuaGetVarString(const std::string& name);
     void _LuaSetVarString(const std::string& name, const std::string& value);
@@ -46,7 +46,7 @@ bool ResourceComp::IncreaseMorale()
         result = true;
     }
     // We should fire this event even when we reached tthe limit
-    owner_.CallEvent<void(int)>(EVENT_ON_INCMORALE, morale_);
+    owner_.CallEvent<EVENT_ON_INCMORALE>(morale_);
     return result;
 }
 
@@ -60,7 +60,7 @@ bool ResourceComp::DecreaseMorale()
         dirtyFlags_ |= ResourceDirty::DirtyMorale;
         result = true;
     }
-    owner_.CallEvent<void(int)>(EVENT_ON_DECMORALE, morale_);
+    owner_.CallEvent<EVENT_ON_DECMORALE>(morale_);
     return result;
 }
 
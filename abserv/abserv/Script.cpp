@@ -24,25 +24,29 @@
 
 namespace Game {
 
-template<typename CharT, typename TraitsT = std::char_traits<CharT> >
-class vectorbuf : public std::basic_streambuf<CharT, TraitsT>
-{
-public:
-    vectorbuf(std::vector<CharT>& vec)
-    {
-        this->setg(vec.data(), vec.data(), vec.data() + vec.size());
-    }
-};
-
 Script::~Script() = default;
 
 bool Script::Execute(kaguya::State& luaState)
 {
-    vectorbuf<char> databuf(buffer_);
-    std::istream is(&databuf);
-    if (!luaState.dostream(is))
+    return Execute(luaState.state(), 0);
+}
+
+bool Script::Execute(lua_State* L, int envIndex)
+{
+    kaguya::util::ScopedSavedStack save(L);
+    // The buffer contains the compiled byte code, so it doesn't need to be parsed again
+    int status = luaL_loadbufferx(L, buffer_.data(), buffer_.size(), fileName_.c_str(), "b");
+    if (status == LUA_OK && envIndex != 0)
+    {
+        // The first upvalue of a main chunk is _ENV
+        lua_pushvalue(L, envIndex);
+        lua_setupvalue(L, -2, 1);
+    }
+    if (status == LUA_OK)
+        status = lua_pcall(L, 0, LUA_MULTRET, 0);
+    if (status != LUA_OK)
     {
-        LOG_ERROR << lua_tostring(luaState.state(), -1) << std::endl;
+        LOG_ERROR << lua_tostring(L, -1) << std::endl;
         return false;
     }
     return true;
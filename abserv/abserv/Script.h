@@ -24,6 +24,8 @@
 #include <vector>
 #include "Asset.h"
 
+struct lua_State;
+
 namespace kaguya {
 class State;
 }
@@ -44,9 +46,15 @@ public:
     {
         return buffer_;
     }
+    const std::vector<char>& GetBuffer() const
+    {
+        return buffer_;
+    }
 
     /// Execute the script
     bool Execute(kaguya::State& luaState);
+    /// Execute the script with the table at envIndex as _ENV
+    bool Execute(lua_State* L, int envIndex);
 };
 
 }
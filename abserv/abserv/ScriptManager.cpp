@@ -39,6 +39,40 @@ namespace Game {
 namespace Lua {
 
 static const char* MAIN_SCRIPT = "/scripts/main.lua";
+/// Registry key of the metatable shared by all environments of a VM
+static const char* ENVIRONMENT_META = "__ab_environment__";
+
+static std::string GetIncludeGuard(const std::string& file)
+{
+    // Make something like an include guard
+    std::string ident(file);
+    sa::MakeIdent(ident);
+    return "__included_" + ident + "__";
+}
+
+/// include() of an environment, the environment table is upvalue 1
+static int LuaEnvironmentInclude(lua_State* L)
+{
+    const char* file = luaL_checkstring(L, 1);
+    auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(file);
+    if (!script)
+        return 0;
+    const int env = lua_upvalueindex(1);
+    const std::string ident = GetIncludeGuard(file);
+    lua_pushstring(L, ident.c_str());
+    const bool included = lua_rawget(L, env) == LUA_TBOOLEAN;
+    lua_pop(L, 1);
+    if (included)
+        return 0;
+    // Included files define data of the including object, so they run in its environment
+    if (script->Execute(L, env))
+    {
+        lua_pushstring(L, ident.c_str());
+        lua_pushboolean(L, 1);
+        lua_rawset(L, env);
+    }
+    return 0;
+}
 
 static void LuaErrorHandler(int errCode, const char* message)
 {
@@ -72,10 +106,7 @@ void RegisterLuaAll(kaguya::State& state)
         auto script = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(file);
         if (script)
         {
-            // Make something like an include guard
-            std::string ident(file);
-            sa::MakeIdent(ident);
-            ident = "__included_" + ident + "__";
+            const std::string ident = GetIncludeGuard(file);
             if (IsBool(state, ident))
                 return;
             if (script->Execute(state))
@@ -110,9 +141,80 @@ void RegisterLuaAll(kaguya::State& state)
         mainS->Execute(state);
 }
 
-void CollectGarbage(kaguya::State& state)
+SharedState CreateState()
+{
+    auto result = std::make_shared<kaguya::State>();
+    RegisterLuaAll(*result);
+
+    lua_State* L = result->state();
+    lua_newtable(L);
+    lua_pushglobaltable(L);
+    lua_setfield(L, -2, "__index");
+    lua_setfield(L, LUA_REGISTRYINDEX, ENVIRONMENT_META);
+    return result;
+}
+
+Environment::~Environment()
+{
+    Reset();
+}
+
+void Environment::Create(SharedState state)
+{
+    Reset();
+    state_ = std::move(state);
+    lua_State* L = state_->state();
+    kaguya::util::ScopedSavedStack save(L);
+    lua_newtable(L);
+    lua_getfield(L, LUA_REGISTRYINDEX, ENVIRONMENT_META);
+    lua_setmetatable(L, -2);
+    lua_pushvalue(L, -1);
+    lua_pushcclosure(L, LuaEnvironmentInclude, 1);
+    lua_setfield(L, -2, "include");
+    env_ = kaguya::LuaTable(L, kaguya::StackTop());
+}
+
+void Environment::Reset()
+{
+    // Release the references while the VM is still alive
+    functions_.clear();
+    functionMask_ = 0;
+    env_ = kaguya::LuaTable();
+    state_.reset();
+}
+
+void Environment::ResolveFunctions(const char* const* names, size_t count)
+{
+    assert(state_);
+    functions_.clear();
+    functionMask_ = 0;
+    functions_.reserve(count);
+    lua_State* L = state_->state();
+    kaguya::util::ScopedSavedStack save(L);
+    env_.push(L);
+    const int env = lua_gettop(L);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (lua_getfield(L, env, names[i]) == LUA_TFUNCTION)
+        {
+            functions_.emplace_back(L, kaguya::StackTop());
+            functionMask_ |= (1ull << i);
+        }
+        else
+        {
+            lua_pop(L, 1);
+            functions_.emplace_back();
+        }
+    }
+}
+
+bool Environment::Execute(Script& script)
 {
-    state.gc().step();
+    assert(state_);
+    lua_State* L = state_->state();
+    kaguya::util::ScopedSavedStack save(L);
+    env_.push(L);
+    return script.Execute(L, lua_gettop(L));
 }
 
 }
@@ -21,53 +21,127 @@
 
 #pragma once
 
+#include <array>
 #include <kaguya/kaguya.hpp>
+#include <memory>
+#include <vector>
+#include <sa/Noncopyable.h>
 
 namespace Game {
+
+class Script;
+
 namespace Lua {
 
+/// A Lua VM shared by many script objects
+using SharedState = std::shared_ptr<kaguya::State>;
+
 void RegisterLuaAll(kaguya::State& state);
+/// Create a new VM with all classes and global functions registered
+SharedState CreateState();
+
+/// Globals of a single script object. Lookups fall back to the globals of the VM,
+/// so everything registered with RegisterLuaAll() is visible, while variables
+/// and functions defined by the script stay in this table.
+class Environment
+{
+    NON_COPYABLE(Environment)
+    NON_MOVEABLE(Environment)
+private:
+    SharedState state_;
+    kaguya::LuaTable env_;
+    /// Callbacks resolved by ResolveFunctions()
+    std::vector<kaguya::LuaFunction> functions_;
+    uint64_t functionMask_{ 0 };
+    void ResolveFunctions(const char* const* names, size_t count);
+public:
+    /// Max number of callbacks of a script object
+    static constexpr size_t MAX_FUNCTIONS = 64;
+
+    Environment() = default;
+    ~Environment();
+
+    void Create(SharedState state);
+    void Reset();
+    bool IsValid() const { return !!state_; }
+    const SharedState& GetState() const { return state_; }
+    /// Execute the script with this table as _ENV
+    bool Execute(Script& script);
+
+    /// Look up the callbacks of the script once after it was executed, so calling
+    /// them later doesn't need to look them up by name. The index of a name is the
+    /// index used with HaveFunction(), GetFunction() and CallFunction().
+    template<size_t Count>
+    void ResolveFunctions(const std::array<const char*, Count>& names)
+    {
+        static_assert(Count <= MAX_FUNCTIONS, "Too many functions");
+        ResolveFunctions(names.data(), Count);
+    }
+    bool HaveFunction(size_t index) const
+    {
+        return (functionMask_ & (1ull << index)) != 0;
+    }
+    kaguya::LuaFunction& GetFunction(size_t index)
+    {
+        return functions_[index];
+    }
+    template<typename... _CArgs>
+    void CallFunction(size_t index, _CArgs&& ... _Args)
+    {
+        if (HaveFunction(index))
+            functions_[index](std::forward<_CArgs>(_Args)...);
+    }
+
+    kaguya::TableKeyReferenceProxy<std::string> operator[](const std::string& name)
+    {
+        return env_[name];
+    }
+};
 
 /// Check if a function exists
-inline bool IsFunction(kaguya::State& state, const std::string& name)
+template<typename T>
+inline bool IsFunction(T& table, const std::string& name)
 {
-    return state[name].type() == LUA_TFUNCTION;
+    return table[name].type() == LUA_TFUNCTION;
 }
 
-inline bool IsVariable(kaguya::State& state, const std::string& name)
+template<typename T>
+inline bool IsVariable(T& table, const std::string& name)
 {
-    auto t = state[name].type();
+    auto t = table[name].type();
     return t == LUA_TBOOLEAN || t == LUA_TNUMBER || t == LUA_TSTRING;
 }
 
-inline bool IsString(kaguya::State& state, const std::string& name)
+template<typename T>
+inline bool IsString(T& table, const std::string& name)
 {
-    return state[name].type() == LUA_TSTRING;
+    return table[name].type() == LUA_TSTRING;
 }
 
-inline bool IsBool(kaguya::State& state, const std::string& name)
+template<typename T>
+inline bool IsBool(T& table, const std::string& name)
 {
-    return state[name].type() == LUA_TBOOLEAN;
+    return table[name].type() == LUA_TBOOLEAN;
 }
 
-inline bool IsNumber(kaguya::State& state, const std::string& name)
+template<typename T>
+inline bool IsNumber(T& table, const std::string& name)
 {
-    return state[name].type() == LUA_TNUMBER;
+    return table[name].type() == LUA_TNUMBER;
 }
 
-inline bool IsNil(kaguya::State& state, const std::string& name)
+template<typename T>
+inline bool IsNil(T& table, const std::string& name)
 {
-    return state[name].type() == LUA_TNIL;
+    return table[name].type() == LUA_TNIL;
 }
 
-template<typename... _CArgs>
-inline void CallFunction(kaguya::State& state, const std::string& name, _CArgs&& ... _Args)
+template<typename T, typename... _CArgs>
+inline void CallFunction(T& table, const std::string& name, _CArgs&& ... _Args)
 {
-    if (IsFunction(state, name))
-        state[name](std::forward<_CArgs>(_Args)...);
+    if (IsFunction(table, name))
+        table[name](std::forward<_CArgs>(_Args)...);
 }
 
-void CollectGarbage(kaguya::State& state);
-
 }
 }
@@ -75,7 +75,7 @@ bool SelectionComp::SelectObject(uint32_t targetId)
 
     currObjectId_ = targetId;
     if (target)
-        target->CallEvent<void(Actor*)>(EVENT_ON_SELECTED, &owner_);
+        target->CallEvent<EVENT_ON_SELECTED>(&owner_);
     return true;
 }
 
@@ -84,7 +84,7 @@ bool SelectionComp::ClickObject(uint32_t targetId)
     auto* clickedObj = owner_.GetGame()->GetObject<GameObject>(targetId);
     if (clickedObj)
     {
-        clickedObj->CallEvent<void(Actor*)>(EVENT_ON_CLICKED, &owner_);
+        clickedObj->CallEvent<EVENT_ON_CLICKED>(&owner_);
         return true;
     }
     return false;
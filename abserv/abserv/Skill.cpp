@@ -51,10 +51,10 @@ void Skill::RegisterLua(kaguya::State& state)
     );
 }
 
-void Skill::InitializeLua()
+void Skill::InitializeLua(Lua::SharedState luaState)
 {
-    Lua::RegisterLuaAll(luaState_);
-    luaState_["self"] = this;
+    luaEnv_.Create(std::move(luaState));
+    luaEnv_["self"] = this;
 }
 
 bool Skill::LoadScript(const std::string& fileName)
@@ -62,30 +62,36 @@ bool Skill::LoadScript(const std::string& fileName)
     script_ = GetSubsystem<IO::DataProvider>()->GetAsset<Script>(fileName);
     if (!script_)
         return false;
-    if (!script_->Execute(luaState_))
+    if (!luaEnv_.Execute(*script_))
         return false;
 
-    energy_ = luaState_["costEnergy"];
-    adrenaline_ = luaState_["costAdrenaline"];
-    activation_ = luaState_["activation"];
-    recharge_ = luaState_["recharge"];
-    overcast_ = luaState_["overcast"];
-    if (Lua::IsNumber(luaState_, "hp"))
-        hp_ = luaState_["hp"];
-
-    if (Lua::IsNumber(luaState_, "range"))
-        range_ = static_cast<Ranges>(luaState_["range"]);
-    if (Lua::IsNumber(luaState_, "targetType"))
-        targetType_ = static_cast<SkillTargetType>(luaState_["targetType"]);
-    if (Lua::IsNumber(luaState_, "effect"))
-        skillEffect_ = static_cast<uint32_t>(luaState_["effect"]);
-    if (Lua::IsNumber(luaState_, "effectTarget"))
-        effectTarget_ = static_cast<uint32_t>(luaState_["effectTarget"]);
-    if (Lua::IsNumber(luaState_, "canInterrupt"))
-        canInterrupt_ = luaState_["canInterrupt"];
-
-    haveOnCancelled_ = Lua::IsFunction(luaState_, "onCancelled");
-    haveOnInterrupted_ = Lua::IsFunction(luaState_, "onInterrupted");
+    energy_ = luaEnv_["costEnergy"];
+    adrenaline_ = luaEnv_["costAdrenaline"];
+    activation_ = luaEnv_["activation"];
+    recharge_ = luaEnv_["recharge"];
+    overcast_ = luaEnv_["overcast"];
+    if (Lua::IsNumber(luaEnv_, "hp"))
+        hp_ = luaEnv_["hp"];
+
+    if (Lua::IsNumber(luaEnv_, "range"))
+        range_ = static_cast<Ranges>(luaEnv_["range"]);
+    if (Lua::IsNumber(luaEnv_, "targetType"))
+        targetType_ = static_cast<SkillTargetType>(luaEnv_["targetType"]);
+    if (Lua::IsNumber(luaEnv_, "effect"))
+        skillEffect_ = static_cast<uint32_t>(luaEnv_["effect"]);
+    if (Lua::IsNumber(luaEnv_, "effectTarget"))
+        effectTarget_ = static_cast<uint32_t>(luaEnv_["effectTarget"]);
+    if (Lua::IsNumber(luaEnv_, "canInterrupt"))
+        canInterrupt_ = luaEnv_["canInterrupt"];
+
+    static constexpr std::array<const char*, FunctionCount> FUNCTION_NAMES = {
+        "canUse",
+        "onCancelled",
+        "onInterrupted",
+        "onStartUse",
+        "onSuccess"
+    };
+    luaEnv_.ResolveFunctions(FUNCTION_NAMES);
 
     return true;
 }
@@ -100,7 +106,7 @@ void Skill::Update(uint32_t)
             auto source = source_.lock();
             auto target = target_.lock();
             // A Skill may even fail here, e.g. when resurrecting an already resurrected target
-            lastError_ = luaState_["onSuccess"](source.get(), target.get());
+            lastError_ = luaEnv_.GetFunction(FunctionOnSuccess)(source.get(), target.get());
             startUse_ = 0;
             if (lastError_ != AB::GameProtocol::SkillErrorNone)
                 recharged_ = 0;
@@ -111,7 +117,7 @@ void Skill::Update(uint32_t)
                 lastUse_ = Utils::Tick();
             }
             if (source)
-                source->CallEvent<void(Skill*)>(EVENT_ON_ENDUSESKILL, this);
+                source->CallEvent<EVENT_ON_ENDUSESKILL>(this);
             source_.reset();
             target_.reset();
         }
@@ -121,7 +127,7 @@ void Skill::Update(uint32_t)
 bool Skill::CanUseSkill(Actor& source, Actor* target)
 {
     bool success = true;
-    source.CallEvent<void(Actor*, Skill*, bool&)>(EVENT_ON_USESKILL, target, this, success);
+    source.CallEvent<EVENT_ON_USESKILL>(target, this, success);
     if (!success)
     {
         lastError_ = AB::GameProtocol::SkillErrorCannotUseSkill;
@@ -176,7 +182,7 @@ bool Skill::CanUseSkill(Actor& source, Actor* target)
         }
         // Finally check the target is not immune or something
         bool targetSuccess = true;
-        target->CallEvent<void(Actor*, Skill*, bool&)>(EVENT_ON_SKILLTARGETED, &source, this, targetSuccess);
+        target->CallEvent<EVENT_ON_SKILLTARGETED>(&source, this, targetSuccess);
         if (!targetSuccess)
         {
             lastError_ = AB::GameProtocol::SkillErrorInvalidTarget;
@@ -198,9 +204,9 @@ uint32_t Skill::GetRecharge(uint32_t recharge)
 
 AB::GameProtocol::SkillError Skill::CanUse(Actor* source, Actor* target)
 {
-    if (Lua::IsFunction(luaState_, "canUse"))
-        return luaState_["canUse"](source, target);
-    return luaState_["onStartUse"](source, target);
+    if (luaEnv_.HaveFunction(FunctionCanUse))
+        return luaEnv_.GetFunction(FunctionCanUse)(source, target);
+    return luaEnv_.GetFunction(FunctionOnStartUse)(source, target);
 }
 
 AB::GameProtocol::SkillError Skill::StartUse(std::shared_ptr<Actor> source, std::shared_ptr<Actor> target)
@@ -231,7 +237,7 @@ AB::GameProtocol::SkillError Skill::StartUse(std::shared_ptr<Actor> source, std:
     source_ = source;
     target_ = target;
 
-    lastError_ = luaState_["onStartUse"](source.get(), target.get());
+    lastError_ = luaEnv_.GetFunction(FunctionOnStartUse)(source.get(), target.get());
     if (lastError_ != AB::GameProtocol::SkillErrorNone)
     {
         startUse_ = 0;
@@ -243,21 +249,21 @@ AB::GameProtocol::SkillError Skill::StartUse(std::shared_ptr<Actor> source, std:
     source->resourceComp_->SetEnergy(Components::SetValueType::Decrease, realEnergy_);
     source->resourceComp_->SetAdrenaline(Components::SetValueType::Decrease, realAdrenaline_);
     source->resourceComp_->SetOvercast(Components::SetValueType::Increase, realOvercast_);
-    source->CallEvent<void(Skill*)>(EVENT_ON_STARTUSESKILL, this);
+    source->CallEvent<EVENT_ON_STARTUSESKILL>(this);
     return lastError_;
 }
 
 void Skill::CancelUse()
 {
     auto source = source_.lock();
-    if (haveOnCancelled_)
+    if (luaEnv_.HaveFunction(FunctionOnCancelled))
     {
         auto target = target_.lock();
-        Lua::CallFunction(luaState_, "onCancelled",
+        luaEnv_.CallFunction(FunctionOnCancelled,
             source.get(), target.get());
     }
     if (source)
-        source->CallEvent<void(Skill*)>(EVENT_ON_ENDUSESKILL, this);
+        source->CallEvent<EVENT_ON_ENDUSESKILL>(this);
     startUse_ = 0;
     // No recharging when canceled
     recharged_ = 0;
@@ -271,16 +277,16 @@ bool Skill::Interrupt()
         return false;
 
     auto source = source_.lock();
-    if (haveOnInterrupted_)
+    if (luaEnv_.HaveFunction(FunctionOnInterrupted))
     {
         auto target = target_.lock();
-        Lua::CallFunction(luaState_, "onInterrupted",
+        luaEnv_.CallFunction(FunctionOnInterrupted,
             source.get(), target.get());
     }
     if (source)
     {
-        source->CallEvent<void(Skill*)>(EVENT_ON_INTERRUPTEDSKILL, this);
-        source->CallEvent<void(Skill*)>(EVENT_ON_ENDUSESKILL, this);
+        source->CallEvent<EVENT_ON_INTERRUPTEDSKILL>(this);
+        source->CallEvent<EVENT_ON_ENDUSESKILL>(this);
     }
     startUse_ = 0;
     source_.reset();
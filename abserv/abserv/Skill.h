@@ -80,7 +80,16 @@ class Skill
     NON_COPYABLE(Skill)
     friend class SkillBar;
 private:
-    kaguya::State luaState_;
+    enum Function : size_t
+    {
+        FunctionCanUse,
+        FunctionOnCancelled,
+        FunctionOnInterrupted,
+        FunctionOnStartUse,
+        FunctionOnSuccess,
+        FunctionCount
+    };
+    Lua::Environment luaEnv_;
     std::shared_ptr<Script> script_;
     int64_t startUse_{ 0 };
     int64_t lastUse_{ 0 };
@@ -99,12 +108,10 @@ private:
     int32_t realOvercast_{ 0 };
     int32_t realHp_{ 0 };
 
-    bool haveOnCancelled_{ false };
-    bool haveOnInterrupted_{ false };
     AB::GameProtocol::SkillError lastError_{ AB::GameProtocol::SkillErrorNone };
 
     bool CanUseSkill(Actor& source, Actor* target);
-    void InitializeLua();
+    void InitializeLua(Lua::SharedState luaState);
     int _LuaGetType() const { return static_cast<int>(data_.type); }
     uint32_t _LuaGetIndex() const { return data_.index; }
     bool _LuaIsElite() const { return data_.isElite; }
@@ -115,10 +122,11 @@ private:
 public:
     static void RegisterLua(kaguya::State& state);
 
-    explicit Skill(const AB::Entities::Skill& skill) :
+    /// luaState is the VM of the owner
+    Skill(const AB::Entities::Skill& skill, Lua::SharedState luaState) :
         data_(skill)
     {
-        InitializeLua();
+        InitializeLua(std::move(luaState));
     }
     // non-copyable
     ~Skill() = default;
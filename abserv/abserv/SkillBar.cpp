@@ -62,7 +62,7 @@ Skill* SkillBar::_LuaGetSkill(int pos)
 int SkillBar::_LuaAddSkill(uint32_t skillIndex)
 {
     SkillManager* sm = GetSubsystem<SkillManager>();
-    std::shared_ptr<Skill> skill = sm->Get(skillIndex);
+    std::shared_ptr<Skill> skill = sm->Get(skillIndex, owner_.GetLuaState());
     if (!skill)
         return -1;
 
@@ -83,7 +83,7 @@ int SkillBar::_LuaAddSkill(uint32_t skillIndex)
 bool SkillBar::_LuaSetSkill(int pos, uint32_t skillIndex)
 {
     auto* sm = GetSubsystem<SkillManager>();
-    auto skill = sm->Get(skillIndex);
+    auto skill = sm->Get(skillIndex, owner_.GetLuaState());
     if (skill)
     {
         if (!SetSkill(static_cast<int>(pos), skill))
@@ -231,6 +231,7 @@ bool SkillBar::Load(const std::string& str, bool locked)
     InitAttributes();
     SetAttributes(attribs);
     auto* skillMan = GetSubsystem<SkillManager>();
+    auto luaState = owner_.GetLuaState();
 
     auto professionsMatch = [&](const AB::Entities::Skill& skill)
     {
@@ -263,10 +264,10 @@ bool SkillBar::Load(const std::string& str, bool locked)
 
     for (size_t i = 0; i < PLAYER_MAX_SKILLS; i++)
     {
-        skills_[i] = skillMan->Get(skills[i]);
+        skills_[i] = skillMan->Get(skills[i], luaState);
         if (skills_[i] && (!hasAccess(skills_[i]->data_) || !professionsMatch(skills_[i]->data_)))
             // This player can not have locked skills
-            skills_[i] = skillMan->Get(0);
+            skills_[i] = skillMan->Get(0, luaState);
     }
 
     return true;
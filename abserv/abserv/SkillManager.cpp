@@ -28,7 +28,7 @@ namespace Game {
 
 SkillManager::SkillManager() = default;
 
-std::shared_ptr<Skill> SkillManager::Get(uint32_t index)
+std::shared_ptr<Skill> SkillManager::Get(uint32_t index, Lua::SharedState luaState)
 {
     if (index == 0)
         return std::shared_ptr<Skill>();
@@ -37,7 +37,7 @@ std::shared_ptr<Skill> SkillManager::Get(uint32_t index)
     auto it = skillCache_.find(index);
     if (it != skillCache_.end())
     {
-        result = std::make_shared<Skill>((*it).second);
+        result = std::make_shared<Skill>((*it).second, std::move(luaState));
     }
     else
     {
@@ -49,7 +49,7 @@ std::shared_ptr<Skill> SkillManager::Get(uint32_t index)
             LOG_ERROR << "Error reading skill with index " << index << std::endl;
             return std::shared_ptr<Skill>();
         }
-        result = std::make_shared<Skill>(skill);
+        result = std::make_shared<Skill>(skill, std::move(luaState));
         // Move to cache
         skillCache_.emplace(index, skill);
     }
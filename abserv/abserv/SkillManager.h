@@ -33,7 +33,7 @@ public:
     SkillManager();
     ~SkillManager() = default;
 
-    std::shared_ptr<Skill> Get(uint32_t index);
+    std::shared_ptr<Skill> Get(uint32_t index, Lua::SharedState luaState);
 };
 
 }
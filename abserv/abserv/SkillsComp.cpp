@@ -52,7 +52,7 @@ SkillsComp::SkillsComp(Actor& owner) :
     newRecharge_(0),
     lastSkillTime_(0)
 {
-    owner_.SubscribeEvent<void(int)>(EVENT_ON_INCMORALE, std::bind(&SkillsComp::OnIncMorale, this, std::placeholders::_1));
+    owner_.SubscribeEvent<EVENT_ON_INCMORALE, &SkillsComp::OnIncMorale>(this);
 }
 
 void SkillsComp::OnIncMorale(int)
@@ -115,8 +115,7 @@ AB::GameProtocol::SkillError SkillsComp::UseSkill(int index, bool ping)
         uint32_t targetId = 0;
         if (skill->HasTarget(SkillTargetTarget))
             targetId = target ? target->id_ : 0;
-        owner_.CallEvent<void(uint32_t,AB::GameProtocol::ObjectCallType,int)>(EVENT_ON_PINGOBJECT,
-            targetId, AB::GameProtocol::ObjectCallTypeUseSkill, lastSkillIndex_ + 1);
+        owner_.CallEvent<EVENT_ON_PINGOBJECT>(targetId, AB::GameProtocol::ObjectCallTypeUseSkill, lastSkillIndex_ + 1);
     }
 #ifdef DEBUG_AI
     if (lastError_ != AB::GameProtocol::SkillErrorNone)
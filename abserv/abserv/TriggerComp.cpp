@@ -30,7 +30,7 @@ namespace Components {
 TriggerComp::TriggerComp(GameObject& owner) :
     owner_(owner)
 {
-    owner_.SubscribeEvent<void(GameObject*)>(EVENT_ON_COLLIDE, std::bind(&TriggerComp::OnCollide, this, std::placeholders::_1));
+    owner_.SubscribeEvent<EVENT_ON_COLLIDE, &TriggerComp::OnCollide>(this);
 }
 
 void TriggerComp::DoTrigger(GameObject* other)
@@ -43,7 +43,7 @@ void TriggerComp::DoTrigger(GameObject* other)
     const int64_t lastTrigger = (it != triggered_.end()) ? (*it).second : 0;
     if (lastTrigger == 0 || static_cast<uint32_t>(tick - lastTrigger) > retriggerTimeout_)
     {
-        owner_.CallEvent<void(GameObject*)>(EVENT_ON_TRIGGER, other);
+        owner_.CallEvent<EVENT_ON_TRIGGER>(other);
         triggered_[other->id_] = tick;
     }
 }
@@ -81,7 +81,7 @@ void TriggerComp::Update(uint32_t timeElapsed)
             {
                 // No longer collides
                 triggered_.erase(it++);
-                owner_.CallEvent<void(GameObject*)>(EVENT_ON_LEFTAREA, o);
+                owner_.CallEvent<EVENT_ON_LEFTAREA>(o);
             }
             else
                 ++it;
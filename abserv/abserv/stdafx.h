@@ -152,7 +152,7 @@ PRAGMA_WARNING_POP
 #include <multi_index_container.hpp>
 #include <sa/CallableTable.h>
 #include <sa/CircularQueue.h>
-#include <sa/Events.h>
+#include <sa/EventTable.h>
 #include <sa/IdGenerator.h>
 #include <sa/Iteration.h>
 #include <sa/StringHash.h>
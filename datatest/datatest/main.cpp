@@ -9,6 +9,10 @@
 #include <AB/Entities/Account.h>
 #include <AB/Entities/Character.h>
 #include <AB/Entities/Game.h>
+#include <AB/Entities/Service.h>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <uuid.h>
 #define PROFILING
 #include "Profiler.h"
@@ -155,11 +159,47 @@ void TestReadCharacter(IO::DataClient* cli)
     }
 }
 
+void TestReadThroughput(IO::DataClient* cli)
+{
+    // Reads per second of a cached entity of about 1 KB
+    LOG_INFO << "TestReadThroughput()" << std::endl;
+    AB::Entities::Service s;
+    s.uuid = "1bd2c2a4-7e5d-4f0e-9a53-2f6d8f3c9b11";
+    s.machine = std::string(250, 'm');
+    s.file = std::string(250, 'f');
+    s.path = std::string(250, 'p');
+    s.arguments = std::string(250, 'a');
+    if (!cli->UpdateOrCreate(s))
+    {
+        LOG_ERROR << "Error UpdateOrCreate" << std::endl;
+        return;
+    }
+
+    static constexpr int COUNT = 200000;
+    std::atomic<int> done = 0;
+    std::atomic<int> failed = 0;
+    std::promise<void> finished;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < COUNT; ++i)
+    {
+        cli->ReadAsync(s, [&](bool success, AB::Entities::Service&)
+        {
+            if (!success)
+                ++failed;
+            if (++done == COUNT)
+                finished.set_value();
+        });
+    }
+    finished.get_future().wait();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO << COUNT << " reads in " << ms << " ms, " << (COUNT * 1000ll / std::max<long long>(1, ms)) <<
+        " reads/s, " << failed << " failed" << std::endl;
+}
+
 int main()
 {
     std::cout << "Connecting..." << std::endl;
-    asio::io_service io_service;
-    IO::DataClient cli(io_service);
+    IO::DataClient cli;
     cli.Connect("localhost", 2770);
     if (!cli.IsConnected())
     {
@@ -175,6 +215,7 @@ run_it:
     TestUpdate(&cli);
     TestPreload(&cli);
     TestReadCharacter(&cli);
+    TestReadThroughput(&cli);
 
     std::cout << "Run again? [y/n]: ";
     std::string answer;
@@ -24,7 +24,7 @@
 #include "Utils.h"
 #include <abcrypto.hpp>
 #include <AB/ProtocolCodes.h>
-#include <lz4.h>
+#include <AB/Packets/Compression.h>
 
 namespace Client {
 
@@ -117,23 +117,30 @@ void InputMessage::FillBuffer(uint8_t* buffer, uint16_t size)
 
 bool InputMessage::Uncompress()
 {
+    if (!CanRead(1))
+        return false;
+    const uint8_t flag = Get<uint8_t>();
+    if (flag == AB::Packets::MESSAGE_UNCOMPRESSED)
+        return true;
+    if (flag != AB::Packets::MESSAGE_COMPRESSED || !CanRead(sizeof(uint16_t)))
+        return false;
+    const uint16_t compressedSize = Get<uint16_t>();
+    if (compressedSize > GetUnreadSize())
+        return false;
+
     char buff[MaxBufferSize];
-    const char* src = reinterpret_cast<const char*>(buffer_ + MaxHeaderSize);
-    int size = LZ4_decompress_safe(src, buff, size_, MaxBufferSize);
-    if (size > 0)
-    {
-        /*
+    const char* src = reinterpret_cast<const char*>(buffer_ + pos_);
+    // Must fit behind the header and be addressable by size_
+    const int capacity = static_cast<int>(MaxBufferSize - pos_) - 1;
+    int size = AB::Packets::DecompressMessage(src, compressedSize, buff, capacity);
+    if (size < 0)
+        return false;
 #ifdef _MSC_VER
-        memcpy_s(buffer_ + MaxHeaderSize, MaxBufferSize, buff, size);
+    memcpy_s(buffer_ + pos_, MaxBufferSize - pos_, buff, static_cast<size_t>(size));
 #else
-        memcpy(buffer_ + MaxHeaderSize, buff, size);
+    memcpy(buffer_ + pos_, buff, static_cast<size_t>(size));
 #endif
-        size_ = static_cast<uint16_t>(size);
-        pos_ = MaxHeaderSize;
-        headerPos_ = MaxHeaderSize;
-        */
-        return true;
-    }
+    size_ = static_cast<uint16_t>((pos_ - headerPos_) + size);
     return true;
 }
 
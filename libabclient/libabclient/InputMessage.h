@@ -96,6 +96,7 @@ public:
         // Only strings
         return Get<T>();
     }
+    /// Must be called after decrypting the message
     bool Uncompress();
 };
 
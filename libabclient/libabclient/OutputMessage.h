@@ -91,7 +91,6 @@ public:
         info_.pos = p;
     }
 
-    bool Compress();
 };
 
 template<>
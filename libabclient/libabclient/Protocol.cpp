@@ -71,8 +71,6 @@ void Protocol::Send(OutputMessage& message)
 {
     if (encryptEnabled_)
         XTEAEncrypt(message);
-    if (compressionEnabled_)
-        message.Compress();
     if (checksumEnabled_)
         message.WriteChecksum();
     message.WriteMessageSize();
@@ -122,14 +120,15 @@ void Protocol::InternalRecvData(uint8_t* buffer, uint16_t size)
 
     if (checksumEnabled_ && !inputMessage_->ReadChecksum())
         return;
-    if (compressionEnabled_)
+    if (encryptEnabled_)
     {
-        if (!inputMessage_->Uncompress())
+        if (!XTEADecrypt(*inputMessage_))
             return;
     }
-    if (encryptEnabled_)
+    // Only the server compresses messages
+    if (compressionEnabled_)
     {
-        if (!XTEADecrypt(*inputMessage_))
+        if (!inputMessage_->Uncompress())
             return;
     }
 
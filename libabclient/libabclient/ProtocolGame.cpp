@@ -102,6 +102,14 @@ ProtocolGame::ProtocolGame(Receiver& receiver, Crypto::DHKeys& keys, asio::io_se
     AddHandler<AB::Packets::Server::ObjectSecProfessionChanged, ServerPacketType::ObjectSecProfessionChanged>();
     AddHandler<AB::Packets::Server::ObjectSetSkill, ServerPacketType::ObjectSetSkill>();
     AddHandler<AB::Packets::Server::SkillTemplateLoaded, ServerPacketType::PlayerSkillTemplLoaded>();
+    packetHandlers_.Add(ServerPacketType::GameObjectTransformations, [this](InputMessage& message)
+    {
+        ParseObjectTransformations(message);
+    });
+    packetHandlers_.Add(ServerPacketType::GamePositionQuantizer, [this](InputMessage& message)
+    {
+        positionQuantizer_ = AB::Packets::Get<AB::Packets::Server::PositionQuantizer>(message);
+    });
 }
 
 void ProtocolGame::Login(const std::string& accountUuid,
@@ -123,6 +131,7 @@ void ProtocolGame::Login(const std::string& accountUuid,
         AB::Packets::Client::GameLogin packet;
         packet.clientOs = AB::CLIENT_OS_CURRENT;
         packet.protocolVersion = AB::PROTOCOL_VERSION;
+        packet.capabilities = AB::PROTOCOL_CAPABILITIES;
         const DH_KEY& key = keys_.GetPublickKey();
         for (int i = 0; i < DH_KEY_LENGTH; ++i)
             packet.key[i] = key[i];
@@ -238,6 +247,38 @@ void ProtocolGame::ParseMessage(InputMessage& message)
     }
 }
 
+void ProtocolGame::ParseObjectTransformations(InputMessage& message)
+{
+    // Same as if we got the single packets
+    auto packet = AB::Packets::Get<AB::Packets::Server::ObjectTransformations>(message);
+    for (const auto& object : packet.objects)
+    {
+        using namespace AB::Packets::Server;
+        const std::array<float, 3> pos = positionQuantizer_.Dequantize(object.pos);
+        if (object.flags & ObjectTransformationSetPosition)
+        {
+            ObjectSetPosition setPos;
+            setPos.id = object.id;
+            setPos.pos = pos;
+            receiver_.OnPacket(updateTick_, setPos);
+        }
+        else if (object.flags & ObjectTransformationPosition)
+        {
+            ObjectPosUpdate posUpdate = { object.id, pos };
+            receiver_.OnPacket(updateTick_, posUpdate);
+        }
+        if (object.flags & ObjectTransformationRotation)
+        {
+            ObjectRotationUpdate rotUpdate = {
+                object.id,
+                DequantizeRotation(object.yRot),
+                (object.flags & ObjectTransformationManualRotation) != 0
+            };
+            receiver_.OnPacket(updateTick_, rotUpdate);
+        }
+    }
+}
+
 void ProtocolGame::ParseKeyExchange(InputMessage& message)
 {
     for (int i = 0; i < DH_KEY_LENGTH; ++i)
@@ -49,6 +49,8 @@ private:
     bool firstRevc_;
     DH_KEY serverKey_;
     bool loggingOut_;
+    /// Sent by the server when entering a game
+    AB::Packets::Server::PositionQuantizer positionQuantizer_;
 
     // Lookup table code -> packet
     sa::CallableTable<AB::GameProtocol::ServerPacketType, void, InputMessage&> packetHandlers_;
@@ -69,6 +71,7 @@ protected:
 
     void ParseMessage(InputMessage& message);
     void ParseKeyExchange(InputMessage& message);
+    void ParseObjectTransformations(InputMessage& message);
 public:
     ProtocolGame(Receiver& receiver, Crypto::DHKeys& keys, asio::io_service& ioService);
     ~ProtocolGame() override = default;